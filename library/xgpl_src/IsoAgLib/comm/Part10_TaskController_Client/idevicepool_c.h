@@ -183,8 +183,9 @@ namespace IsoAgLib {
       virtual void calcChecksumAdd( uint8_t ) { /* no default implementation */ }
       virtual void calcChecksumEnd() { /* no default implementation */ }
 
-      void calcChecksum() {
-        __IsoAgLib::DevicePool_c::calcChecksum();
+      //! @return false if the pool is unchanged and the last checksum is still valid
+      bool calcChecksum() {
+        return __IsoAgLib::DevicePool_c::calcChecksum();
       }
 
       //! not pedantic: it is safe to insert object multiple time
@@ -202,7 +203,8 @@ namespace IsoAgLib {
         __IsoAgLib::DevicePool_c::clear();
       }
 
-      /* changing designators is not yet supported */
+      //! Sends a Change Designator command if the pool is active,
+      //! otherwise the object is part of the next (partial) upload.
       template<class T>
       void changeDesignator( T& obj, const char* str ) {
         __IsoAgLib::DevicePool_c::changeDesignator( obj, str );
@@ -215,6 +217,12 @@ namespace IsoAgLib {
         __IsoAgLib::DevicePool_c::updateLocale();
       }
 
+      //! Upload the objects modified since the last upload (e.g. a changed
+      //! iDeviceObjectDvp_c) as partial pool to all TCs the pool is active on.
+      void updatePool() {
+        __IsoAgLib::DevicePool_c::updatePool();
+      }
+
       // gets the DET by ElementNumber. This is just a convenience function
       // as the DeviceObjects are inserted by the application itself before!
       iDeviceObjectDet_c* getDetObject( uint16_t elementNumber ) {
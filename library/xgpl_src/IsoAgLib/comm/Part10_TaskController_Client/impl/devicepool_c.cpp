@@ -32,11 +32,15 @@ namespace __IsoAgLib {
   /* --- DeviceObject_c -------------------------------------------------- */
 
   uint16_t DeviceObject_c::m_objIdCounter = 1;
+  uint32_t DeviceObject_c::m_modificationCounter = 0;
 
   DeviceObject_c::DeviceObject_c( const IsoAgLib::ProcData::DeviceObjectType_t type, const char* desig )
     : m_objectType( type ),
       m_objectId( ( type == IsoAgLib::ProcData::ObjectTypeDVC )? 0 : m_objIdCounter ),
-      m_designator( NULL ) {
+      m_designator( NULL ),
+      m_modificationStamp( 0 ),
+      m_bytestreamCache(),
+      m_bytestreamCacheCaps() {
 
     isoaglib_assert( m_objectId != 0xFFFF );
     init( desig );
@@ -48,6 +52,7 @@ namespace __IsoAgLib {
   void DeviceObject_c::init( const char* desig ) {
     isoaglib_assert( !desig || (CNAMESPACE::strlen( desig ) <= 32) );
     m_designator = desig;
+    setModified();
   }
 
 
@@ -55,6 +60,45 @@ namespace __IsoAgLib {
     isoaglib_assert( desig );
     isoaglib_assert( CNAMESPACE::strlen( desig ) <= 32 );
     m_designator = desig;
+    setModified();
+  }
+
+
+  void DeviceObject_c::setModified() {
+    m_modificationStamp = ++m_modificationCounter;
+    // keep the capacity, the object will most probably be formatted again
+    m_bytestreamCache.clear();
+  }
+
+
+  void DeviceObject_c::updateBytestreamCache( const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const {
+    if( !m_bytestreamCache.empty()
+        && ( m_bytestreamCacheCaps.versionNr == caps.versionNr )
+        && ( m_bytestreamCacheCaps.hasPeerControl == caps.hasPeerControl ) )
+      return;
+
+    const uint32_t size = getSize( caps );
+    m_bytestreamCache.resize( size );
+
+    ByteStreamBuffer_c buffer;
+    buffer.setBuffer( &m_bytestreamCache[ 0 ] );
+    buffer.setSize( size );
+    formatBytestream( buffer, caps );
+    isoaglib_assert( buffer.getEnd() == size );
+
+    m_bytestreamCacheCaps = caps;
+  }
+
+
+  uint32_t DeviceObject_c::getSizeCached( const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const {
+    updateBytestreamCache( caps );
+    return uint32_t( m_bytestreamCache.size() );
+  }
+
+
+  void DeviceObject_c::formatBytestreamCached( ByteStreamBuffer_c& byteStream, const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const {
+    updateBytestreamCache( caps );
+    byteStream.format( &m_bytestreamCache[ 0 ], m_bytestreamCache.size() );
   }
 
 
@@ -125,9 +169,11 @@ namespace __IsoAgLib {
 
 
   void DeviceObjectDvc_c::setLocalization( const Localization_s& local ) {
-    //if (STL_NAMESPACE::memcmp((void*)&local, (void*)&m_Localization, sizeof(Localization_s)) != 0)
-    // setDirty(true);
+    if( CNAMESPACE::memcmp( &local, &m_localization, sizeof( Localization_s ) ) == 0 )
+      return;
+
     m_localization = local;
+    setModified();
   }
 
 
@@ -147,6 +193,7 @@ namespace __IsoAgLib {
     m_structLabel.Byte5 = label[4];
     m_structLabel.Byte6 = label[5];
     m_structLabel.Byte7 = label[6];
+    setModified();
   }
 
 
@@ -172,6 +219,7 @@ namespace __IsoAgLib {
 
     m_extendedStructureLabel.length = length;
     CNAMESPACE::memcpy( m_extendedStructureLabel.byteString, s, length );
+    setModified();
   }
 
   void DeviceObjectDvc_c::setExtendedStructureLabel( const char* s ) {
@@ -181,6 +229,7 @@ namespace __IsoAgLib {
   void DeviceObjectDvc_c::setSerialNumber( const char* s ) {
     isoaglib_assert( CNAMESPACE::strlen( s ) <= 32 );
     CNAMESPACE::strcpy( m_serialNumber, s );
+    setModified();
   }
 
 
@@ -269,6 +318,7 @@ namespace __IsoAgLib {
     m_type = type;
     m_elementNumber = element;
     m_parentId = pid;
+    setModified();
   }
 
   void DeviceObjectDet_c::formatBytestream( ByteStreamBuffer_c& byteStream, const IsoAgLib::ProcData::ConnectionCapabilities_s& ) const {
@@ -295,6 +345,7 @@ namespace __IsoAgLib {
 
     const size_t oldSize = m_childList.size();
     m_childList.push_back( childId );
+    setModified();
     return m_childList.size() > oldSize;
   }
 
@@ -331,6 +382,7 @@ namespace __IsoAgLib {
   DeviceObjectDet_c::clearChildren()
   {
 	  m_childList.clear();
+	  setModified();
   }
 
 
@@ -376,11 +428,11 @@ namespace __IsoAgLib {
     isoaglib_assert( m_ddi == 0xFFFF );
     isoaglib_assert( dpd_ddi != 0xFFFF );
 
-    DeviceObject_c::init( desig );
     m_ddi = dpd_ddi;
     m_properties = bitmaskProps.getByte( 0 );
     m_method = bitmaskMethods.getByte( 0 );
     m_dvpObjectId = ( dvp ) ? dvp->getObjectId() : 0xFFFF;
+    DeviceObject_c::init( desig );
   }
 
   void DeviceObjectDpd_c::formatBytestream( ByteStreamBuffer_c& byteStream, const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const {
@@ -437,10 +489,9 @@ namespace __IsoAgLib {
     isoaglib_assert( dpt_ddi != 0xFFFF );
     m_ddi = dpt_ddi;
     m_value = value;
+    m_dvpObjectId = ( dvpRef ) ? dvpRef->getObjectId() : 0xFFFF;
 
     DeviceObject_c::init( desig );
-
-    m_dvpObjectId = ( dvpRef ) ? dvpRef->getObjectId() : 0xFFFF;
   }
 
 
@@ -480,7 +531,6 @@ namespace __IsoAgLib {
     , m_offset( offset )
     , m_scale( scale )
     , m_decimals( decimals )
-    , m_isDirty( false )
   {}
 
 
@@ -518,6 +568,7 @@ namespace __IsoAgLib {
   DevicePool_c::DevicePool_c( unsigned int reserveSize )
     : PdPool_c( reserveSize )
     , m_devicePool()
+    , m_checksumStamp( 0 )
   {}
 
 
@@ -563,6 +614,7 @@ namespace __IsoAgLib {
     isoaglib_assert( (devObj.getObjectType() != IsoAgLib::ProcData::ObjectTypeDET) || (getDetObject(((DeviceObjectDet_c*)&devObj)->elementNumber()) == NULL) );
     (void)m_devicePool.insert(
       STL_NAMESPACE::pair<uint16_t, DeviceObject_c*>( devObj.getObjectId(), &devObj ) ).second;
+    m_checksumStamp = 0;
   }
 
 
@@ -580,21 +632,35 @@ namespace __IsoAgLib {
   {
     m_devicePool.clear();
     m_procDatas.clear();
+    m_checksumStamp = 0;
   }
 
-#if 0
-// currently not supported
+
+  const IdentItem_c* DevicePool_c::getIdentItem() const {
+    const DeviceObjectDvc_c* dvc = getDvcObject();
+    return dvc ? dvc->m_identItem : NULL;
+  }
+
+
   void DevicePool_c::changeDesignator( DeviceObject_c& obj, const char* str ) {
     obj.setDesignator( str );
-    const IdentItem_c &identItem = getDvcObject()->getIdentItem();
-    getTcClientInstance( identItem.getMultitonInst() ).processChangeDesignator( identItem, obj.getObjectId(), str );
+
+    const IdentItem_c* identItem = getIdentItem();
+    if( identItem )
+      getTcClientInstance( identItem->getMultitonInst() ).processChangeDesignator( *identItem, obj.getObjectId(), str );
   }
-#endif
 
 
   void DevicePool_c::setLocalSettings( const localSettings_s& l ) {
     getDvcObject()->setLocalSettings( l );
-    // @todo: call TcClient_c function (partial Pool-Upload will be triggered)
+    updatePool();
+  }
+
+
+  void DevicePool_c::updatePool() {
+    const IdentItem_c* identItem = getIdentItem();
+    if( identItem )
+      getTcClientInstance( identItem->getMultitonInst() ).processPoolUpdate( *identItem );
   }
 
 
@@ -609,31 +675,46 @@ namespace __IsoAgLib {
   }
 
 
-  ByteStreamBuffer_c DevicePool_c::getBytestream( uint8_t cmd, const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) {
-    const uint32_t size = getBytestreamSize( caps ) + 1; // one extra byte for command
+  ByteStreamBuffer_c DevicePool_c::getBytestream( uint8_t cmd, const IsoAgLib::ProcData::ConnectionCapabilities_s& caps, uint32_t modifiedSince ) {
+    const uint32_t size = getBytestreamSize( caps, modifiedSince ) + 1; // one extra byte for command
     ByteStreamBuffer_c buffer;
     buffer.setBuffer( allocByteStreamBuffer( size ) );
     buffer.setSize( size );
     buffer.format( cmd );
 
     for ( deviceMap_t::iterator it = m_devicePool.begin(); it != m_devicePool.end(); ++it ) {
-      it->second->formatBytestream( buffer, caps );
+      if( it->second->getModificationStamp() > modifiedSince )
+        it->second->formatBytestreamCached( buffer, caps );
     }
 
     return buffer;
   }
 
 
-  uint32_t DevicePool_c::getBytestreamSize( const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const {
+  uint32_t DevicePool_c::getBytestreamSize( const IsoAgLib::ProcData::ConnectionCapabilities_s& caps, uint32_t modifiedSince ) const {
     uint32_t size = 0;
     for ( deviceMap_t::const_iterator it = m_devicePool.begin(); it != m_devicePool.end(); ++it ) {
-      size += it->second->getSize( caps );
+      if( it->second->getModificationStamp() > modifiedSince )
+        size += it->second->getSizeCached( caps );
     }
     return size;
   }
 
-  void DevicePool_c::calcChecksum()
+
+  bool DevicePool_c::hasModifiedObjects( uint32_t modifiedSince ) const {
+    for ( deviceMap_t::const_iterator it = m_devicePool.begin(); it != m_devicePool.end(); ++it ) {
+      if( it->second->getModificationStamp() > modifiedSince )
+        return true;
+    }
+    return false;
+  }
+
+
+  bool DevicePool_c::calcChecksum()
   {
+    if( ( m_checksumStamp != 0 ) && !hasModifiedObjects( m_checksumStamp ) )
+      return false;
+
     calcChecksumStart();
     
     for ( deviceMap_t::const_iterator it = m_devicePool.begin(); it != m_devicePool.end(); ++it ) {
@@ -641,6 +722,9 @@ namespace __IsoAgLib {
     }
 
     calcChecksumEnd();
+
+    m_checksumStamp = getModificationStamp();
+    return true;
   }
 
 
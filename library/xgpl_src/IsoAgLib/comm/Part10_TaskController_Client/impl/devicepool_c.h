@@ -76,12 +76,22 @@ namespace __IsoAgLib {
         return m_designator;
       };
 
+      //! Stamp of the last modification of this object.
+      //! Compare against DevicePool_c::getModificationStamp() to detect changes.
+      uint32_t getModificationStamp() const {
+        return m_modificationStamp;
+      }
+
 
     protected:
       const IsoAgLib::ProcData::DeviceObjectType_t m_objectType;
       const uint16_t m_objectId;
       const char* m_designator;
 
+      //! To be called by every setter that changes the object's bytestream.
+      //! Drops the cached bytestream and updates the modification stamp.
+      void setModified();
+
       virtual uint32_t getSize( const IsoAgLib::ProcData::ConnectionCapabilities_s& ) const;
 
       void formatHeader( ByteStreamBuffer_c& byteStream ) const;
@@ -90,7 +100,18 @@ namespace __IsoAgLib {
       void calcChecksumAddHeader( DevicePool_c & ) const;
 
     private:
+      uint32_t getSizeCached( const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const;
+      void formatBytestreamCached( ByteStreamBuffer_c& byteStream, const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const;
+      void updateBytestreamCache( const IsoAgLib::ProcData::ConnectionCapabilities_s& caps ) const;
+
+      uint32_t m_modificationStamp;
+
+      // serialized object, only valid for the capabilities it was formatted with
+      mutable STL_NAMESPACE::vector<uint8_t> m_bytestreamCache;
+      mutable IsoAgLib::ProcData::ConnectionCapabilities_s m_bytestreamCacheCaps;
+
       static uint16_t m_objIdCounter;
+      static uint32_t m_modificationCounter;
       friend class DevicePool_c;
   };
 
@@ -122,6 +143,7 @@ namespace __IsoAgLib {
       friend class DevicePool_c;
       void init( const IdentItem_c& ident ) {
         m_identItem = &ident;
+        setModified();
       }
       const char* m_version;
       char m_serialNumber[ 32+1 ];
@@ -238,12 +260,15 @@ namespace __IsoAgLib {
 
       void setOffset( int32_t offset ) {
         m_offset = offset;
+        setModified();
       }
       void setDecimals( uint8_t decimals ) {
         m_decimals = decimals;
+        setModified();
       }
       void setScale( float scale ) {
         m_scale = scale;
+        setModified();
       }
 
       void setUnitDesignator( const char* desig ) {
@@ -268,7 +293,6 @@ namespace __IsoAgLib {
       int32_t m_offset;
       float m_scale;
       uint8_t m_decimals;
-      bool m_isDirty;
   };
 
 
@@ -288,7 +312,9 @@ namespace __IsoAgLib {
       virtual void calcChecksumAdd( uint8_t ) = 0;
       virtual void calcChecksumEnd() = 0;
 
-      void calcChecksum();
+      //! Recalculates the checksum only if the pool has been changed since the last calculation.
+      //! @return true if calcChecksumStart/Add/End have been called
+      bool calcChecksum();
 
       void calcChecksumAdd( uint16_t val );
       void calcChecksumAdd( uint32_t val );
@@ -311,6 +337,10 @@ namespace __IsoAgLib {
       void setLocalSettings( const localSettings_s& );
       void updateLocale();
 
+      //! Upload all objects modified since the last upload as partial pool
+      //! to the Task Controllers this pool is currently active on.
+      void updatePool();
+
       DeviceObjectDvc_c* getDvcObject() const;
       DeviceObjectDet_c* getDetObject( uint16_t elementNumber );
 
@@ -320,15 +350,25 @@ namespace __IsoAgLib {
       void close();
 
       DeviceObject_c* getObject( const uint16_t objId, const IsoAgLib::ProcData::DeviceObjectType_t ) const;
+      const IdentItem_c* getIdentItem() const;
 
-      ByteStreamBuffer_c getBytestream( uint8_t cmdByte, const IsoAgLib::ProcData::ConnectionCapabilities_s& caps );
-      uint32_t getBytestreamSize( const IsoAgLib::ProcData::ConnectionCapabilities_s& ) const;
+      // modifiedSince == 0 gives the full pool, otherwise only the objects modified after the given stamp
+      ByteStreamBuffer_c getBytestream( uint8_t cmdByte, const IsoAgLib::ProcData::ConnectionCapabilities_s& caps, uint32_t modifiedSince = 0 );
+      uint32_t getBytestreamSize( const IsoAgLib::ProcData::ConnectionCapabilities_s&, uint32_t modifiedSince = 0 ) const;
+
+      bool hasModifiedObjects( uint32_t modifiedSince ) const;
+      uint32_t getModificationStamp() const {
+        return DeviceObject_c::m_modificationCounter;
+      }
 
       typedef STL_NAMESPACE::list<ProcData_c*> ProcDataList_t;
       ProcDataList_t &getProcDataList() { return *reinterpret_cast<ProcDataList_t*>( &m_procDatas ); }
 
       typedef STL_NAMESPACE::map<uint16_t, DeviceObject_c*> deviceMap_t;
       deviceMap_t m_devicePool;
+
+      // modification stamp the checksum was calculated for, 0 if invalid
+      uint32_t m_checksumStamp;
   };
 
 }
@@ -43,6 +43,8 @@ namespace __IsoAgLib {
     , m_pool( NULL )
     , m_connectedPds()
     , m_nackHandler( NULL )
+    , m_snapshot()
+    , m_snapshotSent( 0 )
   {
   }
 
@@ -56,6 +58,8 @@ namespace __IsoAgLib {
     , m_pool( NULL )
     , m_connectedPds()
     , m_nackHandler( NULL )
+    , m_snapshot()
+    , m_snapshotSent( 0 )
   {
     init( identItem, pdRemoteNode );
     start( pool );
@@ -101,6 +105,9 @@ namespace __IsoAgLib {
 
     destroyMeasureProgs();
 
+    m_snapshot.clear();
+    m_snapshotSent = 0;
+
     m_pool = NULL;
   }
 
@@ -353,6 +360,61 @@ namespace __IsoAgLib {
   }
 
 
+  unsigned
+  PdConnection_c::sendDefaultSetSnapshot()
+  {
+    // capture first, so all values belong to the same instant
+    m_snapshot.clear();
+    m_snapshotSent = 0;
+
+    for( ConnectedPdMap_t::const_iterator i = m_connectedPds.begin(); i != m_connectedPds.end(); ++i )
+    {
+      if( !i->second->isDefaultSetMember() )
+        continue;
+
+      const MeasureProg_c &measureProg = *static_cast<const MeasureProg_c *>( i->second );
+      const SnapshotValue_s snapshotValue = {
+        measureProg.pdBase().DDI(),
+        measureProg.pdBase().element(),
+        measureProg.pdLocal().getMeasurement().getValue() };
+      m_snapshot.push_back( snapshotValue );
+    }
+
+    continueSnapshot();
+
+    return unsigned( m_snapshot.size() );
+  }
+
+
+  void
+  PdConnection_c::continueSnapshot()
+  {
+    if( !isSnapshotPending() || ( m_identItem == NULL ) || ( m_identItem->getIsoItem() == NULL ) )
+      return;
+
+    size_t count = m_snapshot.size() - m_snapshotSent;
+
+    // one check for the whole burst, -1 if not supported by the HAL
+    const int sendFree = getIsoBusInstance4Comm().sendCanFreecnt();
+    if( ( sendFree >= 0 ) && ( size_t( sendFree ) < count ) )
+      count = size_t( sendFree );
+
+    IsoItem_c* const remoteItem = const_cast<IsoItem_c*>( getRemoteItem() );
+    IsoItem_c* const localItem = m_identItem->getIsoItem();
+
+    for( const size_t end = m_snapshotSent + count; m_snapshotSent < end; ++m_snapshotSent )
+    {
+      const SnapshotValue_s &snapshotValue = m_snapshot[ m_snapshotSent ];
+      ProcessPkg_c pkg( IsoAgLib::ProcData::Value, snapshotValue.element, snapshotValue.ddi, snapshotValue.value );
+
+      pkg.setMonitorItemForDA( remoteItem );
+      pkg.setMonitorItemForSA( localItem );
+
+      getIsoBusInstance4Comm() << pkg;
+    }
+  }
+
+
   void
   PdConnection_c::sendPdAck( int16_t ddi, int16_t element, IsoAgLib::ProcData::CommandType_t pdCmd, IsoAgLib::ProcData::AckResponse_t errorcodes, bool wasBroadcast ) const
   {
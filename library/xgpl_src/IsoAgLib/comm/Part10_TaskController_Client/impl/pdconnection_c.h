@@ -26,6 +26,7 @@
 #include <IsoAgLib/comm/Part5_NetworkManagement/impl/identitem_c.h>
 #include <IsoAgLib/comm/Part10_TaskController_Client/iprocdata.h>
 #include <map>
+#include <vector>
 
 
 namespace __IsoAgLib
@@ -70,9 +71,18 @@ namespace __IsoAgLib
 
     void sendPdAck(int16_t ddi, int16_t element, IsoAgLib::ProcData::CommandType_t, IsoAgLib::ProcData::AckResponse_t errorcodes, bool wasBroadcast) const;
 
+    //! Capture the measurement values of all local PDs of the Default Set at
+    //! one instant and send them back-to-back to the remote node.
+    //! Frames not fitting into the CAN send buffer are sent by continueSnapshot().
+    //! @return number of captured values
+    unsigned sendDefaultSetSnapshot();
+    bool isSnapshotPending() const { return m_snapshotSent < m_snapshot.size(); }
+
   protected:
     void sendNackNotFound( int16_t ddi, int16_t element, IsoAgLib::ProcData::CommandType_t, bool wasBroadcast ) const;
 
+    void continueSnapshot();
+
   private:
 #if defined(HAL_USE_SPECIFIC_FILTERS) && !defined(USE_DIRECT_PD_HANDLING)
     virtual void processMsg( const CanPkg_c& data );
@@ -101,6 +111,18 @@ namespace __IsoAgLib
     ConnectedPdMap_t m_connectedPds;
 
     IsoAgLib::ProcData::iNackHandler_c* m_nackHandler;
+
+  private:
+    struct SnapshotValue_s
+    {
+      uint16_t ddi;
+      uint16_t element;
+      int32_t value;
+    };
+
+    // capacity is kept, so capturing a snapshot normally doesn't allocate
+    STL_NAMESPACE::vector<SnapshotValue_s> m_snapshot;
+    size_t m_snapshotSent;
   };
 
 }
@@ -46,6 +46,7 @@ namespace __IsoAgLib {
     virtual void handleRequest() = 0;
     virtual void handleIncoming( int32_t, bool wasBroadcast ) = 0;
     virtual bool startMeasurement( IsoAgLib::ProcData::MeasurementCommand_t ren_type, int32_t ai32_increment ) = 0;
+    virtual bool isDefaultSetMember() const { return false; }
 
     void sendMsg( IsoAgLib::ProcData::CommandType_t cmd, int32_t value );
 
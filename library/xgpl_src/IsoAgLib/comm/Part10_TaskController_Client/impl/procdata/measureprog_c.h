@@ -44,6 +44,7 @@ namespace __IsoAgLib {
       virtual void handleRequest() ISOAGLIB_OVERRIDE { sendValue(); }
       virtual void handleIncoming( int32_t, bool wasBroadcast ) ISOAGLIB_OVERRIDE;
       virtual bool startMeasurement( IsoAgLib::ProcData::MeasurementCommand_t, int32_t ai32_increment ) ISOAGLIB_OVERRIDE;
+      virtual bool isDefaultSetMember() const ISOAGLIB_OVERRIDE { return pdLocal().isDefaultSet(); }
 
       void valueUpdated();
       void sendValue();
@@ -32,6 +32,8 @@ namespace __IsoAgLib {
     , m_setpoint()
     , m_measurement()
     , m_triggerMethod( 0xDA ) // invalid, needs to be init()
+    , m_controlSource( false )
+    , m_defaultSet( false )
   {
   }
 
@@ -41,6 +43,7 @@ namespace __IsoAgLib {
     , m_measurement()
     , m_triggerMethod( _triggerMethod )
     , m_controlSource( _controlSource )
+    , m_defaultSet( false )
   {
   }
 
@@ -49,6 +49,7 @@ namespace __IsoAgLib {
     uint8_t triggerMethod() const { return m_triggerMethod; }
     inline bool isMethodSet( IsoAgLib::ProcData::TriggerMethod_t _method ) const;
     inline bool isControlSource() const;
+    bool isDefaultSet() const { return m_defaultSet; }
 
   protected:
     Setpoint_c m_setpoint;
@@ -56,6 +57,7 @@ namespace __IsoAgLib {
 
     uint8_t m_triggerMethod;
     bool m_controlSource;
+    bool m_defaultSet;
 
     /** not copyable */
     PdLocal_c( const PdLocal_c& );
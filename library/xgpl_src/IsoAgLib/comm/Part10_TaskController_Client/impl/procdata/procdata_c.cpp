@@ -52,6 +52,8 @@ namespace __IsoAgLib {
       dpd.hasProperty( IsoAgLib::ProcData::ControlSource ),
       setpointhandler );
 
+    m_defaultSet = dpd.hasProperty( IsoAgLib::ProcData::Defaultset );
+
 #ifndef NDEBUG
     m_dpd = &dpd;
     m_det = &det;
@@ -438,23 +438,31 @@ namespace __IsoAgLib {
     }
   }
 
-#if 0
-// currently not supported
   void
   TcClient_c::processChangeDesignator( const IdentItem_c& ident, uint16_t objID, const char* newDesig )
   {
-    for( STL_NAMESPACE::list<PdConnection_c*>::const_iterator it = m_peerConnections.begin();
-         it != m_peerConnections.end(); ++it )
+    IdentToClientInfoMap_t::iterator iter = m_clientInfo.find( const_cast<IdentItem_c *>(&ident) );
+    if( iter == m_clientInfo.end() )
+      return;
+
+    for( int i = 0; i < IsoAgLib::ProcData::ServerTypes; ++i )
     {
-      if( ( &ident == &( ( *it )->getIdentItem() ) ) 
-        && ( *it )->getRemoteNode()
-        && ( *it )->getRemoteNode()->isServer() )
-      {
-        static_cast<TcClientConnection_c*>( *it )->sendCommandChangeDesignator( objID, newDesig, CNAMESPACE::strlen( newDesig ) );
-      }
+      // if the command can't be sent now, the modified object will be part of the next partial pool upload
+      (void)iter->second.m_serverConnections[ i ].sendCommandChangeDesignator( objID, newDesig, uint8_t( CNAMESPACE::strlen( newDesig ) ) );
     }
   }
-#endif
+
+
+  void
+  TcClient_c::processPoolUpdate( const IdentItem_c& ident )
+  {
+    IdentToClientInfoMap_t::iterator iter = m_clientInfo.find( const_cast<IdentItem_c *>(&ident) );
+    if( iter == m_clientInfo.end() )
+      return;
+
+    for( int i = 0; i < IsoAgLib::ProcData::ServerTypes; ++i )
+      iter->second.m_serverConnections[ i ].requestPoolUpdate();
+  }
 
   void
   TcClient_c::notifyServerStatusChange( ServerInstance_c& server, bool new_status )
@@ -75,10 +75,8 @@ namespace __IsoAgLib {
 
       void proprietaryServer( const IsoItem_c &, bool available );
 
-#if 0
-// currently not supported
       void processChangeDesignator( const IdentItem_c&, uint16_t, const char* );
-#endif
+      void processPoolUpdate( const IdentItem_c& );
 
       void notifyServerStatusChange( ServerInstance_c& server, bool new_status );
       void notifyPeerAndControlSourceDestruction( PdRemoteNode_c& pdRemoteNode );
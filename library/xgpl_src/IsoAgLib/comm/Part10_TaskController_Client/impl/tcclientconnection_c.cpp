@@ -55,6 +55,7 @@ namespace __IsoAgLib {
     , m_timeLastWsTaskMsgSent( -1 )
     , m_stateHandler( NULL )
     , m_devPoolState( PoolStateDisconnected )
+    , m_poolUploadStamp( 0 )
     , m_capsClient()
     , m_capsServer()
     , m_schedulerTaskProxy( *this, 100, false )
@@ -76,6 +77,7 @@ namespace __IsoAgLib {
     , m_timeLastWsTaskMsgSent( rhs.m_timeLastWsTaskMsgSent )
     , m_stateHandler( rhs.m_stateHandler )
     , m_devPoolState( rhs.m_devPoolState )
+    , m_poolUploadStamp( rhs.m_poolUploadStamp )
     , m_capsClient( rhs.m_capsClient )
     , m_capsServer( rhs.m_capsServer )
     , m_schedulerTaskProxy( *this, 100, false )
@@ -106,6 +108,7 @@ namespace __IsoAgLib {
     m_timeWsAnnounceKey = -1;
     m_timeWaitWithAnyCommunicationUntil = -1;
     m_timeLastWsTaskMsgSent = -1;
+    m_poolUploadStamp = 0;
 
     setDevPoolState( PoolStatePreconnecting );
   }
@@ -126,6 +129,7 @@ namespace __IsoAgLib {
     m_timeWsAnnounceKey = -1;
     m_timeWaitWithAnyCommunicationUntil = -1;
     m_timeLastWsTaskMsgSent = -1;
+    m_poolUploadStamp = 0;
 
     setDevPoolState( PoolStatePreconnecting );
   }
@@ -247,6 +251,9 @@ namespace __IsoAgLib {
       sendMsg( 0xff, 0xff, 0xff, 0xff, (connected()->getLastStatusTaskTotalsActive() ? 0x01 : 0x00), 0x00, 0x00, 0x00 );
     }
 
+    if( isSnapshotPending() )
+      continueSnapshot();
+
     switch( m_currentCommand.getState() )
     {
     case CurrentCommand_c::Idle:
@@ -262,8 +269,17 @@ namespace __IsoAgLib {
         break;
 
       case PoolStateUploading:
-        m_devicePoolToUpload = getDevicePool().getBytestream( procCmdPar_OPTransferMsg, m_capsConnection );
+      {
+        // full pool on first upload, afterwards only the objects modified since the last upload
+        const uint32_t uploadStamp = getDevicePool().getModificationStamp();
+        m_devicePoolToUpload = getDevicePool().getBytestream( procCmdPar_OPTransferMsg, m_capsConnection, m_poolUploadStamp );
+        m_poolUploadStamp = uploadStamp;
         doCommand( procCmdPar_RequestOPTransferMsg, procCmdPar_RequestOPTransferRespMsg );
+      } break;
+
+      case PoolStateStale:
+        // deactivate, partial upload will follow
+        doCommand( procCmdPar_OPActivateMsg, procCmdPar_OPActivateRespMsg, -1, 0 );
         break;
 
       case PoolStateUploaded:
@@ -300,8 +316,11 @@ namespace __IsoAgLib {
     break;
     case CurrentCommand_c::Aborted:
     {
-      // The only possible TP message here, is the OP transfer. So no other cmd could have been aborted. Start a retry of the transfer.
-      doCommand( procCmdPar_OPTransferMsg, procCmdPar_OPTransferRespMsg );
+      // The only possible TP messages here are the OP transfer and a long Change Designator. Start a retry of the transfer.
+      if( m_currentCommand.getLastSentCommand() == procCmdPar_ChangeDesignatorMsg )
+        doCommand( procCmdPar_ChangeDesignatorMsg, procCmdPar_ChangeDesignatorRespMsg );
+      else
+        doCommand( procCmdPar_OPTransferMsg, procCmdPar_OPTransferRespMsg );
     }
       break;
     default:
@@ -640,11 +659,11 @@ namespace __IsoAgLib {
         eventPoolActivateResponse( data.getUint8Data( 1 ) );
         break;
 
-#if 0
-// not supported yet
       case procCmdPar_ChangeDesignatorRespMsg:
+        // on error the object stays modified and will be part of the next partial pool upload
+        getDevicePool().freeByteStreamBuffer( m_devicePoolToUpload.getBuffer() );
+        m_devicePoolToUpload.setBuffer( NULL );
         break;
-#endif
 
       default:
         break;
@@ -731,12 +750,46 @@ namespace __IsoAgLib {
       }
       else
       {
+        m_poolUploadStamp = getDevicePool().getModificationStamp();
         setDevPoolState(PoolStateUploaded);
       }
     }
   }
 
 
+  bool
+  TcClientConnection_c::sendCommandChangeDesignator( uint16_t objID, const char* newString, uint8_t length )
+  {
+    if( ( getDevPoolState() != PoolStateActive )
+        || ( m_currentCommand.getState() != CurrentCommand_c::Idle )
+        || m_devicePoolToUpload.hasBuffer() )
+      return false;
+
+    isoaglib_assert( length <= 32 );
+
+    const uint32_t size = 4 + length; // command, object ID, length
+    m_devicePoolToUpload.reset();
+    m_devicePoolToUpload.setBuffer( getDevicePool().allocByteStreamBuffer( size ) );
+    m_devicePoolToUpload.setSize( size );
+    m_devicePoolToUpload.format( uint8_t( procCmdPar_ChangeDesignatorMsg ) );
+    m_devicePoolToUpload.format( objID );
+    m_devicePoolToUpload.format( length );
+    m_devicePoolToUpload.format( ( const uint8_t* )newString, length );
+
+    doCommand( procCmdPar_ChangeDesignatorMsg, procCmdPar_ChangeDesignatorRespMsg );
+    return true;
+  }
+
+
+  void
+  TcClientConnection_c::requestPoolUpdate()
+  {
+    if( ( getDevPoolState() == PoolStateActive )
+        && getDevicePool().hasModifiedObjects( m_poolUploadStamp ) )
+      setDevPoolState( PoolStateStale );
+  }
+
+
   void
   TcClientConnection_c::eventPoolUploadResponse( uint8_t result )
   {
@@ -758,6 +811,12 @@ namespace __IsoAgLib {
         if( connected()->getLastStatusTaskTotalsActive() )
           eventTaskStartStop( true );
       }
+      else if( getDevPoolState() == PoolStateStale )
+      {
+        // deactivated, the TC will restart its measurements after the activation
+        stopRunningMeasurement();
+        setDevPoolState( PoolStateUploading );
+      }
     } else {
       setDevPoolState( PoolStateError );
     }
@@ -771,6 +830,18 @@ namespace __IsoAgLib {
 
     switch( cmd )
     {
+    case procCmdPar_ChangeDesignatorMsg:
+      if( m_devicePoolToUpload.getEnd() <= 8 )
+      {
+        uint8_t frame[ 8 ] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+        CNAMESPACE::memcpy( frame, m_devicePoolToUpload.getBuffer(), m_devicePoolToUpload.getEnd() );
+        sendMsg( frame[ 0 ], frame[ 1 ], frame[ 2 ], frame[ 3 ], frame[ 4 ], frame[ 5 ], frame[ 6 ], frame[ 7 ] );
+
+        m_currentCommand.sentSinglePkg( cmd, expectedCmd, timeout, connected()->getNotBusyCount());
+        break;
+      }
+      // fall through - designator doesn't fit into a single packet
+
     case procCmdPar_OPTransferMsg:
       getMultiSendInstance4Comm().sendIsoTarget(
         m_identItem->isoName(),
@@ -123,12 +123,13 @@ namespace __IsoAgLib {
       StateHandler_c* getStateHandler() const { return m_stateHandler; }
       IsoAgLib::ProcData::ClientCapabilities_s getClientCapabilities() const { return m_capsClient; }
 
-#if 0
-// not implemented yet
-      bool sendCommandChangeDesignator( uint16_t /* objID */, const char* /* newString */, uint8_t /* length */ ) {
-        return false; /* @todo: send msg */
-      }
-#endif
+      //! Only sent if the pool is active and no other command is running.
+      //! @return false if the command could not be sent right now
+      bool sendCommandChangeDesignator( uint16_t objID, const char* newString, uint8_t length );
+
+      //! Deactivate the pool and upload all objects modified since the last
+      //! upload as partial pool, if the pool is active and has been modified.
+      void requestPoolUpdate();
 
       void eventTaskStartStop( bool start );
 
@@ -160,7 +161,7 @@ namespace __IsoAgLib {
         PoolStateAwaitingConnectionDecision,
         PoolStateConnecting,
         PoolStateUploading,
-        //PoolStateStale,
+        PoolStateStale,
         PoolStateUploaded,
         PoolStateActive,
         PoolStateError
@@ -374,6 +375,9 @@ namespace __IsoAgLib {
 
       DevPoolState_t m_devPoolState;
 
+      // DevicePool_c modification stamp of the last upload, 0 if nothing uploaded yet
+      uint32_t m_poolUploadStamp;
+
       IsoAgLib::ProcData::ClientCapabilities_s m_capsClient;
       IsoAgLib::ProcData::ServerCapabilities_s m_capsServer;
 
@@ -392,7 +396,7 @@ namespace __IsoAgLib {
     case PoolStatePreconnecting:
     case PoolStateConnecting:
     case PoolStateUploading:
-    //case PoolStateStale:
+    case PoolStateStale:
     case PoolStateUploaded:
     case PoolStateActive:
     case PoolStateError:
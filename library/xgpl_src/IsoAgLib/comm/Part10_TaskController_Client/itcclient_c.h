@@ -60,10 +60,7 @@ namespace IsoAgLib {
       // Do NOT call with "available=false" when "RemovedFromMonitorList" - this will be done automatically internally already!
       void proprietaryServer( const iIsoItem_c &, bool available );
 
-#if 0
-// currently not supported
       void processChangeDesignator( iIdentItem_c& identItem, uint16_t objID, const char* newDesignator );
-#endif
 
 
 #if defined(USE_DIRECT_PD_HANDLING)
@@ -193,13 +190,10 @@ namespace IsoAgLib {
     TcClient_c::proprietaryServer( static_cast<const __IsoAgLib::IsoItem_c&>( item ), available );
   }
 
-#if 0
-// currently not supported
   inline void iTcClient_c::processChangeDesignator( iIdentItem_c& identItem, uint16_t objID, const char* newDesignator )
   {
     return TcClient_c::processChangeDesignator( static_cast<__IsoAgLib::IdentItem_c&>( identItem ), objID, newDesignator );
   }
-#endif
 
 }
 
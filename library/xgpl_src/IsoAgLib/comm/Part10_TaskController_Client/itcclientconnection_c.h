@@ -82,19 +82,21 @@ namespace IsoAgLib {
         __IsoAgLib::TcClientConnection_c::forceDisconnectAndInitiateReconnect( shouldDeletePool );
       }
 
+      //! Send the current values of all Default Set PDs as one consistent snapshot,
+      //! e.g. as response to eventDefaultLoggingStarted.
+      //! @return number of values captured
+      unsigned sendDefaultSetSnapshot()
+      { return PdConnection_c::sendDefaultSetSnapshot(); }
+
       const iTcClientServer_c& server() const
       {
         isoaglib_assert( connected() );
         return connected()->toConstITcClientServer_c();
       }
 
-#if 0
-// currently not supported
-      /* TODO */
       bool sendCommandChangeDesignator( uint16_t objectID, const char* newString, uint8_t stringLength ) {
         return TcClientConnection_c::sendCommandChangeDesignator( objectID, newString, stringLength );
       }
-#endif
 
     private:
       iTcClientConnection_c();
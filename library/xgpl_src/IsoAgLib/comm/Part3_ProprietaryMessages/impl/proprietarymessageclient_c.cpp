@@ -26,6 +26,33 @@
 
 namespace __IsoAgLib
 {
+  void ProprietaryMessage_c::setReceived( const uint8_t* apui8_data, uint16_t aui16_len )
+  {
+    mui16_receivedLen = aui16_len;
+    if( mb_zeroCopyReception )
+    {
+      mpui8_received = apui8_data;
+    }
+    else
+    {
+      ms_receivedData.clearVector();
+      ms_receivedData.setDataStream( 0, apui8_data, aui16_len );
+      mpui8_received = ms_receivedData.getDataStream();
+    }
+  }
+
+
+  void ProprietaryMessage_c::resetReceived()
+  {
+    // the copy in getDataReceive() stays valid until the next reception
+    if( mb_zeroCopyReception )
+    {
+      mpui8_received = NULL;
+      mui16_receivedLen = 0;
+    }
+  }
+
+
   bool ProprietaryMessageA_c::sendWithPrio( unsigned prio, const IsoName_c& a_overwrite_remote ) {
 
     isoaglib_assert( prio <= 7 );
@@ -61,6 +88,16 @@ namespace __IsoAgLib
     }
   }
 
+  void ProprietaryMessageA_c::queueSendWithPrio( unsigned prio, const IsoName_c& a_overwrite_remote ) {
+
+    isoaglib_assert( prio <= 7 );
+    isoaglib_assert(m_ident);
+    // do not allow overwrite to a different target if m_remote is specified
+    isoaglib_assert(!m_remote.isSpecified() || a_overwrite_remote.isUnspecified() || (a_overwrite_remote == m_remote));
+
+    getProprietaryMessageHandlerInstance( m_ident->getMultitonInst() ).queueSend( *this, 0x00, prio, a_overwrite_remote );
+  }
+
   void ProprietaryMessageA_c::init(const IdentItem_c& a_ident, const IsoName_c& a_remote, uint8_t a_dp) {
     isoaglib_assert( NULL == m_ident );
     m_ident = &a_ident;
@@ -71,15 +108,27 @@ namespace __IsoAgLib
 
   void ProprietaryMessageA_c::change(const IdentItem_c& a_ident, const IsoName_c& a_remote, uint8_t a_dp) {
     isoaglib_assert( NULL != m_ident );
-    m_ident = &a_ident;
-    m_remote = a_remote;
-    m_dp = a_dp;
+    if( m_isRegistered )
+    {
+      disableReception();
+      m_ident = &a_ident;
+      m_remote = a_remote;
+      m_dp = a_dp;
+      enableReception();
+    }
+    else
+    {
+      m_ident = &a_ident;
+      m_remote = a_remote;
+      m_dp = a_dp;
+    }
   }
 
 
   void ProprietaryMessageA_c::close() {
     isoaglib_assert( NULL != m_ident );
     isoaglib_assert( !m_isRegistered );
+    getProprietaryMessageHandlerInstance( m_ident->getMultitonInst() ).dequeueSend( *this );
     m_ident = NULL;
     m_remote = IsoName_c::IsoNameUnspecified();
     m_dp = 0;
@@ -141,6 +190,16 @@ namespace __IsoAgLib
     }
   }
 
+  void ProprietaryMessageB_c::queueSendWithPrio( uint8_t ps, unsigned prio, const IsoName_c& a_overwrite_remote ) {
+
+    isoaglib_assert( prio <= 7 );
+    isoaglib_assert(m_ident);
+    // do not allow overwrite to a different target if m_remote is specified
+    isoaglib_assert(!m_remote.isSpecified() || a_overwrite_remote.isUnspecified() || (a_overwrite_remote == m_remote));
+
+    getProprietaryMessageHandlerInstance( m_ident->getMultitonInst() ).queueSend( *this, ps, prio, a_overwrite_remote );
+  }
+
   void ProprietaryMessageB_c::init(const IdentItem_c& a_ident, const IsoName_c& a_remote, uint8_t a_dp) {
     isoaglib_assert(NULL == m_ident);
     m_ident = &a_ident;
@@ -151,14 +210,18 @@ namespace __IsoAgLib
 
   void ProprietaryMessageB_c::change(const IdentItem_c& a_ident, const IsoName_c& a_remote, uint8_t a_dp) {
     isoaglib_assert(NULL != m_ident);
+    // the PS registered for aren't known here, so let the handler re-sort them
+    ProprietaryMessageHandler_c& handler = getProprietaryMessageHandlerInstance( m_ident->getMultitonInst() );
     m_ident = &a_ident;
     m_remote = a_remote;
     m_dp = a_dp;
+    handler.rekeyProprietaryMessage( *this );
   }
 
 
   void ProprietaryMessageB_c::close() {
     isoaglib_assert(NULL != m_ident);
+    getProprietaryMessageHandlerInstance( m_ident->getMultitonInst() ).dequeueSend( *this );
     m_ident = NULL;
     m_remote = IsoName_c::IsoNameUnspecified();
     m_dp = 0;
@@ -43,18 +43,35 @@ namespace __IsoAgLib
     public:
       static const unsigned defaultPriority = 6;
 
-      ProprietaryMessage_c() : m_sendSuccess( SendStream_c::SendSuccess ), ms_receivedData(), ms_sendData(), m_ident( NULL ), m_remote( IsoName_c::IsoNameUnspecified() ), m_dp( 0 ) {}
+      ProprietaryMessage_c() : m_sendSuccess( SendStream_c::SendSuccess ), ms_receivedData(), ms_sendData(), mb_zeroCopyReception( false ), mpui8_received( NULL ), mui16_receivedLen( 0 ), mui16_minSendPeriod( 0 ), m_ident( NULL ), m_remote( IsoName_c::IsoNameUnspecified() ), m_dp( 0 ) {}
       virtual ~ProprietaryMessage_c() {}
 
       IsoAgLib::iGenericData_c& getDataReceive() { return ms_receivedData; }
       IsoAgLib::iGenericData_c& getDataSend() { return ms_sendData; }
 
+      /** With zero-copy reception the received payload is not copied
+          into getDataReceive(), it's only accessible via getReceived()
+          from within processA/processB - the view points into the
+          CAN frame or the stream buffer and is dropped afterwards. */
+      void setZeroCopyReception( bool ab_zeroCopy ) { mb_zeroCopyReception = ab_zeroCopy; }
+      bool isZeroCopyReception() const { return mb_zeroCopyReception; }
+
+      /** payload of the last received message, with zero-copy
+          reception only valid during processA/processB */
+      const uint8_t* getReceived() const { return mpui8_received; }
+      uint16_t getReceivedLen() const { return mui16_receivedLen; }
+
       /** User can check if the sendData is currently being used because MultiSend_c
         is streaming out right now. In this case DO NOT MODIFY the
         GenericData_c SendData via getDataSend() !!!
         */
       bool isSending() const { return ( m_sendSuccess == SendStream_c::Running ); }
 
+      /** minimum time between two queued sends (queueSend) in msec,
+          a newer value queued meanwhile replaces the unsent older one */
+      void setMinSendPeriod( uint16_t aui16_msec ) { mui16_minSendPeriod = aui16_msec; }
+      uint16_t getMinSendPeriod() const { return mui16_minSendPeriod; }
+
       // Note on the following three public getters:
       // Only for use by ProprietaryMessageHandler_c and its classes.
       // Not protected/private because the Tricore compiler doesn't
@@ -65,6 +82,12 @@ namespace __IsoAgLib
       const IsoName_c &remote() const { return m_remote; }
       uint8_t dp() const { return m_dp; }
 
+      void setReceived( const uint8_t* apui8_data, uint16_t aui16_len );
+      void resetReceived();
+
+      //! send of a queued entry, ps only used for B
+      virtual bool sendQueued( uint8_t ps, unsigned prio, const IsoName_c& a_overwrite_remote ) = 0;
+
       virtual void multiPacketFinished(bool /* a_success */) {}
       
     private:
@@ -83,6 +106,12 @@ namespace __IsoAgLib
       IsoAgLib::iGenericData_c ms_receivedData;
       IsoAgLib::iGenericData_c ms_sendData;
 
+      bool mb_zeroCopyReception;
+      const uint8_t* mpui8_received;
+      uint16_t mui16_receivedLen;
+
+      uint16_t mui16_minSendPeriod;
+
     protected:      
       const IdentItem_c* m_ident;
       IsoName_c m_remote;
@@ -109,6 +138,17 @@ namespace __IsoAgLib
       
       bool sendWithPrio( unsigned prio, const IsoName_c& a_overwrite_remote = IsoName_c::IsoNameUnspecified() );
 
+      /** like send(), but through the rate-limited transmit queue
+          of ProprietaryMessageHandler_c: the current getDataSend()
+          is queued and put back into getDataSend() when it's sent */
+      void queueSend(const IsoName_c& a_overwrite_remote = IsoName_c::IsoNameUnspecified())
+      { queueSendWithPrio( defaultPriority, a_overwrite_remote ); }
+
+      void queueSendWithPrio( unsigned prio, const IsoName_c& a_overwrite_remote = IsoName_c::IsoNameUnspecified() );
+
+      virtual bool sendQueued( uint8_t, unsigned prio, const IsoName_c& a_overwrite_remote )
+      { return sendWithPrio( prio, a_overwrite_remote ); }
+
     private:
       bool m_isRegistered;
   };
@@ -132,6 +172,16 @@ namespace __IsoAgLib
       { return sendWithPrio( ps, defaultPriority, a_overwrite_remote ); }
       
       bool sendWithPrio( uint8_t ps, unsigned prio, const IsoName_c& a_overwrite_remote = IsoName_c::IsoNameUnspecified() );
+
+      /** like send(), but through the rate-limited transmit queue,
+          see ProprietaryMessageA_c::queueSend. Queued per PS. */
+      void queueSend( uint8_t ps, const IsoName_c& a_overwrite_remote = IsoName_c::IsoNameUnspecified() )
+      { queueSendWithPrio( ps, defaultPriority, a_overwrite_remote ); }
+
+      void queueSendWithPrio( uint8_t ps, unsigned prio, const IsoName_c& a_overwrite_remote = IsoName_c::IsoNameUnspecified() );
+
+      virtual bool sendQueued( uint8_t ps, unsigned prio, const IsoName_c& a_overwrite_remote )
+      { return sendWithPrio( ps, prio, a_overwrite_remote ); }
   };
 
 };
@@ -23,6 +23,7 @@
 #include <IsoAgLib/comm/impl/isobus_c.h>
 #include <IsoAgLib/comm/Part3_DataLink/impl/multireceive_c.h>
 #include <IsoAgLib/comm/Part5_NetworkManagement/impl/isomonitor_c.h>
+#include <IsoAgLib/scheduler/impl/scheduler_c.h>
 
 
 #if defined(_MSC_VER)
@@ -31,9 +32,20 @@
 
 namespace __IsoAgLib
 {
+  // nothing queued: just look by once in a while
+  static const int32_t sci32_txIdlePeriod = 1000;
+  // budget as token bucket: a frame costs CONFIG_PROPRIETARY_TX_PERIOD,
+  // CONFIG_PROPRIETARY_TX_MAX_FRAMES are refilled per msec
+  static const int32_t sci32_txTokensMax = CONFIG_PROPRIETARY_TX_MAX_FRAMES * CONFIG_PROPRIETARY_TX_PERIOD;
+
+
   ProprietaryMessageHandler_c::ProprietaryMessageHandler_c()
     : m_customerA( *this )
     , m_customerB( *this )
+    , mmap_txEntries()
+    , mi32_txTokens( sci32_txTokensMax )
+    , m_txTokensTime( 0 )
+    , m_schedulerTask( *this, sci32_txIdlePeriod, false )
   {
   }
 
@@ -42,6 +54,11 @@ namespace __IsoAgLib
   ProprietaryMessageHandler_c::init()
   {
     isoaglib_assert (!initialized());
+
+    mi32_txTokens = sci32_txTokensMax;
+    m_txTokensTime = System_c::getTime();
+    getSchedulerInstance().registerTask( m_schedulerTask, 0 );
+
     setInitialized();
   }
 
@@ -49,6 +66,12 @@ namespace __IsoAgLib
   ProprietaryMessageHandler_c::close()
   {
     isoaglib_assert (initialized());
+
+    getSchedulerInstance().deregisterTask( m_schedulerTask );
+    for( unsigned prio = 0; prio < 8; ++prio )
+      m_txClasses[ prio ].clear();
+    mmap_txEntries.clear();
+
     setClosed();
   }
 
@@ -60,9 +83,7 @@ namespace __IsoAgLib
   {
     isoaglib_assert( initialized() ); // most likely module was not configured!
 
-    m_customerA.m_msgs.push_front( &msg );
-
-    m_customerA.registerFilter( getMultitonInst(), msg.ident()->isoName() );
+    m_customerA.insert( getMultitonInst(), msg, PROPRIETARY_A_PGN );
   }
 
 
@@ -70,14 +91,7 @@ namespace __IsoAgLib
   {
     isoaglib_assert(initialized()); // most likely module was not configured!
 
-    if( m_customerB.m_msgs[ ps ] == NULL )
-    {
-      m_customerB.m_msgs[ ps ] = new CanCustomerB_c::MsgList();
-    }
-
-    m_customerB.m_msgs[ ps ]->push_front( &msg );
-
-    m_customerB.registerFilter( getMultitonInst(), msg.ident()->isoName() );
+    m_customerB.insert( getMultitonInst(), msg, PROPRIETARY_B_PGN | ps );
   }
 
 
@@ -86,45 +100,220 @@ namespace __IsoAgLib
 
   void ProprietaryMessageHandler_c::deregisterProprietaryMessage( ProprietaryMessageA_c& msg )
   {
-    for ( CanCustomerA_c::MsgIterator it = m_customerA.m_msgs.begin(); it != m_customerA.m_msgs.end(); ++it )
+    m_customerA.erase( getMultitonInst(), msg, 0x00 );
+  }
+
+
+  void ProprietaryMessageHandler_c::deregisterProprietaryMessage( ProprietaryMessageB_c& msg, uint8_t ps )
+  {
+    m_customerB.erase( getMultitonInst(), msg, ps );
+  }
+
+
+  void ProprietaryMessageHandler_c::rekeyProprietaryMessage( ProprietaryMessageB_c& msg )
+  {
+    m_customerB.rekey( getMultitonInst(), msg );
+  }
+
+
+  // Transmit queue
+  /////////////////
+
+  void
+  ProprietaryMessageHandler_c::queueSend( ProprietaryMessage_c& msg, uint8_t ps, unsigned prio, const IsoName_c& remote )
+  {
+    isoaglib_assert( initialized() ); // most likely module was not configured!
+    isoaglib_assert( prio < 8 );
+
+    const TxKey key( &msg, ps );
+    TxEntries::iterator it = mmap_txEntries.find( key );
+    if( it == mmap_txEntries.end() )
     {
-      if( *it == &msg )
-      {
-        m_customerA.m_msgs.erase( it );
-        break;
-      }
+      it = mmap_txEntries.insert( TxEntries::value_type( key, TxEntry_s() ) ).first;
+      it->second.msg = &msg;
+      it->second.ps = ps;
+      it->second.prio = uint8_t( prio );
+      it->second.lastSent = System_c::getTime() - msg.getMinSendPeriod();
+      m_txClasses[ prio ].push_back( &it->second );
     }
+    else if( it->second.prio != prio )
+    {
+      m_txClasses[ it->second.prio ].remove( &it->second );
+      it->second.prio = uint8_t( prio );
+      m_txClasses[ prio ].push_back( &it->second );
+    }
+
+    // latest value wins
+    TxEntry_s& entry = it->second;
+    entry.data = msg.getDataSend();
+    entry.remote = remote;
+    entry.pending = true;
 
-    m_customerA.deregisterFilter( getMultitonInst(), msg.ident()->isoName() );
+    scheduleSend( entry.lastSent + msg.getMinSendPeriod() );
   }
 
 
-  void ProprietaryMessageHandler_c::deregisterProprietaryMessage( ProprietaryMessageB_c& msg, uint8_t ps )
+  void
+  ProprietaryMessageHandler_c::dequeueSend( const ProprietaryMessage_c& msg )
   {
-    isoaglib_assert( m_customerB.m_msgs[ ps ] != NULL );
+    TxEntries::iterator it = mmap_txEntries.lower_bound( TxKey( &msg, 0x00 ) );
+    while( ( it != mmap_txEntries.end() ) && ( it->first.first == &msg ) )
+    {
+      m_txClasses[ it->second.prio ].remove( &it->second );
+      mmap_txEntries.erase( it++ );
+    }
+  }
+
+
+  void
+  ProprietaryMessageHandler_c::scheduleSend( ecutime_t due )
+  {
+    const ecutime_t now = System_c::getTime();
+    if( due < now )
+      due = now;
+
+    if( due < m_schedulerTask.getNextTriggerTime() )
+      m_schedulerTask.setNextTriggerTime( due );
+  }
 
-    for( CanCustomerB_c::MsgIterator it = m_customerB.m_msgs[ ps ]->begin(); it != m_customerB.m_msgs[ ps ]->end(); ++it )
+
+  void
+  ProprietaryMessageHandler_c::timeEvent()
+  {
+    const ecutime_t now = System_c::getTime();
+
+    const ecutime_t elapsed = now - m_txTokensTime;
+    m_txTokensTime = now;
+    if( elapsed >= CONFIG_PROPRIETARY_TX_PERIOD )
+      mi32_txTokens = sci32_txTokensMax;
+    else
     {
-      if( *it == &msg )
+      mi32_txTokens += int32_t( elapsed ) * CONFIG_PROPRIETARY_TX_MAX_FRAMES;
+      if( mi32_txTokens > sci32_txTokensMax )
+        mi32_txTokens = sci32_txTokensMax;
+    }
+
+    ecutime_t nextDue = now + sci32_txIdlePeriod;
+
+    for( unsigned prio = 0; prio < 8; ++prio )
+    {
+      TxClass& txClass = m_txClasses[ prio ];
+      TxClass sent;
+
+      for( TxClass::iterator it = txClass.begin(); it != txClass.end(); )
       {
-        m_customerB.m_msgs[ ps ]->erase( it );
+        const TxClass::iterator cur = it++;
+        TxEntry_s& entry = **cur;
+        if( ! entry.pending )
+          continue;
 
-        if( m_customerB.m_msgs[ ps ]->empty() )
+        ecutime_t due = entry.lastSent + entry.msg->getMinSendPeriod();
+        if( due <= now )
         {
-          delete m_customerB.m_msgs[ ps ];
-          m_customerB.m_msgs[ ps ] = NULL;
+          if( mi32_txTokens < CONFIG_PROPRIETARY_TX_PERIOD )
+          { // budget used up, wait for the next frame's worth
+            due = now + ( CONFIG_PROPRIETARY_TX_PERIOD - mi32_txTokens + CONFIG_PROPRIETARY_TX_MAX_FRAMES - 1 ) / CONFIG_PROPRIETARY_TX_MAX_FRAMES;
+          }
+          else if( entry.msg->isSending() || ! entry.msg->ident()->isClaimedAddress() )
+          { // previous multi-packet still running / can't send right now
+            due = now + CONFIG_PROPRIETARY_TX_PERIOD;
+          }
+          else
+          {
+            entry.msg->getDataSend() = entry.data;
+            if( entry.msg->sendQueued( entry.ps, prio, entry.remote ) )
+            {
+              entry.pending = false;
+              entry.lastSent = now;
+              mi32_txTokens -= CONFIG_PROPRIETARY_TX_PERIOD;
+              // let the others of this class go first next time
+              sent.splice( sent.end(), txClass, cur );
+              continue;
+            }
+            due = now + CONFIG_PROPRIETARY_TX_PERIOD;
+          }
         }
-        break;
+
+        if( due < nextDue )
+          nextDue = due;
       }
+
+      txClass.splice( txClass.end(), sent );
     }
 
-    m_customerB.deregisterFilter( getMultitonInst(), msg.ident()->isoName() );
+    m_schedulerTask.setNextTriggerTime( nextDue );
+  }
+
+
+  bool
+  ProprietaryMessageHandler_c::DispatchKey_s::operator<( const DispatchKey_s& right ) const
+  {
+    if( pgn != right.pgn )
+      return pgn < right.pgn;
+
+    if( remote.isSpecified() != right.remote.isSpecified() )
+      return right.remote.isSpecified();
+    if( remote != right.remote )
+      return remote < right.remote;
+
+    if( local.isSpecified() != right.local.isSpecified() )
+      return right.local.isSpecified();
+    return local.isSpecified() && ( local < right.local );
   }
 
 
   // CanCustomerAB_c/CanCustomerA_c/CanCustomerB_c
   ////////////////////////////////////////////////
 
+  void
+  ProprietaryMessageHandler_c::CanCustomerAB_c::insert( int multitonInst, ProprietaryMessage_c& msg, uint32_t pgn )
+  {
+    mmap_msgs.insert( MsgIndex::value_type( DispatchKey_s( ( uint32_t( msg.dp() ) << 16 ) | pgn, msg.remote(), msg.ident()->isoName() ), &msg ) );
+
+    registerFilter( multitonInst, msg.ident()->isoName() );
+  }
+
+
+  void
+  ProprietaryMessageHandler_c::CanCustomerAB_c::erase( int multitonInst, const ProprietaryMessage_c& msg, uint8_t ps )
+  {
+    // search by message, not by key: the key may be outdated
+    for( MsgIndexIterator it = mmap_msgs.begin(); it != mmap_msgs.end(); ++it )
+    {
+      if( ( it->second == &msg ) && ( uint8_t( it->first.pgn ) == ps ) )
+      {
+        const IsoName_c identName = it->first.local;
+        mmap_msgs.erase( it );
+        deregisterFilter( multitonInst, identName );
+        return;
+      }
+    }
+
+    isoaglib_assert( !"Deregistering a not registered proprietary message" );
+  }
+
+
+  void
+  ProprietaryMessageHandler_c::CanCustomerAB_c::rekey( int multitonInst, ProprietaryMessage_c& msg )
+  {
+    STL_NAMESPACE::vector<uint32_t> pgns;
+    for( MsgIndexIterator it = mmap_msgs.begin(); it != mmap_msgs.end(); )
+    {
+      if( it->second == &msg )
+      {
+        pgns.push_back( it->first.pgn & 0xFFFF );
+        deregisterFilter( multitonInst, it->first.local );
+        mmap_msgs.erase( it++ );
+      }
+      else
+        ++it;
+    }
+
+    for( STL_NAMESPACE::vector<uint32_t>::const_iterator it = pgns.begin(); it != pgns.end(); ++it )
+      insert( multitonInst, msg, *it );
+  }
+
+
   void
   ProprietaryMessageHandler_c::CanCustomerAB_c::registerFilter( int multitonInst, const IsoName_c& identName )
   {
@@ -169,6 +358,57 @@ namespace __IsoAgLib
   }
 
 
+  void
+  ProprietaryMessageHandler_c::CanCustomerAB_c::collect( uint32_t pgn, const IsoName_c& sender, const IsoName_c& local )
+  {
+    m_matches.clear();
+
+    // messages bound to this sender
+    collectRange( DispatchKey_s( pgn, sender, local ) );
+
+    // messages accepting any sender
+    if( sender.isSpecified() )
+      collectRange( DispatchKey_s( pgn, IsoName_c::IsoNameUnspecified(), local ) );
+  }
+
+
+  void
+  ProprietaryMessageHandler_c::CanCustomerAB_c::collectRange( const DispatchKey_s& key )
+  {
+    if( key.local.isSpecified() )
+    { // destination specific: only the addressed local ident
+      const STL_NAMESPACE::pair<MsgIndexIterator,MsgIndexIterator> range = mmap_msgs.equal_range( key );
+      for( MsgIndexIterator it = range.first; it != range.second; ++it )
+        m_matches.push_back( it->second );
+    }
+    else
+    { // broadcast: all local idents, the unspecified local NAME sorts first
+      for( MsgIndexIterator it = mmap_msgs.lower_bound( key );
+           ( it != mmap_msgs.end() ) && ( it->first.pgn == key.pgn ) && ( it->first.remote == key.remote );
+           ++it )
+        m_matches.push_back( it->second );
+    }
+  }
+
+
+  const uint8_t*
+  ProprietaryMessageHandler_c::CanCustomerAB_c::gatherPayload( Stream_c& stream )
+  {
+    m_payload.resize( stream.getByteTotalSize() );
+
+    uint32_t cnt = 0;
+    if( stream.getIdent().getDa() != 0xFF )
+    { // directed, first byte was filled out, get it in a special way!
+      m_payload[ cnt++ ] = stream.getFirstByte();
+    }
+    // else was BAM, where the first byte was not set already!
+
+    for( ; cnt < m_payload.size(); ++cnt )
+      m_payload[ cnt ] = stream.getNextNotParsed();
+
+    return &m_payload[ 0 ];
+  }
+
 
   void 
   ProprietaryMessageHandler_c::CanCustomerA_c::processMsg( const CanPkg_c& data )
@@ -177,23 +417,18 @@ namespace __IsoAgLib
     if( ! pkg.isValid() || ( pkg.getMonitorItemForSA() == NULL ) )
       return;
 
-    for ( MsgIterator it = m_msgs.begin(); it != m_msgs.end(); ++it )
-    {
-      if ( ( pkg.getMonitorItemForDA() != NULL ) && ( pkg.getMonitorItemForDA() != (*it)->ident()->getIsoItem() ) )
-        continue;
-
-      if ( pkg.isoDp() != (*it)->dp() )
-        continue;
-
-      if ( (*it)->remote().isSpecified() && ( pkg.getISONameForSA() != (*it)->remote() ) )
-        continue;
+    const bool broadcast = ( NULL == pkg.getMonitorItemForDA() );
+    collect( ( uint32_t( pkg.isoDp() ) << 16 ) | PROPRIETARY_A_PGN, pkg.getISONameForSA(),
+             broadcast ? IsoName_c::IsoNameUnspecified() : pkg.getISONameForDA() );
 
-      (*it)->getDataReceive().clearVector();
-      (*it)->getDataReceive().setDataStream( 0, pkg.getUint8DataConstPointer(), pkg.getLen() );
+    for( MatchIterator it = m_matches.begin(); it != m_matches.end(); ++it )
+    {
+      ProprietaryMessageA_c& msg = static_cast<ProprietaryMessageA_c&>( **it );
+      msg.setReceived( pkg.getUint8DataConstPointer(), pkg.getLen() );
       // the static cast is prettier that a old C cast, but the Hightec GCC 3.4.6 is quite picky
-      //(*it)->processA( *static_cast<IsoAgLib::iIsoItem_c*>( pkg.getMonitorItemForSA() ) );
-      (*it)->processA( *( (IsoAgLib::iIsoItem_c*)( pkg.getMonitorItemForSA() ) ),
-                       (NULL == pkg.getMonitorItemForDA()) /* a_broadcast */);
+      //msg.processA( *static_cast<IsoAgLib::iIsoItem_c*>( pkg.getMonitorItemForSA() ) );
+      msg.processA( *( (IsoAgLib::iIsoItem_c*)( pkg.getMonitorItemForSA() ) ), broadcast );
+      msg.resetReceived();
     }
   }
 
@@ -205,21 +440,8 @@ namespace __IsoAgLib
     if ( len >= 0xFFFF )
       return false;
 
-    for ( MsgIterator it = m_msgs.begin(); it != m_msgs.end(); ++it )
-    {
-      if ( ( ident.getDaIsoName().isSpecified() ) && ( ident.getDaIsoName() != (*it)->ident()->isoName() ) )
-        continue;
-
-      if ( ( ident.getPgn() >> 16 ) != (*it)->dp() )
-        continue;
-
-      if ( (*it)->remote().isSpecified() && ( ident.getSaIsoName() != (*it)->remote() ) )
-        continue;
-
-      return true;
-    }
-
-    return false;
+    collect( ( ident.getPgn() & 0xFFFF0000UL ) | PROPRIETARY_A_PGN, ident.getSaIsoName(), ident.getDaIsoName() );
+    return ! m_matches.empty();
   }
 
 
@@ -229,56 +451,22 @@ namespace __IsoAgLib
     if( ! last )
       return false;
 
-    MsgList msgs;
-
     const ReceiveStreamIdentifier_c& ident = apc_stream.getIdent();
-    for ( MsgIterator it = m_msgs.begin(); it != m_msgs.end(); ++it )
-    {
-      if ( ( ident.getDaIsoName().isSpecified() ) && ( ident.getDaIsoName() != (*it)->ident()->isoName() ) )
-        continue;
-
-      if ( ( ident.getPgn() >> 16 ) != (*it)->dp() )
-        continue;
-
-      if ( (*it)->remote().isSpecified() && ( ident.getSaIsoName() != (*it)->remote() ) )
-        continue;
-
-      (*it)->getDataReceive().clearVector();
-      msgs.push_front( *it );
-    }
+    collect( ( ident.getPgn() & 0xFFFF0000UL ) | PROPRIETARY_A_PGN, ident.getSaIsoName(), ident.getDaIsoName() );
 
-    if( ! msgs.empty() )
+    if( ! m_matches.empty() )
     {
-      uint16_t cnt=0;
-
-      if (apc_stream.getIdent().getDa() == 0xFF)
-      { // was BAM, where the first byte was not set already!
-        // let all be read by loop below, no special handling for first byte
-      }
-      else
-      { // directed, first byte was filled out, get it in a special way!
-          uint8_t db = apc_stream.getFirstByte();
-          for (; cnt < 1; ++cnt)
-          {
-              for (MsgIterator it = msgs.begin(); it != msgs.end(); ++it) {
-                  (*it)->getDataReceive().setDataUi8(cnt, db);
-              }
-          }
-      }
-
-      for (; cnt < apc_stream.getByteTotalSize(); ++cnt)
-      {
-        uint8_t db = apc_stream.getNextNotParsed();
-        for( MsgIterator it = msgs.begin(); it != msgs.end(); ++it ) {
-          (*it)->getDataReceive().setDataUi8( cnt, db );
-        }
-      }
+      const uint8_t* payload = gatherPayload( apc_stream );
+      const uint16_t len = uint16_t( apc_stream.getByteTotalSize() );
 
-      for( MsgIterator it = msgs.begin(); it != msgs.end(); ++it ) {
+      for( MatchIterator it = m_matches.begin(); it != m_matches.end(); ++it ) {
+        ProprietaryMessageA_c& msg = static_cast<ProprietaryMessageA_c&>( **it );
+        msg.setReceived( payload, len );
         // the static cast is prettier that a old C cast, but the Hightec GCC 3.4.6 is quite picky
-        //(*it)->processA( *static_cast<IsoAgLib::iIsoItem_c*>( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ) );
-        (*it)->processA( * ( IsoAgLib::iIsoItem_c*)( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ),
-                         (ident.getDaIsoName().isUnspecified()) /* a_broadcast */);
+        //msg.processA( *static_cast<IsoAgLib::iIsoItem_c*>( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ) );
+        msg.processA( * ( IsoAgLib::iIsoItem_c*)( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ),
+                      (ident.getDaIsoName().isUnspecified()) /* a_broadcast */);
+        msg.resetReceived();
       }
     }
 
@@ -295,23 +483,16 @@ namespace __IsoAgLib
       return;
 
     const uint8_t ps = pkg.isoPs();
-    if( m_msgs[ ps ] == NULL )
-      return;
+    collect( ( uint32_t( pkg.isoDp() ) << 16 ) | PROPRIETARY_B_PGN | ps, pkg.getISONameForSA(), IsoName_c::IsoNameUnspecified() );
 
-    for ( MsgIterator it = m_msgs[ ps ]->begin(); it != m_msgs[ ps ]->end(); ++it )
+    for( MatchIterator it = m_matches.begin(); it != m_matches.end(); ++it )
     {
-      if ( pkg.isoDp() != (*it)->dp() )
-        continue;
-
-      if ( (*it)->remote().isSpecified() && ( pkg.getISONameForSA() != (*it)->remote() ) )
-        continue;
-
-      (*it)->getDataReceive().clearVector();
-      (*it)->getDataReceive().setDataStream( 0, pkg.getUint8DataConstPointer(), pkg.getLen() );
-
+      ProprietaryMessageB_c& msg = static_cast<ProprietaryMessageB_c&>( **it );
+      msg.setReceived( pkg.getUint8DataConstPointer(), pkg.getLen() );
       // the static cast is prettier that a old C cast, but the Hightec GCC 3.4.6 is quite picky
-      //(*it)->processB( *static_cast<IsoAgLib::iIsoItem_c*>( pkg.getMonitorItemForSA() ) );
-      (*it)->processB( *( ( IsoAgLib::iIsoItem_c*)( pkg.getMonitorItemForSA() ) ), ps );
+      //msg.processB( *static_cast<IsoAgLib::iIsoItem_c*>( pkg.getMonitorItemForSA() ) );
+      msg.processB( *( ( IsoAgLib::iIsoItem_c*)( pkg.getMonitorItemForSA() ) ), ps );
+      msg.resetReceived();
     }
   }
 
@@ -323,24 +504,8 @@ namespace __IsoAgLib
     if (len >= 0xFFFF)
       return false;
 
-    const uint8_t ps = uint8_t( ident.getPgn() & 0xFF );
-    const uint8_t dp = uint8_t( ident.getPgn() >> 16 );
-
-    if( m_msgs[ ps ] == NULL )
-      return false;
-
-    for ( MsgIterator it = m_msgs[ ps ]->begin(); it != m_msgs[ ps ]->end(); ++it )
-    {
-      if ( dp != (*it)->dp() )
-        continue;
-
-      if ( (*it)->remote().isSpecified() && ( ident.getSaIsoName() != (*it)->remote() ) )
-        continue;
-
-      return true;
-    }
-
-    return false;
+    collect( ( ident.getPgn() & 0xFFFF00FFUL ) | PROPRIETARY_B_PGN, ident.getSaIsoName(), IsoName_c::IsoNameUnspecified() );
+    return ! m_matches.empty();
   }
 
 
@@ -352,57 +517,20 @@ namespace __IsoAgLib
 
     const ReceiveStreamIdentifier_c& ident = apc_stream.getIdent();
     const uint8_t ps = uint8_t( ident.getPgn() & 0xFF );
-    const uint8_t dp = uint8_t( ident.getPgn() >> 16 );
-
-    if( m_msgs[ ps ] == NULL )
-      return false;
-
-    MsgList msgs;
-
-    for ( MsgIterator it = m_msgs[ ps ]->begin(); it != m_msgs[ ps ]->end(); ++it )
-    {
-      if ( dp != (*it)->dp() )
-        continue;
-
-      if ( (*it)->remote().isSpecified() && ( ident.getSaIsoName() != (*it)->remote() ) )
-        continue;
-
-      (*it)->getDataReceive().clearVector();
-      msgs.push_front( *it );
-    }
+    collect( ( ident.getPgn() & 0xFFFF00FFUL ) | PROPRIETARY_B_PGN, ident.getSaIsoName(), IsoName_c::IsoNameUnspecified() );
 
-
-    if( ! msgs.empty() )
+    if( ! m_matches.empty() )
     {
-      uint16_t cnt = 0;
-
-      if (apc_stream.getIdent().getDa() == 0xFF)
-      { // was BAM, where the first byte was not set already!
-        // let all be read by loop below, no special handling for first byte
-      }
-      else
-      { // directed, first byte was filled out, get it in a special way!
-          uint8_t db = apc_stream.getFirstByte();
-          for (; cnt < 1; ++cnt)
-          {
-              for (MsgIterator it = msgs.begin(); it != msgs.end(); ++it) {
-                  (*it)->getDataReceive().setDataUi8(cnt, db);
-              }
-          }
-      }
-
-      for( ; cnt < apc_stream.getByteTotalSize(); ++cnt )
-      {
-        uint8_t db = apc_stream.getNextNotParsed();
-        for( MsgIterator it = msgs.begin(); it != msgs.end(); ++it ) {
-          (*it)->getDataReceive().setDataUi8( cnt, db );
-        }
-      }
+      const uint8_t* payload = gatherPayload( apc_stream );
+      const uint16_t len = uint16_t( apc_stream.getByteTotalSize() );
 
-      for( MsgIterator it = msgs.begin(); it != msgs.end(); ++it ) {
+      for( MatchIterator it = m_matches.begin(); it != m_matches.end(); ++it ) {
+        ProprietaryMessageB_c& msg = static_cast<ProprietaryMessageB_c&>( **it );
+        msg.setReceived( payload, len );
         // the static cast is prettier that a old C cast, but the Hightec GCC 3.4.6 is quite picky
-        //(*it)->processB( *static_cast<IsoAgLib::iIsoItem_c*>( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ) );
-        (*it)->processB( *( IsoAgLib::iIsoItem_c*)( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ), ps );
+        //msg.processB( *static_cast<IsoAgLib::iIsoItem_c*>( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ) );
+        msg.processB( *( IsoAgLib::iIsoItem_c*)( getIsoMonitorInstance( m_handler.getMultitonInst() ).isoMemberNrFast( ident.getSa() ) ), ps );
+        msg.resetReceived();
       }
     }
 
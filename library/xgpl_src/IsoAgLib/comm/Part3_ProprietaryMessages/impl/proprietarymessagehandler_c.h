@@ -24,14 +24,19 @@
 
 #include <IsoAgLib/driver/can/impl/cancustomer_c.h>
 #include <IsoAgLib/driver/can/imaskfilter_c.h>
+#include <IsoAgLib/comm/Part5_NetworkManagement/impl/isoname_c.h>
+#include <IsoAgLib/scheduler/impl/schedulertask_c.h>
 #include <IsoAgLib/util/impl/singleton.h>
+#include "../igenericdata_c.h"
 #include <list>
 #include <map>
+#include <vector>
 
 
 namespace __IsoAgLib
 {
 
+  class ProprietaryMessage_c;
   class ProprietaryMessageA_c;
   class ProprietaryMessageB_c;
 
@@ -53,7 +58,56 @@ namespace __IsoAgLib
     void deregisterProprietaryMessage( ProprietaryMessageA_c& msg );
     void deregisterProprietaryMessage( ProprietaryMessageB_c& msg, uint8_t ps );
 
+    /** re-sort the message for all PS it is registered for
+        after its ident, remote or DP has been changed */
+    void rekeyProprietaryMessage( ProprietaryMessageB_c& msg );
+
+    /** Queue the current send data of msg (for PS with B). A newer
+        queueing of the same message (and PS) replaces the older one if
+        it wasn't sent yet. Sent in order of priority, not faster than
+        the message's min. send period, within the transmit budget
+        (CONFIG_PROPRIETARY_TX_MAX_FRAMES per CONFIG_PROPRIETARY_TX_PERIOD) */
+    void queueSend( ProprietaryMessage_c& msg, uint8_t ps, unsigned prio, const IsoName_c& remote );
+
+    //! drop everything queued for msg
+    void dequeueSend( const ProprietaryMessage_c& msg );
+
   private:
+    void timeEvent();
+    void scheduleSend( ecutime_t due );
+
+    struct TxEntry_s
+    {
+      TxEntry_s() : msg( NULL ), ps( 0 ), prio( 0 ), pending( false ), lastSent( 0 ), remote(), data() {}
+
+      ProprietaryMessage_c* msg;
+      uint8_t ps;
+      uint8_t prio; // the priority class
+      bool pending;
+      ecutime_t lastSent;
+      IsoName_c remote;
+      IsoAgLib::iGenericData_c data; // latest value, staged into getDataSend() when sent
+    };
+    typedef STL_NAMESPACE::pair<const ProprietaryMessage_c*,uint8_t> TxKey;
+    typedef STL_NAMESPACE::map<TxKey,TxEntry_s> TxEntries;
+    typedef STL_NAMESPACE::list<TxEntry_s*> TxClass;
+
+    /** Messages are indexed by (PGN, remote NAME, local NAME).
+        The PGN contains the DP, and for B the PS, too.
+        An unspecified remote accepts any sender; for B
+        and broadcast A the local NAME doesn't matter. */
+    struct DispatchKey_s
+    {
+      DispatchKey_s( uint32_t a_pgn, const IsoName_c& a_remote, const IsoName_c& a_local ) : pgn( a_pgn ), remote( a_remote ), local( a_local ) {}
+
+      /** strict ordering, unspecified NAMEs sort first
+          (IsoName_c::operator< treats them as equal to anything) */
+      bool operator<( const DispatchKey_s& right ) const;
+
+      uint32_t pgn;
+      IsoName_c remote;
+      IsoName_c local;
+    };
 
     class CanCustomerAB_c : public CanCustomer_c
     {
@@ -62,35 +116,53 @@ namespace __IsoAgLib
       CanCustomerAB_c& operator=(const CanCustomerAB_c&);
 
     public:
-      CanCustomerAB_c( ProprietaryMessageHandler_c& handler, IsoAgLib::iMaskFilterType_c filter ) : m_handler( handler ), m_filter( filter ), mmap_registeredMsgs() {}
+      CanCustomerAB_c( ProprietaryMessageHandler_c& handler, IsoAgLib::iMaskFilterType_c filter ) : m_handler( handler ), m_filter( filter ), m_matches(), mmap_msgs(), m_payload(), mmap_registeredMsgs() {}
       virtual ~CanCustomerAB_c() {}
 
+      void insert( int multitonInst, ProprietaryMessage_c& msg, uint32_t pgn );
+      void erase( int multitonInst, const ProprietaryMessage_c& msg, uint8_t ps );
+      void rekey( int multitonInst, ProprietaryMessage_c& msg );
+
+    private:
       void   registerFilter( int multitonInst, const IsoName_c& identName );
       void deregisterFilter( int multitonInst, const IsoName_c& identName );
 
-    private:
       virtual void reactOnAbort( Stream_c & ) {}
       virtual void notificationOnMultiReceiveError( ReceiveStreamIdentifier_c const &, uint8_t, bool ) {}
 
+      void collectRange( const DispatchKey_s& key );
+
     protected:
+      typedef STL_NAMESPACE::multimap<DispatchKey_s,ProprietaryMessage_c*> MsgIndex;
+      typedef STL_NAMESPACE::multimap<DispatchKey_s,ProprietaryMessage_c*>::iterator MsgIndexIterator;
+      typedef STL_NAMESPACE::vector<ProprietaryMessage_c*>::iterator MatchIterator;
+
+      /** fill m_matches with all messages for this PGN from this sender
+          @param local unspecified for broadcasts / PDU2 */
+      void collect( uint32_t pgn, const IsoName_c& sender, const IsoName_c& local );
+
+      /** read the completely received stream into m_payload once for all matches
+          @return the payload, m_payload.size() bytes */
+      const uint8_t* gatherPayload( Stream_c& stream );
+
       ProprietaryMessageHandler_c& m_handler;
       const IsoAgLib::iMaskFilterType_c m_filter;
 
+      // matches of the message currently dispatched, kept to avoid reallocation
+      STL_NAMESPACE::vector<ProprietaryMessage_c*> m_matches;
+
     private:
+      MsgIndex mmap_msgs;
+      STL_NAMESPACE::vector<uint8_t> m_payload;
       STL_NAMESPACE::map<IsoName_c,unsigned> mmap_registeredMsgs; // how many registered for a given NAME.
     };
 
     class CanCustomerA_c : public CanCustomerAB_c
     {
     public:
-      CanCustomerA_c( ProprietaryMessageHandler_c& handler ) : CanCustomerAB_c( handler, IsoAgLib::iMaskFilterType_c( 0x00FF0000, PROPRIETARY_A_PGN << 8, IsoAgLib::iIdent_c::ExtendedIdent ) ), m_msgs() {} // A1 and A2
+      CanCustomerA_c( ProprietaryMessageHandler_c& handler ) : CanCustomerAB_c( handler, IsoAgLib::iMaskFilterType_c( 0x00FF0000, PROPRIETARY_A_PGN << 8, IsoAgLib::iIdent_c::ExtendedIdent ) ) {} // A1 and A2
       virtual ~CanCustomerA_c() {}
 
-      typedef STL_NAMESPACE::list<ProprietaryMessageA_c*> MsgList;
-      typedef STL_NAMESPACE::list<ProprietaryMessageA_c*>::iterator MsgIterator;
-
-      MsgList m_msgs;
-
     private:
       virtual void processMsg( const CanPkg_c& arc_data );
 
@@ -101,16 +173,9 @@ namespace __IsoAgLib
     class CanCustomerB_c : public CanCustomerAB_c
     {
     public:
-      CanCustomerB_c( ProprietaryMessageHandler_c& handler ) : CanCustomerAB_c( handler, IsoAgLib::iMaskFilterType_c( 0x00FF0000, PROPRIETARY_B_PGN << 8, IsoAgLib::iIdent_c::ExtendedIdent ) ) // B1 and B2
-      { CNAMESPACE::memset( m_msgs, 0x00, sizeof( m_msgs ) ); }
-
+      CanCustomerB_c( ProprietaryMessageHandler_c& handler ) : CanCustomerAB_c( handler, IsoAgLib::iMaskFilterType_c( 0x00FF0000, PROPRIETARY_B_PGN << 8, IsoAgLib::iIdent_c::ExtendedIdent ) ) {} // B1 and B2
       virtual ~CanCustomerB_c() {}
 
-      typedef STL_NAMESPACE::list<ProprietaryMessageB_c*> MsgList;
-      typedef STL_NAMESPACE::list<ProprietaryMessageB_c*>::iterator MsgIterator;
-
-      MsgList* m_msgs[256];
-
     private:
       virtual void processMsg( const CanPkg_c& arc_data );
 
@@ -122,6 +187,16 @@ namespace __IsoAgLib
     CanCustomerA_c m_customerA;
     CanCustomerB_c m_customerB;
 
+    TxEntries mmap_txEntries;
+    // one per CAN priority, sent entries move to the back for fairness
+    TxClass m_txClasses[ 8 ];
+    // CONFIG_PROPRIETARY_TX_PERIOD per frame: token bucket for the budget
+    int32_t mi32_txTokens;
+    ecutime_t m_txTokensTime;
+
+    CLASS_SCHEDULER_TASK_PROXY(ProprietaryMessageHandler_c)
+    SchedulerTaskProxy_c m_schedulerTask;
+
     friend ProprietaryMessageHandler_c &getProprietaryMessageHandlerInstance(int instance);
   };
 
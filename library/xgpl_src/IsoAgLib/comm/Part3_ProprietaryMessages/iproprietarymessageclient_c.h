@@ -48,6 +48,12 @@ namespace IsoAgLib
       IsoAgLib::iGenericData_c& getDataReceive() { return __IsoAgLib::ProprietaryMessageA_c::getDataReceive(); }
       IsoAgLib::iGenericData_c& getDataSend() { return __IsoAgLib::ProprietaryMessageA_c::getDataSend(); }
 
+      // zero-copy: don't fill getDataReceive(), use getReceived() from within processA only
+      void setZeroCopyReception( bool zeroCopy ) { __IsoAgLib::ProprietaryMessageA_c::setZeroCopyReception( zeroCopy ); }
+      bool isZeroCopyReception() const { return __IsoAgLib::ProprietaryMessageA_c::isZeroCopyReception(); }
+      const uint8_t* getReceived() const { return __IsoAgLib::ProprietaryMessageA_c::getReceived(); }
+      uint16_t getReceivedLen() const { return __IsoAgLib::ProprietaryMessageA_c::getReceivedLen(); }
+
       // If a_overwrite_remote is specified, the message is sent to a_overwrite_remote
       // else it is sent to m_remote
       bool send(const iIsoName_c& a_overwrite_remote = iIsoName_c::iIsoNameUnspecified())
@@ -60,6 +66,17 @@ namespace IsoAgLib
       {
           return __IsoAgLib::ProprietaryMessageA_c::sendWithPrio( prio, a_overwrite_remote );
       }
+
+      // rate-limited, coalescing alternative to send(): the current getDataSend()
+      // is sent later (latest value wins), at most once per getMinSendPeriod()
+      void queueSend(const iIsoName_c& a_overwrite_remote = iIsoName_c::iIsoNameUnspecified())
+      { __IsoAgLib::ProprietaryMessageA_c::queueSend( a_overwrite_remote ); }
+
+      void queueSendWithPrio( unsigned prio, const iIsoName_c& a_overwrite_remote = iIsoName_c::iIsoNameUnspecified() )
+      { __IsoAgLib::ProprietaryMessageA_c::queueSendWithPrio( prio, a_overwrite_remote ); }
+
+      void setMinSendPeriod( uint16_t msec ) { __IsoAgLib::ProprietaryMessageA_c::setMinSendPeriod( msec ); }
+      uint16_t getMinSendPeriod() const { return __IsoAgLib::ProprietaryMessageA_c::getMinSendPeriod(); }
       
       bool isSending() const { return __IsoAgLib::ProprietaryMessageA_c::isSending(); }
 
@@ -87,11 +104,27 @@ namespace IsoAgLib
       IsoAgLib::iGenericData_c& getDataReceive() { return __IsoAgLib::ProprietaryMessageB_c::getDataReceive(); }
       IsoAgLib::iGenericData_c& getDataSend() { return __IsoAgLib::ProprietaryMessageB_c::getDataSend(); }
 
+      // zero-copy: don't fill getDataReceive(), use getReceived() from within processB only
+      void setZeroCopyReception( bool zeroCopy ) { __IsoAgLib::ProprietaryMessageB_c::setZeroCopyReception( zeroCopy ); }
+      bool isZeroCopyReception() const { return __IsoAgLib::ProprietaryMessageB_c::isZeroCopyReception(); }
+      const uint8_t* getReceived() const { return __IsoAgLib::ProprietaryMessageB_c::getReceived(); }
+      uint16_t getReceivedLen() const { return __IsoAgLib::ProprietaryMessageB_c::getReceivedLen(); }
+
       bool send( uint8_t ps, const iIsoName_c& a_overwrite_remote = iIsoName_c::iIsoNameUnspecified() )
       { return __IsoAgLib::ProprietaryMessageB_c::send( ps, a_overwrite_remote ); }
       
       bool sendWithPrio( uint8_t ps, unsigned prio, const iIsoName_c& a_overwrite_remote = iIsoName_c::iIsoNameUnspecified() )
       { return __IsoAgLib::ProprietaryMessageB_c::sendWithPrio( ps, prio, a_overwrite_remote ); }
+
+      // rate-limited, coalescing alternative to send(), queued per PS
+      void queueSend( uint8_t ps, const iIsoName_c& a_overwrite_remote = iIsoName_c::iIsoNameUnspecified() )
+      { __IsoAgLib::ProprietaryMessageB_c::queueSend( ps, a_overwrite_remote ); }
+
+      void queueSendWithPrio( uint8_t ps, unsigned prio, const iIsoName_c& a_overwrite_remote = iIsoName_c::iIsoNameUnspecified() )
+      { __IsoAgLib::ProprietaryMessageB_c::queueSendWithPrio( ps, prio, a_overwrite_remote ); }
+
+      void setMinSendPeriod( uint16_t msec ) { __IsoAgLib::ProprietaryMessageB_c::setMinSendPeriod( msec ); }
+      uint16_t getMinSendPeriod() const { return __IsoAgLib::ProprietaryMessageB_c::getMinSendPeriod(); }
       
       bool isSending() const { return __IsoAgLib::ProprietaryMessageB_c::isSending(); }
   };
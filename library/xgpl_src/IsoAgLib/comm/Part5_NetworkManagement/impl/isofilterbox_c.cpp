@@ -51,14 +51,27 @@ IsoFilter_s::equalMaskAndFilter (const IsoFilter_s& acrc_isoFilter) const
 
 
 
-IsoFilterBox_c::IsoFilterBox_c (const IsoFilter_s& arcs_isoFilter MULTITON_INST_PARAMETER_DEF_WITH_COMMA)
+IsoFilterBox_c::IsoFilterBox_c (const IsoFilter_s& arcs_isoFilter, const ResolvedSa_s* apcs_resolvedSa, const ResolvedSa_s* apcs_resolvedDa MULTITON_INST_PARAMETER_DEF_WITH_COMMA)
 : MULTITON_PARENT_CONSTRUCTOR
-  ms_isoFilter (arcs_isoFilter)
+  CanCustomer_c()
+, ms_isoFilter (arcs_isoFilter)
+, mpcs_resolvedSa (apcs_resolvedSa)
+, mpcs_resolvedDa (apcs_resolvedDa)
 , mpc_filterBox (NULL)
 , mc_adaptedMaskFilter( 0, 0 )
 {}
 
 
+CanCustomer_c&
+IsoFilterBox_c::customerForCanIo()
+{
+  if ((mpcs_resolvedSa != NULL) || (mpcs_resolvedDa != NULL))
+    return *this; // check the resolved address(es) in processMsg
+  else
+    return *ms_isoFilter.mpc_canCustomer;
+}
+
+
 
 void
 IsoFilterBox_c::updateOnAdd()
@@ -69,36 +82,18 @@ IsoFilterBox_c::updateOnAdd()
 
   IsoAgLib::iMaskFilter_c c_maskFilter = ms_isoFilter.mc_maskFilter;
 
-  if (ms_isoFilter.mc_isoNameSa.isSpecified())
-  { // see if it's in the monitorlist!
-    IsoItem_c *itemSa = getIsoMonitorInstance4Comm().item (ms_isoFilter.mc_isoNameSa, true);
-    if (itemSa == NULL)
-      return; // can't create the filter - IsoName not claimed on the bus!
-
-    // retrieve current address
-    const uint8_t cui8_adr = itemSa->nr();
-
+  if (mpcs_resolvedSa != NULL)
+  { // any SA, checked in processMsg
     isoaglib_assert( ( c_maskFilter.getFilter() & 0xff ) == 0 );
-
-    c_maskFilter.setFilter( c_maskFilter.getFilter() | cui8_adr );
-    c_maskFilter.setMask( c_maskFilter.getMask() | 0xff );
+    c_maskFilter.setMask( c_maskFilter.getMask() & ~0xffUL );
   }
-  if (ms_isoFilter.mc_isoNameDa.isSpecified())
-  { // see if it's in the monitorlist!
-    IsoItem_c* itemDa = getIsoMonitorInstance4Comm().item (ms_isoFilter.mc_isoNameDa, true);
-    if (itemDa == NULL)
-      return; // can't create the filter - IsoName not claimed on the bus!
-
-    // retrieve current address
-    const uint8_t cui8_adr = itemDa->nr();
-
+  if (mpcs_resolvedDa != NULL)
+  { // any DA, checked in processMsg
     isoaglib_assert( ( c_maskFilter.getFilter() & 0xff00UL ) == 0 );
-
-    c_maskFilter.setFilter( c_maskFilter.getFilter() | ( static_cast<uint32_t>( cui8_adr ) << 8 ) );
-    c_maskFilter.setMask( c_maskFilter.getMask() | 0xff00UL );
+    c_maskFilter.setMask( c_maskFilter.getMask() & ~0xff00UL );
   }
 
-  mpc_filterBox = getIsoBusInstance4Comm().insertFilter( *ms_isoFilter.mpc_canCustomer,
+  mpc_filterBox = getIsoBusInstance4Comm().insertFilter( customerForCanIo(),
                                                          c_maskFilter,
                                                          ms_isoFilter.mi8_dlcForce );
   mc_adaptedMaskFilter = c_maskFilter;
@@ -106,20 +101,30 @@ IsoFilterBox_c::updateOnAdd()
 
 
 void
-IsoFilterBox_c::updateOnRemove (const IsoName_c* apc_isoName)
+IsoFilterBox_c::updateOnRemove()
 {
   if (mpc_filterBox == NULL)
     return; // there was none created yet.
 
-  if ( (apc_isoName == NULL)
-       ||
-       (ms_isoFilter.mc_isoNameSa == *apc_isoName)
-       ||
-       (ms_isoFilter.mc_isoNameDa == *apc_isoName) )
-  {
-    getIsoBusInstance4Comm().deleteFilter( *ms_isoFilter.mpc_canCustomer, mc_adaptedMaskFilter );
-    mpc_filterBox = NULL;
-  }
+  getIsoBusInstance4Comm().deleteFilter( customerForCanIo(), mc_adaptedMaskFilter );
+  mpc_filterBox = NULL;
+}
+
+
+void
+IsoFilterBox_c::processMsg( const CanPkg_c& arc_data )
+{
+  if ( (mpcs_resolvedSa != NULL)
+       &&
+       ( !mpcs_resolvedSa->claimed || ( ( arc_data.ident() & 0xFF ) != mpcs_resolvedSa->sa ) ) )
+    return;
+
+  if ( (mpcs_resolvedDa != NULL)
+       &&
+       ( !mpcs_resolvedDa->claimed || ( ( ( arc_data.ident() >> 8 ) & 0xFF ) != mpcs_resolvedDa->sa ) ) )
+    return;
+
+  ms_isoFilter.mpc_canCustomer->processMsg( arc_data );
 }
 
 
@@ -24,13 +24,26 @@
 #include <IsoAgLib/util/impl/singleton.h>
 #include <IsoAgLib/driver/can/imaskfilter_c.h>
 #include <IsoAgLib/driver/can/impl/ident_c.h>
+#include <IsoAgLib/driver/can/impl/cancustomer_c.h>
 #include <IsoAgLib/comm/Part5_NetworkManagement/impl/isoname_c.h>
 
 
 namespace __IsoAgLib {
 
 class FilterBox_c;
-class CanCustomer_c;
+
+
+/** Current address of a NAME that IsoFilters are bound to.
+    Shared by all IsoFilterBoxes using this NAME and kept up to date
+    by the IsoFilterManager_c on address claims/changes/losses. */
+struct ResolvedSa_s
+{
+  ResolvedSa_s() : refCount( 0 ), sa( 0xFE ), claimed( false ) {}
+
+  unsigned refCount;
+  uint8_t sa;
+  bool claimed;
+};
 
 
 struct IsoFilter_s
@@ -68,18 +81,32 @@ private:
 };
 
 
-class IsoFilterBox_c : public ClientBase
+/** One IsoFilter in the CAN filters.
+  A NAME bound filter is inserted once without its SA/DA byte, this box
+  being the customer that checks the SA/DA against the resolved address
+  of the NAME(s). So address claims and changes don't touch the CAN
+  (and HAL) filters at all. Filters without NAME go directly to the
+  customer. Must not be moved once inserted (kept in a list).
+*/
+class IsoFilterBox_c : public ClientBase, public CanCustomer_c
 {
 public:
-  IsoFilterBox_c (const IsoFilter_s& rrefcs_isoFilter MULTITON_INST_PARAMETER_DEF_WITH_COMMA);
+  IsoFilterBox_c (const IsoFilter_s& rrefcs_isoFilter, const ResolvedSa_s* apcs_resolvedSa, const ResolvedSa_s* apcs_resolvedDa MULTITON_INST_PARAMETER_DEF_WITH_COMMA);
 
   bool hasIsoFilter (const IsoFilter_s& arcs_isoFilter) { return (ms_isoFilter == arcs_isoFilter); }
+  const IsoFilter_s& isoFilter() const { return ms_isoFilter; }
 
   void updateOnAdd();
-  void updateOnRemove (const IsoName_c* acrc_isoName);
+  void updateOnRemove();
+
+  virtual void processMsg( const CanPkg_c& arc_data );
 
 private:
+  CanCustomer_c& customerForCanIo();
+
   IsoFilter_s ms_isoFilter;
+  const ResolvedSa_s* mpcs_resolvedSa; // NULL if not bound to a NAME
+  const ResolvedSa_s* mpcs_resolvedDa; // NULL if not bound to a NAME
   FilterBox_c* mpc_filterBox;
   IsoAgLib::iMaskFilter_c mc_adaptedMaskFilter;
 };
@@ -31,7 +31,8 @@ namespace __IsoAgLib {
 
 
 IsoFilterManager_c::IsoFilterManager_c () :
-  mvec_isoFilterBox(),
+  mlist_isoFilterBox(),
+  mmap_resolvedSa(),
   mt_handler(*this)
 {
 }
@@ -54,13 +55,14 @@ IsoFilterManager_c::close()
   isoaglib_assert (initialized());
 
   // for now, clear all the registered filters.
-  for (IsoFilterBox_it it_isoFilterBox = mvec_isoFilterBox.begin();
-       it_isoFilterBox != mvec_isoFilterBox.end();
+  for (IsoFilterBox_it it_isoFilterBox = mlist_isoFilterBox.begin();
+       it_isoFilterBox != mlist_isoFilterBox.end();
         ++it_isoFilterBox)
   { // Search for existing IsoFilterBox
-    it_isoFilterBox->updateOnRemove (NULL);
+    it_isoFilterBox->updateOnRemove();
   }
-  mvec_isoFilterBox.clear();
+  mlist_isoFilterBox.clear();
+  mmap_resolvedSa.clear();
   // for later, all modules should remove their filters!
 
   getIsoMonitorInstance4Comm().deregisterControlFunctionStateHandler( mt_handler );
@@ -72,8 +74,8 @@ IsoFilterManager_c::close()
 bool
 IsoFilterManager_c::existIsoFilter (const IsoFilter_s& arcs_isoFilter)
 {
-  for (IsoFilterBox_it it_isoFilterBox = mvec_isoFilterBox.begin();
-       it_isoFilterBox != mvec_isoFilterBox.end();
+  for (IsoFilterBox_it it_isoFilterBox = mlist_isoFilterBox.begin();
+       it_isoFilterBox != mlist_isoFilterBox.end();
        ++it_isoFilterBox)
   { // Search for existing IsoFilterBox
     if (it_isoFilterBox->hasIsoFilter (arcs_isoFilter))
@@ -91,10 +93,13 @@ IsoFilterManager_c::insertIsoFilter (const IsoFilter_s& arcs_isoFilter)
   // Check if IsoFilter does yet exist in some IsoFilterBox
   if (!existIsoFilter (arcs_isoFilter))
   { // insert an empty IsoFilterBox. initialized then in list right after
-    mvec_isoFilterBox.push_back (IsoFilterBox_c (arcs_isoFilter MULTITON_INST_WITH_COMMA));
+    mlist_isoFilterBox.push_back (IsoFilterBox_c (arcs_isoFilter,
+                                                  acquireResolvedSa (arcs_isoFilter.getIsoNameSa()),
+                                                  acquireResolvedSa (arcs_isoFilter.getIsoNameDa())
+                                                  MULTITON_INST_WITH_COMMA));
 
     // now get the inserted IsoFilterBox and retrigger update of real hardware filters
-    mvec_isoFilterBox.back().updateOnAdd();
+    mlist_isoFilterBox.back().updateOnAdd();
   }
 }
 
@@ -102,14 +107,16 @@ IsoFilterManager_c::insertIsoFilter (const IsoFilter_s& arcs_isoFilter)
 bool
 IsoFilterManager_c::removeIsoFilter (const IsoFilter_s& arcs_isoFilter)
 {
-  for (IsoFilterBox_it it_isoFilterBox = mvec_isoFilterBox.begin();
-       it_isoFilterBox != mvec_isoFilterBox.end();
+  for (IsoFilterBox_it it_isoFilterBox = mlist_isoFilterBox.begin();
+       it_isoFilterBox != mlist_isoFilterBox.end();
        ++it_isoFilterBox)
   { // Search for existing IsoFilterBox
     if (it_isoFilterBox->hasIsoFilter (arcs_isoFilter))
     {
-      it_isoFilterBox->updateOnRemove (NULL);
-      mvec_isoFilterBox.erase (it_isoFilterBox);
+      it_isoFilterBox->updateOnRemove();
+      releaseResolvedSa (it_isoFilterBox->isoFilter().getIsoNameSa());
+      releaseResolvedSa (it_isoFilterBox->isoFilter().getIsoNameDa());
+      mlist_isoFilterBox.erase (it_isoFilterBox);
       return true;
     }
   }
@@ -120,36 +127,60 @@ IsoFilterManager_c::removeIsoFilter (const IsoFilter_s& arcs_isoFilter)
 
 
 
+const ResolvedSa_s*
+IsoFilterManager_c::acquireResolvedSa (const IsoName_c& acrc_isoName)
+{
+  if (acrc_isoName.isUnspecified())
+    return NULL;
+
+  ResolvedSa_s& rs_resolvedSa = mmap_resolvedSa[ acrc_isoName ];
+  if (rs_resolvedSa.refCount++ == 0)
+    resolve (acrc_isoName, rs_resolvedSa);
+
+  return &rs_resolvedSa;
+}
+
+
+void
+IsoFilterManager_c::releaseResolvedSa (const IsoName_c& acrc_isoName)
+{
+  if (acrc_isoName.isUnspecified())
+    return;
+
+  ResolvedSa_map::iterator it_resolvedSa = mmap_resolvedSa.find (acrc_isoName);
+  isoaglib_assert (it_resolvedSa != mmap_resolvedSa.end());
+  if (--it_resolvedSa->second.refCount == 0)
+    mmap_resolvedSa.erase (it_resolvedSa);
+}
+
+
+void
+IsoFilterManager_c::resolve (const IsoName_c& acrc_isoName, ResolvedSa_s& ars_resolvedSa) const
+{
+  const IsoItem_c* pc_item = getIsoMonitorInstance4Comm().item (acrc_isoName, true);
+  ars_resolvedSa.claimed = (pc_item != NULL);
+  ars_resolvedSa.sa = (pc_item != NULL) ? pc_item->nr() : 0xFE;
+}
+
+
 void
 IsoFilterManager_c::reactOnIsoItemModification (ControlFunctionStateHandler_c::iIsoItemAction_e at_action, IsoItem_c const& acrc_isoItem)
 {
-  if ((at_action == ControlFunctionStateHandler_c::AddToMonitorList) || (at_action == ControlFunctionStateHandler_c::ReclaimedAddress))
-  {
-    for (IsoFilterBox_it it_isoFilterBox = mvec_isoFilterBox.begin();
-        it_isoFilterBox != mvec_isoFilterBox.end();
-        ++it_isoFilterBox)
-    { // the ISOFilterBoxes will take care if they have to do anything at all or not...
-      it_isoFilterBox->updateOnAdd();
-    }
-  }
-  else if (at_action == ControlFunctionStateHandler_c::ChangedAddress)
+  // only the NAME's resolved address changes, the CAN filters stay as they are.
+  ResolvedSa_map::iterator it_resolvedSa = mmap_resolvedSa.find (acrc_isoItem.isoName());
+  if (it_resolvedSa == mmap_resolvedSa.end())
+    return; // no IsoFilter bound to this NAME
+
+  if ((at_action == ControlFunctionStateHandler_c::AddToMonitorList)
+   || (at_action == ControlFunctionStateHandler_c::ReclaimedAddress)
+   || (at_action == ControlFunctionStateHandler_c::ChangedAddress))
   {
-    for (IsoFilterBox_it it_isoFilterBox = mvec_isoFilterBox.begin();
-        it_isoFilterBox != mvec_isoFilterBox.end();
-        ++it_isoFilterBox)
-    { // the ISOFilterBoxes will take care if they have to do anything at all or not...
-      it_isoFilterBox->updateOnRemove(&acrc_isoItem.isoName());
-      it_isoFilterBox->updateOnAdd();
-    }
+    resolve (it_resolvedSa->first, it_resolvedSa->second);
   }
   else
   { // ((at_action == RemoveFromMonitorList) || (at_action == LostAddress))
-    for (IsoFilterBox_it it_isoFilterBox = mvec_isoFilterBox.begin();
-         it_isoFilterBox != mvec_isoFilterBox.end();
-         ++it_isoFilterBox)
-    { // the ISOFilterBoxes will take care if they have to do anything at all or not...
-      it_isoFilterBox->updateOnRemove (&acrc_isoItem.isoName());
-    }
+    it_resolvedSa->second.claimed = false;
+    it_resolvedSa->second.sa = 0xFE;
   }
 }
 
@@ -26,7 +26,8 @@
 #include "isofilterbox_c.h"
 
 #include <cstdlib>	// Include before vector or else CNAMESPACE stuff is screwed up for Tasking
-#include <vector>
+#include <list>
+#include <map>
 
 
 namespace __IsoAgLib {
@@ -36,8 +37,10 @@ class IsoFilterManager_c : public Subsystem_c
 {
   MACRO_MULTITON_CONTRIBUTION();
 public:
-  typedef STL_NAMESPACE::vector<IsoFilterBox_c> IsoFilterBox_vec;
-  typedef STL_NAMESPACE::vector<IsoFilterBox_c>::iterator IsoFilterBox_it;
+  // list: the IsoFilterBoxes are registered as CanCustomers, so they mustn't move
+  typedef STL_NAMESPACE::list<IsoFilterBox_c> IsoFilterBox_list;
+  typedef STL_NAMESPACE::list<IsoFilterBox_c>::iterator IsoFilterBox_it;
+  typedef STL_NAMESPACE::map<IsoName_c, ResolvedSa_s> ResolvedSa_map;
 
   ~IsoFilterManager_c () {}
 
@@ -77,10 +80,15 @@ private:
 
   void reactOnIsoItemModification (ControlFunctionStateHandler_c::iIsoItemAction_e /*at_action*/, IsoItem_c const& /*acrc_isoItem*/);
 
+  const ResolvedSa_s* acquireResolvedSa (const IsoName_c& acrc_isoName);
+  void releaseResolvedSa (const IsoName_c& acrc_isoName);
+  void resolve (const IsoName_c& acrc_isoName, ResolvedSa_s& ars_resolvedSa) const;
+
 private:
   IsoFilterManager_c();
 
-  IsoFilterBox_vec mvec_isoFilterBox;
+  IsoFilterBox_list mlist_isoFilterBox;
+  ResolvedSa_map mmap_resolvedSa; // one entry per NAME used in any IsoFilter
   Handler_t mt_handler;
 
   friend IsoFilterManager_c &getIsoFilterManagerInstance( unsigned int instance );
@@ -0,0 +1,65 @@
+/*
+  iiopgenerator_c.h: offline streaming of an object pool into
+    the binary IOP as it would be uploaded to a given VT.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef IIOPGENERATOR_C_H
+#define IIOPGENERATOR_C_H
+
+#include "impl/iopgenerator_c.h"
+
+#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
+
+#include "ivtclientconnection_c.h"
+
+
+namespace IsoAgLib {
+
+/** Build-time analysis of an object pool (PC only, needs the define
+  USE_IOP_GENERATOR_FAKE_VT_PROPERTIES): register the pool as usual, then
+  generate the IOP for the VT properties of interest - without a VT.
+  Don't run the scheduler while generating.
+*/
+class iIopGenerator_c : private __IsoAgLib::IopGenerator_c
+{
+public:
+  typedef __IsoAgLib::IopGenerator_c::VtProperties_s VtProperties_s;
+  typedef __IsoAgLib::IopGenerator_c::Object_s Object_s;
+
+  iIopGenerator_c( iVtClientConnection_c& connection )
+    : IopGenerator_c( static_cast<__IsoAgLib::VtClientConnection_c&>( connection ) ) {}
+
+  bool generate( const VtProperties_s& properties, int8_t languageIndex = 0 ) { return IopGenerator_c::generate( properties, languageIndex ); }
+
+  const STL_NAMESPACE::vector<uint8_t>& data() const { return IopGenerator_c::data(); }
+  const STL_NAMESPACE::vector<Object_s>& objects() const { return IopGenerator_c::objects(); }
+  uint32_t fixSize() const { return IopGenerator_c::fixSize(); }
+  uint32_t languageSize( uint8_t languageIndex ) const { return IopGenerator_c::languageSize( languageIndex ); }
+  uint8_t numLanguages() const { return IopGenerator_c::numLanguages(); }
+
+  uint32_t estimateUploadTimeMs( uint8_t busLoadPercent, uint8_t packetsPerCts = 16 ) const { return IopGenerator_c::estimateUploadTimeMs( busLoadPercent, packetsPerCts ); }
+
+  bool writeIop( const char* filename ) const { return IopGenerator_c::writeIop( filename ); }
+  void writeReport( FILE* file, uint8_t busLoadPercent, uint8_t packetsPerCts = 16 ) const { IopGenerator_c::writeReport( file, busLoadPercent, packetsPerCts ); }
+};
+
+} // IsoAgLib
+
+#endif // USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
+
+#endif
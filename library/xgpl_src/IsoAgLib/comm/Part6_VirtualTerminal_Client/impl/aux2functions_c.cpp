@@ -446,7 +446,7 @@ Aux2Functions_c::sendPreferredAux2Assignments()
     }
   }
 
-  msc_tempSendUpload.vec_uploadBuffer.clear();
+  msc_tempSendUpload.clear();
 
   // calculate needed size for vec_uploadBuffer
   uint16_t msgSize = 2; // minimum size for no assignments
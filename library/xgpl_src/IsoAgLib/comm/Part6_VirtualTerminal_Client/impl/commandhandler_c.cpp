@@ -791,6 +791,9 @@ CommandHandler_c::queueOrReplace (SendUpload_c& ar_sendUpload, bool b_enableRepl
   if( !m_connection.poolSuccessfullyUploaded() )
     return false;
 
+  // queue entries only reference multi-packet data, no copies
+  ar_sendUpload.share();
+
 #ifdef OPTIMIZE_HEAPSIZE_IN_FAVOR_OF_SPEED
   STL_NAMESPACE::list<SendUpload_c,MALLOC_TEMPLATE(SendUpload_c) >::iterator i_sendUpload;
 #else
@@ -996,7 +999,7 @@ CommandHandler_c::tryToStart()
       /// Use Multi or Single CAN-Pkgs?
       //////////////////////////////////
 
-      if( (actSend.mc_streamer == NULL) && (actSend.vec_uploadBuffer.size() < 9) )
+      if( (actSend.mc_streamer == NULL) && (actSend.payloadSize() < 9) )
       { /// Fits into a single CAN-Pkg!
         if( actSend.vec_uploadBuffer[0] == 0x11 )
         { /// Handle special case of LanguageUpdate / UserPoolUpdate
@@ -1055,8 +1058,8 @@ CommandHandler_c::tryToStart()
         (void)getMultiSendInstance( m_connection.getMultitonInst() ).sendIsoTarget(
           m_connection.getIdentItem().isoName(),
           m_connection.getVtServerInst().getIsoName(),
-          &actSend.vec_uploadBuffer.front(),
-          actSend.vec_uploadBuffer.size(), ECU_TO_VT_PGN, this );
+          actSend.payloadData(),
+          actSend.payloadSize(), ECU_TO_VT_PGN, this );
       }
       else
       {
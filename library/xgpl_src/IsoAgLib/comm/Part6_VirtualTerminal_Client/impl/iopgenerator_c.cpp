@@ -0,0 +1,224 @@
+/*
+  iopgenerator_c.cpp: offline streaming of an object pool into
+    the binary IOP as it would be uploaded to a given VT.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#include "iopgenerator_c.h"
+
+#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
+
+#include <IsoAgLib/comm/Part5_NetworkManagement/impl/isoitem_c.h>
+#include "vtclientconnection_c.h"
+#include "vtserverinstance_c.h"
+#include "vtobject_c.h"
+
+
+namespace __IsoAgLib {
+
+
+IopGenerator_c::IopGenerator_c( VtClientConnection_c& connection )
+  : mrc_connection( connection )
+  , ms_properties()
+  , mi8_languageIndex( -1 )
+  , mui32_fixSize( 0 )
+  , m_data()
+  , m_scratch()
+  , m_objects()
+  , m_languageSizes()
+{
+}
+
+
+bool
+IopGenerator_c::generate( const VtProperties_s& properties, int8_t languageIndex )
+{
+  ms_properties = properties;
+  m_data.clear();
+  m_objects.clear();
+  m_languageSizes.clear();
+
+  const IsoItem_c c_dummyIsoItem;
+  VtServerInstance_c c_dummyVt( c_dummyIsoItem, mrc_connection.mrc_vtClient );
+  c_dummyVt.fakeVtProperties( properties.dimension, properties.skWidth, properties.skHeight, properties.colourDepth,
+                              properties.fontSizes, properties.fontTypes, properties.version );
+
+  VtServerInstance_c* const pc_realVt = mrc_connection.mpc_vtServerInstance;
+  mrc_connection.mpc_vtServerInstance = &c_dummyVt;
+  mrc_connection.populateScalingInformation();
+
+  IsoAgLib::iVtClientObjectPool_c& pool = mrc_connection.getPool();
+
+  // same fallback as the upload: unknown language -> default language
+  mi8_languageIndex = ( pool.getNumLang() == 0 ) ? -1
+                    : ( ( languageIndex >= 0 ) && ( languageIndex < int( pool.getNumLang() ) ) ) ? languageIndex : 0;
+
+  mui32_fixSize = streamObjects( pool.getIVtObjects()[ 0 ], pool.getNumObjects(), -1, properties.version, true );
+  for( uint8_t lang = 0; lang < pool.getNumLang(); ++lang )
+    m_languageSizes.push_back( streamObjects( pool.getIVtObjects()[ lang + 1 ], pool.getNumObjectsLang(), int8_t( lang ), properties.version, lang == mi8_languageIndex ) );
+
+  mrc_connection.mpc_vtServerInstance = pc_realVt;
+  if( pc_realVt != NULL )
+    mrc_connection.populateScalingInformation();
+
+  bool b_fits = true;
+  for( STL_NAMESPACE::vector<Object_s>::const_iterator iter = m_objects.begin(); iter != m_objects.end(); ++iter )
+    b_fits = b_fits && iter->fits;
+  return b_fits;
+}
+
+
+uint32_t
+IopGenerator_c::streamObjects( IsoAgLib::iVtObject_c* const HUGE_MEM* objects, uint16_t numObjects, int8_t languageIndex, uint8_t version, bool keep )
+{
+  uint32_t ui32_total = 0;
+  for( uint16_t curObject = 0; curObject < numObjects; ++curObject )
+  {
+    vtObject_c &object = *((vtObject_c*)(objects[ curObject ]));
+    if( UploadPoolState_c::dontUpload( object, version ) )
+      continue;
+
+    const uint32_t ui32_fitSize = object.fitTerminal();
+    m_scratch.resize( ui32_fitSize + 1 );
+
+    uint32_t pos = 0;
+    while( pos < ui32_fitSize )
+    {
+      const uint32_t remaining = ui32_fitSize - pos;
+      const uint16_t maxBytes = uint16_t( ( remaining > 0x7FFF ) ? 0x7FFF : remaining );
+      const int16_t bytes2Buffer = object.stream( &m_scratch[ pos ], maxBytes, objRange_t( pos ) );
+      if( bytes2Buffer <= 0 )
+        break;
+      pos += uint32_t( bytes2Buffer );
+    }
+
+    Object_s s_object;
+    s_object.objectId = object.getID();
+    s_object.objectType = object.getObjectType();
+    s_object.languageIndex = languageIndex;
+    s_object.offset = keep ? uint32_t( m_data.size() ) : 0;
+    s_object.size = pos;
+    // must be complete now, the object mustn't want to stream any further
+    s_object.fits = ( pos == ui32_fitSize ) && ( object.stream( &m_scratch[ pos ], 1, objRange_t( pos ) ) == 0 );
+    m_objects.push_back( s_object );
+
+    if( keep )
+      m_data.insert( m_data.end(), m_scratch.begin(), m_scratch.begin() + pos );
+    ui32_total += pos;
+  }
+  return ui32_total;
+}
+
+
+uint32_t
+IopGenerator_c::languageSize( uint8_t languageIndex ) const
+{
+  return ( languageIndex < m_languageSizes.size() ) ? m_languageSizes[ languageIndex ] : 0;
+}
+
+
+uint32_t
+IopGenerator_c::transferFrames( uint32_t size, uint8_t packetsPerCts )
+{
+  if( size <= 8 )
+    return 1; // single packet
+
+  const uint32_t packets = ( size + 6 ) / 7;
+  const uint32_t windows = ( packets + packetsPerCts - 1 ) / packetsPerCts;
+  // RTS, CTS per window, EoMA - and a DPO per window for ETP
+  return packets + 2 + ( ( size > 1785 ) ? 2 * windows : windows );
+}
+
+
+uint32_t
+IopGenerator_c::estimateUploadTimeMs( uint8_t busLoadPercent, uint8_t packetsPerCts ) const
+{
+  if( busLoadPercent > 99 )
+    busLoadPercent = 99;
+  if( packetsPerCts == 0 )
+    packetsPerCts = 1;
+
+  // each phase is sent with its own Object Pool Transfer command byte
+  uint32_t frames = transferFrames( 1 + mui32_fixSize, packetsPerCts );
+  if( mi8_languageIndex >= 0 )
+  {
+    const uint32_t langSize = languageSize( uint8_t( mi8_languageIndex ) );
+    if( langSize > 0 )
+      frames += transferFrames( 1 + langSize, packetsPerCts );
+  }
+
+  // extended 8 byte frame: 131 bits incl. interframe space, ~10% stuffing.
+  // 140 bits at 250 kbit/s are 560us.
+  const uint64_t us = uint64_t( frames ) * 560 * 100 / ( 100 - busLoadPercent );
+  return uint32_t( ( us + 999 ) / 1000 );
+}
+
+
+bool
+IopGenerator_c::writeIop( const char* filename ) const
+{
+  FILE* file = fopen( filename, "wb" );
+  if( file == NULL )
+    return false;
+
+  const bool b_ok = m_data.empty() || ( fwrite( &m_data[ 0 ], 1, m_data.size(), file ) == m_data.size() );
+  return ( fclose( file ) == 0 ) && b_ok;
+}
+
+
+void
+IopGenerator_c::writeReport( FILE* file, uint8_t busLoadPercent, uint8_t packetsPerCts ) const
+{
+  fprintf( file, "VT version %u, dimension %u, softkeys %ux%u, colour depth %u, font sizes 0x%04x, font types 0x%02x\n",
+           ms_properties.version, ms_properties.dimension, ms_properties.skWidth, ms_properties.skHeight,
+           ms_properties.colourDepth, ms_properties.fontSizes, ms_properties.fontTypes );
+  fprintf( file, "%6s %5s %5s %9s %8s\n", "id", "type", "lang", "offset", "size" );
+
+  unsigned misfits = 0;
+  for( STL_NAMESPACE::vector<Object_s>::const_iterator iter = m_objects.begin(); iter != m_objects.end(); ++iter )
+  {
+    const bool inIop = ( iter->languageIndex < 0 ) || ( iter->languageIndex == mi8_languageIndex );
+    if( iter->languageIndex < 0 )
+      fprintf( file, "%6u %5u %5s ", iter->objectId, iter->objectType, "-" );
+    else
+      fprintf( file, "%6u %5u %5d ", iter->objectId, iter->objectType, iter->languageIndex );
+    if( inIop )
+      fprintf( file, "%9lu %8lu%s\n", (unsigned long)iter->offset, (unsigned long)iter->size, iter->fits ? "" : " MISFIT" );
+    else
+      fprintf( file, "%9s %8lu%s\n", "-", (unsigned long)iter->size, iter->fits ? "" : " MISFIT" );
+    if( !iter->fits )
+      ++misfits;
+  }
+
+  fprintf( file, "\nlanguage independent: %lu bytes\n", (unsigned long)mui32_fixSize );
+  for( uint8_t lang = 0; lang < numLanguages(); ++lang )
+    fprintf( file, "language %u: %lu bytes (%+ld to language 0)\n", lang,
+             (unsigned long)m_languageSizes[ lang ], long( m_languageSizes[ lang ] ) - long( m_languageSizes[ 0 ] ) );
+
+  fprintf( file, "IOP: %lu bytes", (unsigned long)m_data.size() );
+  if( mi8_languageIndex >= 0 )
+    fprintf( file, " with language %d", mi8_languageIndex );
+  fprintf( file, "\nupload: ~%lu ms bus time at %u%% bus load, %u packets per CTS\n",
+           (unsigned long)estimateUploadTimeMs( busLoadPercent, packetsPerCts ), busLoadPercent, packetsPerCts );
+  if( misfits > 0 )
+    fprintf( file, "%u object(s) streamed a different size than fitted!\n", misfits );
+}
+
+
+} // __IsoAgLib
+
+#endif // USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
@@ -0,0 +1,124 @@
+/*
+  iopgenerator_c.h: offline streaming of an object pool into
+    the binary IOP as it would be uploaded to a given VT.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef IOPGENERATOR_C_H
+#define IOPGENERATOR_C_H
+
+#include <IsoAgLib/isoaglib_config.h>
+
+#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
+
+#include <cstdio>
+#include <vector>
+
+
+namespace IsoAgLib {
+  class iVtObject_c;
+}
+
+
+namespace __IsoAgLib {
+
+
+class VtClientConnection_c;
+
+
+/** Streams a registered object pool with the objects' own fitTerminal()
+  and stream() against a dummy VT with the given properties, so scaling,
+  colour/font adaption and the omission of Aux2 objects for version 2 VTs
+  are exactly as on the bus. Collects the size of every object and of
+  every language part.
+  Meant for PC tools only: the dummy VT is attached to the connection
+  while generating, so the scheduler must not run meanwhile.
+*/
+class IopGenerator_c
+{
+public:
+  struct VtProperties_s
+  {
+    uint8_t version;      // VT version, 2: no Aux2 objects
+    uint16_t dimension;   // data/alarm mask (square)
+    uint8_t skWidth;
+    uint8_t skHeight;
+    uint8_t colourDepth;  // 0, 1 or 2 (2, 16 or 256 colours)
+    uint16_t fontSizes;   // as in the Get Text Font Data Response
+    uint8_t fontTypes;    // font style bits supported
+  };
+
+  struct Object_s
+  {
+    uint16_t objectId;
+    uint16_t objectType;
+    int8_t languageIndex; // -1: language independent
+    uint32_t offset;      // in the IOP, only valid for objects in it
+    uint32_t size;        // streamed bytes
+    bool fits;            // streamed size matches fitTerminal()
+  };
+
+  IopGenerator_c( VtClientConnection_c& connection );
+
+  /** Stream the language independent objects and all languages,
+    the IOP keeps the independent objects followed by the given language.
+    @return false if any object's streamed size differs from its fitted size */
+  bool generate( const VtProperties_s& properties, int8_t languageIndex );
+
+  //! IOP bytes (object definitions only, no 0x11 command bytes)
+  const STL_NAMESPACE::vector<uint8_t>& data() const { return m_data; }
+  const STL_NAMESPACE::vector<Object_s>& objects() const { return m_objects; }
+  uint32_t fixSize() const { return mui32_fixSize; }
+  //! @return 0 if the pool has no such language
+  uint32_t languageSize( uint8_t languageIndex ) const;
+  uint8_t numLanguages() const { return uint8_t( m_languageSizes.size() ); }
+
+  /** Pure bus time of the Object Pool Transfer phase(s) for the generated
+    language at 250 kbit/s. VT response times (CTS, End of Object Pool)
+    are not included.
+    @param busLoadPercent load of all other traffic [0..99]
+    @param packetsPerCts packets the VT typically allows per CTS */
+  uint32_t estimateUploadTimeMs( uint8_t busLoadPercent, uint8_t packetsPerCts ) const;
+
+  bool writeIop( const char* filename ) const;
+  void writeReport( FILE* file, uint8_t busLoadPercent, uint8_t packetsPerCts ) const;
+
+private:
+  uint32_t streamObjects( IsoAgLib::iVtObject_c* const HUGE_MEM* objects, uint16_t numObjects, int8_t languageIndex, uint8_t version, bool keep );
+  static uint32_t transferFrames( uint32_t size, uint8_t packetsPerCts );
+
+  VtClientConnection_c& mrc_connection;
+  VtProperties_s ms_properties;
+  int8_t mi8_languageIndex;
+  uint32_t mui32_fixSize;
+  STL_NAMESPACE::vector<uint8_t> m_data;
+  STL_NAMESPACE::vector<uint8_t> m_scratch;
+  STL_NAMESPACE::vector<Object_s> m_objects;
+  STL_NAMESPACE::vector<uint32_t> m_languageSizes;
+
+  /** not copyable : copy constructor is only declared, never defined */
+  IopGenerator_c(const IopGenerator_c&);
+  /** not copyable : copy operator is only declared, never defined */
+  IopGenerator_c& operator=(const IopGenerator_c&);
+};
+
+
+} // __IsoAgLib
+
+#endif // USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
+
+#endif
@@ -28,9 +28,117 @@
 namespace __IsoAgLib {
 
 
+STL_NAMESPACE::list<SharedPoolImage_c*> SharedPoolImage_c::ms_images;
+
+
+bool
+SharedPoolImage_c::Key_s::operator==( const Key_s& rhs ) const
+{
+  // different pools may well carry the same version label
+  if( pool != rhs.pool )
+    return false;
+  for( unsigned i = 0; i < 7; ++i )
+  {
+    if( versionLabel[ i ] != rhs.versionLabel[ i ] )
+      return false;
+  }
+  return( ( phase == rhs.phase )
+       && ( uploadingVersion == rhs.uploadingVersion )
+       && ( hwGraphicType == rhs.hwGraphicType )
+       && ( hwWidth == rhs.hwWidth )
+       && ( hwHeight == rhs.hwHeight )
+       && ( skWidth == rhs.skWidth )
+       && ( skHeight == rhs.skHeight )
+       && ( fontSizes == rhs.fontSizes )
+       && ( size == rhs.size ) );
+}
+
+
+SharedPoolImage_c*
+SharedPoolImage_c::acquire( const Key_s& key )
+{
+  for( STL_NAMESPACE::list<SharedPoolImage_c*>::iterator iter = ms_images.begin(); iter != ms_images.end(); ++iter )
+  {
+    if( (*iter)->m_key == key )
+    {
+      ++(*iter)->m_refCount;
+      return *iter;
+    }
+  }
+
+  SharedPoolImage_c* image = new SharedPoolImage_c( key );
+  image->m_refCount = 1;
+  ms_images.push_back( image );
+  return image;
+}
+
+
+void
+SharedPoolImage_c::release( SharedPoolImage_c*& rp_image )
+{
+  if( rp_image == NULL )
+    return;
+
+  isoaglib_assert( rp_image->m_refCount > 0 );
+  if( --rp_image->m_refCount == 0 )
+  {
+    ms_images.remove( rp_image );
+    delete rp_image;
+  }
+  rp_image = NULL;
+}
+
+
+bool
+SharedPoolImage_c::build( const UploadPoolState_c& uploadPoolState, IsoAgLib::iVtObject_c* const HUGE_MEM* objects, uint16_t numObjects )
+{
+  isoaglib_assert( !mb_built );
+
+  m_data.resize( m_key.size );
+  m_data[ 0 ] = 0x11; // Upload Object Pool!
+  uint32_t pos = 1;
+
+  for( uint16_t curObject = 0; curObject < numObjects; ++curObject )
+  {
+    vtObject_c &object = *((vtObject_c*)(objects[ curObject ]));
+    if( uploadPoolState.dontUpload( object ) )
+      continue;
+
+    uint32_t objectStreamPosition = 0;
+    while( pos < m_key.size )
+    {
+      const uint32_t remaining = m_key.size - pos;
+      const uint16_t maxBytes = uint16_t( ( remaining > 0x7FFF ) ? 0x7FFF : remaining );
+      const uint16_t bytes2Buffer = object.stream( &m_data[ pos ], maxBytes, objectStreamPosition );
+      if( bytes2Buffer == 0 )
+        break;
+
+      pos += bytes2Buffer;
+      objectStreamPosition += bytes2Buffer;
+    }
+  }
+
+  if( pos != m_key.size )
+  { // streaming and fitting disagree - don't share anything then.
+    m_data.clear();
+    return false;
+  }
+
+  mb_built = true;
+  return true;
+}
+
+
 void
 ObjectPoolStreamer_c::setDataNextStreamPart (MultiSendPkg_c* mspData, uint8_t bytes)
 {
+  if (mpc_image != NULL)
+  { // already streamed, just copy out
+    mspData->setDataPart (mpc_image->data(), int32_t (mui32_imagePosition), bytes);
+    mui32_imagePosition += bytes;
+    return;
+  }
+
   while ((m_uploadBufferFilled-m_uploadBufferPosition) < bytes)
   {
     // copy down the rest of the buffer (we have no ring buffer here!)
@@ -74,6 +182,7 @@ ObjectPoolStreamer_c::resetDataNextStreamPart()
 {
   mpc_iterObjects = mpc_objectsToUpload;
   mui32_objectStreamPosition = 0;
+  mui32_imagePosition = 0;
   m_uploadBufferPosition = 0;
   m_uploadBufferFilled = 1;
   marr_uploadBuffer [0] = 0x11; // Upload Object Pool!
@@ -85,6 +194,7 @@ ObjectPoolStreamer_c::saveDataNextStreamPart()
 {
   mpc_iterObjectsStored = mpc_iterObjects;
   mui32_objectStreamPositionStored = mui32_objectStreamPosition;
+  mui32_imagePositionStored = mui32_imagePosition;
   m_uploadBufferPositionStored = m_uploadBufferPosition;
   m_uploadBufferFilledStored = m_uploadBufferFilled;
   for (int i=0; i<ISO_VT_UPLOAD_BUFFER_SIZE; i++)
@@ -97,6 +207,7 @@ ObjectPoolStreamer_c::restoreDataNextStreamPart()
 {
   mpc_iterObjects = mpc_iterObjectsStored;
   mui32_objectStreamPosition = mui32_objectStreamPositionStored;
+  mui32_imagePosition = mui32_imagePositionStored;
   m_uploadBufferPosition = m_uploadBufferPositionStored;
   m_uploadBufferFilled = m_uploadBufferFilledStored;
   for (int i=0; i<ISO_VT_UPLOAD_BUFFER_SIZE; i++)
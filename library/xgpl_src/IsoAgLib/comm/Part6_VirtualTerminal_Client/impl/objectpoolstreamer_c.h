@@ -23,9 +23,13 @@
 
 #include <IsoAgLib/comm/Part3_DataLink/imultisendstreamer_c.h>
 
+#include <list>
+#include <vector>
+
 
 namespace IsoAgLib {
   class iVtObject_c;
+  class iVtClientObjectPool_c;
 }
 
 
@@ -35,6 +39,62 @@ namespace __IsoAgLib {
 class UploadPoolState_c;
 
 
+/** Streamed (fitted) bytes of one object pool upload phase.
+  Shared between all connections uploading the same pool (same pool
+  object, version label and language) to VTs with identical capabilities, so that the
+  objects are streamed only once. The first user builds the image, the
+  others reference it. Reference counted, freed with the last user.
+*/
+class SharedPoolImage_c
+{
+public:
+  struct Key_s
+  {
+    const IsoAgLib::iVtClientObjectPool_c* pool;
+    char versionLabel[ 7 ];
+    uint8_t phase;
+    uint8_t uploadingVersion;
+    uint8_t hwGraphicType;
+    uint16_t hwWidth;
+    uint16_t hwHeight;
+    uint8_t skWidth;
+    uint8_t skHeight;
+    uint16_t fontSizes;
+    uint32_t size;
+
+    bool operator==( const Key_s& rhs ) const;
+  };
+
+  //! @return image for the given key, not yet built if it's the first user
+  static SharedPoolImage_c* acquire( const Key_s& key );
+  //! Drop a reference and reset the pointer. NULL is allowed.
+  static void release( SharedPoolImage_c*& rp_image );
+
+  //! Stream the given objects into the image.
+  //! @return false if the streamed size doesn't match the key's (fitted) size
+  bool build( const UploadPoolState_c& uploadPoolState, IsoAgLib::iVtObject_c* const HUGE_MEM* objects, uint16_t numObjects );
+
+  bool isBuilt() const { return mb_built; }
+  const Key_s& key() const { return m_key; }
+  const STL_NAMESPACE::vector<uint8_t>& data() const { return m_data; }
+
+private:
+  SharedPoolImage_c( const Key_s& key ) : m_key( key ), m_refCount( 0 ), mb_built( false ), m_data() {}
+
+  Key_s m_key;
+  unsigned m_refCount;
+  bool mb_built;
+  STL_NAMESPACE::vector<uint8_t> m_data;
+
+  static STL_NAMESPACE::list<SharedPoolImage_c*> ms_images;
+
+  /** not copyable : copy constructor is only declared, never defined */
+  SharedPoolImage_c(const SharedPoolImage_c&);
+  /** not copyable : copy operator is only declared, never defined */
+  SharedPoolImage_c& operator=(const SharedPoolImage_c&);
+};
+
+
 /** helper class for low level streaming.
   This function was excluded from VtClient_c,
   as some STL aware compilers don't support multiple inheritance
@@ -45,6 +105,9 @@ class ObjectPoolStreamer_c : public IsoAgLib::iMultiSendStreamer_c
 public:
   ObjectPoolStreamer_c( UploadPoolState_c& uploadPoolState )
     : m_uploadPoolState( uploadPoolState )
+    , mpc_image( NULL )
+    , mui32_imagePosition( 0 )
+    , mui32_imagePositionStored( 0 )
   {}
 
   virtual ~ObjectPoolStreamer_c() {}
@@ -58,6 +121,9 @@ public:
 
   void setStreamSize(uint32_t aui32_size) { mui32_size = aui32_size; }
 
+  //! Stream from a prebuilt image instead of the objects (NULL: stream objects)
+  void setImage(const SharedPoolImage_c* apc_image) { mpc_image = apc_image; }
+
 public:
   uint32_t mui32_objectStreamPosition;
   uint32_t mui32_objectStreamPositionStored;
@@ -79,6 +145,10 @@ public:
   uint8_t m_uploadBufferFilledStored;
   uint8_t m_uploadBufferPositionStored;
 
+  const SharedPoolImage_c* mpc_image;
+  uint32_t mui32_imagePosition;
+  uint32_t mui32_imagePositionStored;
+
 private:
   /** not copyable : copy constructor is only declared, never defined */
   ObjectPoolStreamer_c(const ObjectPoolStreamer_c&);
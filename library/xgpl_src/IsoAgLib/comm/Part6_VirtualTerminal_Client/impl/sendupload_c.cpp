@@ -34,6 +34,14 @@ const SendUpload_c& SendUpload_c::operator= (const SendUpload_c& r_source)
   mc_streamer = r_source.mc_streamer;
   ppc_vtObjects = r_source.ppc_vtObjects;
   ui16_numObjects = r_source.ui16_numObjects;
+
+  if (mp_sharedPayload != r_source.mp_sharedPayload)
+  {
+    releasePayload();
+    mp_sharedPayload = r_source.mp_sharedPayload;
+    if (mp_sharedPayload != NULL)
+      ++mp_sharedPayload->refCount;
+  }
   return r_source;
 }
 
@@ -43,6 +51,40 @@ SendUpload_c::~SendUpload_c()
   {
     delete mc_streamer;
   }
+  releasePayload();
+}
+
+void
+SendUpload_c::releasePayload()
+{
+  if (mp_sharedPayload != NULL)
+  {
+    if (--mp_sharedPayload->refCount == 0)
+      delete mp_sharedPayload;
+    mp_sharedPayload = NULL;
+  }
+}
+
+void
+SendUpload_c::clear()
+{
+  releasePayload();
+  vec_uploadBuffer.clear();
+  mc_streamer = NULL;
+  ppc_vtObjects = NULL;
+  ui16_numObjects = 0;
+}
+
+void
+SendUpload_c::share()
+{
+  if ((mp_sharedPayload != NULL) || (mc_streamer != NULL) || (vec_uploadBuffer.size() <= 8))
+    return;
+
+  mp_sharedPayload = new SharedPayload_s;
+  mp_sharedPayload->refCount = 1;
+  mp_sharedPayload->data.swap (vec_uploadBuffer);
+  vec_uploadBuffer.assign (mp_sharedPayload->data.begin(), mp_sharedPayload->data.begin() + 8);
 }
 
 void
@@ -50,6 +92,7 @@ SendUpload_c::setStreamer(const char* apc_newValue, uint16_t a_ID, uint16_t aui1
 {
   isoaglib_assert(mc_streamer == NULL);
 
+  releasePayload();
   ppc_vtObjects = NULL;
 
   mc_streamer = new vtObjectStringStreamer_c(apc_newValue, a_ID, aui16_strLenToSend);
@@ -58,6 +101,7 @@ SendUpload_c::setStreamer(const char* apc_newValue, uint16_t a_ID, uint16_t aui1
 void
 SendUpload_c::set (uint8_t byte1, uint8_t byte2, uint8_t byte3, uint8_t byte4, uint8_t byte5, uint8_t byte6, uint8_t byte7, uint8_t byte8, uint8_t byte9)
 {
+  releasePayload();
   SendUploadBase_c::set(byte1, byte2, byte3, byte4, byte5, byte6, byte7, byte8, byte9);
   mc_streamer = NULL;   /// Use BUFFER - NOT MultiSendStreamer!
   ppc_vtObjects = NULL; 
@@ -68,6 +112,7 @@ SendUpload_c::set (uint8_t byte1, uint8_t byte2, uint8_t byte3, uint8_t byte4, u
 void
 SendUpload_c::set (uint8_t byte1, uint8_t byte2, uint8_t byte3, uint8_t byte4, uint8_t byte5, uint8_t byte6, uint8_t byte7, uint8_t byte8, IsoAgLib::iVtObject_c** rppc_vtObjects, uint16_t aui16_numObjects)
 {
+  releasePayload();
   SendUploadBase_c::set( byte1, byte2, byte3, byte4, byte5, byte6, byte7, byte8 );
   mc_streamer = NULL;  /// Use BUFFER - NOT MultiSendStreamer!
   ppc_vtObjects = rppc_vtObjects;
@@ -114,6 +159,7 @@ SendUpload_c::set (uint16_t aui16_objId, const char* apc_string, uint16_t overri
 #endif
 
   /// Use BUFFER - NOT MultiSendStreamer!
+  releasePayload();
   vec_uploadBuffer.clear();
   vec_uploadBuffer.reserve (((5+strLen) < 8) ? 8 : (5+strLen)); // DO NOT USED an UploadBuffer < 8 as ECU->VT ALWAYS has 8 BYTES!
 
@@ -140,6 +186,7 @@ SendUpload_c::set (uint16_t aui16_objId, const char* apc_string, uint16_t overri
 void
 SendUpload_c::set (uint8_t* apui8_buffer, uint32_t bufferSize)
 {
+  releasePayload();
   SendUploadBase_c::set (apui8_buffer, bufferSize);
   mc_streamer = NULL;   /// Use BUFFER - NOT MultiSendStreamer!
   ppc_vtObjects = NULL;
@@ -33,6 +33,20 @@ namespace __IsoAgLib {
 class vtObjectStringStreamer_c;
 
 
+/** Reference counted payload of a queued command.
+  Commands that don't fit into a single CAN-Pkg are moved into this block
+  when being queued, so that all copies of the SendUpload_c (queue entry,
+  replaced entry, the same command queued for several VT connections)
+  reference the same data instead of duplicating it.
+  The data is never modified while shared; set() detaches instead.
+*/
+struct SharedPayload_s
+{
+  STL_NAMESPACE::vector<uint8_t> data;
+  unsigned refCount;
+};
+
+
 class SendUpload_c : public SendUploadBase_c
 {
 public:
@@ -41,6 +55,7 @@ public:
     , mc_streamer(NULL)
     , ppc_vtObjects (NULL)
     , ui16_numObjects (0)
+    , mp_sharedPayload (NULL)
   {}
 
   SendUpload_c (uint8_t byte1, uint8_t byte2, uint8_t byte3, uint8_t byte4, uint8_t byte5, uint8_t byte6, uint8_t byte7, uint8_t byte8, IsoAgLib::iVtObject_c** rppc_vtObjects, uint16_t aui16_numObjects)
@@ -48,6 +63,7 @@ public:
     , mc_streamer(NULL)  /// Use BUFFER - NOT MultiSendStreamer!
     , ppc_vtObjects (rppc_vtObjects)
     , ui16_numObjects (aui16_numObjects)
+    , mp_sharedPayload (NULL)
   {}
 
   SendUpload_c (uint8_t* apui8_buffer, uint32_t bufferSize)
@@ -55,6 +71,7 @@ public:
     , mc_streamer(NULL)   /// Use BUFFER - NOT MultiSendStreamer!
     , ppc_vtObjects (NULL)
     , ui16_numObjects (0)
+    , mp_sharedPayload (NULL)
   {}
 
   void set (uint8_t byte1, uint8_t byte2, uint8_t byte3, uint8_t byte4, uint8_t byte5, uint8_t byte6, uint8_t byte7, uint8_t byte8, uint8_t byte9);
@@ -66,6 +83,17 @@ public:
 #endif
   void set (uint8_t* apui8_buffer, uint32_t bufferSize);
 
+  //! Empty the buffer for direct filling of vec_uploadBuffer (detaches from a shared payload).
+  void clear();
+
+  //! Move a multi-packet buffer into a shared payload (no-op if already shared or single-packet).
+  //! vec_uploadBuffer keeps the first 8 bytes for the command replacement check.
+  void share();
+
+  //! Complete command data, regardless of being shared or not.
+  const uint8_t* payloadData() const { return mp_sharedPayload ? &mp_sharedPayload->data.front() : &vec_uploadBuffer.front(); }
+  uint32_t payloadSize() const { return uint32_t( mp_sharedPayload ? mp_sharedPayload->data.size() : vec_uploadBuffer.size() ); }
+
   // special functions for streamer. Attention: Will allocate dynamic streamer object!
   void setStreamer(const char* apc_newValue, uint16_t a_ID, uint16_t aui16_strLenToSend);
   inline void unsetStreamer() { mc_streamer = NULL; };
@@ -75,7 +103,11 @@ public:
     , mc_streamer(r_source.mc_streamer)
     , ppc_vtObjects (r_source.ppc_vtObjects)
     , ui16_numObjects (r_source.ui16_numObjects)
-  {}
+    , mp_sharedPayload (r_source.mp_sharedPayload)
+  {
+    if (mp_sharedPayload != NULL)
+      ++mp_sharedPayload->refCount;
+  }
 
   ~SendUpload_c();
 
@@ -86,6 +118,11 @@ public:
 
   IsoAgLib::iVtObject_c** ppc_vtObjects;
   uint16_t ui16_numObjects; // don't care for if "ppc_vtObjects==NULL"
+
+private:
+  void releasePayload();
+
+  SharedPayload_s* mp_sharedPayload;
 };
 
 
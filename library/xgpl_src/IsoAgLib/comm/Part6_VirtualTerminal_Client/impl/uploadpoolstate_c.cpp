@@ -20,6 +20,7 @@
 #include "uploadpoolstate_c.h"
 #include <IsoAgLib/comm/Part3_DataLink/impl/stream_c.h>
 #include <IsoAgLib/comm/Part6_VirtualTerminal_Client/impl/vtclientconnection_c.h>
+#include <IsoAgLib/comm/Part6_VirtualTerminal_Client/impl/vtclient_c.h>
 #include <IsoAgLib/comm/Part6_VirtualTerminal_Client/impl/vtserverinstance_c.h>
 #include <IsoAgLib/comm/Part6_VirtualTerminal_Client/ivtclientobjectpool_c.h>
 #include <IsoAgLib/comm/Part6_VirtualTerminal_Client/ivtobjectworkingset_c.h>
@@ -53,6 +54,7 @@ UploadPoolState_c::UploadPoolState_c(
   //marrp7c_versionLabel[ 7 ] body!
   , m_uploadingVersion( 0 )
   , mc_iVtObjectStreamer( *this )
+  , mp_poolImage( NULL )
   , men_uploadPoolState( UploadPoolEndSuccess ) // default for Slaves!
   , men_uploadPoolType( UploadPoolTypeCompleteInitially ) // dummy
   , mi32_uploadTimestamp( 0 )
@@ -92,6 +94,7 @@ UploadPoolState_c::~UploadPoolState_c()
 {
   men_uploadPoolState = UploadPoolDestructing;
   getMultiSendInstance( m_connection.getMultitonInst() ).abortSend( *this );
+  releasePoolImage();
 }
 
 
@@ -376,6 +379,8 @@ UploadPoolState_c::handleLoadVersionResponse( unsigned errorNibble )
 void
 UploadPoolState_c::uploadFailed( UploadError aen_uploadError )
 {
+  releasePoolImage();
+
   IsoAgLib::iVtClientObjectPool_c::UploadErrorData poolUpLoadErrorData(IsoAgLib::iVtClientObjectPool_c::UploadError_NoError,
                                                                        m_connection.getVtServerInst().getIsoName().funcInst());
   
@@ -562,9 +567,16 @@ UploadPoolState_c::startLoadVersion()
 
 bool
 UploadPoolState_c::dontUpload( const vtObject_c& object ) const
+{
+  return dontUpload( object, m_uploadingVersion );
+}
+
+
+bool
+UploadPoolState_c::dontUpload( const vtObject_c& object, uint8_t uploadingVersion )
 {
   return( object.isOmittedFromUpload()
-       || ((m_uploadingVersion == 2) && (object.getObjectType() >= VT_OBJECT_TYPE_AUXILIARY_FUNCTION_2) && (object.getObjectType() <= VT_OBJECT_TYPE_AUXILIARY_POINTER) ) );
+       || ((uploadingVersion == 2) && (object.getObjectType() >= VT_OBJECT_TYPE_AUXILIARY_FUNCTION_2) && (object.getObjectType() <= VT_OBJECT_TYPE_AUXILIARY_POINTER) ) );
 }
 
 
@@ -760,6 +772,8 @@ UploadPoolState_c::indicateUploadCompletion()
 void
 UploadPoolState_c::indicateUploadPhaseCompletion()
 {
+  releasePoolImage();
+
   if (men_uploadPoolType == UploadPoolTypeUserPoolUpdate)
   { // we only have one part, so we're done!
     mc_iVtObjectStreamer.mpc_objectsToUpload = NULL; // just for proper cleanup.
@@ -788,6 +802,7 @@ UploadPoolState_c::startCurrentUploadPhase()
   {
   case UploadPoolTypeUserPoolUpdate:
     streamer = ms_uploadPhaseUser.pc_streamer;
+    releasePoolImage(); // partial updates are always streamed directly
     mc_iVtObjectStreamer.mpc_objectsToUpload = mppc_uploadPhaseUserObjects;
     mc_iVtObjectStreamer.setStreamSize (ms_uploadPhaseUser.ui32_size);
     break;
@@ -816,6 +831,7 @@ UploadPoolState_c::startCurrentUploadPhase()
       case UploadPhaseIVtObjectsFix:
         mc_iVtObjectStreamer.mpc_objectsToUpload = m_pool.getIVtObjects()[0]; // main FIX (lang. indep) iVtObject part
         mc_iVtObjectStreamer.setStreamSize (ms_uploadPhasesAutomatic [mui_uploadPhaseAutomatic].ui32_size);
+        attachPoolImage (m_pool.getIVtObjects()[0], m_pool.getNumObjects(), ms_uploadPhasesAutomatic [mui_uploadPhaseAutomatic].ui32_size);
         break;
 
       case UploadPhaseIVtObjectsLang:
@@ -823,6 +839,7 @@ UploadPoolState_c::startCurrentUploadPhase()
         const int8_t realUploadingLanguageAsIndex = calcRealUploadingLanguage( true ) + 1; // skip language-independent objects.
         mc_iVtObjectStreamer.mpc_objectsToUpload = m_pool.getIVtObjects()[ realUploadingLanguageAsIndex ];
         mc_iVtObjectStreamer.setStreamSize (ms_uploadPhasesAutomatic [mui_uploadPhaseAutomatic].ui32_size);
+        attachPoolImage (m_pool.getIVtObjects()[ realUploadingLanguageAsIndex ], m_pool.getNumObjectsLang(), ms_uploadPhasesAutomatic [mui_uploadPhaseAutomatic].ui32_size);
       } break;
 
       case UploadPhaseAppSpecificFix:
@@ -841,6 +858,69 @@ UploadPoolState_c::startCurrentUploadPhase()
 }
 
 
+/** Use a shared streamed image for the current automatic upload phase
+    if other connections upload the same pool (identified by its version label)
+    to VTs with the same capabilities. Without version label or with only
+    one connection the objects are streamed directly as before.
+  */
+void
+UploadPoolState_c::attachPoolImage( IsoAgLib::iVtObject_c* const HUGE_MEM* objects, uint16_t numObjects, uint32_t size )
+{
+#if CONFIG_VT_CLIENT_SHARED_POOL_IMAGE
+  if( ( mp_poolImage != NULL ) && mp_poolImage->isBuilt() && ( mp_poolImage->key().size == size )
+   && ( mp_poolImage->key().phase == uint8_t( mui_uploadPhaseAutomatic ) ) )
+  { // re-start of the same phase (e.g. after abort): keep the image
+    mc_iVtObjectStreamer.setImage( mp_poolImage );
+    return;
+  }
+#endif
+
+  releasePoolImage();
+
+#if CONFIG_VT_CLIENT_SHARED_POOL_IMAGE
+  if( !mb_usingVersionLabel || ( getVtClientInstance( m_connection.getMultitonInst() ).getClientCount() < 2 ) )
+    return;
+
+  const VtServerInstance_c::vtCapabilities_s &caps = m_connection.getVtServerInst().getConstVtCapabilities();
+
+  SharedPoolImage_c::Key_s key;
+  key.pool = &m_pool;
+  for( unsigned i = 0; i < 7; ++i )
+    key.versionLabel[ i ] = marrp7c_versionLabel[ i ];
+  key.phase = uint8_t( mui_uploadPhaseAutomatic );
+  key.uploadingVersion = m_uploadingVersion;
+  key.hwGraphicType = caps.hwGraphicType;
+  key.hwWidth = caps.hwWidth;
+  key.hwHeight = caps.hwHeight;
+  key.skWidth = caps.skWidth;
+  key.skHeight = caps.skHeight;
+  key.fontSizes = caps.fontSizes;
+  key.size = size;
+
+  mp_poolImage = SharedPoolImage_c::acquire( key );
+  if( !mp_poolImage->isBuilt() && !mp_poolImage->build( *this, objects, numObjects ) )
+  {
+    SharedPoolImage_c::release( mp_poolImage );
+    return;
+  }
+
+  mc_iVtObjectStreamer.setImage( mp_poolImage );
+#else
+  (void)objects;
+  (void)numObjects;
+  (void)size;
+#endif
+}
+
+
+void
+UploadPoolState_c::releasePoolImage()
+{
+  mc_iVtObjectStreamer.setImage( NULL );
+  SharedPoolImage_c::release( mp_poolImage );
+}
+
+
 void
 UploadPoolState_c::setObjectPoolUploadingLanguage()
 {
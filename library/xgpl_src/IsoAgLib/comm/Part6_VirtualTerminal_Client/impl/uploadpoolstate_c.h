@@ -120,6 +120,7 @@ namespace __IsoAgLib {
 
     uint32_t fitTerminalWrapper( const vtObject_c& object ) const;
     bool dontUpload( const vtObject_c& object ) const;
+    static bool dontUpload( const vtObject_c& object, uint8_t uploadingVersion );
 
     bool activeAuxN() const;
     bool activeAuxO() const;
@@ -167,6 +168,9 @@ namespace __IsoAgLib {
 
     void uploadFailed( UploadError aen_uploadError );
 
+    void attachPoolImage( IsoAgLib::iVtObject_c* const HUGE_MEM* objects, uint16_t numObjects, uint32_t size );
+    void releasePoolImage();
+
     // MultiSendEventHandler_c
     virtual void reactOnStateChange( const SendStream_c& );
 
@@ -179,6 +183,7 @@ namespace __IsoAgLib {
 
     uint8_t m_uploadingVersion; // if uploading a v3 client to a v2 VT (without Aux2), uploadingVersion will be v2
     ObjectPoolStreamer_c mc_iVtObjectStreamer;
+    SharedPoolImage_c* mp_poolImage; // streamed image of the current phase, shared with other connections
     UploadPoolState_t men_uploadPoolState;
     UploadPoolType_t men_uploadPoolType;
 
@@ -222,6 +227,7 @@ namespace __IsoAgLib {
   inline void
   UploadPoolState_c::doStop()
   {
+    releasePoolImage();
     men_uploadPoolState = UploadPoolInit;
   }
 
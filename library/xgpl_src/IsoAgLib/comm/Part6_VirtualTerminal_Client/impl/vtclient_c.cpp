@@ -316,6 +316,24 @@ VtClient_c::sendCommandForDEBUG(IsoAgLib::iIdentItem_c& mrc_wsMasterIdentItem, u
 }
 
 
+unsigned
+VtClient_c::sendCommandToAllConnections(uint8_t* apui8_buffer, uint32_t ui32_size, bool b_enableReplaceOfCmd)
+{
+  SendUpload_c sendUpload;
+  sendUpload.set (apui8_buffer, ui32_size);
+  sendUpload.share();
+
+  unsigned queued = 0;
+  for (unsigned index = 0; index < m_vtConnections.size(); index++)
+  {
+    if( ( m_vtConnections[index] != NULL ) &&
+        m_vtConnections[index]->commandHandler().queueOrReplace (sendUpload, b_enableReplaceOfCmd) )
+      ++queued;
+  }
+  return queued;
+}
+
+
 void
 VtClient_c::notifyAllConnectionsOnAux1InputStatus( const CanPkgExt_c& refc_data ) const
 {
@@ -64,6 +64,10 @@ public:
 
   bool sendCommandForDEBUG(IsoAgLib::iIdentItem_c& apc_wsMasterIdentItem, uint8_t* apui8_buffer, uint32_t ui32_size);
 
+  /** queue the same command on all connections, the payload is only held once.
+      @return number of connections the command was queued for */
+  unsigned sendCommandToAllConnections(uint8_t* apui8_buffer, uint32_t ui32_size, bool b_enableReplaceOfCmd=false);
+
   VtClientConnection_c& getClientByID (uint8_t ui8_clientIndex) { return *m_vtConnections[ui8_clientIndex]; }
   VtClientConnection_c* getClientPtrByID (uint8_t ui8_clientIndex) { return ( ui8_clientIndex < m_vtConnections.size() ) ? m_vtConnections[ui8_clientIndex] : NULL; }
 
@@ -71,6 +75,7 @@ public:
   // is any claimed VT sending VT status
   bool isAnyVtActive( bool mustBePrimary ) const { return (getActiveVtServer( mustBePrimary, NULL ) != NULL); }
   uint16_t getActiveVtCount() const { return m_serverManager.getActiveVtCount(); }
+  uint16_t getClientCount() const;
 
   void notifyAllConnectionsOnAux1InputStatus( const CanPkgExt_c& refc_data ) const;
   void notifyAllConnectionsOnAux2InputStatus( const CanPkgExt_c& refc_data ) const;
@@ -88,18 +93,8 @@ public:
   ////////////////////////
   // INTERFACE FUNTIONS //
   ////////////////////////
-// the following define should be globally defined in the project settings...
-// (currently not supported, due to multi VT enhancements)
-#if 0
-#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
-  void fakeVtProperties (uint16_t aui16_dimension, uint16_t aui16_skWidth, uint16_t aui16_skHeight, uint8_t aui16_colorDepth, uint16_t aui16_fontSizes)
-  { m_serverManager.fakeVtProperties(aui16_dimension, aui16_skWidth, aui16_skHeight, aui16_colorDepth, aui16_fontSizes, *this); }
-#endif
-#endif
 
 private:
-  uint16_t getClientCount() const;
-
   class CanCustomerProxy_c : public CanCustomer_c {
   public:
     typedef VtClient_c Owner_t;
@@ -234,6 +234,10 @@ private:
 
   IsoAgLib::iVtClientDataStorage_c& m_dataStorageHandler;
 
+#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
+  friend class IopGenerator_c; // attaches its dummy VT while streaming
+#endif
+
   CLASS_SCHEDULER_TASK_PROXY(VtClientConnection_c)
 
   SchedulerTaskProxy_c m_schedulerTaskProxy;
@@ -30,6 +30,8 @@
 #include <IsoAgLib/util/convert.h>
 #include <IsoAgLib/util/iassert.h>
 
+#include <vector>
+
 // Make sure not such macro is used.
 #undef MACRO_vtObjectTypeA
 #undef MACRO_vtObjectTypeS
@@ -97,7 +99,537 @@ vtObjectGraphicsContext_c::stream(uint8_t* destMemory, uint16_t maxBytes, objRan
   return 0;
 }
 
-vtObjectGraphicsContext_c::vtObjectGraphicsContext_c() {}
+/** Locally recorded Graphics Context commands.
+    While recording, the VT-side state (graphics cursor, colours and
+    attribute objects) resulting from the recorded commands is tracked,
+    so that commands without visible effect can be dropped:
+    - setting a cursor/colour/attribute to the value it already has
+    - a set-command directly superseded by another one of the same kind
+    - consecutive viewport pan/zoom/resize commands
+    Consecutive drawLine commands are merged into one open Draw Polygon
+    command (a polyline), which is sent as one TP transfer instead of one
+    command (and VT response) per line segment. */
+class vtObjectGraphicsContext_c::DisplayList_c
+{
+public:
+  //! Maximum number of points merged into one polygon (~1 kB of TP payload).
+  static const uint16_t scui16_maxMergedPoints = 255;
+
+  struct Op_s
+  {
+    uint8_t cmdID;
+    uint8_t type;       //!< text type for Draw Text
+    int16_t x;          //!< position/size or colour value
+    int16_t y;
+    float zoom;
+    const IsoAgLib::iVtObject_c* object;
+    uint32_t offset;    //!< first point in m_pointsX/m_pointsY or first character in m_text
+    uint16_t count;     //!< number of points/characters
+  };
+
+  DisplayList_c()
+    : mb_recording( false )
+    , m_ops()
+    , m_pointsX()
+    , m_pointsY()
+    , m_text()
+    , mb_runOpen( false )
+    , mi16_runStartX( 0 )
+    , mi16_runStartY( 0 )
+    , mb_dirty( false )
+    , mi16_dirtyX1( 0 )
+    , mi16_dirtyY1( 0 )
+    , mi16_dirtyX2( 0 )
+    , mi16_dirtyY2( 0 )
+  {
+    resetState();
+  }
+
+  bool isRecording() const { return mb_recording; }
+  uint16_t size() const { return uint16_t( m_ops.size() ); }
+
+  void begin()
+  {
+    clear();
+    resetState();
+    mb_recording = true;
+  }
+
+  void clear()
+  {
+    m_ops.clear();
+    m_pointsX.clear();
+    m_pointsY.clear();
+    m_text.clear();
+    mb_runOpen = false;
+    mb_recording = false;
+  }
+
+  void flush( vtObjectGraphicsContext_c& arc_gc, CommandHandler_c& rc_cmd );
+
+  void record( uint8_t aui8_cmdID, int16_t ai16_x = 0, int16_t ai16_y = 0 )
+  {
+    Op_s s_op = newOp( aui8_cmdID );
+    s_op.x = ai16_x;
+    s_op.y = ai16_y;
+    append( s_op );
+  }
+
+  void recordObject( uint8_t aui8_cmdID, const IsoAgLib::iVtObject_c* apc_object )
+  {
+    Op_s s_op = newOp( aui8_cmdID );
+    s_op.object = apc_object;
+    append( s_op );
+  }
+
+  void recordZoom( uint8_t aui8_cmdID, int16_t ai16_x, int16_t ai16_y, float af_zoom )
+  {
+    Op_s s_op = newOp( aui8_cmdID );
+    s_op.x = ai16_x;
+    s_op.y = ai16_y;
+    s_op.zoom = af_zoom;
+    append( s_op );
+  }
+
+  void recordPolygon( uint16_t aui16_cnt, const int16_t* api16_x, const int16_t* api16_y )
+  {
+    if( ( 0 == aui16_cnt ) || ( 0 == api16_x ) || ( 0 == api16_y ) )
+      return;
+
+    Op_s s_op = newOp( e_drawPolygonCmdID );
+    s_op.offset = uint32_t( m_pointsX.size() );
+    s_op.count = aui16_cnt;
+    m_pointsX.insert( m_pointsX.end(), api16_x, api16_x + aui16_cnt );
+    m_pointsY.insert( m_pointsY.end(), api16_y, api16_y + aui16_cnt );
+    s_op.x = api16_x[ aui16_cnt - 1 ];
+    s_op.y = api16_y[ aui16_cnt - 1 ];
+    append( s_op );
+  }
+
+  void recordText( uint8_t aui8_type, uint8_t aui8_cnt, const char* apc_string )
+  {
+    Op_s s_op = newOp( e_drawTextCmdID );
+    s_op.type = aui8_type;
+    s_op.offset = uint32_t( m_text.size() );
+    s_op.count = aui8_cnt;
+    if( apc_string )
+      m_text.insert( m_text.end(), apc_string, apc_string + aui8_cnt );
+    else
+      m_text.insert( m_text.end(), aui8_cnt, ' ' );
+    append( s_op );
+  }
+
+  void invalidate( int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2 );
+  bool getDirty( int16_t& ri16_x1, int16_t& ri16_y1, int16_t& ri16_x2, int16_t& ri16_y2 ) const;
+  bool intersectsDirty( int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2 ) const;
+  void clearDirty() { mb_dirty = false; }
+
+private:
+  static Op_s newOp( uint8_t aui8_cmdID )
+  {
+    Op_s s_op;
+    s_op.cmdID = aui8_cmdID;
+    s_op.type = 0;
+    s_op.x = 0;
+    s_op.y = 0;
+    s_op.zoom = 0.0F;
+    s_op.object = NULL;
+    s_op.offset = 0;
+    s_op.count = 0;
+    return s_op;
+  }
+
+  void resetState()
+  {
+    mb_cursorKnown = false;
+    mi16_cursorX = 0;
+    mi16_cursorY = 0;
+    for( unsigned i = 0; i < AttrCount; ++i )
+    {
+      mab_attrKnown[ i ] = false;
+      mai16_attrColour[ i ] = 0;
+      mapc_attrObject[ i ] = NULL;
+    }
+  }
+
+  //! Index of the set-command's state slot, AttrCount for non set-commands.
+  static unsigned attrIndex( uint8_t aui8_cmdID )
+  {
+    switch( aui8_cmdID )
+    {
+      case e_setForegroundColourCmdID: return AttrForeground;
+      case e_setBackgroundColourCmdID: return AttrBackground;
+      case e_setLineAttributeCmdID:    return AttrLine;
+      case e_setFillAttributeCmdID:    return AttrFill;
+      case e_setFontAttributeCmdID:    return AttrFont;
+      default:                         return AttrCount;
+    }
+  }
+
+  static bool isViewportCmd( uint8_t aui8_cmdID )
+  {
+    return ( aui8_cmdID == e_panViewportCmdID )
+        || ( aui8_cmdID == e_zoomViewportCmdID )
+        || ( aui8_cmdID == e_panAndZoomViewportCmdID )
+        || ( aui8_cmdID == e_changeViewportSizeCmdID );
+  }
+
+  void append( const Op_s& arc_op );
+
+  enum Attr_t { AttrForeground, AttrBackground, AttrLine, AttrFill, AttrFont, AttrCount };
+
+  bool mb_recording;
+  STL_NAMESPACE::vector<Op_s> m_ops;
+  STL_NAMESPACE::vector<int16_t> m_pointsX;
+  STL_NAMESPACE::vector<int16_t> m_pointsY;
+  STL_NAMESPACE::vector<char> m_text;
+
+  // VT-side state after the recorded commands
+  bool mb_cursorKnown;
+  int16_t mi16_cursorX;
+  int16_t mi16_cursorY;
+  bool mab_attrKnown[ AttrCount ];
+  int16_t mai16_attrColour[ AttrCount ];
+  const IsoAgLib::iVtObject_c* mapc_attrObject[ AttrCount ];
+
+  // the last recorded op is a polyline that may be continued
+  bool mb_runOpen;
+  int16_t mi16_runStartX;
+  int16_t mi16_runStartY;
+
+  // application maintained dirty rectangle
+  bool mb_dirty;
+  int16_t mi16_dirtyX1;
+  int16_t mi16_dirtyY1;
+  int16_t mi16_dirtyX2;
+  int16_t mi16_dirtyY2;
+};
+
+
+void
+vtObjectGraphicsContext_c::DisplayList_c::append( const Op_s& arc_op )
+{
+  const bool cb_startKnown = mb_cursorKnown;
+  const int16_t ci16_startX = mi16_cursorX;
+  const int16_t ci16_startY = mi16_cursorY;
+  const unsigned cui_attr = attrIndex( arc_op.cmdID );
+
+  // drop commands not changing anything
+  if( arc_op.cmdID == e_setGraphicsCursorCmdID )
+  {
+    if( mb_cursorKnown && ( mi16_cursorX == arc_op.x ) && ( mi16_cursorY == arc_op.y ) )
+      return;
+  }
+  else if( cui_attr < AttrCount )
+  {
+    if( mab_attrKnown[ cui_attr ]
+        && ( mai16_attrColour[ cui_attr ] == arc_op.x )
+        && ( mapc_attrObject[ cui_attr ] == arc_op.object ) )
+      return;
+  }
+
+  // update tracked state
+  switch( arc_op.cmdID )
+  {
+    case e_setGraphicsCursorCmdID:
+    case e_eraseRectangleCmdID:
+    case e_drawLineCmdID:
+    case e_drawRectangleCmdID:
+    case e_drawClosedEllipseCmdID:
+    case e_drawPolygonCmdID:
+      mb_cursorKnown = true;
+      mi16_cursorX = arc_op.x;
+      mi16_cursorY = arc_op.y;
+      break;
+
+    case e_drawTextCmdID:
+    case e_drawVTObjectCmdID:
+      // extent depends on VT font/object rendering
+      mb_cursorKnown = false;
+      break;
+
+    default:
+      if( cui_attr < AttrCount )
+      {
+        mab_attrKnown[ cui_attr ] = true;
+        mai16_attrColour[ cui_attr ] = arc_op.x;
+        mapc_attrObject[ cui_attr ] = arc_op.object;
+      }
+      break;
+  }
+
+  if( !m_ops.empty() )
+  {
+    Op_s& rs_last = m_ops.back();
+
+    // directly superseded set-command / viewport change
+    if( ( rs_last.cmdID == arc_op.cmdID )
+        && ( ( arc_op.cmdID == e_setGraphicsCursorCmdID ) || ( cui_attr < AttrCount ) || isViewportCmd( arc_op.cmdID ) ) )
+    {
+      rs_last = arc_op;
+      return;
+    }
+
+    // continue the open polyline, but never close it (would enable filling)
+    if( ( arc_op.cmdID == e_drawLineCmdID )
+        && mb_runOpen
+        && ( rs_last.count < scui16_maxMergedPoints )
+        && !( ( arc_op.x == mi16_runStartX ) && ( arc_op.y == mi16_runStartY ) ) )
+    {
+      m_pointsX.push_back( arc_op.x );
+      m_pointsY.push_back( arc_op.y );
+      ++rs_last.count;
+      rs_last.x = arc_op.x;
+      rs_last.y = arc_op.y;
+      return;
+    }
+  }
+
+  if( ( arc_op.cmdID == e_drawLineCmdID ) && cb_startKnown
+      && !( ( arc_op.x == ci16_startX ) && ( arc_op.y == ci16_startY ) ) )
+  { // start a new polyline run
+    Op_s s_run = arc_op;
+    s_run.cmdID = e_drawPolygonCmdID;
+    s_run.offset = uint32_t( m_pointsX.size() );
+    s_run.count = 1;
+    m_pointsX.push_back( arc_op.x );
+    m_pointsY.push_back( arc_op.y );
+    m_ops.push_back( s_run );
+    mb_runOpen = true;
+    mi16_runStartX = ci16_startX;
+    mi16_runStartY = ci16_startY;
+    return;
+  }
+
+  m_ops.push_back( arc_op );
+  mb_runOpen = false;
+}
+
+
+void
+vtObjectGraphicsContext_c::DisplayList_c::flush( vtObjectGraphicsContext_c& arc_gc, CommandHandler_c& rc_cmd )
+{
+  for( STL_NAMESPACE::vector<Op_s>::const_iterator iter = m_ops.begin(); iter != m_ops.end(); ++iter )
+  {
+    const Op_s& s_op = *iter;
+    switch( s_op.cmdID )
+    {
+      case e_setGraphicsCursorCmdID:
+        rc_cmd.sendCommandSetGraphicsCursor( &arc_gc, s_op.x, s_op.y, false );
+        break;
+      case e_setForegroundColourCmdID:
+        rc_cmd.sendCommandSetForegroundColour( &arc_gc, uint8_t( s_op.x ), false );
+        break;
+      case e_setBackgroundColourCmdID:
+        rc_cmd.sendCommandSetBackgroundColour( &arc_gc, uint8_t( s_op.x ), false );
+        break;
+      case e_setLineAttributeCmdID:
+        rc_cmd.sendCommandSetGCLineAttributes( &arc_gc, static_cast<const IsoAgLib::iVtObjectLineAttributes_c*>( s_op.object ), false );
+        break;
+      case e_setFillAttributeCmdID:
+        rc_cmd.sendCommandSetGCFillAttributes( &arc_gc, static_cast<const IsoAgLib::iVtObjectFillAttributes_c*>( s_op.object ), false );
+        break;
+      case e_setFontAttributeCmdID:
+        rc_cmd.sendCommandSetGCFontAttributes( &arc_gc, static_cast<const IsoAgLib::iVtObjectFontAttributes_c*>( s_op.object ), false );
+        break;
+      case e_eraseRectangleCmdID:
+        rc_cmd.sendCommandEraseRectangle( &arc_gc, s_op.x, s_op.y, false );
+        break;
+      case e_drawPointCmdID:
+        rc_cmd.sendCommandDrawPoint( &arc_gc, false );
+        break;
+      case e_drawLineCmdID:
+        rc_cmd.sendCommandDrawLine( &arc_gc, s_op.x, s_op.y, false );
+        break;
+      case e_drawRectangleCmdID:
+        rc_cmd.sendCommandDrawRectangle( &arc_gc, s_op.x, s_op.y, false );
+        break;
+      case e_drawClosedEllipseCmdID:
+        rc_cmd.sendCommandDrawClosedEllipse( &arc_gc, s_op.x, s_op.y, false );
+        break;
+      case e_drawPolygonCmdID:
+        if( s_op.count == 1 )
+          rc_cmd.sendCommandDrawLine( &arc_gc, s_op.x, s_op.y, false );
+        else
+          rc_cmd.sendCommandDrawPolygon( &arc_gc, s_op.count, &m_pointsX[ s_op.offset ], &m_pointsY[ s_op.offset ], false );
+        break;
+      case e_drawTextCmdID:
+        rc_cmd.sendCommandDrawText( &arc_gc, s_op.type, uint8_t( s_op.count ), ( s_op.count > 0 ) ? &m_text[ s_op.offset ] : "", false );
+        break;
+      case e_panViewportCmdID:
+        rc_cmd.sendCommandPanViewport( &arc_gc, s_op.x, s_op.y, false );
+        break;
+      case e_zoomViewportCmdID:
+        rc_cmd.sendCommandZoomViewport( &arc_gc, s_op.zoom, false );
+        break;
+      case e_panAndZoomViewportCmdID:
+        rc_cmd.sendCommandPanAndZoomViewport( &arc_gc, s_op.x, s_op.y, s_op.zoom, false );
+        break;
+      case e_changeViewportSizeCmdID:
+        rc_cmd.sendCommandChangeViewportSize( &arc_gc, uint16_t( s_op.x ), uint16_t( s_op.y ), false );
+        break;
+      case e_drawVTObjectCmdID:
+        rc_cmd.sendCommandDrawVtObject( &arc_gc, s_op.object, false );
+        break;
+      case e_copyCanvasToPictureGraphicCmdID:
+        rc_cmd.sendCommandCopyCanvas2PictureGraphic( &arc_gc, static_cast<const IsoAgLib::iVtObjectPictureGraphic_c*>( s_op.object ), false );
+        break;
+      case e_copyViewportToPictureGraphicCmdID:
+        rc_cmd.sendCommandCopyViewport2PictureGraphic( &arc_gc, static_cast<const IsoAgLib::iVtObjectPictureGraphic_c*>( s_op.object ), false );
+        break;
+      default:
+        isoaglib_assert( !"unknown Graphics Context command in display list" );
+        break;
+    }
+  }
+
+  clear();
+}
+
+
+void
+vtObjectGraphicsContext_c::DisplayList_c::invalidate( int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2 )
+{
+  if( ai16_x1 > ai16_x2 ) { const int16_t t = ai16_x1; ai16_x1 = ai16_x2; ai16_x2 = t; }
+  if( ai16_y1 > ai16_y2 ) { const int16_t t = ai16_y1; ai16_y1 = ai16_y2; ai16_y2 = t; }
+
+  if( !mb_dirty )
+  {
+    mb_dirty = true;
+    mi16_dirtyX1 = ai16_x1;
+    mi16_dirtyY1 = ai16_y1;
+    mi16_dirtyX2 = ai16_x2;
+    mi16_dirtyY2 = ai16_y2;
+    return;
+  }
+
+  if( ai16_x1 < mi16_dirtyX1 ) mi16_dirtyX1 = ai16_x1;
+  if( ai16_y1 < mi16_dirtyY1 ) mi16_dirtyY1 = ai16_y1;
+  if( ai16_x2 > mi16_dirtyX2 ) mi16_dirtyX2 = ai16_x2;
+  if( ai16_y2 > mi16_dirtyY2 ) mi16_dirtyY2 = ai16_y2;
+}
+
+
+bool
+vtObjectGraphicsContext_c::DisplayList_c::getDirty( int16_t& ri16_x1, int16_t& ri16_y1, int16_t& ri16_x2, int16_t& ri16_y2 ) const
+{
+  if( !mb_dirty )
+    return false;
+
+  ri16_x1 = mi16_dirtyX1;
+  ri16_y1 = mi16_dirtyY1;
+  ri16_x2 = mi16_dirtyX2;
+  ri16_y2 = mi16_dirtyY2;
+  return true;
+}
+
+
+bool
+vtObjectGraphicsContext_c::DisplayList_c::intersectsDirty( int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2 ) const
+{
+  if( !mb_dirty )
+    return false;
+
+  if( ai16_x1 > ai16_x2 ) { const int16_t t = ai16_x1; ai16_x1 = ai16_x2; ai16_x2 = t; }
+  if( ai16_y1 > ai16_y2 ) { const int16_t t = ai16_y1; ai16_y1 = ai16_y2; ai16_y2 = t; }
+
+  return ( ai16_x1 <= mi16_dirtyX2 ) && ( ai16_x2 >= mi16_dirtyX1 )
+      && ( ai16_y1 <= mi16_dirtyY2 ) && ( ai16_y2 >= mi16_dirtyY1 );
+}
+
+
+vtObjectGraphicsContext_c::vtObjectGraphicsContext_c()
+  : mp_displayList( NULL )
+{}
+
+
+vtObjectGraphicsContext_c::~vtObjectGraphicsContext_c()
+{
+  delete mp_displayList;
+}
+
+
+vtObjectGraphicsContext_c::DisplayList_c&
+vtObjectGraphicsContext_c::displayList()
+{
+  if( !mp_displayList )
+    mp_displayList = new DisplayList_c();
+
+  return *mp_displayList;
+}
+
+
+bool
+vtObjectGraphicsContext_c::isRecording() const
+{
+  return mp_displayList && mp_displayList->isRecording();
+}
+
+
+void
+vtObjectGraphicsContext_c::beginDisplayList()
+{
+  displayList().begin();
+}
+
+
+void
+vtObjectGraphicsContext_c::flushDisplayList()
+{
+  if( isRecording() )
+    mp_displayList->flush( *this, getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler() );
+}
+
+
+void
+vtObjectGraphicsContext_c::discardDisplayList()
+{
+  if( mp_displayList )
+    mp_displayList->clear();
+}
+
+
+bool
+vtObjectGraphicsContext_c::isDisplayListActive() const
+{
+  return isRecording();
+}
+
+
+uint16_t
+vtObjectGraphicsContext_c::getDisplayListSize() const
+{
+  return mp_displayList ? mp_displayList->size() : 0;
+}
+
+
+void
+vtObjectGraphicsContext_c::invalidateRect( int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2 )
+{
+  displayList().invalidate( ai16_x1, ai16_y1, ai16_x2, ai16_y2 );
+}
+
+
+bool
+vtObjectGraphicsContext_c::getDirtyRect( int16_t& ri16_x1, int16_t& ri16_y1, int16_t& ri16_x2, int16_t& ri16_y2 ) const
+{
+  return mp_displayList && mp_displayList->getDirty( ri16_x1, ri16_y1, ri16_x2, ri16_y2 );
+}
+
+
+bool
+vtObjectGraphicsContext_c::isRectDirty( int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2 ) const
+{
+  return mp_displayList && mp_displayList->intersectsDirty( ai16_x1, ai16_y1, ai16_x2, ai16_y2 );
+}
+
+
+void
+vtObjectGraphicsContext_c::clearDirtyRect()
+{
+  if( mp_displayList )
+    mp_displayList->clearDirty();
+}
 
 void
 vtObjectGraphicsContext_c::setGraphicsCursor( int16_t ai16_x, int16_t ai16_y,
@@ -110,6 +642,11 @@ vtObjectGraphicsContext_c::setGraphicsCursor( int16_t ai16_x, int16_t ai16_y,
       sizeof(iVtObjectGraphicsContext_s), ai16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_setGraphicsCursorCmdID, ai16_x, ai16_y );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandSetGraphicsCursor(
               this, ai16_x, ai16_y, b_enableReplaceOfCmd);
 }
@@ -123,6 +660,11 @@ vtObjectGraphicsContext_c::setForegroundColour( uint8_t newValue,
       sizeof(iVtObjectGraphicsContext_s), newValue);
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_setForegroundColourCmdID, newValue );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandSetForegroundColour(
               this, newValue, b_enableReplaceOfCmd);
 }
@@ -136,6 +678,11 @@ vtObjectGraphicsContext_c::setBackgroundColour( uint8_t newValue,
       sizeof(iVtObjectGraphicsContext_s), newValue);
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_setBackgroundColourCmdID, newValue );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandSetBackgroundColour(
               this, newValue, b_enableReplaceOfCmd);
 }
@@ -149,6 +696,11 @@ vtObjectGraphicsContext_c::setLineAttributes( const IsoAgLib::iVtObjectLineAttri
       sizeof(iVtObjectGraphicsContext_s), newLineAttributes);
   }
 
+  if (isRecording()) {
+    mp_displayList->recordObject( e_setLineAttributeCmdID, newLineAttributes );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandSetGCLineAttributes(
               this, newLineAttributes, b_enableReplaceOfCmd);
 }
@@ -162,6 +714,11 @@ vtObjectGraphicsContext_c::setFillAttributes( const IsoAgLib::iVtObjectFillAttri
       sizeof(iVtObjectGraphicsContext_s), newFillAttributes);
   }
 
+  if (isRecording()) {
+    mp_displayList->recordObject( e_setFillAttributeCmdID, newFillAttributes );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandSetGCFillAttributes(
               this, newFillAttributes, b_enableReplaceOfCmd);
 }
@@ -175,6 +732,11 @@ vtObjectGraphicsContext_c::setFontAttributes( const IsoAgLib::iVtObjectFontAttri
       sizeof(iVtObjectGraphicsContext_s), newFontAttributes);
   }
 
+  if (isRecording()) {
+    mp_displayList->recordObject( e_setFontAttributeCmdID, newFontAttributes );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandSetGCFontAttributes(
               this, newFontAttributes, b_enableReplaceOfCmd);
 }
@@ -190,6 +752,11 @@ vtObjectGraphicsContext_c::eraseRectangle( int16_t ai16_x, int16_t ai16_y,
       sizeof(iVtObjectGraphicsContext_s), ai16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_eraseRectangleCmdID, ai16_x, ai16_y );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandEraseRectangle(
               this, ai16_x, ai16_y, b_enableReplaceOfCmd);
 }
@@ -199,6 +766,11 @@ vtObjectGraphicsContext_c::drawPoint( bool /*b_updateObject*/, bool b_enableRepl
 {
   // No change of object => b_updateObject ignored.
 
+  if (isRecording()) {
+    mp_displayList->record( e_drawPointCmdID );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandDrawPoint(
               this, b_enableReplaceOfCmd);
 }
@@ -214,6 +786,11 @@ vtObjectGraphicsContext_c::drawLine( int16_t ai16_x, int16_t ai16_y,
       sizeof(iVtObjectGraphicsContext_s), ai16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_drawLineCmdID, ai16_x, ai16_y );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandDrawLine(
               this, ai16_x, ai16_y, b_enableReplaceOfCmd);
 }
@@ -229,6 +806,11 @@ vtObjectGraphicsContext_c::drawRectangle( int16_t ai16_x, int16_t ai16_y,
       sizeof(iVtObjectGraphicsContext_s), ai16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_drawRectangleCmdID, ai16_x, ai16_y );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandDrawRectangle(
               this, ai16_x, ai16_y, b_enableReplaceOfCmd);
 }
@@ -244,6 +826,11 @@ vtObjectGraphicsContext_c::drawClosedEllipse( int16_t ai16_x, int16_t ai16_y,
       sizeof(iVtObjectGraphicsContext_s), ai16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_drawClosedEllipseCmdID, ai16_x, ai16_y );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandDrawClosedEllipse(
               this, ai16_x, ai16_y, b_enableReplaceOfCmd);
 }
@@ -260,6 +847,11 @@ vtObjectGraphicsContext_c::drawPolygon( uint16_t cnt, const int16_t* api16_x, co
       sizeof(iVtObjectGraphicsContext_s), api16_y[cnt-1] );
   }
 
+  if (isRecording()) {
+    mp_displayList->recordPolygon( cnt, api16_x, api16_y );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandDrawPolygon(
               this, cnt, api16_x, api16_y, b_enableReplaceOfCmd);
 }
@@ -282,6 +874,11 @@ vtObjectGraphicsContext_c::drawText( uint8_t type, uint8_t cnt, const char* apc_
       sizeof(iVtObjectGraphicsContext_s), i16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->recordText( type, cnt, apc_string );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandDrawText(
               this, type, cnt, apc_string, b_enableReplaceOfCmd);
 }
@@ -297,6 +894,11 @@ vtObjectGraphicsContext_c::panViewport( int16_t ai16_x, int16_t ai16_y,
       sizeof(iVtObjectGraphicsContext_s), ai16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_panViewportCmdID, ai16_x, ai16_y );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandPanViewport(
               this, ai16_x, ai16_y, b_enableReplaceOfCmd);
 }
@@ -313,6 +915,11 @@ vtObjectGraphicsContext_c::zoomViewport( float newValue,
       sizeof(iVtObjectGraphicsContext_s), newValue);
   }
 
+  if (isRecording()) {
+    mp_displayList->recordZoom( e_zoomViewportCmdID, 0, 0, newValue );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandZoomViewport(
               this, newValue, b_enableReplaceOfCmd);
 }
@@ -333,6 +940,11 @@ vtObjectGraphicsContext_c::panAndZoomViewport( int16_t ai16_x, int16_t ai16_y, f
       sizeof(iVtObjectGraphicsContext_s), newValue);
   }
 
+  if (isRecording()) {
+    mp_displayList->recordZoom( e_panAndZoomViewportCmdID, ai16_x, ai16_y, newValue );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandPanAndZoomViewport(
               this, ai16_x, ai16_y, newValue, b_enableReplaceOfCmd);
 }
@@ -348,6 +960,11 @@ vtObjectGraphicsContext_c::changeViewportSize( uint16_t newWidth, uint16_t newHe
       sizeof(iVtObjectGraphicsContext_s), newHeight);
   }
 
+  if (isRecording()) {
+    mp_displayList->record( e_changeViewportSizeCmdID, int16_t( newWidth ), int16_t( newHeight ) );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandChangeViewportSize(
               this, newWidth, newHeight, b_enableReplaceOfCmd);
 }
@@ -370,6 +987,11 @@ vtObjectGraphicsContext_c::drawVtObject( const iVtObject_c* const newVtObject,
       sizeof(iVtObjectGraphicsContext_s), i16_y );
   }
 
+  if (isRecording()) {
+    mp_displayList->recordObject( e_drawVTObjectCmdID, newVtObject );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandDrawVtObject(
               this, newVtObject, b_enableReplaceOfCmd);
 }
@@ -378,6 +1000,11 @@ void
 vtObjectGraphicsContext_c::copyCanvas2PictureGraphic( const IsoAgLib::iVtObjectPictureGraphic_c* const pc_iVtObjectPictureGraphic,
                                                       bool /*b_updateObject*/, bool b_enableReplaceOfCmd)
 {
+  if (isRecording()) {
+    mp_displayList->recordObject( e_copyCanvasToPictureGraphicCmdID, pc_iVtObjectPictureGraphic );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandCopyCanvas2PictureGraphic(
               this, pc_iVtObjectPictureGraphic, b_enableReplaceOfCmd);
 }
@@ -386,6 +1013,11 @@ void
 vtObjectGraphicsContext_c::copyViewport2PictureGraphic( const IsoAgLib::iVtObjectPictureGraphic_c* const pc_iVtObjectPictureGraphic,
                                                         bool /*b_updateObject*/, bool b_enableReplaceOfCmd)
 {
+  if (isRecording()) {
+    mp_displayList->recordObject( e_copyViewportToPictureGraphicCmdID, pc_iVtObjectPictureGraphic );
+    return;
+  }
+
   getVtClientInstance4Comm().getClientByID(s_properties.clientId).commandHandler().sendCommandCopyViewport2PictureGraphic(
               this, pc_iVtObjectPictureGraphic, b_enableReplaceOfCmd);
 }
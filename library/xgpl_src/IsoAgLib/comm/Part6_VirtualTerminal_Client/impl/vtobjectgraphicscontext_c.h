@@ -79,6 +79,7 @@ public:
 
   //  Operation: vtObjectGraphicsContext_c
   vtObjectGraphicsContext_c( void );
+  virtual ~vtObjectGraphicsContext_c();
 
   //! Give total size of object including header and attributes.
   uint32_t fitTerminal( void ) const { return mi_totalSize; }
@@ -145,6 +146,21 @@ public:
   void copyViewport2PictureGraphic(const IsoAgLib::iVtObjectPictureGraphic_c* const pc_VtObjectPictureGraphic,
        bool b_updateObject=false, bool b_enableReplaceOfCmd=false);
 
+  // //////////////////////////////////
+  // Display-list mode: record and coalesce commands locally, send on flush
+  void beginDisplayList();
+  void flushDisplayList();
+  void discardDisplayList();
+  bool isDisplayListActive() const;
+  uint16_t getDisplayListSize() const;
+
+  // //////////////////////////////////
+  // Dirty-rectangle tracking (canvas coordinates, inclusive)
+  void invalidateRect(int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2);
+  bool getDirtyRect(int16_t& ri16_x1, int16_t& ri16_y1, int16_t& ri16_x2, int16_t& ri16_y2) const;
+  bool isRectDirty(int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2) const;
+  void clearDirtyRect();
+
 #ifdef USE_ISO_TERMINAL_GETATTRIBUTES
   // ///////////////////////// getter for attributes
   /** that attribute is in parentheses in the spec, so commented out here
@@ -184,6 +200,18 @@ public:
   void saveReceivedAttribute (uint8_t attrID, uint8_t* pui8_attributeValue);
 #endif
 private:
+  // not copyable (owns the display list)
+  vtObjectGraphicsContext_c( const vtObjectGraphicsContext_c& );
+  vtObjectGraphicsContext_c& operator=( const vtObjectGraphicsContext_c& );
+
+  class DisplayList_c;
+  DisplayList_c& displayList();
+  bool isRecording() const;
+
+  //! Recorded commands and the tracked VT-side state.
+  //! Only allocated when display-list or dirty-rectangle features are used.
+  DisplayList_c* mp_displayList;
+
   //! Total size of Graphics Context attributes.
   static const unsigned mi_attributesSize = (
     sizeof(uint16_t) +
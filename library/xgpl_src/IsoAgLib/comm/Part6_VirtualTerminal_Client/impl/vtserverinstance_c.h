@@ -144,18 +144,25 @@ public:
   void requestLocalSettings( IdentItem_c& identItem );
 
 // the following define should be globally defined in the project settings...
-// (currently not supported, due to multi VT enhancements)
-#if 0
 #ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
-  void fakeVtProperties (uint16_t aui16_dimension, uint16_t aui16_skWidth, uint16_t aui16_skHeight, uint8_t aui16_colorDepth, uint16_t aui16_fontSizes)
+  /** Only for the IopGenerator_c's dummy VT: set the properties as if the
+      hardware, font, softkey and version responses had been received */
+  void fakeVtProperties (uint16_t aui16_dimension, uint8_t aui8_skWidth, uint8_t aui8_skHeight, uint8_t aui8_colorDepth,
+                         uint16_t aui16_fontSizes, uint8_t aui8_fontTypes, uint8_t aui8_version)
   {
     ms_vtCapabilitiesA.hwWidth = aui16_dimension;
-    ms_vtCapabilitiesA.skWidth = aui16_skWidth;
-    ms_vtCapabilitiesA.skHeight = aui16_skHeight;
-    ms_vtCapabilitiesA.hwGraphicType = aui16_colorDepth;
+    ms_vtCapabilitiesA.hwHeight = aui16_dimension;
+    ms_vtCapabilitiesA.skWidth = aui8_skWidth;
+    ms_vtCapabilitiesA.skHeight = aui8_skHeight;
+    ms_vtCapabilitiesA.hwGraphicType = aui8_colorDepth;
     ms_vtCapabilitiesA.fontSizes = aui16_fontSizes;
+    ms_vtCapabilitiesA.fontTypes = aui8_fontTypes;
+    ms_vtCapabilitiesA.iso11783version = aui8_version;
+    ms_vtCapabilitiesA.lastReceivedHardware = 1;
+    ms_vtCapabilitiesA.lastReceivedFont = 1;
+    ms_vtCapabilitiesA.lastReceivedSoftkeys = 1;
+    ms_vtCapabilitiesA.lastReceivedVersion = 1;
   }
-#endif
 #endif
 
   /** interface convert function - avoids lots of explicit static_casts */
@@ -211,22 +211,4 @@ VtServerManager_c::processVtStatusMsg(const CanPkgExt_c& arc_data,
   }
 }
 
-// (currently not supported, due to multi VT enhancements)
-#if 0
-#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
-void
-VtServerManager_c::fakeVtProperties (uint16_t aui16_dimension, uint16_t aui16_skWidth, uint16_t aui16_skHeight,
-                                     uint8_t aui16_colorDepth, uint16_t aui16_fontSizes,
-                                     VtClient_c& aref_vtClient)
-{
-  const IsoItem_c c_dummyIsoItem;
-  // casting NULL to a reference is okay here, as the reference isn't used for any FAKE_VT case (iop_generator, etc.)
-  ml_vtServerInst.push_back ( new VtServerInstance_c (c_dummyIsoItem, aref_vtClient) );
-  VtServerInstance_c* p_vtServerInst = ml_vtServerInst.back();
-  p_vtServerInst->fakeVtProperties (aui16_dimension, aui16_skWidth, aui16_skHeight, aui16_colorDepth, aui16_fontSizes);
-  // ... and notify all vtClientServerComm instances
-}
-#endif
-#endif
-
 } // __IsoAgLib
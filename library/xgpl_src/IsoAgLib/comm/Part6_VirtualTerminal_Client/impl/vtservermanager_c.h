@@ -66,16 +66,6 @@ public:
   
   STL_NAMESPACE::vector<VtServerInstance_c*>& getRefServerInstanceVec() { return ml_vtServerInst; }
 
-// the following define should be globally defined in the project settings...
-// (currently not supported, due to multi VT enhancements)
-#if 0
-#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
-  void fakeVtProperties (uint16_t aui16_dimension, uint16_t aui16_skWidth, uint16_t aui16_skHeight,
-                         uint8_t aui16_colorDepth, uint16_t aui16_fontSizes,
-                         VtClient_c& aref_vtClient);
-#endif
-#endif
-
 private:
     
   STL_NAMESPACE::vector<VtServerInstance_c*> ml_vtServerInst;
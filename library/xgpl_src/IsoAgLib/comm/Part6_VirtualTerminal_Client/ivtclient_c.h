@@ -98,11 +98,11 @@ public:
 
   bool isAnyVtAvailable() const { return VtClient_c::isAnyVtAvailable(); }
 
-// the following define should be globally defined in the project settings...
-#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
-  void fakeVtProperties (uint16_t aui16_dimension, uint16_t aui16_skWidth, uint16_t aui16_skHeight, uint8_t aui16_colorDepth, uint16_t aui16_fontSizes)
-  { VtClient_c::fakeVtProperties (aui16_dimension, aui16_skWidth, aui16_skHeight, aui16_colorDepth, aui16_fontSizes); }
-#endif
+  //! Queue the same command on all registered connections (e.g. dual-VT setups).
+  //! The payload is only stored once and referenced by all send queues.
+  //! @return number of connections the command was queued for
+  unsigned sendCommandToAllConnections (uint8_t* apui8_buffer, uint32_t ui32_size, bool b_enableReplaceOfCmd=false)
+  { return VtClient_c::sendCommandToAllConnections (apui8_buffer, ui32_size, b_enableReplaceOfCmd); }
 
 private:
 #if ( PRT_INSTANCE_CNT == 1 )
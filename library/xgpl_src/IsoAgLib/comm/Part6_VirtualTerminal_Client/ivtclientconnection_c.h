@@ -116,6 +116,9 @@ private:
 
   friend class iVtClient_c;
   friend class __IsoAgLib::VtClientConnection_c;
+#ifdef USE_IOP_GENERATOR_FAKE_VT_PROPERTIES
+  friend class iIopGenerator_c;
+#endif
 };
 
 
@@ -310,6 +310,60 @@ public:
                                    bool b_updateObject=false, bool b_enableReplaceOfCmd=false) {
     vtObjectGraphicsContext_c::copyViewport2PictureGraphic (iVtObjectPictureGraphic, b_updateObject, b_enableReplaceOfCmd);
   }
+
+  //! Start recording the Graphics Context commands locally instead of sending them.
+  //! While recording, redundant commands are dropped (cursor/colour/attribute set to the
+  //! value it already has, set-commands directly replaced by another one of the same kind,
+  //! consecutive viewport changes) and consecutive drawLine calls are merged into
+  //! polyline Draw Polygon commands. The b_enableReplaceOfCmd parameter is ignored
+  //! for recorded commands; b_updateObject is still applied immediately.
+  //! A display list that is still recording is discarded.
+  void beginDisplayList() {
+    vtObjectGraphicsContext_c::beginDisplayList();
+  }
+
+  //! Send the recorded commands (in order, without queue replacement) and stop recording.
+  void flushDisplayList() {
+    vtObjectGraphicsContext_c::flushDisplayList();
+  }
+
+  //! Drop the recorded commands without sending them and stop recording.
+  void discardDisplayList() {
+    vtObjectGraphicsContext_c::discardDisplayList();
+  }
+
+  //! @return true between beginDisplayList() and flushDisplayList()/discardDisplayList()
+  bool isDisplayListActive() const {
+    return vtObjectGraphicsContext_c::isDisplayListActive();
+  }
+
+  //! @return number of commands currently recorded (after coalescing)
+  uint16_t getDisplayListSize() const {
+    return vtObjectGraphicsContext_c::getDisplayListSize();
+  }
+
+  //! Mark a region of the canvas as changed (corners inclusive, any order).
+  //! The dirty rectangle is the bounding box of all regions marked since the last clearDirtyRect().
+  //! It is maintained by the application only, so the redraw can be limited to
+  //! the parts of the canvas whose data actually changed.
+  void invalidateRect(int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2) {
+    vtObjectGraphicsContext_c::invalidateRect (ai16_x1, ai16_y1, ai16_x2, ai16_y2);
+  }
+
+  //! @return false if nothing is dirty, otherwise the dirty rectangle is returned
+  bool getDirtyRect(int16_t& ri16_x1, int16_t& ri16_y1, int16_t& ri16_x2, int16_t& ri16_y2) const {
+    return vtObjectGraphicsContext_c::getDirtyRect (ri16_x1, ri16_y1, ri16_x2, ri16_y2);
+  }
+
+  //! @return true if the given region overlaps the dirty rectangle and has to be redrawn
+  bool isRectDirty(int16_t ai16_x1, int16_t ai16_y1, int16_t ai16_x2, int16_t ai16_y2) const {
+    return vtObjectGraphicsContext_c::isRectDirty (ai16_x1, ai16_y1, ai16_x2, ai16_y2);
+  }
+
+  //! Reset the dirty rectangle, typically after the redraw has been flushed.
+  void clearDirtyRect() {
+    vtObjectGraphicsContext_c::clearDirtyRect();
+  }
 #ifdef USE_ISO_TERMINAL_GETATTRIBUTES
   // ///////////////////////// getter for attributes
   /** that attribute is in parentheses in the spec, so commented out here
@@ -18,6 +18,7 @@
   file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
 */
 #include "gnss_c.h"
+#include "gnss_conversion.h"
 
 #include <IsoAgLib/comm/impl/isobus_c.h>
 #include <IsoAgLib/comm/Part3_DataLink/impl/multireceive_c.h>
@@ -45,52 +46,6 @@
 #endif
 
 
-// Off-class/namespace c-style helper functions
-static void getDegree10Minus7FromStream( __IsoAgLib::Stream_c& rc_stream, int32_t& ri32_result )
-{
-  #if HAL_SIZEOF_INT == 4
-  // use 64 bit variable
-  int64_t i64_temp;
-  IsoAgLib::convertIstream( rc_stream, i64_temp );
-  double d_temp = double(i64_temp);
-  ri32_result = int32_t( d_temp * 1.0e-9 );
-  #else
-  // only take higher 4 bytes
-  int32_t i32_temp;
-
-  // ignore the result of the following call
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // only take this part
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // NMEA sends with 1.0e-16, while normally 1.0e-7 is enough -> mult with 1.0e-9
-  double d_temp = ( double(i32_temp) * 4294967296.0 * 1.0e-9 );
-  ri32_result = int32_t( d_temp );
-  #endif
-}
-
-static void getAltitude10Minus2FromStream( __IsoAgLib::Stream_c& rc_stream, int32_t& ri32_result )
-{
-  #if HAL_SIZEOF_INT == 4
-  // use 64 bit variable
-  int64_t i64_temp;
-  IsoAgLib::convertIstream( rc_stream, i64_temp );
-  double d_temp = double(i64_temp);
-  // NMEA sends with 1.0e-6, while normally 1.0e-2 is enough -> mult with 1.0e-4
-  ri32_result = int32_t( d_temp * 1.0e-4 );
-  #else
-  // only take higher 4 bytes
-  int32_t i32_temp;
-
-  // ignore the result of the following call
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // only take this part
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // NMEA sends with 1.0e-6, while normally 1.0e-2 is enough -> mult with 1.0e-4
-  double d_temp = ( double(i32_temp) * 4294967296.0 * 1.0e-4 );
-  ri32_result = int32_t( d_temp );
-  #endif
-}
-
 namespace __IsoAgLib {
 
   Gnss_c::Gnss_c()
@@ -295,21 +250,19 @@ namespace __IsoAgLib {
         if ( checkParseReceived( senderName ) )
         { // sender is allowed to send
           // Here we get degrees as fraction of 128, and have to change to rad 10^-4
-          // -> / 128 * MATH_PI / 180 * 10000
-#define MATH_PI 3.14159265
-          const uint16_t courseOverGroundRad10Minus4 = static_cast<uint16_t>( static_cast<double>(pkg.getUint16Data( 0 ) ) * MATH_PI * 125.0 / 288.0 );
+          const uint32_t courseOverGroundRad10Minus4 = convertJ1939DirectionToRad10Minus4( pkg.getUint16Data( 0 ) );
           // [256 one bit is 1/256 km/h] [* 1000 * 100 / 60 / 60 -> we get km/h but want cm/sec]
-          const uint16_t speedOverGroundCmSec        = static_cast<uint16_t>( static_cast<double>( pkg.getUint16Data( 2 ) * 125 ) / static_cast<double>( 128 * 9 ) );
+          const uint32_t speedOverGroundCmSec        = convertJ1939SpeedToCmSec( pkg.getUint16Data( 2 ) );
 
           /// @todo ON REQUEST-259: check for the REAL max, 62855 is a little bigger than 62831 or alike that could be calculated. but anyway...
           if ( (courseOverGroundRad10Minus4 > (62855))
             || (speedOverGroundCmSec        > (65532)) )
             return;
 
-          mui16_courseOverGroundRad10Minus4 = courseOverGroundRad10Minus4;
-          mui16_speedOverGroundCmSec        = speedOverGroundCmSec;
+          mui16_courseOverGroundRad10Minus4 = static_cast<uint16_t>( courseOverGroundRad10Minus4 );
+          mui16_speedOverGroundCmSec        = static_cast<uint16_t>( speedOverGroundCmSec );
 
-          mi32_altitudeCm = static_cast<int32_t>( ( static_cast<double>( pkg.getUint16Data( 6 ) ) * 0.125 - 2500.0 ) * 100.0 );
+          mi32_altitudeCm = convertJ1939AltitudeToCm( pkg.getUint16Data( 6 ) );
 
           mi32_lastDirection = ci32_now;
           setSelectedDataSourceISOName( senderName );
@@ -463,11 +416,11 @@ namespace __IsoAgLib {
           setDateTimeUtcGps((UtcNow->tm_year+1900), UtcNow->tm_mon + 1, UtcNow->tm_mday,
                              UtcNow->tm_hour, UtcNow->tm_min, UtcNow->tm_sec, (ui32_milliseconds%1000));
         }
-        // now read Latitude --> convert into double [degree]
+        // now read Latitude [degree * 1.0e-7]
         getDegree10Minus7FromStream( stream, mi32_latitudeDegree10Minus7 );
-        // now read Longitude --> convert into double [degree]
+        // now read Longitude [degree * 1.0e-7]
         getDegree10Minus7FromStream( stream, mi32_longitudeDegree10Minus7 );
-        // now read Altitude --> convert into double [meter]
+        // now read Altitude [cm]
         getAltitude10Minus2FromStream( stream, mi32_altitudeCm );
         // now fetch Quality - gps-mode
         uint8_t ui8_tempValue;
@@ -0,0 +1,173 @@
+/*
+  gnss_conversion.h: integer (fixed-point) conversion of the raw
+    NMEA 2000 / J1939 GNSS values into the internal scalings
+
+  (C) Copyright 2015 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef GNSS_CONVERSION_H
+#define GNSS_CONVERSION_H
+
+#include <IsoAgLib/isoaglib_config.h>
+#include <IsoAgLib/comm/Part3_DataLink/impl/stream_c.h>
+#include <IsoAgLib/util/iutil_funcs.h>
+
+
+/** The GNSS receive paths are hot (10..20 Hz) and are also used on
+    targets without FPU, so all conversions in here are done in pure
+    integer arithmetic. The results are exactly truncated (towards zero).
+    The former double-based conversions gave the same results, except
+    - latitudes/longitudes just below a full 1.0e-7 degree step, where
+      the double lost precision and rounded up to the next step, and
+    - J1939 directions beyond 62855, which were wrapped by the
+      double->uint16 cast and are rejected now.
+    tools/benchmarks/src/gnss_conversion.cpp checks this.
+  */
+namespace __IsoAgLib {
+
+/** calculate trunc( ai32_high * 2^aui8_shift / aui32_divisor ) without
+    the need for 64 bit arithmetic (long division in 8 bit steps).
+    @param ai32_high upper 32 bit of the original 64 bit value
+    @param aui8_shift power of two that remains after cancelling 2^32 against the decimal scaling
+    @param aui32_divisor remaining odd divisor (has to be < 2^24)
+  */
+inline int32_t
+mulPow2DivTrunc( int32_t ai32_high, uint8_t aui8_shift, uint32_t aui32_divisor )
+{
+  const bool cb_negative = ( ai32_high < 0 );
+  const uint32_t cui32_abs = cb_negative ? ( 0UL - uint32_t( ai32_high ) ) : uint32_t( ai32_high );
+
+  uint32_t ui32_quotient = cui32_abs / aui32_divisor;
+  uint32_t ui32_remainder = cui32_abs % aui32_divisor;
+
+  while( aui8_shift > 0 )
+  {
+    const uint8_t cui8_step = ( aui8_shift > 8 ) ? 8 : aui8_shift;
+    ui32_remainder <<= cui8_step;
+    ui32_quotient = ( ui32_quotient << cui8_step ) + ( ui32_remainder / aui32_divisor );
+    ui32_remainder %= aui32_divisor;
+    aui8_shift = uint8_t( aui8_shift - cui8_step );
+  }
+
+  return cb_negative ? -int32_t( ui32_quotient ) : int32_t( ui32_quotient );
+}
+
+
+#if HAL_SIZEOF_INT == 4
+/** convert NMEA 2000 latitude/longitude [degree * 1.0e-16] to [degree * 1.0e-7] */
+inline int32_t
+convertNmeaDegree10Minus16ToDegree10Minus7( int64_t ai64_raw )
+{
+  return int32_t( ai64_raw / 1000000000L );
+}
+
+/** convert NMEA 2000 altitude [m * 1.0e-6] to [cm] */
+inline int32_t
+convertNmeaAltitude10Minus6ToCm( int64_t ai64_raw )
+{
+  return int32_t( ai64_raw / 10000L );
+}
+#endif
+
+// used on targets without 64 bit arithmetic, available on all for checks
+/** convert the upper 32 bit of a NMEA 2000 latitude/longitude [degree * 1.0e-16] to [degree * 1.0e-7]
+    -> raw * 2^32 / 10^9 == raw * 2^23 / 5^9 */
+inline int32_t
+convertNmeaDegree10Minus16HighToDegree10Minus7( int32_t ai32_rawHigh )
+{
+  return mulPow2DivTrunc( ai32_rawHigh, 23, 1953125UL );
+}
+
+/** convert the upper 32 bit of a NMEA 2000 altitude [m * 1.0e-6] to [cm]
+    -> raw * 2^32 / 10^4 == raw * 2^28 / 5^4 */
+inline int32_t
+convertNmeaAltitude10Minus6HighToCm( int32_t ai32_rawHigh )
+{
+  return mulPow2DivTrunc( ai32_rawHigh, 28, 625UL );
+}
+
+
+/** convert J1939 Vehicle Direction [1/128 degree] to [rad * 1.0e-4]
+    -> raw * 3.14159265 * 125 / 288, with 56985/41792 being the smallest
+       fraction that gives identical results over the whole uint16 range */
+inline uint32_t
+convertJ1939DirectionToRad10Minus4( uint16_t aui16_raw )
+{
+  return ( uint32_t( aui16_raw ) * 56985UL ) / 41792UL;
+}
+
+/** convert J1939 Vehicle Speed [1/256 km/h] to [cm/s]
+    -> raw * 1000 * 100 / 256 / 3600 == raw * 125 / 1152 */
+inline uint32_t
+convertJ1939SpeedToCmSec( uint16_t aui16_raw )
+{
+  return ( uint32_t( aui16_raw ) * 125UL ) / 1152UL;
+}
+
+/** convert J1939 Vehicle Altitude [0.125 m, offset -2500 m] to [cm]
+    -> ( raw * 0.125 - 2500 ) * 100 == ( raw * 25 - 500000 ) / 2 */
+inline int32_t
+convertJ1939AltitudeToCm( uint16_t aui16_raw )
+{
+  return ( int32_t( aui16_raw ) * 25L - 500000L ) / 2;
+}
+
+
+#ifdef USE_DATASTREAMS_IO
+/** read NMEA 2000 latitude/longitude [degree * 1.0e-16] from stream as [degree * 1.0e-7] */
+inline void
+getDegree10Minus7FromStream( Stream_c& rc_stream, int32_t& ri32_result )
+{
+  #if HAL_SIZEOF_INT == 4
+  int64_t i64_temp;
+  IsoAgLib::convertIstream( rc_stream, i64_temp );
+  ri32_result = convertNmeaDegree10Minus16ToDegree10Minus7( i64_temp );
+  #else
+  // only take higher 4 bytes
+  int32_t i32_temp;
+
+  // ignore the result of the following call
+  IsoAgLib::convertIstream( rc_stream, i32_temp );
+  // only take this part
+  IsoAgLib::convertIstream( rc_stream, i32_temp );
+  ri32_result = convertNmeaDegree10Minus16HighToDegree10Minus7( i32_temp );
+  #endif
+}
+
+/** read NMEA 2000 altitude [m * 1.0e-6] from stream as [cm] */
+inline void
+getAltitude10Minus2FromStream( Stream_c& rc_stream, int32_t& ri32_result )
+{
+  #if HAL_SIZEOF_INT == 4
+  int64_t i64_temp;
+  IsoAgLib::convertIstream( rc_stream, i64_temp );
+  ri32_result = convertNmeaAltitude10Minus6ToCm( i64_temp );
+  #else
+  // only take higher 4 bytes
+  int32_t i32_temp;
+
+  // ignore the result of the following call
+  IsoAgLib::convertIstream( rc_stream, i32_temp );
+  // only take this part
+  IsoAgLib::convertIstream( rc_stream, i32_temp );
+  ri32_result = convertNmeaAltitude10Minus6HighToCm( i32_temp );
+  #endif
+}
+#endif
+
+} // __IsoAgLib
+
+#endif
@@ -22,6 +22,7 @@
   file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
 */
 #include "timeposgps_c.h"
+#include "gnss_conversion.h"
 
 #include <IsoAgLib/comm/impl/isobus_c.h>
 #include <IsoAgLib/comm/Part3_DataLink/impl/multireceive_c.h>
@@ -50,54 +51,6 @@
 const float gcf_rapidUpdateFilter = 0.15f;  // 15% new, 85%old to filter the update time.
 
 
-#ifdef ENABLE_NMEA_2000_MULTI_PACKET
-// Off-class/namespace c-style helper functions
-static void getDegree10Minus7FromStream( __IsoAgLib::Stream_c& rc_stream, int32_t& ri32_result )
-{
-  #if HAL_SIZEOF_INT == 4
-  // use 64 bit variable
-  int64_t i64_temp;
-  IsoAgLib::convertIstream( rc_stream, i64_temp );
-  double d_temp = double(i64_temp);
-  ri32_result = int32_t( d_temp * 1.0e-9 );
-  #else
-  // only take higher 4 bytes
-  int32_t i32_temp;
-
-  // ignore the result of the following call
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // only take this part
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // NMEA sends with 1.0e-16, while normally 1.0e-7 is enough -> mult with 1.0e-9
-  double d_temp = ( double(i32_temp) * 4294967296.0 * 1.0e-9 );
-  ri32_result = int32_t( d_temp );
-  #endif
-}
-
-static void getAltitude10Minus2FromStream( __IsoAgLib::Stream_c& rc_stream, int32_t& ri32_result )
-{
-  #if HAL_SIZEOF_INT == 4
-  // use 64 bit variable
-  int64_t i64_temp;
-  IsoAgLib::convertIstream( rc_stream, i64_temp );
-  double d_temp = double(i64_temp);
-  // NMEA sends with 1.0e-6, while normally 1.0e-2 is enough -> mult with 1.0e-4
-  ri32_result = int32_t( d_temp * 1.0e-4 );
-  #else
-  // only take higher 4 bytes
-  int32_t i32_temp;
-
-  // ignore the result of the following call
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // only take this part
-  IsoAgLib::convertIstream( rc_stream, i32_temp );
-  // NMEA sends with 1.0e-6, while normally 1.0e-2 is enough -> mult with 1.0e-4
-  double d_temp = ( double(i32_temp) * 4294967296.0 * 1.0e-4 );
-  ri32_result = int32_t( d_temp );
-  #endif
-}
-#endif // END of ENABLE_NMEA_2000_MULTI_PACKET
-
 namespace __IsoAgLib {
 
   #if defined(ENABLE_NMEA_2000_MULTI_PACKET)
@@ -602,13 +555,14 @@ namespace __IsoAgLib {
         if ( checkParseReceivedGps( rcc_tempISOName ) )
         { // sender is allowed to send
           // Here we get degrees as fraction of 128, and have to change to rad 10^-4
-          // -> / 128 * MATH_PI / 180 * 10000
-#define MATH_PI 3.14159265
-          mui16_courseOverGroundRad10Minus4 = static_cast<uint16_t>( static_cast<double>(pkg.getUint16Data( 0 ) ) * MATH_PI * 125.0 / 288.0 );
+          const uint32_t courseOverGroundRad10Minus4 = convertJ1939DirectionToRad10Minus4( pkg.getUint16Data( 0 ) );
           // [256 one bit is 1/256 km/h] [* 1000 * 100 / 60 / 60 -> we get km/h but want cm/sec]
-          mui16_speedOverGroundCmSec        = static_cast<uint16_t>( static_cast<double>( pkg.getUint16Data( 2 ) * 125 ) / static_cast<double>( 128 * 9 ) );
+          const uint32_t speedOverGroundCmSec        = convertJ1939SpeedToCmSec( pkg.getUint16Data( 2 ) );
+          // out of range (e.g. J1939 "not available") is kept as "not available" and not notified below
+          mui16_courseOverGroundRad10Minus4 = static_cast<uint16_t>( ( courseOverGroundRad10Minus4 > 62855 ) ? 0xFFFF : courseOverGroundRad10Minus4 );
+          mui16_speedOverGroundCmSec        = static_cast<uint16_t>( speedOverGroundCmSec );
           // we are getting speed from here as well:
-          mi32_altitudeCm = static_cast<int32_t>( ( static_cast<double>( pkg.getUint16Data( 6 ) ) * 0.125 - 2500.0 ) * 100.0 );
+          mi32_altitudeCm = convertJ1939AltitudeToCm( pkg.getUint16Data( 6 ) );
           // always update values to know if the information is there or not!
 
           // set last time (also always, because if the sender's sending it's sending so we can't send!!
@@ -942,11 +896,11 @@ namespace __IsoAgLib {
             setTimeUtc(UtcNow->tm_hour, UtcNow->tm_min, UtcNow->tm_sec, (ui32_milliseconds%1000));
           }
         }
-        // now read Latitude --> convert into double [degree]
+        // now read Latitude [degree * 1.0e-7]
         getDegree10Minus7FromStream( rc_stream, mi32_latitudeDegree10Minus7 );
-        // now read Longitude --> convert into double [degree]
+        // now read Longitude [degree * 1.0e-7]
         getDegree10Minus7FromStream( rc_stream, mi32_longitudeDegree10Minus7 );
-        // now read Altitude --> convert into double [meter]
+        // now read Altitude [cm]
         getAltitude10Minus2FromStream( rc_stream, mi32_altitudeCm );
         // now fetch Quality - gps-mode
         rc_stream >> ui8_tempValue;
@@ -1090,6 +1044,7 @@ namespace __IsoAgLib {
     getIsoBusInstance4Comm() << pkg;
 
     pkg.setIsoPgn(VEHICLE_DIRECTION_SPEED_PGN);
+#define MATH_PI 3.14159265
     pkg.setUint16Data(0, static_cast<uint16_t>( double( mui16_courseOverGroundRad10Minus4 ) * 288.0 / 125.0 / MATH_PI ) );
     pkg.setUint16Data(2, static_cast<uint16_t>( double( mui16_speedOverGroundCmSec ) * static_cast<double>( 128 * 9 ) / 125.0 ) );
     pkg.setUint16Data(4, 0xFFFF ); // dunno what to send here for N/A
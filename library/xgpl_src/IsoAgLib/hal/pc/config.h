@@ -29,8 +29,8 @@
 #define HAL_CAN_BITRATE_CNT 9
 
 /// define list of allowed speed settings
-#define HAL_RS232_BAUDRATE_LIST {75, 600, 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200}
-#define HAL_RS232_BITRATE_CNT 10
+#define HAL_RS232_BAUDRATE_LIST {75, 600, 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600}
+#define HAL_RS232_BITRATE_CNT 13
 
 
 // IsoAgLib counting for BUS-NR and MsgObj starts both in C-Style with 0
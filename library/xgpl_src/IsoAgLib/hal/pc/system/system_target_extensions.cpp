@@ -91,6 +91,10 @@ static HALSimulator_c* g_halSimulator = NULL;
 HALSimulator_c &halSimulator() { isoaglib_assert( g_halSimulator ); return *g_halSimulator; }
 void setHalSimulator( HALSimulator_c* sim ) { g_halSimulator = sim; }
 
+static TimeSource_c* g_timeSource = NULL;
+
+void setTimeSource( TimeSource_c* source ) { g_timeSource = source; }
+
 
 
 #ifndef WIN32
@@ -155,7 +159,7 @@ openSystem()
   }
 
   // init system start time (first call sets the start-time-base)
-  (void)getTime();
+  (void)getSystemTime();
 
   s_systemStarted = canStartDriver();
   if( !s_systemStarted )
@@ -182,14 +186,14 @@ isSystemOpened()
 #ifdef WIN32
   // VC++ and mingw with native Win32 API provides very accurate
   // msec timer - use that
-  ecutime_t getTime()
+  ecutime_t getSystemTime()
   { // returns time in msec
     // in case of mingw compiler error link winmm.lib (add -lwinmm).
     return MACRO_ISOAGLIB_TIMEGETTIME() - getStartupTime();
   }
 #else
  // use gettimeofday for native LINUX system
-ecutime_t getTime()
+ecutime_t getSystemTime()
 {
   /** linux-2.6 */
   timespec ts;
@@ -200,6 +204,12 @@ ecutime_t getTime()
 #endif
 
 
+ecutime_t getTime()
+{
+  return ( g_timeSource != NULL ) ? g_timeSource->getTime() : getSystemTime();
+}
+
+
 int16_t
 getSnr(uint8_t *snrDat)
 {
@@ -92,6 +92,19 @@ HALSimulator_c &halSimulator();
 void setHalSimulator( HALSimulator_c *sim );
 
 
+/** Simulated time base: while one is set, getTime() answers it
+  instead of the system clock (see TraceSimulator_c). */
+class TimeSource_c
+{
+public:
+  virtual ~TimeSource_c() {}
+  virtual ecutime_t getTime() = 0;
+};
+
+//! NULL switches back to the system clock
+void setTimeSource( TimeSource_c *source );
+
+
 #define  GET_U_C               35        /* UC (Boardnnung)   */
 #define  GET_U_EXT_8_5_V       15        /* U 8,r = sim; */
 
@@ -104,6 +117,7 @@ void closeSystem();
 bool isSystemOpened();
 
 ecutime_t getTime();
+ecutime_t getSystemTime();                 /* [ms] since startup, ignoring any TimeSource_c */
 ecutime_t getStartupTime();
 int16_t getSnr(uint8_t *snrDat);               /* serial number of target */
 
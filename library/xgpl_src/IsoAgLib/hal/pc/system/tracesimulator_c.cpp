@@ -0,0 +1,295 @@
+/*
+  tracesimulator_c.cpp: HAL simulator replaying recorded input traces
+    and capturing the outputs against a simulated clock
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#include "tracesimulator_c.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _MSC_VER
+#pragma warning( disable : 4996 )
+#endif
+
+
+TraceSimulator_c::TraceSimulator_c()
+  : HALSimulator_c()
+  , m_inputs()
+  , mui32_next( 0 )
+  , m_capture()
+  , men_clockMode( ClockSystem )
+  , mui16_factor( 1 )
+  , mt_virtualTime( 0 )
+  , mt_systemBase( 0 )
+{
+  for( uint8_t ui8_ch = 0; ui8_ch < scui8_channels; ++ui8_ch )
+  {
+    mi32_analog[ ui8_ch ] = 0;
+    mi32_digital[ ui8_ch ] = 0;
+    mi32_frequency[ ui8_ch ] = 0;
+    mi32_period[ ui8_ch ] = -1; // no signal: 0xFFFFFFFF
+    mi32_counter[ ui8_ch ] = 0;
+    mi32_counterBase[ ui8_ch ] = 0;
+    mt_counterChange[ ui8_ch ] = 0;
+  }
+}
+
+
+TraceSimulator_c::~TraceSimulator_c()
+{
+  if( men_clockMode != ClockSystem )
+    __HAL::setTimeSource( NULL );
+}
+
+
+bool
+TraceSimulator_c::loadTrace( const char* filename )
+{
+  FILE* file = fopen( filename, "r" );
+  if( file == NULL )
+    return false;
+
+  m_inputs.clear();
+  mui32_next = 0;
+
+  bool b_ok = true;
+  char line[ 128 ];
+  while( b_ok && ( fgets( line, sizeof( line ), file ) != NULL ) )
+  {
+    const char* pos = line;
+    while( ( *pos == ' ' ) || ( *pos == '\t' ) )
+      ++pos;
+    if( ( *pos == '#' ) || ( *pos == '\r' ) || ( *pos == '\n' ) || ( *pos == '\0' ) )
+      continue;
+
+    long long time;
+    char kind;
+    unsigned channel;
+    long value;
+    b_ok = ( sscanf( pos, "%lld %c%u %ld", &time, &kind, &channel, &value ) == 4 )
+        && ( strchr( "adfpn", kind ) != NULL ) && ( channel < scui8_channels );
+    if( b_ok )
+    {
+      const Event_s s_event = { ecutime_t( time ), uint8_t( kind ), uint8_t( channel ), int32_t( value ) };
+      m_inputs.push_back( s_event );
+    }
+  }
+  fclose( file );
+
+  // traces merged from several recordings needn't be in order
+  STL_NAMESPACE::stable_sort( m_inputs.begin(), m_inputs.end() );
+  return b_ok;
+}
+
+
+void
+TraceSimulator_c::addInput( ecutime_t time, Kind_t kind, uint8_t channel, int32_t value )
+{
+  if( channel >= scui8_channels )
+    return;
+
+  const Event_s s_event = { time, uint8_t( kind ), channel, value };
+  m_inputs.insert( STL_NAMESPACE::upper_bound( m_inputs.begin() + mui32_next, m_inputs.end(), s_event ), s_event );
+}
+
+
+ecutime_t
+TraceSimulator_c::nextInputTime() const
+{
+  return replayFinished() ? ecutime_t( -1 ) : m_inputs[ mui32_next ].time;
+}
+
+
+void
+TraceSimulator_c::setClockMode( ClockMode_t mode, uint16_t factor )
+{
+  const ecutime_t t_now = ( men_clockMode == ClockSystem ) ? __HAL::getSystemTime() : getTime();
+
+  men_clockMode = mode;
+  mui16_factor = ( factor > 0 ) ? factor : 1;
+  mt_virtualTime = t_now;
+  mt_systemBase = __HAL::getSystemTime();
+
+  __HAL::setTimeSource( ( mode == ClockSystem ) ? NULL : this );
+}
+
+
+ecutime_t
+TraceSimulator_c::getTime()
+{
+  switch( men_clockMode )
+  {
+    case ClockVirtual:
+      return mt_virtualTime;
+    case ClockAccelerated:
+      return mt_virtualTime + ( __HAL::getSystemTime() - mt_systemBase ) * mui16_factor;
+    case ClockSystem:
+      break;
+  }
+  return __HAL::getSystemTime();
+}
+
+
+void
+TraceSimulator_c::replay()
+{
+  if( replayFinished() )
+    return;
+
+  const ecutime_t t_now = __HAL::getTime();
+  for( ; ( mui32_next < m_inputs.size() ) && ( m_inputs[ mui32_next ].time <= t_now ); ++mui32_next )
+  {
+    const Event_s& s_event = m_inputs[ mui32_next ];
+    switch( s_event.kind )
+    {
+      case KindAnalog:    mi32_analog[ s_event.channel ] = s_event.value; break;
+      case KindDigital:   mi32_digital[ s_event.channel ] = s_event.value; break;
+      case KindFrequency: mi32_frequency[ s_event.channel ] = s_event.value; break;
+      case KindPeriod:    mi32_period[ s_event.channel ] = s_event.value; break;
+      case KindCounter:
+        if( s_event.value != mi32_counter[ s_event.channel ] )
+          mt_counterChange[ s_event.channel ] = s_event.time;
+        mi32_counter[ s_event.channel ] = s_event.value;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+
+void
+TraceSimulator_c::record( Kind_t kind, uint8_t channel, int32_t value )
+{
+  const Event_s s_event = { __HAL::getTime(), uint8_t( kind ), channel, value };
+  m_capture.push_back( s_event );
+}
+
+
+bool
+TraceSimulator_c::writeCapture( const char* filename ) const
+{
+  FILE* file = fopen( filename, "w" );
+  if( file == NULL )
+    return false;
+
+  for( STL_NAMESPACE::vector<Event_s>::const_iterator iter = m_capture.begin(); iter != m_capture.end(); ++iter )
+    fprintf( file, "%lld %c%u %ld\n", (long long)iter->time, char( iter->kind ), unsigned( iter->channel ), long( iter->value ) );
+  return ( fclose( file ) == 0 );
+}
+
+
+void
+TraceSimulator_c::eventMainRelais( bool on )
+{
+  record( KindMainRelay, 0, on ? 1 : 0 );
+}
+
+
+void
+TraceSimulator_c::eventSetPwmFreq( uint8_t bOutputGroup, uint32_t dwFrequency )
+{
+  record( KindPwmFreq, bOutputGroup, int32_t( dwFrequency ) );
+}
+
+
+void
+TraceSimulator_c::eventSetDigout( uint8_t bOutputNo, uint16_t wPWMValue )
+{
+  record( KindDigout, bOutputNo, wPWMValue );
+}
+
+
+int16_t
+TraceSimulator_c::getDiginOnoff( uint8_t bInputNumber )
+{
+  if( bInputNumber >= scui8_channels )
+    return HAL_RANGE_ERR;
+  replay();
+  return ( mi32_digital[ bInputNumber ] > 0 ) ? 1 : 0;
+}
+
+
+void
+TraceSimulator_c::getDiginFreq( uint8_t bInput, uint32_t *pwFrequency )
+{
+  replay();
+  *pwFrequency = ( bInput < scui8_channels ) ? uint32_t( mi32_frequency[ bInput ] ) : 0;
+}
+
+
+uint32_t
+TraceSimulator_c::getCounterPeriod_us( uint8_t bInput )
+{
+  replay();
+  return ( bInput < scui8_channels ) ? uint32_t( mi32_period[ bInput ] ) : 0xFFFFFFFFUL;
+}
+
+
+int16_t
+TraceSimulator_c::getAdc( uint8_t bKanalnummer )
+{
+  if( bKanalnummer >= scui8_channels )
+    return HAL_RANGE_ERR;
+  replay();
+  return int16_t( mi32_analog[ bKanalnummer ] );
+}
+
+
+uint32_t
+TraceSimulator_c::getCounter( uint8_t bInput )
+{
+  if( bInput >= scui8_channels )
+    return 0;
+  replay();
+  return uint32_t( mi32_counter[ bInput ] - mi32_counterBase[ bInput ] );
+}
+
+
+int16_t
+TraceSimulator_c::resetCounter( uint8_t bInput )
+{
+  if( bInput >= scui8_channels )
+    return HAL_RANGE_ERR;
+  replay();
+  mi32_counterBase[ bInput ] = mi32_counter[ bInput ];
+  return HAL_NO_ERR;
+}
+
+
+uint32_t
+TraceSimulator_c::getCounterLastSignalAge( uint8_t bInput )
+{
+  if( bInput >= scui8_channels )
+    return 0xFFFF;
+  replay();
+  const ecutime_t t_age = __HAL::getTime() - mt_counterChange[ bInput ];
+  return ( t_age > 0xFFFF ) ? 0xFFFFUL : uint32_t( t_age );
+}
+
+
+bool
+TraceSimulator_c::getCounterOn( uint8_t ab_channel )
+{
+  if( ab_channel >= scui8_channels )
+    return false;
+  replay();
+  return ( mi32_digital[ ab_channel ] > 0 );
+}
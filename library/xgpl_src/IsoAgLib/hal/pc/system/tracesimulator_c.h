@@ -0,0 +1,147 @@
+/*
+  tracesimulator_c.h: HAL simulator replaying recorded input traces
+    and capturing the outputs against a simulated clock
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef _HAL_PC_TRACESIMULATOR_C_H_
+#define _HAL_PC_TRACESIMULATOR_C_H_
+
+#include "system_target_extensions.h"
+
+#include <vector>
+
+
+/** HALSimulator_c for closed-loop regression tests with the hal_simulator
+  inputs/outputs drivers: all input channels come from one trace held in
+  memory, all outputs are captured into one trace of the same format.
+  A trace has one line per change: "<time [ms]> <kind><channel> <value>",
+  e.g. "1500 a3 812" - '#' starts a comment. Kinds are the Kind_t letters.
+
+  With ClockVirtual the application runs faster than real time: instead of
+  waiting, the test loop advances the clock (e.g. by the time the
+  Scheduler's timeEvent returned, or to nextInputTime()).
+  ClockAccelerated runs the system clock by a factor instead.
+*/
+class TraceSimulator_c : public HALSimulator_c, public __HAL::TimeSource_c
+{
+public:
+  enum Kind_t {
+    // inputs
+    KindAnalog    = 'a', // getAdc
+    KindDigital   = 'd', // getDiginOnoff / getCounterOn (input level)
+    KindFrequency = 'f', // getDiginFreq / getCounterFrequency
+    KindPeriod    = 'p', // getCounterPeriod_us
+    KindCounter   = 'n', // getCounter (pulses)
+    // outputs
+    KindDigout    = 'o', // setDigout (PWM value)
+    KindPwmFreq   = 'w', // setPwmFreq (per output group)
+    KindMainRelay = 'm'  // setMainRelais (channel 0)
+  };
+
+  enum ClockMode_t {
+    ClockSystem,
+    ClockVirtual,
+    ClockAccelerated
+  };
+
+  struct Event_s
+  {
+    ecutime_t time;
+    uint8_t kind;    // Kind_t
+    uint8_t channel;
+    int32_t value;
+
+    bool operator<( const Event_s& rhs ) const { return time < rhs.time; }
+  };
+
+  TraceSimulator_c();
+  virtual ~TraceSimulator_c();
+
+  /** replace the input trace by the given file
+    @return false if it can't be read or has a malformed line */
+  bool loadTrace( const char* filename );
+  //! add a single input change (may be in the past or out of order)
+  void addInput( ecutime_t time, Kind_t kind, uint8_t channel, int32_t value );
+
+  //! time of the next pending input change, -1 if the trace is finished
+  ecutime_t nextInputTime() const;
+  bool replayFinished() const { return mui32_next >= m_inputs.size(); }
+
+  /** choose the clock getTime() answers with. Switching between the
+    simulated clocks keeps the time continuous. Installs this simulator
+    as __HAL::TimeSource_c unless ClockSystem is chosen.
+    @param factor speed-up for ClockAccelerated */
+  void setClockMode( ClockMode_t mode, uint16_t factor = 1 );
+  ClockMode_t clockMode() const { return men_clockMode; }
+  //! ClockVirtual only
+  void advanceTime( ecutime_t ms ) { mt_virtualTime += ms; }
+  void setTime( ecutime_t time ) { if( time > mt_virtualTime ) mt_virtualTime = time; }
+
+  const STL_NAMESPACE::vector<Event_s>& capture() const { return m_capture; }
+  void clearCapture() { m_capture.clear(); }
+  bool writeCapture( const char* filename ) const;
+
+  // TimeSource_c
+  virtual ecutime_t getTime();
+
+  // HALSimulator_c: outputs
+  virtual void eventMainRelais( bool on );
+  virtual void eventSetPwmFreq( uint8_t bOutputGroup, uint32_t dwFrequency );
+  virtual void eventSetDigout( uint8_t bOutputNo, uint16_t wPWMValue );
+
+  // HALSimulator_c: inputs
+  virtual int16_t getDiginOnoff( uint8_t bInputNumber );
+  virtual void getDiginFreq( uint8_t bInput, uint32_t *pwFrequency );
+  virtual uint32_t getCounterPeriod_us( uint8_t bInput );
+  virtual int16_t getAdc( uint8_t bKanalnummer );
+  virtual uint32_t getCounter( uint8_t bInput );
+  virtual int16_t resetCounter( uint8_t bInput );
+  virtual uint32_t getCounterLastSignalAge( uint8_t bInput );
+  virtual bool getCounterOn( uint8_t ab_channel );
+
+private:
+  static const uint8_t scui8_channels = 32;
+
+  //! apply all input changes due
+  void replay();
+  void record( Kind_t kind, uint8_t channel, int32_t value );
+
+  STL_NAMESPACE::vector<Event_s> m_inputs;
+  uint32_t mui32_next;
+  STL_NAMESPACE::vector<Event_s> m_capture;
+
+  int32_t mi32_analog[ scui8_channels ];
+  int32_t mi32_digital[ scui8_channels ];
+  int32_t mi32_frequency[ scui8_channels ];
+  int32_t mi32_period[ scui8_channels ];
+  int32_t mi32_counter[ scui8_channels ];
+  int32_t mi32_counterBase[ scui8_channels ];
+  ecutime_t mt_counterChange[ scui8_channels ];
+
+  ClockMode_t men_clockMode;
+  uint16_t mui16_factor;
+  ecutime_t mt_virtualTime;
+  ecutime_t mt_systemBase;
+
+  /** not copyable : copy constructor is only declared, never defined */
+  TraceSimulator_c(const TraceSimulator_c&);
+  /** not copyable : copy operator is only declared, never defined */
+  TraceSimulator_c& operator=(const TraceSimulator_c&);
+};
+
+#endif
@@ -276,11 +276,66 @@
 #  define CONFIG_VT_CLIENT_NUM_SEND_PRIORITIES 1
 #endif
 
+// share the streamed object pool between connections uploading the
+// same (version-labelled) pool to VTs with identical capabilities.
+#ifndef CONFIG_VT_CLIENT_SHARED_POOL_IMAGE
+#  define CONFIG_VT_CLIENT_SHARED_POOL_IMAGE 1
+#endif
+
 // Don't keep this too low, as it will also be used for all other commands!
 #ifndef CONFIG_FS_CLIENT_MAX_WRITE_SIZE
 #  define CONFIG_FS_CLIENT_MAX_WRITE_SIZE 240
 #endif
 
+// bus budget for queued proprietary messages (queueSend):
+// at most CONFIG_PROPRIETARY_TX_MAX_FRAMES frames (or multi-packet starts)
+// per CONFIG_PROPRIETARY_TX_PERIOD msec, bursts up to the same amount.
+#ifndef CONFIG_PROPRIETARY_TX_MAX_FRAMES
+#  define CONFIG_PROPRIETARY_TX_MAX_FRAMES 4
+#endif
+#ifndef CONFIG_PROPRIETARY_TX_PERIOD
+#  define CONFIG_PROPRIETARY_TX_PERIOD 10
+#endif
+
+// EEPROM segments kept in RAM by EepromIo_c to serve repeated reads.
+// (Segments staged by an open transaction are kept in addition.)
+#ifndef CONFIG_EEPROM_READ_CACHE_SEGMENTS
+#  define CONFIG_EEPROM_READ_CACHE_SEGMENTS 4
+#endif
+
+// time [ms] RS232IO_c::send() waits for a full send buffer to drain
+// before giving up
+#ifndef CONFIG_RS232_SEND_TIMEOUT
+#  define CONFIG_RS232_SEND_TIMEOUT 1000
+#endif
+
+// longest sentence (incl. '$' and checksum) NmeaScanner_c accepts.
+// NMEA-0183 allows 82 characters, some receivers exceed that.
+#ifndef CONFIG_RS232_NMEA_MAX_SENTENCE_LENGTH
+#  define CONFIG_RS232_NMEA_MAX_SENTENCE_LENGTH 128
+#endif
+
+// number of latest non-fatal errors kept by iLibErr_c for
+// field diagnostics (readTrace), 0 disables the trace
+#ifndef CONFIG_ERR_TRACE_SIZE
+#  define CONFIG_ERR_TRACE_SIZE 0
+#endif
+
+// edges (counter changes) FrequencyEstimator_c keeps per counter
+// input for its moving window
+#ifndef CONFIG_COUNTER_ESTIMATOR_EDGES
+#  define CONFIG_COUNTER_ESTIMATOR_EDGES 8
+#endif
+
+// analog inputs the Inputs_c sampling table can hold, and the
+// samples per input its average/median filters work on
+#ifndef CONFIG_ANALOG_SAMPLER_CHANNELS
+#  define CONFIG_ANALOG_SAMPLER_CHANNELS 16
+#endif
+#ifndef CONFIG_ANALOG_SAMPLER_DEPTH
+#  define CONFIG_ANALOG_SAMPLER_DEPTH 4
+#endif
+
 
 /* ***** Auto-set dependant defines ***** */
 
@@ -101,6 +101,9 @@ namespace __IsoAgLib {
     const ecutime_t startTime = System_c::getTime();
 #endif
 
+    // errors registered since the last call, off the hot path
+    IsoAgLib::getILibErrInstance().processNotifications();
+
     for ( int ind = 0; ind < CAN_INSTANCE_CNT; ind++ ) {
 #if defined( ISOAGLIB_SCHEDULER_MAX_TIMEEVENT ) && ( ISOAGLIB_SCHEDULER_MAX_TIMEEVENT > 0 )
       if( (System_c::getTime() - startTime) > ISOAGLIB_SCHEDULER_MAX_TIMEEVENT )
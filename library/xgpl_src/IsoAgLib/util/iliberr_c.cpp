@@ -19,12 +19,31 @@
 */
 
 #include <IsoAgLib/isoaglib_config.h>
+#include <IsoAgLib/hal/hal_system.h>
 #include <cstring>
 #include "iliberr_c.h"
 
 
 namespace IsoAgLib {
 
+namespace {
+
+#if defined( __GNUC__ ) && ( ( __GNUC__ > 4 ) || ( ( __GNUC__ == 4 ) && ( __GNUC_MINOR__ >= 7 ) ) )
+// errors may also be registered from other threads (USE_MUTUAL_EXCLUSION)
+template <typename T> inline T atomicAdd( T& var, T val ) { return __atomic_fetch_add( &var, val, __ATOMIC_RELAXED ); }
+template <typename T> inline void atomicOr( T& var, T val ) { __atomic_fetch_or( &var, val, __ATOMIC_RELEASE ); }
+template <typename T> inline T atomicExchange( T& var, T val ) { return __atomic_exchange_n( &var, val, __ATOMIC_ACQUIRE ); }
+template <typename T> inline void atomicStore( T& var, T val ) { __atomic_store_n( &var, val, __ATOMIC_RELAXED ); }
+#else
+// targets without compiler atomics register errors from one context only
+template <typename T> inline T atomicAdd( T& var, T val ) { const T old = var; var = T( var + val ); return old; }
+template <typename T> inline void atomicOr( T& var, T val ) { var = T( var | val ); }
+template <typename T> inline T atomicExchange( T& var, T val ) { const T old = var; var = val; return old; }
+template <typename T> inline void atomicStore( T& var, T val ) { var = val; }
+#endif
+
+}
+
 iLibErr_c &getILibErrInstance()
 {
   MACRO_SINGLETON_GET_INSTANCE_BODY( iLibErr_c );
@@ -34,6 +53,9 @@ iLibErr_c &getILibErrInstance()
 void iLibErr_c::init()
 {
   CNAMESPACE::memset( &m_nonFatal, 0, TypeNonFatalSize * sizeof( uint16_t ) );
+  CNAMESPACE::memset( &m_pending, 0, TypeNonFatalSize * sizeof( uint16_t ) );
+  resetCounters();
+  mui32_traceWrite = 0;
 }
 
 
@@ -44,22 +66,103 @@ iLibErr_c::close()
 
 
 iLibErr_c::iLibErr_c() :
+  mui32_traceWrite( 0 ),
   CONTAINER_CLIENT1_CTOR_INITIALIZER_LIST
 {
+  init();
 }
 
 
 void iLibErr_c::registerNonFatal( TypeNonFatal_en at_errType, int instance )
 {
-  m_nonFatal[ at_errType ] |= uint16_t( 1 << instance );
+  const uint16_t ui16_bit = uint16_t( 1 << instance );
+  atomicOr( m_nonFatal[ at_errType ], ui16_bit );
+
+  const ecutime_t now = HAL::getTime();
+  if( instance < CAN_INSTANCE_CNT )
+  {
+    Counter_s &rs_counter = m_counter[ at_errType ][ instance ];
+    if( atomicAdd( rs_counter.count, uint32_t( 1 ) ) == 0 )
+      atomicStore( rs_counter.firstTime, now );
+    atomicStore( rs_counter.lastTime, now );
+  }
+
+  const uint32_t ui32_slot = atomicAdd( mui32_traceWrite, uint32_t( 1 ) );
+#if CONFIG_ERR_TRACE_SIZE > 0
+  TraceEntry_s &rs_entry = m_trace[ ui32_slot % CONFIG_ERR_TRACE_SIZE ];
+  rs_entry.time = now;
+  rs_entry.type = uint8_t( at_errType );
+  rs_entry.instance = uint8_t( instance );
+#else
+  (void)ui32_slot;
+#endif
+
+  // set last, so processNotifications() sees the counts
+  atomicOr( m_pending[ at_errType ], ui16_bit );
+}
+
+
+iLibErr_c::Counter_s
+iLibErr_c::counter( TypeNonFatal_en type, int instance ) const
+{
+  if( instance < CAN_INSTANCE_CNT )
+    return m_counter[ type ][ instance ];
+
+  const Counter_s s_none = { 0, 0, 0 };
+  return s_none;
+}
 
-  #ifdef OPTIMIZE_HEAPSIZE_IN_FAVOR_OF_SPEED
-  for ( STL_NAMESPACE::vector<iErrorObserver_c*,MALLOC_TEMPLATE(iErrorObserver_c*)>::iterator pc_iter = m_arrClientC1.begin(); ( pc_iter != m_arrClientC1.end() ); ++pc_iter )
-  #else
-  for ( STL_NAMESPACE::vector<iErrorObserver_c*>::iterator pc_iter = m_arrClientC1.begin(); ( pc_iter != m_arrClientC1.end() ); ++pc_iter )
-  #endif
+
+void
+iLibErr_c::resetCounters()
+{
+  CNAMESPACE::memset( &m_counter, 0, sizeof( m_counter ) );
+}
+
+
+uint16_t
+iLibErr_c::readTrace( TraceEntry_s* pc_dest, uint16_t aui16_max ) const
+{
+#if CONFIG_ERR_TRACE_SIZE > 0
+  const uint32_t ui32_end = mui32_traceWrite;
+  uint32_t ui32_cnt = ( ui32_end < CONFIG_ERR_TRACE_SIZE ) ? ui32_end : CONFIG_ERR_TRACE_SIZE;
+  if( ui32_cnt > aui16_max )
+    ui32_cnt = aui16_max;
+
+  for( uint32_t ui32_ind = 0; ui32_ind < ui32_cnt; ++ui32_ind )
+    pc_dest[ ui32_ind ] = m_trace[ ( ui32_end - ui32_cnt + ui32_ind ) % CONFIG_ERR_TRACE_SIZE ];
+  return uint16_t( ui32_cnt );
+#else
+  (void)pc_dest;
+  (void)aui16_max;
+  return 0;
+#endif
+}
+
+
+void
+iLibErr_c::processNotifications()
+{
+  for( int type = 0; type < TypeNonFatalSize; ++type )
   {
-    (*pc_iter)->nonFatalError( at_errType, instance );
+    if( m_pending[ type ] == 0 )
+      continue;
+
+    const uint16_t ui16_pending = atomicExchange( m_pending[ type ], uint16_t( 0 ) );
+    for( int instance = 0; instance < 16; ++instance )
+    {
+      if( ( ui16_pending & ( 1 << instance ) ) == 0 )
+        continue;
+
+      #ifdef OPTIMIZE_HEAPSIZE_IN_FAVOR_OF_SPEED
+      for ( STL_NAMESPACE::vector<iErrorObserver_c*,MALLOC_TEMPLATE(iErrorObserver_c*)>::iterator pc_iter = m_arrClientC1.begin(); ( pc_iter != m_arrClientC1.end() ); ++pc_iter )
+      #else
+      for ( STL_NAMESPACE::vector<iErrorObserver_c*>::iterator pc_iter = m_arrClientC1.begin(); ( pc_iter != m_arrClientC1.end() ); ++pc_iter )
+      #endif
+      {
+        (*pc_iter)->nonFatalError( TypeNonFatal_en( type ), instance );
+      }
+    }
   }
 }
 
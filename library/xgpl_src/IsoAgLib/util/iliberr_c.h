@@ -39,6 +39,10 @@ namespace IsoAgLib {
 /**
   Basic object for Error Management:
   some functions for state check and setting of error state;
+  registration only counts and flags the error (lock-free where the
+  compiler provides atomics), the observers are notified from the
+  Scheduler's timeEvent - once per error type and instance, however
+  often it occurred meanwhile.
   @author Dipl.-Inform. Achim Spangler
   @author Dipl.-Inform. Martin Wodok
 */
@@ -73,6 +77,18 @@ public:
     Active
   };
 
+  struct Counter_s {
+    uint32_t count;
+    ecutime_t firstTime; // [ms], only valid if count > 0
+    ecutime_t lastTime;
+  };
+
+  struct TraceEntry_s {
+    ecutime_t time;
+    uint8_t type;        // TypeNonFatal_en
+    uint8_t instance;
+  };
+
   void registerNonFatal( TypeNonFatal_en at_errType, int instance );
 
   State_en state( TypeNonFatal_en type, int instance ) const {
@@ -87,13 +103,35 @@ public:
     m_nonFatal[ type ] &= uint16_t(~( 1 << instance ));
   }
 
+  /** occurrences since init() or resetCounters(),
+    counted for instances below CAN_INSTANCE_CNT */
+  Counter_s counter( TypeNonFatal_en type, int instance ) const;
+  void resetCounters();
+
+  /** copy the latest trace entries (at most CONFIG_ERR_TRACE_SIZE), oldest first.
+    @return number of entries copied */
+  uint16_t readTrace( TraceEntry_s* pc_dest, uint16_t aui16_max ) const;
+  //! number of errors registered since init(), including the ones dropped from the trace
+  uint32_t traceTotal() const { return mui32_traceWrite; }
+
   void registerObserver( iErrorObserver_c &arc_observer );
   void deregisterObserver( iErrorObserver_c &arc_observer );
 
+  /** notify the observers of the errors registered since the last call.
+    Called by the Scheduler on each timeEvent. */
+  void processNotifications();
+
 private:
   iLibErr_c();
 
   uint16_t m_nonFatal[ TypeNonFatalSize ];
+  uint16_t m_pending[ TypeNonFatalSize ];
+  Counter_s m_counter[ TypeNonFatalSize ][ CAN_INSTANCE_CNT ];
+
+  uint32_t mui32_traceWrite;
+#if CONFIG_ERR_TRACE_SIZE > 0
+  TraceEntry_s m_trace[ CONFIG_ERR_TRACE_SIZE ];
+#endif
 
   CONTAINER_CLIENT1_MEMBER_FUNCTIONS_MAIN(iErrorObserver_c)
   friend iLibErr_c &getILibErrInstance();
@@ -55,6 +55,11 @@ public:
   //! check for end of input stream
   virtual bool eof() const { return c_targetHandle.eof(); };
 
+  //! read whole blocks, directly out of the memory mapped file where possible
+  virtual uint32_t readBlock( uint8_t* pui8_data, uint32_t ui32_len ) { return c_targetHandle.readBlock( pui8_data, ui32_len ); }
+  virtual uint32_t peekSpan( const uint8_t*& rpui8_span ) { return c_targetHandle.peekSpan( rpui8_span ); }
+  virtual uint32_t skip( uint32_t ui32_len ) { return c_targetHandle.skip( ui32_len ); }
+
   //  Operation: getFileName
   //! get file name
   const STD_TSTRING& getFileName() const { return str_openedFile; };
@@ -52,6 +52,9 @@ public:
   //! write to output stream
   virtual StreamOutput_c& operator<<(uint8_t ui8_data);
 
+  //! write a whole block to output stream
+  virtual uint32_t writeBlock( const uint8_t* pui8_data, uint32_t ui32_len ) { return c_targetHandle.writeBlock( pui8_data, ui32_len ); }
+
   //  Operation: eof
   //! check for end of output stream
   virtual bool eof() const { return c_targetHandle.eof(); };
@@ -43,6 +43,30 @@ public:
   //! Virtual destructor to prevent from warning.
   virtual ~StreamInput_c() {};
 
+  // Block access. The defaults work byte by byte,
+  // sources holding contiguous data override them.
+
+  //! Read up to ui32_len bytes, less only at eof().
+  //! @return number of bytes read
+  virtual uint32_t readBlock( uint8_t* pui8_data, uint32_t ui32_len ) {
+    uint32_t ui32_read = 0;
+    for (; (ui32_read < ui32_len) && (!eof()); ++ui32_read) *this >> pui8_data[ui32_read];
+    return ui32_read;
+  }
+
+  //! Contiguous bytes that can be read in place without copying.
+  //! They stay unread until skip()ped and are valid until the next read.
+  //! @return number of bytes at rpui8_span, 0 if not supported (or eof)
+  virtual uint32_t peekSpan( const uint8_t*& rpui8_span ) { rpui8_span = NULL; return 0; }
+
+  //! Drop up to ui32_len bytes.
+  //! @return number of bytes dropped
+  virtual uint32_t skip( uint32_t ui32_len ) {
+    uint32_t ui32_skipped = 0;
+    for (; (ui32_skipped < ui32_len) && (!eof()); ++ui32_skipped) get();
+    return ui32_skipped;
+  }
+
   // For convenience some transparent interface extensions.
 
   //! Read one byte
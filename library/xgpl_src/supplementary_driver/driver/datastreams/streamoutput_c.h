@@ -40,6 +40,13 @@ public:
 
   void put(uint8_t aui8_data) { operator<<(aui8_data); };
 
+  //! Write a whole block, the default writes byte by byte.
+  //! @return number of bytes written (ui32_len unless the stream failed)
+  virtual uint32_t writeBlock( const uint8_t* pui8_data, uint32_t ui32_len ) {
+    for (uint32_t ui32_ind = 0; ui32_ind < ui32_len; ++ui32_ind) operator<<(pui8_data[ui32_ind]);
+    return good() ? ui32_len : 0;
+  }
+
   //  Operation: eof
   virtual bool eof() const=0;
 
@@ -20,6 +20,8 @@
 
 #include "volatilememorywithsize_c.h"
 
+#include <cstring>
+
 
 
 // //////////////////////////////// +X2C Operation 6851 : operator >>
@@ -58,3 +60,31 @@ VolatileMemoryWithSize_c::eof() const
   return !(mi32_available > 0);
 }
 
+
+
+uint32_t
+VolatileMemoryWithSize_c::readBlock( uint8_t* pui8_data, uint32_t ui32_len )
+{
+  const uint32_t ui32_read = skip( ui32_len );
+  CNAMESPACE::memcpy( pui8_data, mpcui8_data - ui32_read, ui32_read );
+  return ui32_read;
+}
+
+
+uint32_t
+VolatileMemoryWithSize_c::peekSpan( const uint8_t*& rpui8_span )
+{
+  rpui8_span = mpcui8_data;
+  return (mi32_available > 0) ? uint32_t( mi32_available ) : 0;
+}
+
+
+uint32_t
+VolatileMemoryWithSize_c::skip( uint32_t ui32_len )
+{
+  const uint32_t ui32_available = (mi32_available > 0) ? uint32_t( mi32_available ) : 0;
+  const uint32_t ui32_skipped = (ui32_len < ui32_available) ? ui32_len : ui32_available;
+  mpcui8_data += ui32_skipped;
+  mi32_available -= int32_t( ui32_skipped );
+  return ui32_skipped;
+}
@@ -52,6 +52,10 @@ public:
   //  Operation: eof
   virtual bool eof() const;
 
+  virtual uint32_t readBlock( uint8_t* pui8_data, uint32_t ui32_len );
+  virtual uint32_t peekSpan( const uint8_t*& rpui8_span );
+  virtual uint32_t skip( uint32_t ui32_len );
+
   const VolatileMemoryWithSize_c& operator = (const VolatileMemoryWithSize_c& rrefc_src);
 
 protected:
@@ -36,6 +36,13 @@ namespace IsoAgLib
 */
 class iEepromIo_c : private __IsoAgLib::EepromIo_c {
 public:
+  using __IsoAgLib::EepromIo_c::RecordState_t;
+  using __IsoAgLib::EepromIo_c::RecordValid;
+  using __IsoAgLib::EepromIo_c::RecordInvalid;
+  using __IsoAgLib::EepromIo_c::RecordVersionMismatch;
+  using __IsoAgLib::EepromIo_c::RecordSizeMismatch;
+  using __IsoAgLib::EepromIo_c::scui16_recordHeaderSize;
+
   /** destructor has nothing to destruct */
   ~iEepromIo_c() {}
 
@@ -157,6 +164,51 @@ public:
   bool readString(uint8_t *const apb_string, uint16_t aui16_number)
     {return EepromIo_c::readString(apb_string, aui16_number);}
 
+  /* *************************************** */
+  /* ********** record operations ********** */
+  /* *************************************** */
+  /**
+    write a versioned, checksummed record (header followed by the data);
+    the read/write positions are not changed.
+    @param aui8_version version of the data layout, 0xFF is reserved
+    @return true -> written (or staged, in a transaction) without errors
+  */
+  bool writeRecord(uint16_t aui16_address, uint8_t aui8_version, const uint8_t* apb_data, uint16_t aui16_len)
+    {return EepromIo_c::writeRecord(aui16_address, aui8_version, apb_data, aui16_len);}
+
+  template<class T>
+  bool writeRecord(uint16_t aui16_address, uint8_t aui8_version, const T& rTemplateVal)
+    {return EepromIo_c::writeRecord(aui16_address, aui8_version, rTemplateVal);}
+
+  /** read a record; the data is only changed if the result is RecordValid */
+  RecordState_t readRecord(uint16_t aui16_address, uint8_t aui8_version, uint8_t* apb_data, uint16_t aui16_len)
+    {return EepromIo_c::readRecord(aui16_address, aui8_version, apb_data, aui16_len);}
+
+  template<class T>
+  RecordState_t readRecord(uint16_t aui16_address, uint8_t aui8_version, T& rTemplateVal)
+    {return EepromIo_c::readRecord(aui16_address, aui8_version, rTemplateVal);}
+
+  /** get version and length of a valid record, e.g. to migrate old versions */
+  bool recordInfo(uint16_t aui16_address, uint8_t& rui8_version, uint16_t& rui16_len)
+    {return EepromIo_c::recordInfo(aui16_address, rui8_version, rui16_len);}
+
+  /* *************************************** */
+  /* ************ transactions ************* */
+  /* *************************************** */
+  /**
+    gather all following writes in RAM until commitTransaction(),
+    which writes each modified segment once. May be nested.
+    A failed commit keeps the unwritten segments gathered for
+    another commitTransaction() or abortTransaction().
+  */
+  void beginTransaction() { EepromIo_c::beginTransaction(); }
+  bool commitTransaction() { return EepromIo_c::commitTransaction(); }
+  void abortTransaction() { EepromIo_c::abortTransaction(); }
+  bool isInTransaction() const { return EepromIo_c::isInTransaction(); }
+
+  /** drop the read cache, e.g. when the EEPROM was written bypassing iEepromIo_c */
+  void invalidateCache() { EepromIo_c::invalidateCache(); }
+
 private:
   /** allow getIeepromInstance() access to shielded base class.
       otherwise __IsoAgLib::getEepromInstance() wouldn't be accepted by compiler
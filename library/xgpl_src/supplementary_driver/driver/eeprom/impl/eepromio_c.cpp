@@ -25,6 +25,8 @@
 #include <IsoAgLib/util/impl/singleton.h>
 #include <IsoAgLib/util/iliberr_c.h>
 
+#include <algorithm>
+
 
 // Begin Namespace __IsoAgLib
 namespace __IsoAgLib {
@@ -40,8 +42,19 @@ EepromIo_c &getEepromInstance()
 void EepromIo_c::init()
 { // set the segment size
   mui16_segmentSize = HAL::getEepromSegmentSize();
+  isoaglib_assert( ( mui16_segmentSize > 0 ) && ( mui16_segmentSize <= MAX_EEPROM_SEGMENT_SIZE ) );
   // set read/write positions to beginning
   mui16_rPosition = mui16_wPosition = 0;
+  mui8_transactionDepth = 0;
+  m_lines.clear();
+}
+
+
+void EepromIo_c::close()
+{
+  isoaglib_assert( mui8_transactionDepth == 0 );
+  mui8_transactionDepth = 0;
+  m_lines.clear();
 }
 
 
@@ -98,14 +111,8 @@ EepromIo_c::readString(uint8_t *const apb_string, uint16_t aui16_number)
   }
 
   isoaglib_assert( ! eofg( aui16_number-1 ) );
-  // call BIOS function to check that EEPROM is ready
-  setState4BiosReturn(wait_eepromReady());
-  // use eepromRead BIOS function to read in correct number of bytes into data string
-  // don't update read position
-  int16_t i16_retVal = HAL::eepromRead(mui16_rPosition, aui16_number, apb_string);
-  setState4BiosReturn(i16_retVal); // update state dependent on return of BIOS function
   // increment position on success
-  if (i16_retVal == HAL_NO_ERR)
+  if ( readCached( mui16_rPosition, aui16_number, apb_string ) )
   {
     mui16_rPosition += aui16_number;
     return true;
@@ -120,6 +127,11 @@ EepromIo_c::write(uint16_t aui16_address, uint16_t aui16_number, const uint8_t*
 {
   isoaglib_assert( (uint32_t(aui16_address) + uint32_t(aui16_number)) <= eepromSize() );
 
+  if( mui8_transactionDepth > 0 )
+  { // gather, written on commit
+    return updateCache( aui16_address, aui16_number, apb_data, true );
+  }
+
 #ifdef HAL_USE_BUFFERED_EEPROM
   if( aui16_number > 0 )
   {
@@ -128,6 +140,7 @@ EepromIo_c::write(uint16_t aui16_address, uint16_t aui16_number, const uint8_t*
     // set EEPROM to writable
     setState4BiosReturn( HAL::eepromWp( false ) );
     setState4BiosReturn( HAL::eepromWrite( aui16_address, aui16_number, apb_data ) );
+    (void)updateCache( aui16_address, aui16_number, apb_data, false );
   }
   return true;
 #else
@@ -135,70 +148,90 @@ EepromIo_c::write(uint16_t aui16_address, uint16_t aui16_number, const uint8_t*
        ui16_actualStart = aui16_address,
        ui16_actualSize;
   const uint8_t* pb_data = apb_data;
-  uint8_t pb_compare[MAX_EEPROM_SEGMENT_SIZE];
+  bool b_result = true;
 
   while (ui16_restNumber > 0)
   { // if data doesn't fit in one segment write with series of BIOS write calls
-    // init for write
-   if (writeInit())
-   {  // init successfull
-      // get data portion for this call
-      // set to maximal size for this segment
-      ui16_actualSize = maxSize(ui16_actualStart);
-      // if needed size is smaller or equiv set ui16_actualSize to the needed
-      if (ui16_actualSize >= ui16_restNumber) ui16_actualSize = ui16_restNumber;
-      // now ui16_actualSize is allowed -> write BIOS
-
-      // perform up to MAX_EEPROM_WRITE_TRY_CYCLE_CNT write tries - and register error if re-read of just written
-      // value is different from wanted value
-      uint8_t ui8_tryCnt = 0;
-      for ( ; ui8_tryCnt < MAX_EEPROM_WRITE_TRY_CYCLE_CNT; ui8_tryCnt++ )
-      { // first check if the data is different from the original data in EEPROM
-        // (avoid rewrite of same data)
-        // call BIOS function to check that EEPROM is ready
-        setState4BiosReturn(wait_eepromReady());
-        // then call BIOS function to read
-        setState4BiosReturn(HAL::eepromRead (ui16_actualStart, ui16_actualSize, (uint8_t*)pb_compare));
-
-        // compare actual data in EEPROM with given data
-        if (CNAMESPACE::memcmp(pb_compare, pb_data,ui16_actualSize) != 0)
-        { // old data is different -> write new data
-          if (writeInit())
-          { // call BIOS function
-            setState4BiosReturn(HAL::eepromWrite(ui16_actualStart, ui16_actualSize, pb_data));
-          }
-        }
-        else
-        { // re-read of value delivers same value -> break try loop
-          break;
-        }
-      }
-      if ( ui8_tryCnt == MAX_EEPROM_WRITE_TRY_CYCLE_CNT )
-      { // write without success, as re-read delivers always different value
-        IsoAgLib::getILibErrInstance().registerNonFatal( IsoAgLib::iLibErr_c::HalEpromWriteError, 0 );
-        // don't try further writes
-        break;
-      }
-      else if ( IsoAgLib::getILibErrInstance().good( IsoAgLib::iLibErr_c::HalEpromWriteError, 0 ) )
-      { //update the write vals
-        // decrement number of uint8_t which must be written in next loop run
-        ui16_restNumber -= ui16_actualSize;
-        // set the EEPROM memory start position for next write loop run
-        ui16_actualStart += ui16_actualSize;
-        // set pointer to source data to begin of next part
-        pb_data += ui16_actualSize;
-      }
-      else
+    // get data portion for this call
+    // set to maximal size for this segment
+    ui16_actualSize = maxSize(ui16_actualStart);
+    // if needed size is smaller or equiv set ui16_actualSize to the needed
+    if (ui16_actualSize >= ui16_restNumber) ui16_actualSize = ui16_restNumber;
+
+    // skip the segment if the cache already knows the same data
+    const Line_s* pc_line = line( ui16_actualStart / mui16_segmentSize, false );
+    if ( ( pc_line == NULL )
+      || ( CNAMESPACE::memcmp( pc_line->data + ( ui16_actualStart % mui16_segmentSize ), pb_data, ui16_actualSize ) != 0 ) )
+    {
+      if ( !writeSegment( ui16_actualStart, ui16_actualSize, pb_data ) )
       { // error is already stored in state var ->just exit loop
+        b_result = false;
         break;
       }
-    } // if write init
+    }
+    // decrement number of uint8_t which must be written in next loop run
+    ui16_restNumber -= ui16_actualSize;
+    // set the EEPROM memory start position for next write loop run
+    ui16_actualStart += ui16_actualSize;
+    // set pointer to source data to begin of next part
+    pb_data += ui16_actualSize;
   } // while
-  return( IsoAgLib::getILibErrInstance().good( IsoAgLib::iLibErr_c::HalEpromWriteError, 0 ) );
+
+  if ( b_result )
+    (void)updateCache( aui16_address, aui16_number, apb_data, false );
+  else // content of the segments unknown now
+    invalidateCache();
+  return b_result;
 #endif
 }
 
 
+bool
+EepromIo_c::writeSegment(uint16_t aui16_address, uint16_t aui16_number, const uint8_t* apb_data)
+{
+  if (!writeInit())
+    return false;
+  return writeSegmentData(aui16_address, aui16_number, apb_data);
+}
+
+
+bool
+EepromIo_c::writeSegmentData(uint16_t aui16_address, uint16_t aui16_number, const uint8_t* apb_data)
+{
+  isoaglib_assert( aui16_number <= MAX_EEPROM_SEGMENT_SIZE );
+
+  uint8_t pb_compare[MAX_EEPROM_SEGMENT_SIZE];
+
+  // perform up to MAX_EEPROM_WRITE_TRY_CYCLE_CNT write tries - and register error if re-read of just written
+  // value is different from wanted value
+  uint8_t ui8_tryCnt = 0;
+  for ( ; ui8_tryCnt < MAX_EEPROM_WRITE_TRY_CYCLE_CNT; ui8_tryCnt++ )
+  { // first check if the data is different from the original data in EEPROM
+    // (avoid rewrite of same data)
+    // call BIOS function to check that EEPROM is ready
+    setState4BiosReturn(wait_eepromReady());
+    // then call BIOS function to read
+    setState4BiosReturn(HAL::eepromRead (aui16_address, aui16_number, (uint8_t*)pb_compare));
+
+    // compare actual data in EEPROM with given data
+    if (CNAMESPACE::memcmp(pb_compare, apb_data, aui16_number) != 0)
+    { // old data is different -> write new data (ready and unprotected, see above)
+      setState4BiosReturn(HAL::eepromWrite(aui16_address, aui16_number, apb_data));
+    }
+    else
+    { // re-read of value delivers same value -> break try loop
+      break;
+    }
+  }
+  if ( ui8_tryCnt == MAX_EEPROM_WRITE_TRY_CYCLE_CNT )
+  { // write without success, as re-read delivers always different value
+    IsoAgLib::getILibErrInstance().registerNonFatal( IsoAgLib::iLibErr_c::HalEpromWriteError, 0 );
+    return false;
+  }
+  return( IsoAgLib::getILibErrInstance().good( IsoAgLib::iLibErr_c::HalEpromWriteError, 0 ) );
+}
+
+
 bool
 EepromIo_c::writeInit()
 {
@@ -283,14 +316,314 @@ EepromIo_c::readIntern(uint8_t* apb_data, uint8_t aui8_len)
 {
   if ( ! eofg( aui8_len ) )
   {
-    setState4BiosReturn(wait_eepromReady());
-    HAL::eepromRead(mui16_rPosition, aui8_len, apb_data);
+    (void)readCached(mui16_rPosition, aui8_len, apb_data);
     mui16_rPosition += aui8_len; //inkrement position
   }
   return *this;
 }
 
 
+EepromIo_c::Line_s*
+EepromIo_c::line(uint16_t aui16_segment, bool ab_load)
+{
+  for( STL_NAMESPACE::vector<Line_s>::iterator iter = m_lines.begin(); iter != m_lines.end(); ++iter )
+  {
+    if( iter->segment == aui16_segment )
+    {
+      iter->lastUse = ++mui16_useCnt;
+      return &(*iter);
+    }
+  }
+  if( !ab_load )
+    return NULL;
+
+  Line_s s_line;
+  s_line.segment = aui16_segment;
+  s_line.lastUse = ++mui16_useCnt;
+  s_line.dirtyBegin = s_line.dirtyEnd = 0;
+
+  const uint32_t ui32_start = uint32_t( aui16_segment ) * mui16_segmentSize;
+  const uint16_t ui16_size = uint16_t( STL_NAMESPACE::min( uint32_t( mui16_segmentSize ), eepromSize() - ui32_start ) );
+
+  setState4BiosReturn(wait_eepromReady());
+  const int16_t i16_retVal = HAL::eepromRead( uint16_t( ui32_start ), ui16_size, s_line.data );
+  setState4BiosReturn(i16_retVal);
+  if( i16_retVal != HAL_NO_ERR )
+    return NULL;
+
+  // make room before adding, so the returned pointer stays valid
+  trimCache( ( CONFIG_EEPROM_READ_CACHE_SEGMENTS > 0 ) ? ( CONFIG_EEPROM_READ_CACHE_SEGMENTS - 1 ) : 0 );
+  m_lines.push_back( s_line );
+  return &m_lines.back();
+}
+
+
+bool
+EepromIo_c::readCached(uint16_t aui16_address, uint16_t aui16_number, uint8_t* apb_data)
+{
+  while( aui16_number > 0 )
+  {
+    const uint16_t ui16_offset = aui16_address % mui16_segmentSize;
+    const uint16_t ui16_size = STL_NAMESPACE::min( uint16_t( mui16_segmentSize - ui16_offset ), aui16_number );
+
+    const Line_s* pc_line = line( aui16_address / mui16_segmentSize, ( CONFIG_EEPROM_READ_CACHE_SEGMENTS > 0 ) );
+    if( pc_line != NULL )
+    {
+      CNAMESPACE::memcpy( apb_data, pc_line->data + ui16_offset, ui16_size );
+    }
+    else
+    { // no cache (or loading failed) -> directly
+      setState4BiosReturn(wait_eepromReady());
+      const int16_t i16_retVal = HAL::eepromRead( aui16_address, ui16_size, apb_data );
+      setState4BiosReturn(i16_retVal);
+      if( i16_retVal != HAL_NO_ERR )
+        return false;
+    }
+    aui16_address += ui16_size;
+    aui16_number -= ui16_size;
+    apb_data += ui16_size;
+  }
+  return true;
+}
+
+
+bool
+EepromIo_c::updateCache(uint16_t aui16_address, uint16_t aui16_number, const uint8_t* apb_data, bool ab_stage)
+{
+  while( aui16_number > 0 )
+  {
+    const uint16_t ui16_offset = aui16_address % mui16_segmentSize;
+    const uint16_t ui16_size = STL_NAMESPACE::min( uint16_t( mui16_segmentSize - ui16_offset ), aui16_number );
+
+    Line_s* pc_line = line( aui16_address / mui16_segmentSize, ab_stage );
+    if( pc_line != NULL )
+    {
+      if( ab_stage )
+      { // only changed bytes extend the range to write
+        for( uint16_t i = ui16_offset; i < ui16_offset + ui16_size; ++i )
+        {
+          const uint8_t ui8_value = apb_data[ i - ui16_offset ];
+          if( pc_line->data[ i ] == ui8_value )
+            continue;
+          pc_line->data[ i ] = ui8_value;
+          if( !pc_line->isDirty() )
+          {
+            pc_line->dirtyBegin = i;
+            pc_line->dirtyEnd = uint16_t( i + 1 );
+          }
+          else
+          {
+            pc_line->dirtyBegin = STL_NAMESPACE::min( pc_line->dirtyBegin, i );
+            pc_line->dirtyEnd = STL_NAMESPACE::max( pc_line->dirtyEnd, uint16_t( i + 1 ) );
+          }
+        }
+      }
+      else
+        CNAMESPACE::memcpy( pc_line->data + ui16_offset, apb_data, ui16_size );
+    }
+    else if( ab_stage )
+      return false;
+
+    aui16_address += ui16_size;
+    aui16_number -= ui16_size;
+    apb_data += ui16_size;
+  }
+  return true;
+}
+
+
+void
+EepromIo_c::trimCache(uint16_t aui16_keep)
+{
+  for(;;)
+  {
+    uint16_t ui16_clean = 0;
+    STL_NAMESPACE::vector<Line_s>::iterator oldest = m_lines.end();
+    for( STL_NAMESPACE::vector<Line_s>::iterator iter = m_lines.begin(); iter != m_lines.end(); ++iter )
+    {
+      if( iter->isDirty() )
+        continue;
+      ++ui16_clean;
+      // age via unsigned difference, robust against wrap-around of the use counter
+      if( ( oldest == m_lines.end() ) || ( uint16_t( mui16_useCnt - iter->lastUse ) > uint16_t( mui16_useCnt - oldest->lastUse ) ) )
+        oldest = iter;
+    }
+    if( ui16_clean <= aui16_keep )
+      return;
+    m_lines.erase( oldest );
+  }
+}
+
+
+void
+EepromIo_c::invalidateCache()
+{
+  trimCache( 0 );
+}
+
+
+bool
+EepromIo_c::commitTransaction()
+{
+  if( mui8_transactionDepth == 0 )
+  { // not open or already aborted
+    return false;
+  }
+  if( mui8_transactionDepth > 1 )
+  {
+    --mui8_transactionDepth;
+    return true;
+  }
+
+  // write in address order
+  STL_NAMESPACE::sort( m_lines.begin(), m_lines.end() );
+
+  // unprotect once for all segments
+#ifdef HAL_USE_BUFFERED_EEPROM
+  setState4BiosReturn( HAL::eepromWp( false ) );
+#else
+  if( !writeInit() )
+    return false;
+#endif
+  for( STL_NAMESPACE::vector<Line_s>::iterator iter = m_lines.begin(); iter != m_lines.end(); ++iter )
+  {
+    if( !iter->isDirty() )
+      continue;
+
+    const uint16_t ui16_address = uint16_t( iter->segment * mui16_segmentSize + iter->dirtyBegin );
+    const uint16_t ui16_number = uint16_t( iter->dirtyEnd - iter->dirtyBegin );
+    const uint8_t* pb_data = iter->data + iter->dirtyBegin;
+
+#ifdef HAL_USE_BUFFERED_EEPROM
+    const int16_t i16_retVal = HAL::eepromWrite( ui16_address, ui16_number, pb_data );
+    setState4BiosReturn( i16_retVal );
+    if( i16_retVal != HAL_NO_ERR )
+      return false;
+#else
+    if( !writeSegmentData( ui16_address, ui16_number, pb_data ) )
+      return false;
+#endif
+    iter->dirtyBegin = iter->dirtyEnd = 0;
+  }
+
+  mui8_transactionDepth = 0;
+  trimCache( CONFIG_EEPROM_READ_CACHE_SEGMENTS );
+  return true;
+}
+
+
+void
+EepromIo_c::abortTransaction()
+{
+  mui8_transactionDepth = 0;
+  for( STL_NAMESPACE::vector<Line_s>::iterator iter = m_lines.begin(); iter != m_lines.end(); )
+  {
+    if( iter->isDirty() )
+      iter = m_lines.erase( iter );
+    else
+      ++iter;
+  }
+}
+
+
+void
+EepromIo_c::fletcher16(uint16_t& rui16_sum1, uint16_t& rui16_sum2, const uint8_t* apb_data, uint16_t aui16_len)
+{
+  for( uint16_t i = 0; i < aui16_len; ++i )
+  {
+    rui16_sum1 = uint16_t( ( rui16_sum1 + apb_data[ i ] ) % 255 );
+    rui16_sum2 = uint16_t( ( rui16_sum2 + rui16_sum1 ) % 255 );
+  }
+}
+
+
+bool
+EepromIo_c::writeRecord(uint16_t aui16_address, uint8_t aui8_version, const uint8_t* apb_data, uint16_t aui16_len)
+{
+  if( ( uint32_t( aui16_address ) + scui16_recordHeaderSize + aui16_len ) > eepromSize() )
+  {
+    isoaglib_assert( !"record exceeds eeprom size" );
+    return false;
+  }
+
+  uint8_t pui8_header[ scui16_recordHeaderSize ];
+  pui8_header[ 0 ] = aui8_version;
+  pui8_header[ 1 ] = uint8_t( aui16_len & 0xFF );
+  pui8_header[ 2 ] = uint8_t( aui16_len >> 8 );
+  uint16_t ui16_sum1 = 0, ui16_sum2 = 0;
+  fletcher16( ui16_sum1, ui16_sum2, pui8_header, 3 );
+  fletcher16( ui16_sum1, ui16_sum2, apb_data, aui16_len );
+  // stored inverted, so an all-zero area isn't a valid record
+  const uint16_t ui16_checksum = uint16_t( ~( ( ui16_sum2 << 8 ) | ui16_sum1 ) );
+  pui8_header[ 3 ] = uint8_t( ui16_checksum & 0xFF );
+  pui8_header[ 4 ] = uint8_t( ui16_checksum >> 8 );
+
+  // header and data go out together with the least segment writes
+  beginTransaction();
+  const bool b_staged = write( aui16_address, scui16_recordHeaderSize, pui8_header )
+                     && write( uint16_t( aui16_address + scui16_recordHeaderSize ), aui16_len, apb_data );
+  const bool b_committed = commitTransaction();
+  if( !b_committed )
+    abortTransaction();
+  return b_staged && b_committed;
+}
+
+
+bool
+EepromIo_c::recordInfo(uint16_t aui16_address, uint8_t& rui8_version, uint16_t& rui16_len)
+{
+  uint8_t pui8_header[ scui16_recordHeaderSize ];
+  if( ( uint32_t( aui16_address ) + scui16_recordHeaderSize ) > eepromSize() )
+    return false;
+  if( !readCached( aui16_address, scui16_recordHeaderSize, pui8_header ) )
+    return false;
+
+  const uint16_t ui16_len = uint16_t( pui8_header[ 1 ] | ( uint16_t( pui8_header[ 2 ] ) << 8 ) );
+  if( ( uint32_t( aui16_address ) + scui16_recordHeaderSize + ui16_len ) > eepromSize() )
+    return false;
+
+  uint16_t ui16_sum1 = 0, ui16_sum2 = 0;
+  fletcher16( ui16_sum1, ui16_sum2, pui8_header, 3 );
+
+  uint8_t pui8_chunk[ MAX_EEPROM_SEGMENT_SIZE ];
+  uint16_t ui16_address = uint16_t( aui16_address + scui16_recordHeaderSize );
+  for( uint16_t ui16_rest = ui16_len; ui16_rest > 0; )
+  {
+    const uint16_t ui16_size = STL_NAMESPACE::min( ui16_rest, uint16_t( MAX_EEPROM_SEGMENT_SIZE ) );
+    if( !readCached( ui16_address, ui16_size, pui8_chunk ) )
+      return false;
+    fletcher16( ui16_sum1, ui16_sum2, pui8_chunk, ui16_size );
+    ui16_address += ui16_size;
+    ui16_rest -= ui16_size;
+  }
+
+  const uint16_t ui16_checksum = uint16_t( ~( ( ui16_sum2 << 8 ) | ui16_sum1 ) );
+  if( ( pui8_header[ 3 ] != uint8_t( ui16_checksum & 0xFF ) ) || ( pui8_header[ 4 ] != uint8_t( ui16_checksum >> 8 ) ) )
+    return false;
+
+  rui8_version = pui8_header[ 0 ];
+  rui16_len = ui16_len;
+  return true;
+}
+
+
+EepromIo_c::RecordState_t
+EepromIo_c::readRecord(uint16_t aui16_address, uint8_t aui8_version, uint8_t* apb_data, uint16_t aui16_len)
+{
+  uint8_t ui8_version;
+  uint16_t ui16_len;
+  if( !recordInfo( aui16_address, ui8_version, ui16_len ) )
+    return RecordInvalid;
+  if( ui8_version != aui8_version )
+    return RecordVersionMismatch;
+  if( ui16_len != aui16_len )
+    return RecordSizeMismatch;
+
+  // the data was just read for the checksum, so this is served by the cache
+  return readCached( uint16_t( aui16_address + scui16_recordHeaderSize ), aui16_len, apb_data ) ? RecordValid : RecordInvalid;
+}
+
+
 EepromIo_c&
 operator<<(EepromIo_c& rc_stream, const IsoName_c& rc_data )
 {
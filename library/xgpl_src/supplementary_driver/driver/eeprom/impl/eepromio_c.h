@@ -21,9 +21,12 @@
 #ifndef EEPROM_IO_H
 #define EEPROM_IO_H
 
+#include <IsoAgLib/isoaglib_config.h>
 #include <supplementary_driver/hal/hal_eeprom.h>
 #include <IsoAgLib/util/iassert.h>
 
+#include <vector>
+
 
 namespace __IsoAgLib 
 {
@@ -33,17 +36,33 @@ class IsoName_c;
   object for communication with the EEPROM,
   stream read/write operators for all basic types;
   avoid rewriting same values to EEPROM;
-  manages operations cross segment boundaries
+  manages operations cross segment boundaries;
+  caches recently read segments;
+  versioned, checksummed records and transactions which
+  gather all writes and flush them once per segment on commit
   @short Simple data communication with EEPROM.
   @author Dipl.-Inform. Achim Spangler
 */
 class EepromIo_c 
 {
 public:
+  /** result of reading a record */
+  enum RecordState_t
+  {
+    RecordValid,           // data was read
+    RecordInvalid,         // no record or checksum wrong (e.g. never written, torn write)
+    RecordVersionMismatch, // valid record of another version, use recordInfo() to migrate
+    RecordSizeMismatch     // valid record of this version, but with another size
+  };
+
+  /** version (1), length (2), checksum (2) */
+  static const uint16_t scui16_recordHeaderSize = 5;
+
   ~EepromIo_c() {}
 
   void init();
-  void close() {}
+  /** discards an open transaction and the read cache */
+  void close();
 
   // ++++++++++++++++++++++++++++++++++++
   // ++++ EEPROM managing operations ++++
@@ -192,6 +211,72 @@ public:
   */
   bool readString(uint8_t *const apb_string, uint16_t aui16_number);
 
+  /* *************************************** */
+  /* ********** record operations ********** */
+  /* *************************************** */
+
+  /**
+    write a record (header followed by the data) at the given address;
+    the read/write positions are not changed.
+    The record occupies scui16_recordHeaderSize + aui16_len bytes.
+    Outside of a transaction the record is flushed as one transaction.
+    @param aui16_address start of the record
+    @param aui8_version version of the data layout, 0xFF is reserved
+    @return true -> written (or staged, in a transaction) without errors
+  */
+  bool writeRecord(uint16_t aui16_address, uint8_t aui8_version, const uint8_t* apb_data, uint16_t aui16_len);
+
+  template<class T>
+  bool writeRecord(uint16_t aui16_address, uint8_t aui8_version, const T& rTemplateVal)
+    { return writeRecord(aui16_address, aui8_version, (const uint8_t*)(&rTemplateVal), sizeof(T)); }
+
+  /**
+    read a record written by writeRecord; apb_data is only changed
+    if the record is valid and matches version and length.
+    The read/write positions are not changed.
+  */
+  RecordState_t readRecord(uint16_t aui16_address, uint8_t aui8_version, uint8_t* apb_data, uint16_t aui16_len);
+
+  template<class T>
+  RecordState_t readRecord(uint16_t aui16_address, uint8_t aui8_version, T& rTemplateVal)
+    { return readRecord(aui16_address, aui8_version, (uint8_t*)(&rTemplateVal), sizeof(T)); }
+
+  /**
+    get version and length of a valid record, e.g. to migrate old versions
+    @return false -> no valid record at this address
+  */
+  bool recordInfo(uint16_t aui16_address, uint8_t& rui8_version, uint16_t& rui16_len);
+
+  /* *************************************** */
+  /* ************ transactions ************* */
+  /* *************************************** */
+
+  /**
+    start gathering all following writes (stream operators, strings
+    and records) in RAM; reads deliver the gathered data.
+    Transactions may be nested, only the outermost commit writes.
+  */
+  void beginTransaction() { ++mui8_transactionDepth; }
+
+  /**
+    write all gathered changes - once per modified segment,
+    only the changed range and only bytes which differ.
+    Stops at the first failing segment: the transaction then stays
+    open with this and all following segments still gathered, so
+    commit again to retry or abort to drop them.
+    @return true -> all segments written without errors
+                    (or nested commit, which doesn't write)
+  */
+  bool commitTransaction();
+
+  /** drop all gathered changes of the (outermost) transaction */
+  void abortTransaction();
+
+  bool isInTransaction() const { return ( mui8_transactionDepth > 0 ); }
+
+  /** drop the read cache, e.g. when the EEPROM was written bypassing EepromIo_c */
+  void invalidateCache();
+
 private:
 // Private methods
   friend EepromIo_c& operator<<(EepromIo_c& rc_stream, const IsoName_c& rc_data );
@@ -204,8 +289,53 @@ private:
     : mui16_segmentSize( 0 )
     , mui16_rPosition( 0 )
     , mui16_wPosition( 0 )
+    , mui8_transactionDepth( 0 )
+    , mui16_useCnt( 0 )
+    , m_lines()
   {}
 
+  /** RAM copy of one EEPROM segment */
+  struct Line_s
+  {
+    uint16_t segment;
+    uint16_t lastUse;
+    // modified (staged) range, empty if dirtyBegin >= dirtyEnd
+    uint16_t dirtyBegin;
+    uint16_t dirtyEnd;
+    uint8_t data[MAX_EEPROM_SEGMENT_SIZE];
+
+    bool isDirty() const { return dirtyBegin < dirtyEnd; }
+    bool operator<( const Line_s& other ) const { return segment < other.segment; }
+  };
+
+  /**
+    get the cached segment; load it if not cached and ab_load
+    @return NULL if not cached and not loaded (or loading failed)
+  */
+  Line_s* line(uint16_t aui16_segment, bool ab_load);
+
+  /** read through the cache */
+  bool readCached(uint16_t aui16_address, uint16_t aui16_number, uint8_t* apb_data);
+
+  /** apply the data to the cached segments; if ab_stage load missing segments and mark them dirty
+    @return false -> a segment to stage couldn't be loaded */
+  bool updateCache(uint16_t aui16_address, uint16_t aui16_number, const uint8_t* apb_data, bool ab_stage);
+
+  /** remove clean segments (least recently used first) until at most aui16_keep are left */
+  void trimCache(uint16_t aui16_keep);
+
+  /**
+    write data within one segment, compare and retry
+    up to MAX_EEPROM_WRITE_TRY_CYCLE_CNT times
+  */
+  bool writeSegment(uint16_t aui16_address, uint16_t aui16_number, const uint8_t* apb_data);
+
+  /** writeSegment without writeInit(), for a series of segments after one writeInit() */
+  bool writeSegmentData(uint16_t aui16_address, uint16_t aui16_number, const uint8_t* apb_data);
+
+  /** add data to a Fletcher-16 checksum */
+  static void fletcher16(uint16_t& rui16_sum1, uint16_t& rui16_sum2, const uint8_t* apb_data, uint16_t aui16_len);
+
   /**
     set error flags dependent on BIOS return value
     @param ai16_biosReturn BIOS return value which should be translated in error state of EEPROM_IO
@@ -306,6 +436,15 @@ private:
   /** actual write position in EEPROM */
   uint16_t mui16_wPosition;
 
+  /** nesting depth of beginTransaction() */
+  uint8_t mui8_transactionDepth;
+
+  /** use counter for LRU replacement in the cache */
+  uint16_t mui16_useCnt;
+
+  /** cached segments - including all dirty segments of the open transaction */
+  STL_NAMESPACE::vector<Line_s> m_lines;
+
   friend EepromIo_c &getEepromInstance();
 };
 
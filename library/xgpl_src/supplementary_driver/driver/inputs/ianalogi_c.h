@@ -22,6 +22,7 @@
 #define IANALOGI_C_H
 
 #include "impl/analogi_c.h"
+#include "iinputs_c.h"
 
 
 namespace IsoAgLib {
@@ -79,6 +80,19 @@ public:
   */
   void setFastAdc(bool ab_useFast=true){AnalogI_c::setFastAdc(ab_useFast);}
 
+  /**
+    answer val() from the values of the last iInputs_c::sampleAnalog()
+    instead of reading the HAL on each call
+    @param ren_filter filter applied to the samples
+    @return false if the sampling table is full
+  */
+  bool setSampled( iInputs_c::AnalogFilter_t ren_filter = iInputs_c::AnalogLatest ) { return AnalogI_c::setSampled( ren_filter ); }
+
+  /** read the HAL on each val() again */
+  void setUnsampled() { AnalogI_c::setUnsampled(); }
+
+  bool isSampled() const { return AnalogI_c::isSampled(); }
+
   /**
     deliver the channel number of the output object
     @return number to use for BIOS access to this channel
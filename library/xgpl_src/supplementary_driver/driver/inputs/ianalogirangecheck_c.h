@@ -22,6 +22,7 @@
 #define IANALOGIRANGECHECK_C_H
 
 #include "impl/analogirangecheck_c.h"
+#include "iinputs_c.h"
 
 
 namespace IsoAgLib {
@@ -87,6 +88,19 @@ public:
   */
   void setFastAdc(bool ab_useFast=true){AnalogIRangeCheck_c::setFastAdc(ab_useFast);}
 
+  /**
+    answer val() and the range checks from the values of the last
+    iInputs_c::sampleAnalog() instead of reading the HAL on each call
+    @param ren_filter filter applied to the samples
+    @return false if the sampling table is full
+  */
+  bool setSampled( iInputs_c::AnalogFilter_t ren_filter = iInputs_c::AnalogLatest ) { return AnalogIRangeCheck_c::setSampled( ren_filter ); }
+
+  /** read the HAL on each val() again */
+  void setUnsampled() { AnalogIRangeCheck_c::setUnsampled(); }
+
+  bool isSampled() const { return AnalogIRangeCheck_c::isSampled(); }
+
   /**
     deliver the channel number of the output object
     @return number to use for BIOS access to this channel
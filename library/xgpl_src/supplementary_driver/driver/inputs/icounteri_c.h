@@ -25,6 +25,8 @@
 
 namespace IsoAgLib {
 
+typedef __IsoAgLib::FrequencyEstimator_c iFrequencyEstimator_c;
+
 /**
   Input object for counting of digital impulses
   @see iCounterI_c
@@ -83,19 +85,47 @@ public:
   void reset() {CounterI_c::reset();}
 
   /**
-    get period of counter channel
+    get period of counter channel (filtered once setEstimator() was called)
     @return time between last two signals in microseconds
             or 0xFFFFFFFF if time is longer than initially given timebase
   */
   uint32_t period_us() {return CounterI_c::period_us();}
 
   /**
-    get frequency of counter channel
+    get frequency of counter channel in the unit of the target's BIOS,
+    see estimatedFrequency_mHz() for the filtered frequency
     @return frequency calculated from time between last two signals
             or 0 if time is longer than initially given timebase
   */
   uint32_t frequency() {return CounterI_c::frequency();}
 
+  /**
+    configure the filtered frequency estimation
+    @param filter FilterRaw, FilterWindow (last aui8_param edges)
+                  or FilterExponential (weight 1/2^aui8_param)
+    @param aui8_param see filter
+    @param aui16_timeout_ms edge age after which the signal is regarded as stopped
+  */
+  void setEstimator( iFrequencyEstimator_c::Filter_t filter, uint8_t aui8_param, uint16_t aui16_timeout_ms )
+    { CounterI_c::setEstimator( filter, aui8_param, aui16_timeout_ms ); }
+
+  /**
+    poll the counter for the filtered estimation, once per application cycle
+  */
+  void updateEstimate() { CounterI_c::updateEstimate(); }
+
+  /**
+    get filtered frequency as of the last updateEstimate()
+    @return frequency [mHz] or 0 without signal
+  */
+  uint32_t estimatedFrequency_mHz() const { return CounterI_c::estimatedFrequency_mHz(); }
+
+  /**
+    get filtered period as of the last updateEstimate()
+    @return period [us] or 0xFFFFFFFF without signal
+  */
+  uint32_t estimatedPeriod_us() const { return CounterI_c::estimatedPeriod_us(); }
+
   /**
     get the ON state (voltage above limit on pin)
     @return TRUE if voltage above limit
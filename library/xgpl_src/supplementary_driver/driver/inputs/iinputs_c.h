@@ -27,7 +27,8 @@ namespace IsoAgLib {
 
 /**
   Management of the Inputs in general.
-  Currently "empty", but do init/close nevertheless!
+  Do init/close nevertheless!
+  Holds the sampling table of the analog inputs set to sampled.
   @see iAnalogI_c
   @see iDigitalI_c
   @see iCounterI_c
@@ -35,9 +36,21 @@ namespace IsoAgLib {
 class iInputs_c : private __IsoAgLib::Inputs_c
 {
 public:
+  using Inputs_c::AnalogFilter_t;
+  using Inputs_c::AnalogLatest;
+  using Inputs_c::AnalogAverage;
+  using Inputs_c::AnalogMedian;
+
   void init() { Inputs_c::init(); }
   void close() { Inputs_c::close(); }
 
+  /** read all sampled analog inputs once from the HAL;
+    call once per application cycle or from a HAL timer callback */
+  void sampleAnalog() { Inputs_c::sampleAnalog(); }
+
+  //! number of sampleAnalog() calls since init
+  uint32_t analogSampleCnt() const { return Inputs_c::analogSampleCnt(); }
+
 private:
   // unimplemented, shouldn't be called by app.
   ~iInputs_c();
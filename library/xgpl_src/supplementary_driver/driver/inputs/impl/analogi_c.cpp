@@ -31,12 +31,19 @@ AnalogI_c::AnalogI_c(uint8_t ab_channel, IsoAgLib::iInput_c::analogType_t ren_an
   , ui16_minRangeValue(0)
   , ui16_maxRangeValue(0)
   , b_activateOverrideRangeErrors(false)
+  , ui8_sampleSlot(0xFF)
 {
   if ( ab_channel != 0xFF )
     init( ab_channel, ren_analogType, ab_useMean, ab_fastAdc );
 }
 
 
+AnalogI_c::~AnalogI_c()
+{
+  setUnsampled();
+}
+
+
 void
 AnalogI_c::init(uint8_t ab_channel, IsoAgLib::iInput_c::analogType_t ren_analogType, bool ab_useMean, bool ab_fastAdc)
 {
@@ -64,6 +71,41 @@ AnalogI_c::init(uint8_t ab_channel, IsoAgLib::iInput_c::analogType_t ren_analogT
 
 uint16_t
 AnalogI_c::val() const
+{
+  if ( ui8_sampleSlot != 0xFF )
+    return getInputsInstance().analogValue( ui8_sampleSlot );
+  return halVal();
+}
+
+
+bool
+AnalogI_c::setSampled( Inputs_c::AnalogFilter_t ren_filter )
+{
+  setUnsampled();
+  return getInputsInstance().registerAnalog( *this, &AnalogI_c::sampleHal, ui8_sampleSlot, ren_filter );
+}
+
+
+uint16_t
+AnalogI_c::sampleHal( const AnalogI_c& arc_input )
+{
+  return arc_input.halVal();
+}
+
+
+void
+AnalogI_c::setUnsampled()
+{
+  if ( ui8_sampleSlot != 0xFF )
+  {
+    getInputsInstance().unregisterAnalog( ui8_sampleSlot );
+    ui8_sampleSlot = 0xFF;
+  }
+}
+
+
+uint16_t
+AnalogI_c::halVal() const
 {
   int16_t i16_sensor;
   if (b_useMean)
@@ -21,6 +21,7 @@
 #define ANALOGI_C_H
 
 #include "inputbase_c.h"
+#include "inputs_c.h"
 
 
 namespace __IsoAgLib {
@@ -48,7 +49,7 @@ public:
   AnalogI_c(uint8_t ab_channel = 0xFF, IsoAgLib::iInput_c::analogType_t ren_analogType = IsoAgLib::iInput_c::voltage, bool ab_useMean = false,
              bool ab_fastAdc = false);
 
-  ~AnalogI_c() {}
+  ~AnalogI_c();
 
   /**
     internal called constructor which creates a new input channel,initialize the hardware and configures conversion calculation
@@ -66,6 +67,20 @@ public:
   */
   uint16_t val() const;
 
+  /**
+    take this input into the Inputs_c sampling table: from then on val()
+    and the range checks answer from the values of the last
+    Inputs_c::sampleAnalog() instead of reading the HAL on each call
+    @param ren_filter filter applied to the samples
+    @return false if the sampling table is full (the input stays unsampled)
+  */
+  bool setSampled( Inputs_c::AnalogFilter_t ren_filter = Inputs_c::AnalogLatest );
+
+  /** read the HAL on each val() again */
+  void setUnsampled();
+
+  bool isSampled() const { return ( ui8_sampleSlot != 0xFF ); }
+
   /**
     check if value is greater than 0
     @return true if sensor value is different from 0, otherwise 0
@@ -91,6 +106,11 @@ public:
   void setFastAdc(bool ab_useFast=true);
 
 protected:
+  /** read the value from the HAL with the configured ADC method */
+  uint16_t halVal() const;
+
+  uint8_t sampleSlot() const { return ui8_sampleSlot; }
+
   // unimplemented, not copyabled
   AnalogI_c(const AnalogI_c&);
   AnalogI_c& operator=(const AnalogI_c&);
@@ -112,6 +132,12 @@ private: // Private attributes
   uint16_t ui16_minRangeValue;
   uint16_t ui16_maxRangeValue;
   bool b_activateOverrideRangeErrors;
+
+  /** slot in the Inputs_c sampling table, 0xFF if not sampled */
+  uint8_t ui8_sampleSlot;
+
+  /** Inputs_c::AnalogSampler_t of the sampled inputs */
+  static uint16_t sampleHal( const AnalogI_c& arc_input );
 };
 
 } // __IsoAgLib
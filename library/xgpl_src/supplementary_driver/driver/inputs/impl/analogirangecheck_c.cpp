@@ -45,17 +45,37 @@ AnalogIRangeCheck_c::~AnalogIRangeCheck_c()
 }
 
 
+bool
+AnalogIRangeCheck_c::setSampled( Inputs_c::AnalogFilter_t ren_filter )
+{
+  if ( !AnalogI_c::setSampled( ren_filter ) )
+    return false;
+  getInputsInstance().setAnalogRange( sampleSlot(), ui16_minValid, ui16_maxValid );
+  return true;
+}
+
+
 void
 AnalogIRangeCheck_c::setRange( uint16_t aui16_minValid, uint16_t aui16_maxValid )
 {
   ui16_minValid = aui16_minValid;
   ui16_maxValid = aui16_maxValid;
+  if ( isSampled() )
+    getInputsInstance().setAnalogRange( sampleSlot(), ui16_minValid, ui16_maxValid );
 }
 
 
 int16_t
 AnalogIRangeCheck_c::validatedVal( bool &rb_tooLow, bool &rb_tooHigh ) const
 {
+  if ( isSampled() )
+  {
+    const Inputs_c &crc_inputs = getInputsInstance();
+    rb_tooLow  = crc_inputs.analogTooLow( sampleSlot() );
+    rb_tooHigh = crc_inputs.analogTooHigh( sampleSlot() );
+    return int16_t( crc_inputs.analogValue( sampleSlot() ) );
+  }
+
   const int16_t ci16_tempVal = val();
   rb_tooLow  = ( ci16_tempVal < ui16_minValid );
   rb_tooHigh = ( ci16_tempVal > ui16_maxValid );
@@ -66,6 +86,9 @@ AnalogIRangeCheck_c::validatedVal( bool &rb_tooLow, bool &rb_tooHigh ) const
 bool
 AnalogIRangeCheck_c::good( void ) const
 {
+ if ( isSampled() )
+   return !checkRangeError();
+
  const uint16_t ui16_tempVal = val();
  if ( ( ui16_tempVal >= ui16_minValid )
    && ( ui16_tempVal <= ui16_maxValid ) ) {
@@ -87,6 +110,9 @@ AnalogIRangeCheck_c::error( void ) const
 bool
 AnalogIRangeCheck_c::checkRangeError( void ) const
 {
+ if ( isSampled() )
+   return checkTooLow() || checkTooHigh();
+
  const uint16_t ui16_tempVal = val();
  if ( ( ui16_tempVal < ui16_minValid )
    || ( ui16_tempVal > ui16_maxValid ) ) {
@@ -101,6 +127,9 @@ AnalogIRangeCheck_c::checkRangeError( void ) const
 bool
 AnalogIRangeCheck_c::checkTooHigh( void ) const
 {
+  if ( isSampled() )
+    return getInputsInstance().analogTooHigh( sampleSlot() );
+
   const uint16_t ui16_tempVal = val();
   if ( ui16_tempVal > ui16_maxValid ) {
     return true;
@@ -114,6 +143,9 @@ AnalogIRangeCheck_c::checkTooHigh( void ) const
 bool
 AnalogIRangeCheck_c::checkTooLow( void ) const
 {
+  if ( isSampled() )
+    return getInputsInstance().analogTooLow( sampleSlot() );
+
   const uint16_t ui16_tempVal = val();
   if ( ui16_tempVal < ui16_minValid ) {
     return true;
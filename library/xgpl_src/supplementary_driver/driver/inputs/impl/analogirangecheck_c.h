@@ -63,6 +63,10 @@ public:
 
   virtual ~AnalogIRangeCheck_c();
 
+  /** as AnalogI_c::setSampled(), the range is then also
+    evaluated once per Inputs_c::sampleAnalog() */
+  bool setSampled( Inputs_c::AnalogFilter_t ren_filter = Inputs_c::AnalogLatest );
+
   /** get validate val
     @param rb_tooLow  reference to bool value which is set dependent on ( value < minLimit )
     @param rb_tooHigh reference to bool value which is set dependent on ( value > maxLimit )
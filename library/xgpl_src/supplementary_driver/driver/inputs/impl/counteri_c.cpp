@@ -18,6 +18,7 @@
   file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
 */
 #include "counteri_c.h"
+#include <IsoAgLib/hal/hal_system.h>
 
 namespace __IsoAgLib {
 
@@ -34,4 +35,11 @@ CounterI_c::getState() const
   }
 }
 
+
+void
+CounterI_c::updateEstimate()
+{
+  m_estimator.sample( HAL::getTime(), val(), lastSignalAge(), HAL::getCounterPeriod_us( channelNr() ) );
+}
+
 } // __IsoAgLib
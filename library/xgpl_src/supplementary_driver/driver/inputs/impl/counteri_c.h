@@ -21,6 +21,7 @@
 #define COUNTERI_C_H
 
 #include "inputbase_c.h"
+#include "frequencyestimator_c.h"
 #include <IsoAgLib/util/iassert.h>
 #include <supplementary_driver/hal/hal_inputs.h>
 
@@ -85,14 +86,16 @@ public:
   inline void reset();
 
   /**
-    get period of counter channel
+    get period of counter channel; once setEstimator() was called this is
+    the filtered period of the last updateEstimate(), without HAL access
     @return time between last two signals in microseconds
             or 0xFFFFFFFF if time is longer than initially given timebase
   */
   inline uint32_t period_us();
 
   /**
-    get frequency of counter channel
+    get frequency of counter channel. Always the HAL value, as its unit is
+    up to the target's BIOS - use estimatedFrequency_mHz() for the filtered one
     @return frequency calculated from time between last two signals
             or 0 if time is longer than initially given timebase
   */
@@ -109,12 +112,42 @@ public:
   */
   inline bool isCounterOn();
 
+  /**
+    configure the filtered frequency estimation, see FrequencyEstimator_c
+    @param filter filter to apply
+    @param aui8_param window edges or exponential weight shift
+    @param aui16_timeout_ms edge age after which the signal is regarded as stopped
+  */
+  void setEstimator( FrequencyEstimator_c::Filter_t filter, uint8_t aui8_param, uint16_t aui16_timeout_ms )
+  { m_estimator.configure( filter, aui8_param, aui16_timeout_ms ); mb_estimate = true; }
+
+  /**
+    poll the counter for the filtered estimation;
+    call once per application cycle (or from a timer interrupt)
+  */
+  void updateEstimate();
+
+  /**
+    filtered frequency as of the last updateEstimate()
+    @return frequency [mHz] or 0 without signal
+  */
+  uint32_t estimatedFrequency_mHz() const { return m_estimator.frequency_mHz(); }
+
+  /**
+    filtered period as of the last updateEstimate()
+    @return period [us] or 0xFFFFFFFF without signal
+  */
+  uint32_t estimatedPeriod_us() const { return m_estimator.period_us(); }
+
   /** deliver detailed error state information for this Counter Input
     * @return cin_err_t [noCinErr|cin_openErr|cin_shortcutErr|cin_overvoltErr|cin_undervoltErr]
     */
   cin_err_t getState( void ) const;
 
 private:
+  FrequencyEstimator_c m_estimator;
+  bool mb_estimate;
+
   // unimplemented, not copyable
   CounterI_c(const CounterI_c&);
   CounterI_c& operator=(const CounterI_c&);
@@ -128,6 +161,8 @@ CounterI_c::CounterI_c(
     bool ab_activHigh,
     bool ab_risingEdge)
   : InputBase_c( ab_channel, IsoAgLib::iInput_c::counter )
+  , m_estimator()
+  , mb_estimate( false )
 {
   if ( ab_channel != 0xFF )
     init( ab_channel, aui16_timebase, ab_activHigh, ab_risingEdge );
@@ -165,6 +200,7 @@ void
 CounterI_c::reset()
 {
   HAL::resetCounter(channelNr());
+  m_estimator.reset();
 }
 
 
@@ -172,7 +208,7 @@ inline
 uint32_t
 CounterI_c::period_us()
 {
-  return HAL::getCounterPeriod_us(channelNr());
+  return mb_estimate ? m_estimator.period_us() : HAL::getCounterPeriod_us(channelNr());
 }
 
 
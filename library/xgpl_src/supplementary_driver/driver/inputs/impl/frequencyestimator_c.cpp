@@ -0,0 +1,169 @@
+/*
+  frequencyestimator_c.cpp:
+    implementation for FrequencyEstimator_c, filtered frequency
+    estimation for counter inputs
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#include "frequencyestimator_c.h"
+
+#if CONFIG_COUNTER_ESTIMATOR_EDGES < 2
+#  error "CONFIG_COUNTER_ESTIMATOR_EDGES needs at least 2 edges"
+#endif
+
+
+namespace __IsoAgLib {
+
+static const uint32_t scui32_noPeriod = 0xFFFFFFFFUL;
+
+
+FrequencyEstimator_c::FrequencyEstimator_c()
+  : men_filter( FilterRaw )
+  , mui8_param( 0 )
+  , mui16_timeout( 1000 )
+{
+  reset();
+}
+
+
+void
+FrequencyEstimator_c::configure( Filter_t filter, uint8_t aui8_param, uint16_t aui16_timeout_ms )
+{
+  men_filter = filter;
+  switch( filter )
+  {
+    case FilterWindow:
+      if( aui8_param < 2 ) aui8_param = 2;
+      if( aui8_param > CONFIG_COUNTER_ESTIMATOR_EDGES ) aui8_param = CONFIG_COUNTER_ESTIMATOR_EDGES;
+      break;
+    case FilterExponential:
+      if( aui8_param < 1 ) aui8_param = 1;
+      if( aui8_param > 8 ) aui8_param = 8;
+      break;
+    case FilterRaw:
+      break;
+  }
+  mui8_param = aui8_param;
+  mui16_timeout = aui16_timeout_ms;
+  reset();
+}
+
+
+void
+FrequencyEstimator_c::reset()
+{
+  mui8_newest = 0;
+  mui8_edgeCnt = 0;
+  mui32_filtered = scui32_noPeriod;
+  mui32_frequency = 0;
+  mui32_period = scui32_noPeriod;
+}
+
+
+void
+FrequencyEstimator_c::sample( ecutime_t at_now, uint32_t aui32_count, uint32_t aui32_lastSignalAge, uint32_t aui32_period_us )
+{
+  const bool cb_newEdges = ( mui8_edgeCnt == 0 )
+    ? ( aui32_count > 0 )
+    : ( aui32_count != ms_edges[ mui8_newest ].count );
+
+  if( cb_newEdges )
+  {
+    if( ( mui8_edgeCnt > 0 ) && ( aui32_count < ms_edges[ mui8_newest ].count ) )
+    { // counter was reset, the edges before are lost
+      mui8_edgeCnt = 0;
+      mui32_filtered = scui32_noPeriod;
+    }
+
+    if( mui8_edgeCnt > 0 )
+      mui8_newest = uint8_t( ( mui8_newest + 1 ) % CONFIG_COUNTER_ESTIMATOR_EDGES );
+    if( mui8_edgeCnt < CONFIG_COUNTER_ESTIMATOR_EDGES )
+      ++mui8_edgeCnt;
+    ms_edges[ mui8_newest ].time = at_now - ecutime_t( aui32_lastSignalAge );
+    ms_edges[ mui8_newest ].count = aui32_count;
+
+    // the HAL measures single periods exactly, the ring only gives
+    // multiples of the poll and HAL time resolution
+    uint32_t ui32_period = aui32_period_us;
+    if( ( ui32_period == scui32_noPeriod ) || ( men_filter == FilterWindow ) )
+    {
+      const uint32_t cui32_windowPeriod = windowPeriod_us();
+      if( cui32_windowPeriod != scui32_noPeriod )
+        ui32_period = cui32_windowPeriod;
+    }
+
+    if( ( men_filter == FilterExponential ) && ( mui32_filtered != scui32_noPeriod ) && ( ui32_period != scui32_noPeriod ) )
+    {
+      const int64_t ci64_delta = int64_t( ui32_period ) - int64_t( mui32_filtered );
+      mui32_filtered = uint32_t( int64_t( mui32_filtered ) + ci64_delta / ( int64_t( 1 ) << mui8_param ) );
+    }
+    else
+      mui32_filtered = ui32_period;
+  }
+
+  if( ( aui32_lastSignalAge >= mui16_timeout ) || ( mui32_filtered == scui32_noPeriod ) )
+    publish( scui32_noPeriod );
+  else
+  { // no edge for longer than a period: the signal has slowed down at least to 1/age
+    const uint32_t cui32_age_us = aui32_lastSignalAge * 1000UL;
+    publish( ( cui32_age_us > mui32_filtered ) ? cui32_age_us : mui32_filtered );
+  }
+}
+
+
+uint32_t
+FrequencyEstimator_c::windowPeriod_us() const
+{
+  const Edge_s& crs_newest = ms_edges[ mui8_newest ];
+  const uint8_t cui8_span = ( men_filter == FilterWindow ) ? mui8_param : uint8_t( 2 );
+
+  // oldest edge within the window, but not beyond the timeout
+  uint8_t ui8_oldest = mui8_newest;
+  for( uint8_t ui8_n = 1; ( ui8_n < cui8_span ) && ( ui8_n < mui8_edgeCnt ); ++ui8_n )
+  {
+    const uint8_t cui8_index = uint8_t( ( mui8_newest + CONFIG_COUNTER_ESTIMATOR_EDGES - ui8_n ) % CONFIG_COUNTER_ESTIMATOR_EDGES );
+    if( ( crs_newest.time - ms_edges[ cui8_index ].time ) > ecutime_t( mui16_timeout ) )
+      break;
+    ui8_oldest = cui8_index;
+  }
+
+  const Edge_s& crs_oldest = ms_edges[ ui8_oldest ];
+  const uint32_t cui32_pulses = crs_newest.count - crs_oldest.count;
+  const ecutime_t ct_span = crs_newest.time - crs_oldest.time;
+  if( ( cui32_pulses == 0 ) || ( ct_span <= 0 ) )
+    return scui32_noPeriod;
+
+  return uint32_t( ( uint64_t( ct_span ) * 1000UL ) / cui32_pulses );
+}
+
+
+void
+FrequencyEstimator_c::publish( uint32_t aui32_period_us )
+{
+  if( ( aui32_period_us == scui32_noPeriod ) || ( aui32_period_us == 0 ) )
+  {
+    mui32_frequency = 0;
+    mui32_period = scui32_noPeriod;
+  }
+  else
+  {
+    mui32_frequency = uint32_t( 1000000000UL / aui32_period_us );
+    mui32_period = aui32_period_us;
+  }
+}
+
+} // __IsoAgLib
@@ -0,0 +1,100 @@
+/*
+  frequencyestimator_c.h:
+    header for FrequencyEstimator_c, filtered frequency estimation
+    for counter inputs
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef FREQUENCYESTIMATOR_C_H
+#define FREQUENCYESTIMATOR_C_H
+
+#include <IsoAgLib/isoaglib_config.h>
+
+
+namespace __IsoAgLib {
+
+/**
+  Filtered frequency/period of a pulse counter, computed from polls of
+  the counter value, the age of its last edge and the HAL period.
+  The edges seen by the polls go into a ring, from which the
+  estimate is precomputed on each sample(): reading it is O(1) and,
+  as both results are single 32-bit words, safe while sample() runs
+  in an interrupt or another task.
+  Without new edges the estimate decays with the age of the last edge
+  (the signal is at most as fast as 1/age) down to 0 at the timeout.
+  Doesn't access the HAL itself, so it can be fed from simulations.
+  */
+class FrequencyEstimator_c
+{
+public:
+  enum Filter_t {
+    FilterRaw,         // period of the last two edges as measured by the HAL
+    FilterWindow,      // edges over the time spanned by the last n edges
+    FilterExponential  // period smoothed by weight 1/2^n per new edge
+  };
+
+  FrequencyEstimator_c();
+
+  /** @param filter filter to apply
+      @param aui8_param n for FilterWindow (2..CONFIG_COUNTER_ESTIMATOR_EDGES)
+                        or FilterExponential (1..8)
+      @param aui16_timeout_ms edge age after which the signal is regarded
+                        as stopped, also the maximum time span of the window */
+  void configure( Filter_t filter, uint8_t aui8_param, uint16_t aui16_timeout_ms );
+
+  void reset();
+
+  /** feed one poll of the counter
+      @param at_now time of the poll [ms]
+      @param aui32_count pulses counted
+      @param aui32_lastSignalAge time since the last edge [ms]
+      @param aui32_period_us HAL period of the last two edges, 0xFFFFFFFF if unknown */
+  void sample( ecutime_t at_now, uint32_t aui32_count, uint32_t aui32_lastSignalAge, uint32_t aui32_period_us );
+
+  //! @return estimated frequency [mHz], 0 without signal
+  uint32_t frequency_mHz() const { return mui32_frequency; }
+  //! @return estimated period [us], 0xFFFFFFFF without signal
+  uint32_t period_us() const { return mui32_period; }
+
+private:
+  struct Edge_s
+  {
+    ecutime_t time;  // of the last edge counted
+    uint32_t count;
+  };
+
+  void publish( uint32_t aui32_period_us );
+  uint32_t windowPeriod_us() const;
+
+  Filter_t men_filter;
+  uint8_t mui8_param;
+  uint16_t mui16_timeout;
+
+  Edge_s ms_edges[ CONFIG_COUNTER_ESTIMATOR_EDGES ];
+  uint8_t mui8_newest;
+  uint8_t mui8_edgeCnt;
+
+  //! filtered period [us] before the timeout extrapolation
+  uint32_t mui32_filtered;
+
+  volatile uint32_t mui32_frequency;
+  volatile uint32_t mui32_period;
+};
+
+} // __IsoAgLib
+
+#endif
@@ -33,4 +33,148 @@ getInputsInstance()
 }
 
 
+Inputs_c::Inputs_c()
+  : mui8_analogSlotEnd( 0 )
+  , mui32_analogSampleCnt( 0 )
+{
+  for( uint8_t ui8_slot = 0; ui8_slot < CONFIG_ANALOG_SAMPLER_CHANNELS; ++ui8_slot )
+  {
+    mui16_analogValue[ ui8_slot ] = 0;
+    mui8_analogRange[ ui8_slot ] = 0;
+    marr_analogHistory[ ui8_slot ].pc_input = NULL;
+  }
+}
+
+
+void
+Inputs_c::init()
+{
+  mui32_analogSampleCnt = 0;
+}
+
+
+void
+Inputs_c::close()
+{
+  for( uint8_t ui8_slot = 0; ui8_slot < mui8_analogSlotEnd; ++ui8_slot )
+  {
+    if( marr_analogHistory[ ui8_slot ].pc_input != NULL )
+      *marr_analogHistory[ ui8_slot ].pui8_slot = 0xFF;
+    marr_analogHistory[ ui8_slot ].pc_input = NULL;
+  }
+  mui8_analogSlotEnd = 0;
+}
+
+
+bool
+Inputs_c::registerAnalog( const AnalogI_c& arc_input, AnalogSampler_t pf_sampler, uint8_t& rui8_slot, AnalogFilter_t filter )
+{
+  uint8_t ui8_slot = 0;
+  while( ( ui8_slot < CONFIG_ANALOG_SAMPLER_CHANNELS ) && ( marr_analogHistory[ ui8_slot ].pc_input != NULL ) )
+    ++ui8_slot;
+  if( ui8_slot == CONFIG_ANALOG_SAMPLER_CHANNELS )
+    return false;
+
+  AnalogHistory_s &rs_history = marr_analogHistory[ ui8_slot ];
+  rs_history.pc_input = &arc_input;
+  rs_history.pf_sampler = pf_sampler;
+  rs_history.pui8_slot = &rui8_slot;
+  rs_history.en_filter = filter;
+  rs_history.ui16_minValid = 0;
+  rs_history.ui16_maxValid = 0xFFFF;
+  rs_history.ui8_fill = 0;
+  rs_history.ui8_pos = 0;
+
+  // the input's val() must not answer from a stale slot
+  mui16_analogValue[ ui8_slot ] = pf_sampler( arc_input );
+  mui8_analogRange[ ui8_slot ] = 0;
+
+  if( ui8_slot >= mui8_analogSlotEnd )
+    mui8_analogSlotEnd = uint8_t( ui8_slot + 1 );
+  rui8_slot = ui8_slot;
+  return true;
+}
+
+
+void
+Inputs_c::unregisterAnalog( uint8_t aui8_slot )
+{
+  marr_analogHistory[ aui8_slot ].pc_input = NULL;
+  while( ( mui8_analogSlotEnd > 0 ) && ( marr_analogHistory[ mui8_analogSlotEnd - 1 ].pc_input == NULL ) )
+    --mui8_analogSlotEnd;
+}
+
+
+void
+Inputs_c::setAnalogRange( uint8_t aui8_slot, uint16_t aui16_minValid, uint16_t aui16_maxValid )
+{
+  marr_analogHistory[ aui8_slot ].ui16_minValid = aui16_minValid;
+  marr_analogHistory[ aui8_slot ].ui16_maxValid = aui16_maxValid;
+  evaluateRange( aui8_slot );
+}
+
+
+void
+Inputs_c::evaluateRange( uint8_t aui8_slot )
+{
+  const AnalogHistory_s &crs_history = marr_analogHistory[ aui8_slot ];
+  const uint16_t cui16_value = mui16_analogValue[ aui8_slot ];
+
+  uint8_t ui8_range = 0;
+  if( cui16_value < crs_history.ui16_minValid ) ui8_range |= RangeTooLow;
+  if( cui16_value > crs_history.ui16_maxValid ) ui8_range |= RangeTooHigh;
+  mui8_analogRange[ aui8_slot ] = ui8_range;
+}
+
+
+void
+Inputs_c::sampleAnalog()
+{
+  for( uint8_t ui8_slot = 0; ui8_slot < mui8_analogSlotEnd; ++ui8_slot )
+  {
+    AnalogHistory_s &rs_history = marr_analogHistory[ ui8_slot ];
+    if( rs_history.pc_input == NULL )
+      continue;
+
+    const uint16_t cui16_sample = rs_history.pf_sampler( *rs_history.pc_input );
+    uint16_t ui16_value = cui16_sample;
+
+    if( rs_history.en_filter != AnalogLatest )
+    {
+      rs_history.ui16_samples[ rs_history.ui8_pos ] = cui16_sample;
+      rs_history.ui8_pos = uint8_t( ( rs_history.ui8_pos + 1 ) % CONFIG_ANALOG_SAMPLER_DEPTH );
+      if( rs_history.ui8_fill < CONFIG_ANALOG_SAMPLER_DEPTH )
+        ++rs_history.ui8_fill;
+
+      // the samples are in the first ui8_fill entries until the ring is full
+      const uint8_t cui8_fill = rs_history.ui8_fill;
+      if( rs_history.en_filter == AnalogAverage )
+      {
+        uint32_t ui32_sum = 0;
+        for( uint8_t ui8_n = 0; ui8_n < cui8_fill; ++ui8_n )
+          ui32_sum += rs_history.ui16_samples[ ui8_n ];
+        ui16_value = uint16_t( ( ui32_sum + cui8_fill / 2 ) / cui8_fill );
+      }
+      else
+      { // insertion sort of a copy - the depth is small
+        uint16_t ui16_sorted[ CONFIG_ANALOG_SAMPLER_DEPTH ];
+        for( uint8_t ui8_n = 0; ui8_n < cui8_fill; ++ui8_n )
+        {
+          const uint16_t cui16_new = rs_history.ui16_samples[ ui8_n ];
+          uint8_t ui8_pos = ui8_n;
+          for( ; ( ui8_pos > 0 ) && ( ui16_sorted[ ui8_pos - 1 ] > cui16_new ); --ui8_pos )
+            ui16_sorted[ ui8_pos ] = ui16_sorted[ ui8_pos - 1 ];
+          ui16_sorted[ ui8_pos ] = cui16_new;
+        }
+        ui16_value = ui16_sorted[ cui8_fill / 2 ];
+      }
+    }
+
+    mui16_analogValue[ ui8_slot ] = ui16_value;
+    evaluateRange( ui8_slot );
+  }
+  ++mui32_analogSampleCnt;
+}
+
+
 } // __IsoAgLib
@@ -20,23 +20,91 @@
 #ifndef INPUTS_C_H
 #define INPUTS_C_H
 
+#include <IsoAgLib/isoaglib_config.h>
+
 
 namespace __IsoAgLib {
 
+class AnalogI_c;
+
 /**
   Class for management of Inputs.
-  Currently unsused, but should be initialized/closed nevertheless!
+  Should be initialized/closed nevertheless!
+
+  Holds the analog sampling table: sampleAnalog() reads all analog
+  inputs registered by AnalogI_c::setSampled() once from the HAL,
+  filters them and evaluates their range. Until the next
+  sampleAnalog() their val() and range checks answer from this
+  snapshot, without HAL access.
   */
 class Inputs_c {
 public:
-  void init() {}
-  void close() {}
+  enum AnalogFilter_t {
+    AnalogLatest,   // value of the last sampleAnalog()
+    AnalogAverage,  // mean of the last CONFIG_ANALOG_SAMPLER_DEPTH samples
+    AnalogMedian    // median of the last CONFIG_ANALOG_SAMPLER_DEPTH samples
+  };
+
+  void init();
+  void close();
+
+  /** read all registered analog inputs from the HAL and update the
+    table; call once per application cycle or from a HAL timer callback.
+    Readers in the same task see a consistent snapshot of all channels. */
+  void sampleAnalog();
+
+  //! number of sampleAnalog() calls since init
+  uint32_t analogSampleCnt() const { return mui32_analogSampleCnt; }
+
+  /** reads the input from the HAL; supplied by AnalogI_c, so this
+    file doesn't depend on the analog input driver being built */
+  typedef uint16_t (*AnalogSampler_t)( const AnalogI_c& );
+
+  /** take the input into the table
+    @param rui8_slot the input's slot index, set here and reset to 0xFF on close()
+    @return false if the table is full */
+  bool registerAnalog( const AnalogI_c& arc_input, AnalogSampler_t pf_sampler, uint8_t& rui8_slot, AnalogFilter_t filter );
+  void unregisterAnalog( uint8_t aui8_slot );
+
+  uint16_t analogValue( uint8_t aui8_slot ) const { return mui16_analogValue[ aui8_slot ]; }
+  bool analogTooLow( uint8_t aui8_slot ) const { return ( mui8_analogRange[ aui8_slot ] & RangeTooLow ) != 0; }
+  bool analogTooHigh( uint8_t aui8_slot ) const { return ( mui8_analogRange[ aui8_slot ] & RangeTooHigh ) != 0; }
+  void setAnalogRange( uint8_t aui8_slot, uint16_t aui16_minValid, uint16_t aui16_maxValid );
 
 private:
+  enum {
+    RangeTooLow  = 0x01,
+    RangeTooHigh = 0x02
+  };
+
+  struct AnalogHistory_s
+  {
+    const AnalogI_c* pc_input;  // NULL: slot is free
+    AnalogSampler_t pf_sampler;
+    uint8_t* pui8_slot;
+    AnalogFilter_t en_filter;
+    uint16_t ui16_minValid;
+    uint16_t ui16_maxValid;
+    uint8_t ui8_fill;
+    uint8_t ui8_pos;
+    uint16_t ui16_samples[ CONFIG_ANALOG_SAMPLER_DEPTH ];
+  };
+
+  void evaluateRange( uint8_t aui8_slot );
+
   // only for singleton
-  Inputs_c() {}
+  Inputs_c();
   ~Inputs_c() {}
 
+  // results, read many times per cycle, kept together
+  uint16_t mui16_analogValue[ CONFIG_ANALOG_SAMPLER_CHANNELS ];
+  uint8_t mui8_analogRange[ CONFIG_ANALOG_SAMPLER_CHANNELS ];
+
+  AnalogHistory_s marr_analogHistory[ CONFIG_ANALOG_SAMPLER_CHANNELS ];
+  //! slots below are possibly used, all above are free
+  uint8_t mui8_analogSlotEnd;
+  uint32_t mui32_analogSampleCnt;
+
 private:
   friend Inputs_c &getInputsInstance();
 };
@@ -72,6 +72,24 @@ public:
   */
   void set(bool ab_state) { DigitalO_c::set(ab_state); }
 
+  /**
+    stage the output PWM frequency for the next iOutputs_c::commit()
+    @param aui32_val value to use as PWM frequency in [mHz]
+  */
+  void stageFreq(uint32_t aui32_val) { DigitalO_c::stageFreq(aui32_val); }
+
+  /**
+    stage the output PWM value for the next iOutputs_c::commit()
+    @param aui16_val value to set for the output channel
+  */
+  void stage(uint16_t aui16_val) { DigitalO_c::stage(aui16_val); }
+
+  /**
+    stage total OFF or ON for the next iOutputs_c::commit()
+    @param ab_state
+  */
+  void stage(bool ab_state) { DigitalO_c::stage(ab_state); }
+
   /**
     deliver actual set value
     @return last set value [0..0xffff]
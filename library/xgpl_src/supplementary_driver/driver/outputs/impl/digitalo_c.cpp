@@ -19,6 +19,7 @@
 */
 
 #include "digitalo_c.h"
+#include "outputs_c.h"
 #include <IsoAgLib/util/iassert.h>
 
 
@@ -53,6 +54,7 @@ DigitalO_c::setFreq(uint32_t aui32_val)
   { // wrong channel number or wrong frequency
     isoaglib_assert( !"setFreq error" );
   }
+  getOutputsInstance().notifyPwmFreq(channelNr(), aui32_val);
 }
 
 
@@ -60,6 +62,7 @@ void
 DigitalO_c::set(uint16_t aui16_val)
 {
   HAL::setDigout(channelNr(), aui16_val);
+  getOutputsInstance().notifyDigout(channelNr(), aui16_val);
 }
 
 
@@ -70,6 +73,27 @@ DigitalO_c::set(bool ab_state)
 }
 
 
+void
+DigitalO_c::stageFreq(uint32_t aui32_val)
+{
+  getOutputsInstance().stagePwmFreq(channelNr(), aui32_val);
+}
+
+
+void
+DigitalO_c::stage(uint16_t aui16_val)
+{
+  getOutputsInstance().stageDigout(channelNr(), aui16_val);
+}
+
+
+void
+DigitalO_c::stage(bool ab_state)
+{
+  stage( ab_state ? getMaxOutputPwm() : uint16_t(0) );
+}
+
+
 bool
 DigitalO_c::good() const
 {
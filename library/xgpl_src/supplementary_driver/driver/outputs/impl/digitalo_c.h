@@ -77,6 +77,25 @@ public:
   */
   void set(bool ab_state);
 
+  /**
+    stage the output PWM frequency for the next Outputs_c::commit()
+    @param aui32_val value to use as PWM frequency in [mHz]
+  */
+  void stageFreq(uint32_t aui32_val);
+
+  /**
+    stage the output PWM value for the next Outputs_c::commit()
+    @param aui16_val value to set for the output channel [0..0xffff]
+  */
+  void stage(uint16_t aui16_val);
+
+  /**
+    stage total OFF or ON for the next Outputs_c::commit()
+    (ON is the max PWM of the frequency currently written)
+    @param ab_state
+  */
+  void stage(bool ab_state);
+
   /**
     deliver actual set value
     @return last set value [0..0xffff]
@@ -23,6 +23,7 @@
 #include <IsoAgLib/util/iliberr_c.h>
 #include <IsoAgLib/driver/system/impl/system_c.h>
 #include <supplementary_driver/hal/hal_outputs.h>
+#include <IsoAgLib/util/iassert.h>
 
 
 namespace __IsoAgLib {
@@ -34,6 +35,22 @@ getOutputsInstance()
 }
 
 
+void
+Outputs_c::init()
+{
+  for( uint8_t ui8_index = 0; ui8_index < NumChannels; ++ui8_index )
+  {
+    mui16_stagedPwm[ ui8_index ] = 0;
+    mui16_writtenPwm[ ui8_index ] = 0;
+    mui32_stagedFreq[ ui8_index ] = 0;
+    mui32_writtenFreq[ ui8_index ] = 0;
+    mui8_flags[ ui8_index ] = 0;
+  }
+  mui8_dirtyCnt = 0;
+  resetStatistics();
+}
+
+
 void
 Outputs_c::setMainRelais( bool ab_active )
 {
@@ -41,4 +58,149 @@ Outputs_c::setMainRelais( bool ab_active )
 }
 
 
+void
+Outputs_c::markDirty( uint8_t aui8_index, uint8_t aui8_flag )
+{
+  if( ( mui8_flags[ aui8_index ] & ( FlagPwmDirty | FlagFreqDirty ) ) == 0 )
+    mui8_dirty[ mui8_dirtyCnt++ ] = aui8_index;
+  mui8_flags[ aui8_index ] |= aui8_flag;
+}
+
+
+void
+Outputs_c::stageDigout( uint8_t aui8_channel, uint16_t aui16_val )
+{
+  isoaglib_assert( uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN ) < NumChannels );
+  const uint8_t cui8_index = uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN );
+
+  mui16_stagedPwm[ cui8_index ] = aui16_val;
+  if( ( mui8_flags[ cui8_index ] & FlagPwmKnown ) && ( mui16_writtenPwm[ cui8_index ] == aui16_val ) )
+  { // a pending change may have been reverted, commit() skips it then
+    if( ( mui8_flags[ cui8_index ] & FlagPwmDirty ) == 0 )
+      ++marr_statistics[ cui8_index ].suppressed;
+  }
+  else
+    markDirty( cui8_index, FlagPwmDirty );
+}
+
+
+void
+Outputs_c::stagePwmFreq( uint8_t aui8_channel, uint32_t aui32_val )
+{
+  isoaglib_assert( uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN ) < NumChannels );
+  const uint8_t cui8_index = uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN );
+
+  mui32_stagedFreq[ cui8_index ] = aui32_val;
+  if( ( mui8_flags[ cui8_index ] & FlagFreqKnown ) && ( mui32_writtenFreq[ cui8_index ] == aui32_val ) )
+  {
+    if( ( mui8_flags[ cui8_index ] & FlagFreqDirty ) == 0 )
+      ++marr_statistics[ cui8_index ].suppressed;
+  }
+  else
+    markDirty( cui8_index, FlagFreqDirty );
+}
+
+
+uint8_t
+Outputs_c::commit()
+{
+  uint8_t ui8_channels[ NumChannels ];
+  uint16_t ui16_values[ NumChannels ];
+  uint8_t ui8_cnt = 0;
+
+  for( uint8_t ui8_pos = 0; ui8_pos < mui8_dirtyCnt; ++ui8_pos )
+  {
+    const uint8_t cui8_index = mui8_dirty[ ui8_pos ];
+    const uint8_t cui8_channel = uint8_t( cui8_index + DIGITAL_OUTPUT_MIN );
+    uint8_t &rui8_flags = mui8_flags[ cui8_index ];
+    ChannelStatistics_s &rs_statistics = marr_statistics[ cui8_index ];
+
+    // the frequency goes first, as the PWM value is relative to it
+    if( rui8_flags & FlagFreqDirty )
+    {
+      if( ( rui8_flags & FlagFreqKnown ) && ( mui32_writtenFreq[ cui8_index ] == mui32_stagedFreq[ cui8_index ] ) )
+        ++rs_statistics.suppressed;
+      else
+      {
+        if( HAL::setPwmFreq( cui8_channel, mui32_stagedFreq[ cui8_index ] ) != HAL_NO_ERR )
+        { // wrong channel number or wrong frequency
+          isoaglib_assert( !"stagePwmFreq error" );
+        }
+        mui32_writtenFreq[ cui8_index ] = mui32_stagedFreq[ cui8_index ];
+        rui8_flags |= FlagFreqKnown;
+        ++rs_statistics.writes;
+      }
+    }
+
+    if( rui8_flags & FlagPwmDirty )
+    {
+      if( ( rui8_flags & FlagPwmKnown ) && ( mui16_writtenPwm[ cui8_index ] == mui16_stagedPwm[ cui8_index ] ) )
+        ++rs_statistics.suppressed;
+      else
+      {
+        ui8_channels[ ui8_cnt ] = cui8_channel;
+        ui16_values[ ui8_cnt ] = mui16_stagedPwm[ cui8_index ];
+        ++ui8_cnt;
+        mui16_writtenPwm[ cui8_index ] = mui16_stagedPwm[ cui8_index ];
+        rui8_flags |= FlagPwmKnown;
+        ++rs_statistics.writes;
+      }
+    }
+
+    rui8_flags &= uint8_t( ~( FlagPwmDirty | FlagFreqDirty ) );
+  }
+  mui8_dirtyCnt = 0;
+
+  if( ui8_cnt > 0 )
+    HAL::setDigouts( ui8_channels, ui16_values, ui8_cnt );
+
+  return ui8_cnt;
+}
+
+
+void
+Outputs_c::invalidate()
+{
+  for( uint8_t ui8_index = 0; ui8_index < NumChannels; ++ui8_index )
+    mui8_flags[ ui8_index ] &= uint8_t( ~( FlagPwmKnown | FlagFreqKnown ) );
+}
+
+
+void
+Outputs_c::resetStatistics()
+{
+  for( uint8_t ui8_index = 0; ui8_index < NumChannels; ++ui8_index )
+  {
+    marr_statistics[ ui8_index ].writes = 0;
+    marr_statistics[ ui8_index ].suppressed = 0;
+  }
+}
+
+
+void
+Outputs_c::notifyDigout( uint8_t aui8_channel, uint16_t aui16_val )
+{
+  if( uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN ) >= NumChannels )
+    return;
+  const uint8_t cui8_index = uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN );
+
+  mui16_writtenPwm[ cui8_index ] = aui16_val;
+  mui8_flags[ cui8_index ] |= FlagPwmKnown;
+  ++marr_statistics[ cui8_index ].writes;
+}
+
+
+void
+Outputs_c::notifyPwmFreq( uint8_t aui8_channel, uint32_t aui32_val )
+{
+  if( uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN ) >= NumChannels )
+    return;
+  const uint8_t cui8_index = uint8_t( aui8_channel - DIGITAL_OUTPUT_MIN );
+
+  mui32_writtenFreq[ cui8_index ] = aui32_val;
+  mui8_flags[ cui8_index ] |= FlagFreqKnown;
+  ++marr_statistics[ cui8_index ].writes;
+}
+
+
 } // __IsoAgLib
@@ -28,21 +28,78 @@ namespace __IsoAgLib {
 
 /**
   Hardware dependent object for hardware independent getting of output data;
+
+  Besides the immediate DigitalO_c::set(), outputs can be staged: the
+  stage...() calls only update shadow registers, commit() then writes
+  just the channels whose value differs from the one last written,
+  the PWM values with one HAL::setDigouts() call. Applications that
+  re-assert all outputs every cycle thus only cause HAL calls on change.
   */
 class Outputs_c
 {
 public:
-  void init() {}
+  enum { NumChannels = DIGITAL_OUTPUT_MAX - DIGITAL_OUTPUT_MIN + 1 };
+
+  struct ChannelStatistics_s
+  {
+    uint32_t writes;     // HAL calls (PWM value and frequency)
+    uint32_t suppressed; // staged values equal to the written ones
+  };
+
+  void init();
   void close() {}
 
   /** control the relay which is responsible for activation of the PWM output */
   void setMainRelais( bool ab_active ); 
 
+  /** stage the PWM value of an output for the next commit() */
+  void stageDigout( uint8_t aui8_channel, uint16_t aui16_val );
+  /** stage the PWM frequency [mHz] of an output for the next commit() */
+  void stagePwmFreq( uint8_t aui8_channel, uint32_t aui32_val );
+
+  /** write all staged changes to the HAL: frequencies first,
+    then the PWM values in one batch.
+    @return number of PWM values written */
+  uint8_t commit();
+
+  /** forget the written values, so each channel is written on its next
+    commit - e.g. after the outputs were switched off by the main relay */
+  void invalidate();
+
+  const ChannelStatistics_s& statistics( uint8_t aui8_channel ) const
+  { return marr_statistics[ aui8_channel - DIGITAL_OUTPUT_MIN ]; }
+  void resetStatistics();
+
+  /** keep the shadow registers in line with immediate DigitalO_c writes */
+  void notifyDigout( uint8_t aui8_channel, uint16_t aui16_val );
+  void notifyPwmFreq( uint8_t aui8_channel, uint32_t aui32_val );
+
 private:
+  enum {
+    FlagPwmKnown  = 0x01,
+    FlagFreqKnown = 0x02,
+    FlagPwmDirty  = 0x04,
+    FlagFreqDirty = 0x08
+  };
+
+  void markDirty( uint8_t aui8_index, uint8_t aui8_flag );
+
   // for singleton only
-  Outputs_c() {}
+  Outputs_c() { init(); }
   ~Outputs_c() {}
 
+  uint16_t mui16_stagedPwm[ NumChannels ];
+  uint16_t mui16_writtenPwm[ NumChannels ];
+  uint32_t mui32_stagedFreq[ NumChannels ];
+  uint32_t mui32_writtenFreq[ NumChannels ];
+  uint8_t mui8_flags[ NumChannels ];
+
+  //! indices of the channels with a Flag...Dirty set, in staging order
+  uint8_t mui8_dirty[ NumChannels ];
+  uint8_t mui8_dirtyCnt;
+
+  ChannelStatistics_s marr_statistics[ NumChannels ];
+
 private:
   friend Outputs_c &getOutputsInstance();
 };
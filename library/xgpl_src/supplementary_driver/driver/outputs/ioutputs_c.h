@@ -39,6 +39,24 @@ public:
   /** control the relay which is responsible for activation of the PWM output */
   void setMainRelais( bool ab_active ) { Outputs_c::setMainRelais( ab_active ); }
 
+  typedef __IsoAgLib::Outputs_c::ChannelStatistics_s ChannelStatistics_s;
+
+  /** stage the PWM value of an output for the next commit() */
+  void stageDigout( uint8_t aui8_channel, uint16_t aui16_val ) { Outputs_c::stageDigout( aui8_channel, aui16_val ); }
+  /** stage the PWM frequency [mHz] of an output for the next commit() */
+  void stagePwmFreq( uint8_t aui8_channel, uint32_t aui32_val ) { Outputs_c::stagePwmFreq( aui8_channel, aui32_val ); }
+
+  /** write all staged changes that differ from the last written values
+    @return number of PWM values written */
+  uint8_t commit() { return Outputs_c::commit(); }
+
+  /** have each channel written on its next commit */
+  void invalidate() { Outputs_c::invalidate(); }
+
+  /** HAL writes and suppressed (unchanged) values of an output */
+  const ChannelStatistics_s& statistics( uint8_t aui8_channel ) const { return Outputs_c::statistics( aui8_channel ); }
+  void resetStatistics() { Outputs_c::resetStatistics(); }
+
 private:
   /** allow getIoutputsInstance() access to shielded base class.
       otherwise __IsoAgLib::getOutputsInstance() wouldn't be accepted by compiler
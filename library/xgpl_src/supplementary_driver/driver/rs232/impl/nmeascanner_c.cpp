@@ -0,0 +1,527 @@
+/*
+  nmeascanner_c.cpp:
+    source for NmeaScanner_c, incremental NMEA-0183 sentence
+    framing and decoding on top of RS232IO_c
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#include "nmeascanner_c.h"
+#include "rs232io_c.h"
+
+
+namespace __IsoAgLib {
+
+namespace {
+
+// GGA has the most fields (14), leave some room for proprietary extensions
+const uint8_t scui8_maxFields = 20;
+
+struct Field_s
+{
+  const char* begin;
+  const char* end;
+
+  bool empty() const { return begin == end; }
+  char first() const { return empty() ? '\0' : *begin; }
+};
+
+
+inline bool isDigit( char c ) { return ( c >= '0' ) && ( c <= '9' ); }
+
+
+int8_t hexValue( char c )
+{
+  if( isDigit( c ) ) return int8_t( c - '0' );
+  if( ( c >= 'A' ) && ( c <= 'F' ) ) return int8_t( c - 'A' + 10 );
+  if( ( c >= 'a' ) && ( c <= 'f' ) ) return int8_t( c - 'a' + 10 );
+  return -1;
+}
+
+
+/** split the fields after "$ttSSS," up to '*' (or the end)
+  @return number of fields */
+uint8_t splitFields( const char* sentence, uint16_t len, Field_s* fields )
+{
+  const char* end = sentence + len;
+  const char* pos = sentence + 7;
+  uint8_t cnt = 0;
+
+  fields[ 0 ].begin = pos;
+  for( ; ( pos < end ) && ( *pos != '*' ); ++pos )
+  {
+    if( *pos == ',' )
+    {
+      fields[ cnt ].end = pos;
+      if( ++cnt == scui8_maxFields )
+        return cnt;
+      fields[ cnt ].begin = pos + 1;
+    }
+  }
+  fields[ cnt ].end = pos;
+  return uint8_t( cnt + 1 );
+}
+
+
+/** parse a decimal field as fixed point value with the given number of
+  decimals, further decimals are cut off.
+  The caller chooses decimals so the value fits into 31 bits. */
+bool parseFixed( const Field_s& field, uint8_t decimals, int32_t& value )
+{
+  const char* pos = field.begin;
+  bool b_negative = false;
+  if( ( pos < field.end ) && ( ( *pos == '-' ) || ( *pos == '+' ) ) )
+  {
+    b_negative = ( *pos == '-' );
+    ++pos;
+  }
+
+  int32_t i32_val = 0;
+  bool b_digits = false;
+  for( ; ( pos < field.end ) && isDigit( *pos ); ++pos, b_digits = true )
+    i32_val = i32_val * 10 + ( *pos - '0' );
+
+  uint8_t ui8_dec = 0;
+  if( ( pos < field.end ) && ( *pos == '.' ) )
+  {
+    for( ++pos; ( pos < field.end ) && isDigit( *pos ); ++pos, b_digits = true )
+    {
+      if( ui8_dec < decimals )
+      {
+        i32_val = i32_val * 10 + ( *pos - '0' );
+        ++ui8_dec;
+      }
+    }
+  }
+
+  if( ( pos != field.end ) || !b_digits )
+    return false;
+
+  for( ; ui8_dec < decimals; ++ui8_dec )
+    i32_val *= 10;
+  value = b_negative ? -i32_val : i32_val;
+  return true;
+}
+
+
+bool parseUnsigned( const Field_s& field, uint8_t decimals, uint32_t& value )
+{
+  int32_t i32_val;
+  if( !parseFixed( field, decimals, i32_val ) || ( i32_val < 0 ) )
+    return false;
+  value = uint32_t( i32_val );
+  return true;
+}
+
+
+/** "(d)ddmm.mmmm" with hemisphere 'N'/'S' resp. 'E'/'W' */
+bool parseCoordinate( const Field_s& field, const Field_s& hemisphere, char negative, int32_t& degree10Minus7 )
+{
+  // minutes with 5 decimals keep ddddmm.mmmmm within 31 bits
+  int32_t i32_val;
+  if( !parseFixed( field, 5, i32_val ) || ( i32_val < 0 ) || hemisphere.empty() )
+    return false;
+
+  const int32_t i32_degree = i32_val / 10000000;
+  const int32_t i32_minutes10Minus5 = i32_val % 10000000;
+  if( i32_minutes10Minus5 >= 6000000 )
+    return false;
+
+  // deg * 10^7 + min * 10^5 * 100 / 60
+  degree10Minus7 = i32_degree * 10000000 + ( i32_minutes10Minus5 * 5 + 1 ) / 3;
+  if( hemisphere.first() == negative )
+    degree10Minus7 = -degree10Minus7;
+  return true;
+}
+
+
+/** "hhmmss(.sss)" */
+bool parseTime( const Field_s& field, NmeaData_s& data )
+{
+  uint32_t ui32_val;
+  if( !parseUnsigned( field, 3, ui32_val ) )
+    return false;
+
+  const uint32_t ui32_hhmmss = ui32_val / 1000;
+  data.hour = uint8_t( ui32_hhmmss / 10000 );
+  data.minute = uint8_t( ( ui32_hhmmss / 100 ) % 100 );
+  data.second = uint8_t( ui32_hhmmss % 100 );
+  data.msec = uint16_t( ui32_val % 1000 );
+  data.timeValid = ( data.hour < 24 ) && ( data.minute < 60 ) && ( data.second < 61 );
+  return data.timeValid;
+}
+
+
+/** "ddmmyy", two digit years from 80 on are taken as 19yy */
+bool parseDate( const Field_s& field, NmeaData_s& data )
+{
+  uint32_t ui32_val;
+  if( !parseUnsigned( field, 0, ui32_val ) )
+    return false;
+
+  data.day = uint8_t( ui32_val / 10000 );
+  data.month = uint8_t( ( ui32_val / 100 ) % 100 );
+  data.year = uint16_t( ( ( ui32_val % 100 ) < 80 ? 2000 : 1900 ) + ( ui32_val % 100 ) );
+  data.dateValid = ( data.day >= 1 ) && ( data.day <= 31 ) && ( data.month >= 1 ) && ( data.month <= 12 );
+  return data.dateValid;
+}
+
+
+uint16_t limitUint16( uint32_t value )
+{
+  return ( value > 0xFFFFUL ) ? uint16_t( 0xFFFF ) : uint16_t( value );
+}
+
+
+/** knots -> cm/s, 1 kn = 1852/3600 m/s */
+bool parseKnots( const Field_s& field, uint16_t& speedCmSec )
+{
+  uint32_t ui32_knots10Minus3;
+  if( !parseUnsigned( field, 3, ui32_knots10Minus3 ) || ( ui32_knots10Minus3 > 1000000UL ) )
+    return false;
+  speedCmSec = limitUint16( ( ui32_knots10Minus3 * 1852UL + 18000UL ) / 36000UL );
+  return true;
+}
+
+
+/** km/h -> cm/s */
+bool parseKmh( const Field_s& field, uint16_t& speedCmSec )
+{
+  uint32_t ui32_kmh10Minus3;
+  if( !parseUnsigned( field, 3, ui32_kmh10Minus3 ) )
+    return false;
+  speedCmSec = limitUint16( ( ui32_kmh10Minus3 + 18 ) / 36 );
+  return true;
+}
+
+
+/** degree -> rad * 10^4, pi/180 * 10 = 3927/22500 (error < 1e-6) */
+bool parseCourse( const Field_s& field, uint16_t& courseRad10Minus4 )
+{
+  uint32_t ui32_degree10Minus3;
+  if( !parseUnsigned( field, 3, ui32_degree10Minus3 ) || ( ui32_degree10Minus3 >= 360000UL ) )
+    return false;
+  courseRad10Minus4 = uint16_t( ( ui32_degree10Minus3 * 3927UL + 11250UL ) / 22500UL );
+  return true;
+}
+
+
+IsoAgLib::IsoGnssMethod_t ggaQualityToMethod( char quality )
+{
+  switch( quality )
+  {
+    case '0': return IsoAgLib::IsoNoGps;
+    case '1': return IsoAgLib::IsoGnssFix;
+    case '2': return IsoAgLib::IsoDgnssFix;
+    case '3': return IsoAgLib::IsoGnssPrecise;
+    case '4': return IsoAgLib::IsoRtkFixedInteger;
+    case '5': return IsoAgLib::IsoRtkFloat;
+    case '6': return IsoAgLib::IsoDrEstimated;
+    case '7': return IsoAgLib::IsoGnssManual;
+    case '8': return IsoAgLib::IsoGnssSimulated;
+    default:  return IsoAgLib::IsoGnssError;
+  }
+}
+
+} // anonymous namespace
+
+
+NmeaData_s::NmeaData_s()
+  : timeValid( false )
+  , hour( 0 )
+  , minute( 0 )
+  , second( 0 )
+  , msec( 0 )
+  , dateValid( false )
+  , year( 0 )
+  , month( 0 )
+  , day( 0 )
+  , positionValid( false )
+  , latitudeDegree10Minus7( 0 )
+  , longitudeDegree10Minus7( 0 )
+  , altitudeValid( false )
+  , altitudeCm( 0 )
+  , geoidalSeparationCm( 0 )
+  , gnssMethod( IsoAgLib::IsoGnssNull )
+  , satelliteCnt( 0 )
+  , hdop10Minus2( 0 )
+  , directionValid( false )
+  , speedCmSec( 0 )
+  , courseRad10Minus4( 0 )
+  , deviationValid( false )
+  , latitudeDeviationCm( 0 )
+  , longitudeDeviationCm( 0 )
+  , altitudeDeviationCm( 0 )
+{
+}
+
+
+NmeaScanner_c::NmeaScanner_c()
+  : mpc_handler( NULL )
+  , mb_requireChecksum( true )
+  , men_state( StateIdle )
+  , mui16_len( 0 )
+  , mui8_checksum( 0 )
+  , mui8_received( 0 )
+  , mui32_sentences( 0 )
+  , mui32_checksumErrors( 0 )
+  , mui32_overflows( 0 )
+{
+  mc_line[ 0 ] = '\0';
+}
+
+
+void
+NmeaScanner_c::feed( const uint8_t* data, uint16_t len )
+{
+  for( const uint8_t* end = data + len; data < end; ++data )
+  {
+    const char c = char( *data );
+
+    // a start character always begins a new sentence, so a garbled
+    // sentence never swallows the next one
+    if( ( c == '$' ) || ( c == '!' ) )
+    {
+      mc_line[ 0 ] = c;
+      mui16_len = 1;
+      mui8_checksum = 0;
+      men_state = StateBody;
+      continue;
+    }
+
+    if( men_state == StateIdle )
+      continue;
+
+    if( ( c == '\r' ) || ( c == '\n' ) )
+    { // only reached without checksum
+      if( men_state != StateBody )
+        ++mui32_checksumErrors;
+      else if( !mb_requireChecksum )
+        complete();
+      else
+        ++mui32_checksumErrors;
+      men_state = StateIdle;
+      continue;
+    }
+
+    if( mui16_len >= CONFIG_RS232_NMEA_MAX_SENTENCE_LENGTH )
+    {
+      ++mui32_overflows;
+      men_state = StateIdle;
+      continue;
+    }
+    mc_line[ mui16_len++ ] = c;
+
+    switch( men_state )
+    {
+      case StateBody:
+        if( c == '*' )
+          men_state = StateChecksumHigh;
+        else
+          mui8_checksum ^= uint8_t( c );
+        break;
+
+      case StateChecksumHigh:
+      {
+        const int8_t i8_nibble = hexValue( c );
+        if( i8_nibble < 0 )
+        {
+          ++mui32_checksumErrors;
+          men_state = StateIdle;
+        }
+        else
+        {
+          mui8_received = uint8_t( i8_nibble << 4 );
+          men_state = StateChecksumLow;
+        }
+        break;
+      }
+
+      case StateChecksumLow:
+      {
+        const int8_t i8_nibble = hexValue( c );
+        if( ( i8_nibble >= 0 ) && ( ( mui8_received | uint8_t( i8_nibble ) ) == mui8_checksum ) )
+          complete();
+        else
+          ++mui32_checksumErrors;
+        men_state = StateIdle;
+        break;
+      }
+
+      case StateIdle:
+        break;
+    }
+  }
+}
+
+
+uint32_t
+NmeaScanner_c::process( RS232IO_c& rs232 )
+{
+  uint8_t pui8_chunk[ 64 ];
+  uint32_t ui32_total = 0;
+  uint16_t ui16_read;
+  while( ( ui16_read = rs232.receive( pui8_chunk, sizeof( pui8_chunk ) ) ) > 0 )
+  {
+    feed( pui8_chunk, ui16_read );
+    ui32_total += ui16_read;
+  }
+  return ui32_total;
+}
+
+
+void
+NmeaScanner_c::complete()
+{
+  mc_line[ mui16_len ] = '\0';
+  ++mui32_sentences;
+  if( mpc_handler != NULL )
+    mpc_handler->handleSentence( mc_line, mui16_len );
+}
+
+
+NmeaScanner_c::SentenceType_t
+NmeaScanner_c::sentenceType( const char* sentence, uint16_t len )
+{
+  // "$ttSSS,"
+  if( ( len < 7 ) || ( sentence[ 6 ] != ',' ) )
+    return SentenceUnknown;
+
+  const char* type = sentence + 3;
+  if( ( type[ 0 ] == 'G' ) && ( type[ 1 ] == 'G' ) && ( type[ 2 ] == 'A' ) ) return SentenceGga;
+  if( ( type[ 0 ] == 'R' ) && ( type[ 1 ] == 'M' ) && ( type[ 2 ] == 'C' ) ) return SentenceRmc;
+  if( ( type[ 0 ] == 'V' ) && ( type[ 1 ] == 'T' ) && ( type[ 2 ] == 'G' ) ) return SentenceVtg;
+  if( ( type[ 0 ] == 'G' ) && ( type[ 1 ] == 'S' ) && ( type[ 2 ] == 'T' ) ) return SentenceGst;
+  return SentenceUnknown;
+}
+
+
+NmeaScanner_c::SentenceType_t
+NmeaScanner_c::decode( const char* sentence, uint16_t len, NmeaData_s& data )
+{
+  const SentenceType_t en_type = sentenceType( sentence, len );
+  if( en_type == SentenceUnknown )
+    return en_type;
+
+  Field_s fields[ scui8_maxFields ];
+  const uint8_t ui8_fields = splitFields( sentence, len, fields );
+  // pad missing trailing fields (older NMEA versions) as empty
+  for( uint8_t ui8_ind = ui8_fields; ui8_ind < scui8_maxFields; ++ui8_ind )
+    fields[ ui8_ind ].begin = fields[ ui8_ind ].end = sentence + len;
+
+  switch( en_type )
+  {
+    case SentenceGga:
+    {
+      // time, lat, N/S, lon, E/W, quality, satellites, HDOP, alt, M, separation, M, ...
+      parseTime( fields[ 0 ], data );
+      data.gnssMethod = fields[ 5 ].empty() ? IsoAgLib::IsoGnssNull : ggaQualityToMethod( fields[ 5 ].first() );
+      const bool b_fix = ( data.gnssMethod != IsoAgLib::IsoNoGps ) && ( data.gnssMethod != IsoAgLib::IsoGnssError );
+
+      int32_t i32_lat, i32_lon;
+      if( b_fix
+          && parseCoordinate( fields[ 1 ], fields[ 2 ], 'S', i32_lat )
+          && parseCoordinate( fields[ 3 ], fields[ 4 ], 'W', i32_lon ) )
+      {
+        data.latitudeDegree10Minus7 = i32_lat;
+        data.longitudeDegree10Minus7 = i32_lon;
+        data.positionValid = true;
+      }
+      else
+        data.positionValid = false;
+
+      uint32_t ui32_val;
+      if( parseUnsigned( fields[ 6 ], 0, ui32_val ) )
+        data.satelliteCnt = ( ui32_val > 0xFF ) ? uint8_t( 0xFF ) : uint8_t( ui32_val );
+      if( parseUnsigned( fields[ 7 ], 2, ui32_val ) )
+        data.hdop10Minus2 = limitUint16( ui32_val );
+
+      data.altitudeValid = b_fix && parseFixed( fields[ 8 ], 2, data.altitudeCm );
+      if( !parseFixed( fields[ 10 ], 2, data.geoidalSeparationCm ) )
+        data.geoidalSeparationCm = 0;
+      break;
+    }
+
+    case SentenceRmc:
+    {
+      // time, status, lat, N/S, lon, E/W, speed [kn], course, date, ...
+      parseTime( fields[ 0 ], data );
+      parseDate( fields[ 8 ], data );
+      const bool b_fix = ( fields[ 1 ].first() == 'A' );
+
+      int32_t i32_lat, i32_lon;
+      if( b_fix
+          && parseCoordinate( fields[ 2 ], fields[ 3 ], 'S', i32_lat )
+          && parseCoordinate( fields[ 4 ], fields[ 5 ], 'W', i32_lon ) )
+      {
+        data.latitudeDegree10Minus7 = i32_lat;
+        data.longitudeDegree10Minus7 = i32_lon;
+        data.positionValid = true;
+      }
+      else
+        data.positionValid = false;
+
+      uint16_t ui16_speed, ui16_course = 0;
+      data.directionValid = b_fix && parseKnots( fields[ 6 ], ui16_speed )
+                         && ( fields[ 7 ].empty() || parseCourse( fields[ 7 ], ui16_course ) );
+      if( data.directionValid )
+      {
+        data.speedCmSec = ui16_speed;
+        data.courseRad10Minus4 = ui16_course;
+      }
+      break;
+    }
+
+    case SentenceVtg:
+    {
+      // course true, T, course magnetic, M, speed [kn], N, speed [km/h], K, mode
+      uint16_t ui16_speed, ui16_course = 0;
+      const bool b_fix = ( fields[ 8 ].first() != 'N' );
+      const bool b_speed = parseKmh( fields[ 6 ], ui16_speed ) || parseKnots( fields[ 4 ], ui16_speed );
+      data.directionValid = b_fix && b_speed
+                         && ( fields[ 0 ].empty() || parseCourse( fields[ 0 ], ui16_course ) );
+      if( data.directionValid )
+      {
+        data.speedCmSec = ui16_speed;
+        data.courseRad10Minus4 = ui16_course;
+      }
+      break;
+    }
+
+    case SentenceGst:
+    {
+      // time, rms, semi-major, semi-minor, orientation, lat sigma, lon sigma, alt sigma [m]
+      parseTime( fields[ 0 ], data );
+      uint32_t ui32_lat, ui32_lon, ui32_alt;
+      data.deviationValid = parseUnsigned( fields[ 5 ], 2, ui32_lat )
+                         && parseUnsigned( fields[ 6 ], 2, ui32_lon )
+                         && parseUnsigned( fields[ 7 ], 2, ui32_alt );
+      if( data.deviationValid )
+      {
+        data.latitudeDeviationCm = ui32_lat;
+        data.longitudeDeviationCm = ui32_lon;
+        data.altitudeDeviationCm = ui32_alt;
+      }
+      break;
+    }
+
+    case SentenceUnknown:
+      break;
+  }
+  return en_type;
+}
+
+} // __IsoAgLib
@@ -0,0 +1,177 @@
+/*
+  nmeascanner_c.h:
+    header for NmeaScanner_c, incremental NMEA-0183 sentence
+    framing and decoding on top of RS232IO_c
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef NMEASCANNER_C_H
+#define NMEASCANNER_C_H
+
+#include <IsoAgLib/isoaglib_config.h>
+#include <IsoAgLib/comm/Part7_ApplicationLayer/ibasetypes.h>
+
+namespace __IsoAgLib {
+
+class RS232IO_c;
+
+/** Values decoded from GGA, RMC, VTG and GST sentences, in the units of
+  the corresponding TimePosGps_c setters (setGpsLatitudeDegree10Minus7,
+  setGpsSpeedCmSec, setGpsCourseRad10Minus4, setGpsAltitudeCm,
+  setGnssMode, setSatelliteCnt, setHdop10Minus2, setTimeUtcGps,
+  setDateUtc). A sentence only updates the fields it carries,
+  the ...Valid flags tell which groups have been received so far.
+  Conversions are integer only, as in gnss_conversion.h.
+*/
+struct NmeaData_s
+{
+  NmeaData_s();
+
+  // GGA, RMC, GST
+  bool timeValid;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  uint16_t msec;
+
+  // RMC
+  bool dateValid;
+  uint16_t year;
+  uint8_t month;
+  uint8_t day;
+
+  // GGA, RMC (only with a fix)
+  bool positionValid;
+  int32_t latitudeDegree10Minus7;
+  int32_t longitudeDegree10Minus7;
+
+  // GGA
+  bool altitudeValid;
+  int32_t altitudeCm;          // above mean sea level
+  int32_t geoidalSeparationCm;
+  IsoAgLib::IsoGnssMethod_t gnssMethod;
+  uint8_t satelliteCnt;
+  uint16_t hdop10Minus2;
+
+  // RMC, VTG (only with a fix)
+  bool directionValid;
+  uint16_t speedCmSec;
+  uint16_t courseRad10Minus4;  // true course over ground
+
+  // GST: 1-sigma errors
+  bool deviationValid;
+  uint32_t latitudeDeviationCm;
+  uint32_t longitudeDeviationCm;
+  uint32_t altitudeDeviationCm;
+};
+
+
+/** Incremental NMEA-0183 sentence framer: received bytes are scanned
+  exactly once, the checksum is built on the fly, and each complete and
+  valid sentence is handed to the SentenceHandler_c straight out of the
+  scanner's line buffer - no copy, no rescan of partial sentences.
+  Call process() from the application's timeEvent (or feed() with bytes
+  from any other source), decode() the sentences of interest in the
+  handler.
+*/
+class NmeaScanner_c
+{
+public:
+  enum SentenceType_t {
+    SentenceUnknown,
+    SentenceGga,
+    SentenceRmc,
+    SentenceVtg,
+    SentenceGst
+  };
+
+  class SentenceHandler_c
+  {
+  public:
+    virtual ~SentenceHandler_c() {}
+
+    /** called for every complete sentence with matching (or, if not
+      required, without) checksum.
+      @param sentence "$GPGGA,...*hh" - 0-terminated, without CR/LF.
+                      Only valid during the call!
+      @param len length of the sentence */
+    virtual void handleSentence( const char* sentence, uint16_t len ) = 0;
+  };
+
+  NmeaScanner_c();
+
+  void setHandler( SentenceHandler_c* handler ) { mpc_handler = handler; }
+
+  /** accept sentences without "*hh" (default: rejected) */
+  void setRequireChecksum( bool require ) { mb_requireChecksum = require; }
+
+  /** scan the given bytes, the handler is called for each sentence
+    completed by them. Partial sentences are kept for the next call. */
+  void feed( const uint8_t* data, uint16_t len );
+
+  /** feed everything currently received on the given RS232 channel
+    @return number of bytes consumed */
+  uint32_t process( RS232IO_c& rs232 );
+
+  /** drop a partially received sentence, e.g. after a baudrate change */
+  void reset() { men_state = StateIdle; }
+
+  uint32_t sentenceCnt() const { return mui32_sentences; }
+  uint32_t checksumErrorCnt() const { return mui32_checksumErrors; }
+  //! sentences dropped for exceeding CONFIG_RS232_NMEA_MAX_SENTENCE_LENGTH
+  uint32_t overflowCnt() const { return mui32_overflows; }
+
+  static SentenceType_t sentenceType( const char* sentence, uint16_t len );
+
+  /** decode a GGA, RMC, VTG or GST sentence (any talker) into data.
+    The checksum is not checked again.
+    @return type of the sentence, SentenceUnknown leaves data untouched */
+  static SentenceType_t decode( const char* sentence, uint16_t len, NmeaData_s& data );
+
+private:
+  enum State_t {
+    StateIdle,
+    StateBody,
+    StateChecksumHigh,
+    StateChecksumLow
+  };
+
+  void complete();
+
+  SentenceHandler_c* mpc_handler;
+  bool mb_requireChecksum;
+
+  State_t men_state;
+  uint16_t mui16_len;
+  uint8_t mui8_checksum;
+  uint8_t mui8_received;
+
+  uint32_t mui32_sentences;
+  uint32_t mui32_checksumErrors;
+  uint32_t mui32_overflows;
+
+  char mc_line[ CONFIG_RS232_NMEA_MAX_SENTENCE_LENGTH + 1 ];
+
+  /** not copyable : copy constructor is only declared, never defined */
+  NmeaScanner_c(const NmeaScanner_c&);
+  /** not copyable : copy operator is only declared, never defined */
+  NmeaScanner_c& operator=(const NmeaScanner_c&);
+};
+
+} // __IsoAgLib
+
+#endif
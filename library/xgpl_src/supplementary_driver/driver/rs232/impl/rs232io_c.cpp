@@ -206,18 +206,35 @@ bool RS232IO_c::setRecBufferSize(uint16_t aui16_bufferSize)
   /* ********    sending     ******** */
   /* ******************************** */
 
-  void RS232IO_c::send(const uint8_t* apb_data, uint8_t aui8_len)
+  void RS232IO_c::send(const uint8_t* apb_data, uint16_t aui16_len)
   {
     isoaglib_assert( isInitialized() );
 
     uint16_t ui16_maxSendItemSize;
     uint16_t ui16_startSendPos = 0,
-            ui16_restLen = aui8_len;  
+            ui16_restLen = aui16_len;
+    ecutime_t t_lastProgress = HAL::getTime();
 
     while ( ui16_restLen > 0 )
     { // send max item
 
-      ui16_maxSendItemSize = mui16_sndBuf - HAL::getRs232TxBufCount(mui8_channel);    
+      const int16_t i16_pending = HAL::getRs232TxBufCount(mui8_channel);
+      if ( i16_pending < 0 ) {
+        isoaglib_assert( !"RS232 send buffer state error" );
+        return;
+      }
+      // the HAL may buffer more than mui16_sndBuf
+      ui16_maxSendItemSize = ( uint16_t( i16_pending ) < mui16_sndBuf )
+        ? uint16_t( mui16_sndBuf - i16_pending ) : 0;
+      if ( ui16_maxSendItemSize == 0 )
+      { // wait for the buffer to drain, but not forever
+        if ( ( HAL::getTime() - t_lastProgress ) > CONFIG_RS232_SEND_TIMEOUT ) {
+          isoaglib_assert( !"RS232 send buffer stalled" );
+          return;
+        }
+        continue;
+      }
+      t_lastProgress = HAL::getTime();
 
       // restrict actual max item size to waiting chars to send
       if ( ui16_maxSendItemSize > ui16_restLen ) ui16_maxSendItemSize = ui16_restLen;
@@ -236,7 +253,7 @@ bool RS232IO_c::setRecBufferSize(uint16_t aui16_bufferSize)
 
   RS232IO_c& RS232IO_c::operator<<(const char *const apc_data)
   {
-    send( (uint8_t*)(apc_data), (uint8_t)CNAMESPACE::strlen( apc_data ) );
+    send( (uint8_t*)(apc_data), (uint16_t)CNAMESPACE::strlen( apc_data ) );
     return *this;
   }
 
@@ -325,21 +342,14 @@ RS232IO_c& RS232IO_c::operator<<(float af_data)
 /* ********   receiving    ******** */
 /* ******************************** */
 
-void RS232IO_c::receive(uint8_t* pb_data, uint16_t aui16_len)
+uint16_t RS232IO_c::receive(uint8_t* pb_data, uint16_t aui16_len)
 {
   isoaglib_assert( isInitialized() );
 
-  uint8_t* pb_writer = pb_data;
-  uint16_t ui16_ind = 0;
-  for (; ui16_ind < aui16_len; ui16_ind++)
-  {
-    if (eof())
-    { // error - buffer empty before reading wanted count of data
-      break;
-    }
-    HAL::getRs232Char(pb_writer, mui8_channel);
-    pb_writer++;
-  }
+  // the HAL reports the count as int16_t
+  if ( aui16_len > 0x7FFF ) aui16_len = 0x7FFF;
+  const int16_t i16_read = HAL::getRs232NChar(pb_data, aui16_len, mui8_channel);
+  return ( i16_read > 0 ) ? uint16_t( i16_read ) : 0;
 }
 
 
@@ -170,14 +170,15 @@ public:
   /* ******************************** */
 
   /**
-    send data uint8_t string with given length on RS232
+    send data uint8_t string with given length on RS232;
+    passed to the HAL in blocks as large as the send buffer allows
 
     possible errors:
         * Err_c::rs232_overflow send buffer buffer overflow during send
     @param apb_data pointer to data string
-    @param aui8_len length of data string
+    @param aui16_len length of data string
   */
-  void send(const uint8_t* rpData, uint8_t aui8_len);
+  void send(const uint8_t* rpData, uint16_t aui16_len);
 
   /**
     send NULL terminated string on RS232 (terminating NULL isn't sent)
@@ -259,14 +260,15 @@ public:
   /* ******************************** */
 
   /**
-    receive data uint8_t string with given length on RS232
+    receive up to aui16_len bytes of data on RS232 as one block
 
     possible errors:
         * Err_c::rs232_underflow receive buffer underflow during receive
     @param pb_data pointer to data string
     @param aui16_len length of data string
+    @return number of bytes received (less than aui16_len if the receive buffer got empty)
   */
-  void receive(uint8_t* pData, uint16_t aui16_len);
+  uint16_t receive(uint8_t* pData, uint16_t aui16_len);
   /** read a line to the next apperance of '\n'.
       read nothing if the delimiter isn't found.
     @param pui8_data    pointer to buffer for writing the data
@@ -0,0 +1,74 @@
+/*
+  inmeascanner_c.h:
+    interface for incremental NMEA-0183 sentence framing and
+    decoding on top of iRS232IO_c
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef INMEASCANNER_C_H
+#define INMEASCANNER_C_H
+
+#include "impl/nmeascanner_c.h"
+#include "irs232io_c.h"
+
+namespace IsoAgLib {
+
+typedef __IsoAgLib::NmeaData_s iNmeaData_s;
+
+/** Reads GNSS receiver output from an RS232 channel sentence by sentence.
+  Derive from iNmeaScanner_c::SentenceHandler_c, set it as handler and
+  call process() periodically; decode() the sentences of interest
+  from within handleSentence():
+  @code
+  void MyGps_c::handleSentence( const char* sentence, uint16_t len )
+  {
+    if( iNmeaScanner_c::decode( sentence, len, m_data ) == iNmeaScanner_c::SentenceGga && m_data.positionValid )
+      ...
+  }
+  @endcode
+*/
+class iNmeaScanner_c : private __IsoAgLib::NmeaScanner_c
+{
+public:
+  using __IsoAgLib::NmeaScanner_c::SentenceHandler_c;
+  using __IsoAgLib::NmeaScanner_c::SentenceType_t;
+  using __IsoAgLib::NmeaScanner_c::SentenceUnknown;
+  using __IsoAgLib::NmeaScanner_c::SentenceGga;
+  using __IsoAgLib::NmeaScanner_c::SentenceRmc;
+  using __IsoAgLib::NmeaScanner_c::SentenceVtg;
+  using __IsoAgLib::NmeaScanner_c::SentenceGst;
+
+  iNmeaScanner_c() : NmeaScanner_c() {}
+
+  void setHandler( SentenceHandler_c* handler ) { NmeaScanner_c::setHandler( handler ); }
+  void setRequireChecksum( bool require ) { NmeaScanner_c::setRequireChecksum( require ); }
+
+  void feed( const uint8_t* data, uint16_t len ) { NmeaScanner_c::feed( data, len ); }
+  uint32_t process( iRS232IO_c& rs232 ) { return NmeaScanner_c::process( static_cast<__IsoAgLib::RS232IO_c&>( rs232 ) ); }
+  void reset() { NmeaScanner_c::reset(); }
+
+  uint32_t sentenceCnt() const { return NmeaScanner_c::sentenceCnt(); }
+  uint32_t checksumErrorCnt() const { return NmeaScanner_c::checksumErrorCnt(); }
+  uint32_t overflowCnt() const { return NmeaScanner_c::overflowCnt(); }
+
+  static SentenceType_t sentenceType( const char* sentence, uint16_t len ) { return NmeaScanner_c::sentenceType( sentence, len ); }
+  static SentenceType_t decode( const char* sentence, uint16_t len, iNmeaData_s& data ) { return NmeaScanner_c::decode( sentence, len, data ); }
+};
+
+} // IsoAgLib
+
+#endif
@@ -28,6 +28,8 @@
 
 namespace IsoAgLib {
 
+class iNmeaScanner_c;
+
 /**
   object for serial communication via RS232 device;
   the interface is initialized during constructor call;
@@ -169,9 +171,9 @@ public:
     possible errors:
         * Err_c::rs232_overflow send buffer buffer overflow during send
     @param rpData pointer to data string
-    @param aui8_len length of data string
+    @param aui16_len length of data string
   */
-  void send(const uint8_t* rpData, uint8_t aui8_len) {RS232IO_c::send(rpData, aui8_len);};
+  void send(const uint8_t* rpData, uint16_t aui16_len) {RS232IO_c::send(rpData, aui16_len);};
 
   /**
     send NULL terminated string on RS232 (terminating NULL isn't sent)
@@ -263,14 +265,15 @@ public:
   /* ******************************** */
 
   /**
-    receive data uint8_t string with given length on RS232
+    receive up to aui16_len bytes of data on RS232 as one block
 
     possible errors:
         * Err_c::rs232_underflow receive buffer underflow during receive
     @param pData pointer to data string
     @param aui16_len length of data string
+    @return number of bytes received (less than aui16_len if the receive buffer got empty)
   */
-  void receive(uint8_t* pData, uint16_t aui16_len) {RS232IO_c::receive(pData, aui16_len);};
+  uint16_t receive(uint8_t* pData, uint16_t aui16_len) {return RS232IO_c::receive(pData, aui16_len);};
   /** read a line to the next apperance of '\n'.
       read nothing if the delimiter isn't found.
     @param pui8_data    pointer to buffer for writing the data
@@ -366,6 +369,9 @@ public:
     {return static_cast<iRS232IO_c&>(RS232IO_c::operator>>(f_data));};
 
 private: //Private methods
+  /** allow iNmeaScanner_c::process() access to shielded base class */
+  friend class iNmeaScanner_c;
+
   #if defined( RS232_INSTANCE_CNT ) && ( RS232_INSTANCE_CNT > 1 )
   /** allow getIrs232Instance() access to shielded base class.
       otherwise __IsoAgLib::getRs232Instance() wouldn't be accepted by compiler
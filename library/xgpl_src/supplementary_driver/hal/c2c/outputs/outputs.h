@@ -99,6 +99,12 @@ namespace HAL
   void setDigout(uint8_t aui8_channel, uint16_t wPWMValue);
   uint16_t getDigout( uint8_t bOutputNo );
 
+  inline void setDigouts( const uint8_t* channels, const uint16_t* values, uint8_t count )
+  {
+    for( uint8_t i = 0; i < count; ++i )
+      setDigout( channels[i], values[i] );
+  }
+
   inline int16_t getDigoutCurrent( uint8_t aui8_channel )
   { return -1; }
 
@@ -140,6 +140,20 @@ namespace HAL
   */
   inline int16_t getRs232Char(uint8_t *pbRead, uint8_t aui8_channel)
     { isoaglib_header_assert(0 == aui8_channel); (void)aui8_channel; return __HAL::get_rs232_char(pbRead); }
+  /**
+    read up to wNumber bytes from receive buffer
+    (no block read in the BIOS, byte by byte)
+    @param pbRead pointer to target data
+    @param wNumber maximum number of bytes to read
+    @return number of bytes read
+  */
+  inline int16_t getRs232NChar(uint8_t *pbRead, uint16_t wNumber, uint8_t aui8_channel)
+  {
+    uint16_t ui16_read = 0;
+    while( ( ui16_read < wNumber ) && ( getRs232Char( pbRead + ui16_read, aui8_channel ) == HAL_NO_ERR ) )
+      ++ui16_read;
+    return int16_t( ui16_read );
+  }
   /**
     read bLastChar terminated string from receive buffer
     @param pbRead pointer to target data
@@ -101,6 +101,12 @@ namespace HAL
   void setDigout(uint8_t aui8_channel, uint16_t wPWMValue);
   uint16_t getDigout( uint8_t bOutputNo );
 
+  inline void setDigouts( const uint8_t* channels, const uint16_t* values, uint8_t count )
+  {
+    for( uint8_t i = 0; i < count; ++i )
+      setDigout( channels[i], values[i] );
+  }
+
   inline int16_t setDigoutMask(uint16_t wOutputMask, uint16_t wDigitalValue)
   { return __HAL::set_digout_mask(wOutputMask, wDigitalValue); }
 
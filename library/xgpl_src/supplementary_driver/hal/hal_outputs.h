@@ -64,6 +64,15 @@ namespace HAL
   */
   void setDigout( uint8_t aui8_channel, uint16_t wPWMValue);
 
+  /**
+    set the pwm values of several outputs at once
+    (targets without a batch BIOS function set them one by one)
+    @param channels channel numbers of the outputs
+    @param values Values to set, same order as channels; [0..0xFFFF]
+    @param count number of outputs to set
+  */
+  void setDigouts( const uint8_t* channels, const uint16_t* values, uint8_t count );
+
   /**
     get pwm value 0 ... 100 %
     @param aui8_channel channel number of output
@@ -24,6 +24,13 @@
 #else
   #include <fcntl.h>
 #endif
+#include <cstring>
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
 
 #if __GNUC__ < 3
   #define MACRO_IOS ios
@@ -33,9 +40,52 @@
 
 using namespace std;
 
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+//! map the whole file, only for plain reading of regular files
+bool TargetFileStreamInput_c::openMapped( const char* filename, FileMode_t at_mode )
+{
+  if ( ( at_mode & ( StreamOut | StreamApp | StreamTrunc ) ) != 0 ) return false;
+
+  const int fd = ::open( filename, O_RDONLY );
+  if ( fd < 0 ) return false;
+
+  struct stat s_stat;
+  if ( ( fstat( fd, &s_stat ) != 0 ) || !S_ISREG( s_stat.st_mode ) || ( uint64_t( s_stat.st_size ) > 0xFFFFFFFFULL ) )
+  {
+    ::close( fd );
+    return false;
+  }
+
+  void* p_map = NULL;
+  if ( s_stat.st_size > 0 )
+  { // the mapping stays valid after closing the descriptor
+    p_map = mmap( NULL, size_t( s_stat.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+    if ( p_map == MAP_FAILED )
+    {
+      ::close( fd );
+      return false;
+    }
+    madvise( p_map, size_t( s_stat.st_size ), MADV_SEQUENTIAL );
+  }
+  ::close( fd );
+
+  b_mapped = true;
+  pui8_map = static_cast<const uint8_t*>( p_map );
+  ui32_mapSize = uint32_t( s_stat.st_size );
+  ui32_mapPos = ( ( at_mode & StreamAte ) != 0 ) ? ui32_mapSize : 0;
+  return true;
+}
+#endif
+
+
 //! open a input stream
 bool TargetFileStreamInput_c::open( const TCHAR* filename, FileMode_t at_mode )
 {
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  if ( b_mapped ) close();
+  if ( openMapped( filename, at_mode ) ) return true;
+#endif
+
 #ifndef USE_BUFFERED_READ
 
   b_eofReached = false;
@@ -94,6 +144,15 @@ bool TargetFileStreamInput_c::open( const TCHAR* filename, FileMode_t at_mode )
 //! @param ui8_data:
 TargetFileStreamInput_c& TargetFileStreamInput_c::operator>>(uint8_t &ui8_data)
 {
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  if (b_mapped)
+  {
+    if (ui32_mapPos < ui32_mapSize)
+      ui8_data = pui8_map[ui32_mapPos++];
+    return *this;
+  }
+#endif
+
 #ifndef USE_BUFFERED_READ
 
   ifstream* isp_tmp = static_cast<ifstream*>(this);
@@ -107,31 +166,159 @@ TargetFileStreamInput_c& TargetFileStreamInput_c::operator>>(uint8_t &ui8_data)
 #else
 
   if (ui16_currentReadIndexInBuffer >= ui16_bytesInBuffer)
+    fillBuffer();
+
+  if (ui16_currentReadIndexInBuffer < ui16_bytesInBuffer)
+  {
+    ui8_data = ch_buf[ui16_currentReadIndexInBuffer];
+    ui16_currentReadIndexInBuffer++;
+  }
+#endif
+
+  return *this;
+}
+
+#ifdef USE_BUFFERED_READ
+void
+TargetFileStreamInput_c::fillBuffer()
+{
+  ui16_bytesInBuffer = fread(ch_buf, 1, cui16_bufSize, fileDescr);
+  ui16_currentReadIndexInBuffer = 0;
+  b_eofReached = feof(fileDescr);
+  if (!b_eofReached)
   {
-    ui16_bytesInBuffer = fread(ch_buf, 1, cui16_bufSize, fileDescr);
-    ui16_currentReadIndexInBuffer = 0;
+    ungetc(fgetc(fileDescr), fileDescr); // do peek
+    // stream state is still EOF after fgetc/ungetc in case fgetc yields EOF
     b_eofReached = feof(fileDescr);
-    if (!b_eofReached)
+  }
+}
+#endif
+
+
+uint32_t
+TargetFileStreamInput_c::readBlock( uint8_t* pui8_data, uint32_t ui32_len )
+{
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  if (b_mapped)
+  {
+    const uint32_t ui32_read = ( ui32_len < ui32_mapSize - ui32_mapPos ) ? ui32_len : ui32_mapSize - ui32_mapPos;
+    if (ui32_read > 0)
+      memcpy( pui8_data, pui8_map + ui32_mapPos, ui32_read );
+    ui32_mapPos += ui32_read;
+    return ui32_read;
+  }
+#endif
+
+#ifndef USE_BUFFERED_READ
+  ifstream* isp_tmp = static_cast<ifstream*>(this);
+  if ((ui32_len == 0) || eof())
+    return 0;
+
+  isp_tmp->read( reinterpret_cast<char*>(pui8_data), streamsize(ui32_len) );
+  const uint32_t ui32_read = uint32_t(isp_tmp->gcount());
+
+  // same as operator>>: eof as soon as nothing more is left to read
+  if (isp_tmp->eof() || (isp_tmp->peek() == EOF))
+    b_eofReached = true;
+  return ui32_read;
+#else
+  if (!fileDescr)
+    return 0;
+
+  uint32_t ui32_read = 0;
+  while (ui32_read < ui32_len)
+  {
+    if (ui16_currentReadIndexInBuffer >= ui16_bytesInBuffer)
     {
-      ungetc(fgetc(fileDescr), fileDescr); // do peek
-      // stream state is still EOF after fgetc/ungetc in case fgetc yields EOF
-      b_eofReached = feof(fileDescr);
+      if (b_eofReached)
+        break;
+      if (ui32_len - ui32_read >= cui16_bufSize)
+      { // large remainder: read directly into the destination
+        ui32_read += uint32_t(fread(pui8_data + ui32_read, 1, ui32_len - ui32_read, fileDescr));
+        ui16_bytesInBuffer = ui16_currentReadIndexInBuffer = 0;
+        b_eofReached = feof(fileDescr);
+        if (!b_eofReached)
+        {
+          ungetc(fgetc(fileDescr), fileDescr); // do peek
+          b_eofReached = feof(fileDescr);
+        }
+        break;
+      }
+      fillBuffer();
+      if (ui16_bytesInBuffer == 0)
+        break;
     }
+
+    uint32_t ui32_chunk = uint32_t(ui16_bytesInBuffer - ui16_currentReadIndexInBuffer);
+    if (ui32_chunk > ui32_len - ui32_read)
+      ui32_chunk = ui32_len - ui32_read;
+    memcpy(pui8_data + ui32_read, ch_buf + ui16_currentReadIndexInBuffer, ui32_chunk);
+    ui16_currentReadIndexInBuffer = uint16_t(ui16_currentReadIndexInBuffer + ui32_chunk);
+    ui32_read += ui32_chunk;
   }
+  return ui32_read;
+#endif
+}
 
-  if (ui16_currentReadIndexInBuffer < ui16_bytesInBuffer)
+
+uint32_t
+TargetFileStreamInput_c::peekSpan( const uint8_t*& rpui8_span )
+{
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  if (b_mapped)
   {
-    ui8_data = ch_buf[ui16_currentReadIndexInBuffer];
-    ui16_currentReadIndexInBuffer++;
+    rpui8_span = pui8_map + ui32_mapPos;
+    return ui32_mapSize - ui32_mapPos;
   }
 #endif
 
-  return *this;
+#ifndef USE_BUFFERED_READ
+  rpui8_span = NULL;
+  return 0;
+#else
+  if (fileDescr && (ui16_currentReadIndexInBuffer >= ui16_bytesInBuffer) && !b_eofReached)
+    fillBuffer();
+
+  rpui8_span = reinterpret_cast<const uint8_t*>(ch_buf) + ui16_currentReadIndexInBuffer;
+  return (ui16_currentReadIndexInBuffer < ui16_bytesInBuffer) ? uint32_t(ui16_bytesInBuffer - ui16_currentReadIndexInBuffer) : 0;
+#endif
+}
+
+
+uint32_t
+TargetFileStreamInput_c::skip( uint32_t ui32_len )
+{
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  if (b_mapped)
+  {
+    const uint32_t ui32_skipped = ( ui32_len < ui32_mapSize - ui32_mapPos ) ? ui32_len : ui32_mapSize - ui32_mapPos;
+    ui32_mapPos += ui32_skipped;
+    return ui32_skipped;
+  }
+#endif
+
+  uint8_t pui8_scratch[ 256 ];
+  uint32_t ui32_skipped = 0;
+  while (ui32_skipped < ui32_len)
+  {
+    const uint32_t ui32_chunk = ( ui32_len - ui32_skipped < sizeof(pui8_scratch) ) ? ui32_len - ui32_skipped : uint32_t(sizeof(pui8_scratch));
+    const uint32_t ui32_read = readBlock( pui8_scratch, ui32_chunk );
+    ui32_skipped += ui32_read;
+    if (ui32_read < ui32_chunk)
+      break;
+  }
+  return ui32_skipped;
 }
 
+
 bool
 TargetFileStreamInput_c::eof() const
 {
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  if (b_mapped)
+    return ui32_mapPos >= ui32_mapSize;
+#endif
+
 #ifndef USE_BUFFERED_READ
   return b_eofReached | static_cast<const ifstream*>(this)->eof();
 #else
@@ -145,6 +332,18 @@ TargetFileStreamInput_c::eof() const
 void
 TargetFileStreamInput_c::close()
 {
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  if (b_mapped)
+  {
+    if (pui8_map)
+      munmap( const_cast<uint8_t*>(pui8_map), ui32_mapSize );
+    pui8_map = NULL;
+    ui32_mapSize = ui32_mapPos = 0;
+    b_mapped = false;
+    return;
+  }
+#endif
+
 #ifndef USE_BUFFERED_READ
   static_cast<ifstream*>(this)->close();
 #else
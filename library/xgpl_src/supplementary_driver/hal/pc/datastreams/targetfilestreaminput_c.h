@@ -25,6 +25,12 @@
   #undef USE_BUFFERED_READ
 #endif
 
+// regular files opened for reading are memory mapped where POSIX mmap
+// is available, everything else falls back to the ifstream/buffered read
+#if !defined(WIN32) && !defined(WINCE) && !defined(ISOAGLIB_USE_UNICODE)
+  #define TARGET_FILE_STREAM_INPUT_MMAP
+#endif
+
 
 #include <IsoAgLib/isoaglib_config.h>
 #include <fstream>
@@ -63,12 +69,32 @@ public:
 	//  b_eofReached is initialized to false in open()
 	virtual bool eof() const;
 
+  //! read up to ui32_len bytes, less only at end of file
+  uint32_t readBlock( uint8_t* pui8_data, uint32_t ui32_len );
+
+  //! bytes which can be read in place (from the mapping or the read buffer),
+  //! they stay unread until skip()ped. 0 at eof or if not supported.
+  uint32_t peekSpan( const uint8_t*& rpui8_span );
+
+  //! drop up to ui32_len bytes, @return number of bytes dropped
+  uint32_t skip( uint32_t ui32_len );
+
   TargetFileStreamInput_c() : fileDescr(NULL), b_eofReached(false), ui16_bytesInBuffer(0), ui16_currentReadIndexInBuffer(0)
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+    , b_mapped(false), pui8_map(NULL), ui32_mapSize(0), ui32_mapPos(0)
+#endif
   {}
 
   virtual ~TargetFileStreamInput_c() { close(); }
 
 private:
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  bool openMapped( const char* filename, FileMode_t at_mode );
+#endif
+#ifdef USE_BUFFERED_READ
+  //! refill ch_buf once it is consumed
+  void fillBuffer();
+#endif
 
   FILE *fileDescr;
 
@@ -85,6 +111,13 @@ private:
 
   uint16_t ui16_bytesInBuffer;
   uint16_t ui16_currentReadIndexInBuffer;
+
+#ifdef TARGET_FILE_STREAM_INPUT_MMAP
+  bool b_mapped;
+  const uint8_t* pui8_map;
+  uint32_t ui32_mapSize;
+  uint32_t ui32_mapPos;
+#endif
 }; // ~X2C
 
 // TargetFileStreamInput_c & operator>> (TargetFileStreamInput_c &, uint8_t &ui8_data);
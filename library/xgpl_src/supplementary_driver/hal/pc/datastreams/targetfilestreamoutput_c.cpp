@@ -43,6 +43,9 @@ bool TargetFileStreamOutput_c::open( const TCHAR* filename, FileMode_t at_mode )
 #else
 	if ( ( at_mode & StreamIn ) != 0 ) return false;
 
+	// must be set before opening to take effect
+	rdbuf()->pubsetbuf( mpc_buffer, scui32_bufferSize );
+
 	STL_NAMESPACE::ios_base::openmode mode = STL_NAMESPACE::ios_base::out;
 
 	if ( ( at_mode & StreamAte    ) != 0 ) mode = STL_NAMESPACE::ios_base::openmode( mode | STL_NAMESPACE::ios_base::ate    );
@@ -70,6 +73,12 @@ TargetFileStreamOutput_c& TargetFileStreamOutput_c::operator<<(uint8_t ui8_data)
 	return *this;
 }
 
+uint32_t TargetFileStreamOutput_c::writeBlock( const uint8_t* pui8_data, uint32_t ui32_len )
+{
+	static_cast<ofstream*>(this)->write( reinterpret_cast<const char*>(pui8_data), streamsize(ui32_len) );
+	return good() ? ui32_len : 0;
+}
+
 //! close a output stream
 //! Parameter:
 //! @param pathname if pathname != NULL => sync file and path
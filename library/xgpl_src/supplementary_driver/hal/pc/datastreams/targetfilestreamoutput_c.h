@@ -40,6 +40,9 @@ class TargetFileStreamOutput_c : public STL_NAMESPACE::ofstream
 {
 
 public:
+  TargetFileStreamOutput_c() : mpc_buffer( new char[ scui32_bufferSize ] ) {}
+  virtual ~TargetFileStreamOutput_c() { STL_NAMESPACE::ofstream::close(); delete [] mpc_buffer; }
+
 	//! open a output stream
 	bool open( STD_TSTRING& filename, FileMode_t at_mode ){ return open( filename.c_str(), at_mode );};
 	//! open a output stream
@@ -53,6 +56,10 @@ public:
   //! @param ui8_data:
   virtual TargetFileStreamOutput_c& operator<<(uint8_t ui8_data);
 
+  //! write a whole block, blocks larger than the stream buffer bypass it
+  //! @return number of bytes written (ui32_len unless the stream failed)
+  uint32_t writeBlock( const uint8_t* pui8_data, uint32_t ui32_len );
+
   //  Operation: eof
   virtual bool eof() const { return static_cast<const STL_NAMESPACE::ofstream*>(this)->eof();};
 
@@ -62,6 +69,16 @@ public:
   // Operation: good
   virtual bool good() const { return static_cast<const STL_NAMESPACE::ofstream*>(this)->good();};
 
+private:
+  //! the default filebuf buffer of a few KiB means a write syscall per
+  //! few KiB when streaming byte by byte
+  static const uint32_t scui32_bufferSize = 0x10000;
+  char* mpc_buffer;
+
+  /** not copyable : copy constructor is only declared, never defined */
+  TargetFileStreamOutput_c(const TargetFileStreamOutput_c&);
+  /** not copyable : copy operator is only declared, never defined */
+  TargetFileStreamOutput_c& operator=(const TargetFileStreamOutput_c&);
 }; // ~X2C
 
 #endif // -X2C
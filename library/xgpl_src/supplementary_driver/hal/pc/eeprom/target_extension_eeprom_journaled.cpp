@@ -0,0 +1,620 @@
+/*
+  target_extension_eeprom_journaled.cpp: source for PC specific
+    extensions for the HAL for EEPROM - write-back cached image
+    with an append-only journal
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Usage under Commercial License:
+  Licensees with a valid commercial license may use this file
+  according to their commercial license agreement. (To obtain a
+  commercial license contact OSB AG via <http://isoaglib.com/en/contact>)
+
+  Usage under GNU General Public License with exceptions for ISOAgLib:
+  Alternatively (if not holding a valid commercial license)
+  use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+/** \file supplementary_driver/hal/pc/eeprom/target_extension_eeprom_journaled.cpp
+ * Same eeprom.dat as the "simulating" driver, but the file is only
+ * touched on open and on flush:
+ * - The image is mapped into memory (POSIX: private mapping, so the
+ *   image file itself is only replaced as a whole on checkpoint).
+ * - Writes go to the image and mark their pages dirty.
+ * - Dirty pages are appended to eeprom.dat.jnl as CRC protected
+ *   records, EEPROM_JOURNAL_FLUSH_DELAY msec after the first write -
+ *   by a flusher thread with USE_MUTUAL_EXCLUSION, else on the next
+ *   EEPROM access. A torn record at the end is dropped on open.
+ * - Once the journal exceeds EEPROM_JOURNAL_CHECKPOINT_SIZE the image
+ *   is written to a temporary file, renamed over eeprom.dat, and the
+ *   journal is truncated.
+ * Select with USE_EEPROM_DRIVER="journaled", which also defines
+ * HAL_USE_BUFFERED_EEPROM so EepromIo_c writes in one piece.
+ * ********************************************************** */
+
+#include "eeprom.h"
+#include <IsoAgLib/hal/pc/system/system_target_extensions.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#ifdef WIN32
+#  include <io.h>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#ifdef USE_MUTUAL_EXCLUSION
+#  include <IsoAgLib/hal/generic_utils/system/mutex_pthread.h>
+#  include <IsoAgLib/hal/generic_utils/system/ThreadWrapper_pthread.h>
+#endif
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4996 )
+#endif
+
+namespace __HAL {
+
+
+// These are the default names for the pc's simulated eeprom
+// Add a #define in your config file if you wish to name it something else.
+#ifndef EEPROM_DAT_FILE
+#  ifdef WIN32
+#    define EEPROM_DAT_FILE		"..\\..\\..\\simulated_io\\eeprom.dat"
+#  else
+#    define EEPROM_DAT_FILE		"../../../simulated_io/eeprom.dat"
+#  endif
+#endif
+
+// flush dirty pages this many msec after the first write to a clean image
+#ifndef EEPROM_JOURNAL_FLUSH_DELAY
+#  define EEPROM_JOURNAL_FLUSH_DELAY 50
+#endif
+
+// rewrite eeprom.dat and restart the journal once it's grown that large
+#ifndef EEPROM_JOURNAL_CHECKPOINT_SIZE
+#  define EEPROM_JOURNAL_CHECKPOINT_SIZE (256*1024)
+#endif
+
+
+namespace {
+
+const uint32_t scui32_imageSize = 32*1024;
+const uint16_t scui16_pageSize = 32;
+const uint16_t scui16_pageCnt = scui32_imageSize / scui16_pageSize;
+
+// record: magic(2) address(2) length(2) data(length) crc32(4), little endian
+const uint16_t scui16_recordMagic = 0x4A45; // "EJ"
+const uint16_t scui16_recordHeaderSize = 6;
+
+
+uint32_t crc32( uint32_t crc, const uint8_t* data, uint32_t len )
+{
+  static uint32_t table[ 256 ];
+  static bool tableReady = false;
+  if( !tableReady )
+  {
+    for( uint32_t n = 0; n < 256; ++n )
+    {
+      uint32_t c = n;
+      for( int k = 0; k < 8; ++k )
+        c = ( c & 1 ) ? ( 0xEDB88320UL ^ ( c >> 1 ) ) : ( c >> 1 );
+      table[ n ] = c;
+    }
+    tableReady = true;
+  }
+
+  crc = ~crc;
+  for( uint32_t i = 0; i < len; ++i )
+    crc = table[ ( crc ^ data[ i ] ) & 0xFF ] ^ ( crc >> 8 );
+  return ~crc;
+}
+
+
+void putUi16( std::vector<uint8_t>& buf, uint16_t value )
+{
+  buf.push_back( uint8_t( value ) );
+  buf.push_back( uint8_t( value >> 8 ) );
+}
+
+
+uint16_t getUi16( const uint8_t* data )
+{
+  return uint16_t( data[ 0 ] | ( data[ 1 ] << 8 ) );
+}
+
+
+uint32_t getUi32( const uint8_t* data )
+{
+  return uint32_t( data[ 0 ] ) | ( uint32_t( data[ 1 ] ) << 8 ) | ( uint32_t( data[ 2 ] ) << 16 ) | ( uint32_t( data[ 3 ] ) << 24 );
+}
+
+
+bool syncFile( FILE* file )
+{
+  if( fflush( file ) != 0 )
+    return false;
+#ifdef WIN32
+  return _commit( _fileno( file ) ) == 0;
+#else
+  return fsync( fileno( file ) ) == 0;
+#endif
+}
+
+
+class JournaledImage_c
+#ifdef USE_MUTUAL_EXCLUSION
+  : public HAL::ThreadWrapper
+#endif
+{
+public:
+  JournaledImage_c();
+  ~JournaledImage_c();
+
+  int16_t read( uint16_t address, uint16_t number, uint8_t* data );
+  int16_t write( uint16_t address, uint16_t number, const uint8_t* data );
+
+  //! flush if the delay since the first unflushed write has passed
+  void flushIfDue();
+
+private:
+  bool open();
+  bool mapImage( const char* fileName );
+  void replayJournal();
+  bool flush();
+  bool checkpoint( const std::vector<uint8_t>& image );
+
+  void lock()
+  {
+#ifdef USE_MUTUAL_EXCLUSION
+    m_protectImage.waitAcquireAccess();
+#endif
+  }
+  void unlock()
+  {
+#ifdef USE_MUTUAL_EXCLUSION
+    m_protectImage.releaseAccess();
+#endif
+  }
+
+#ifdef USE_MUTUAL_EXCLUSION
+  virtual int Exec();
+
+  HAL::ExclusiveAccess_c m_protectImage;
+  // only one flush at a time: flusher thread vs. final flush
+  HAL::ExclusiveAccess_c m_protectFlush;
+#endif
+
+  bool mb_opened;
+  bool mb_openFailed;
+  const char* mpc_datFile;
+  std::string mstr_journalFile;
+
+  uint8_t* mpui8_image;
+#ifdef WIN32
+  std::vector<uint8_t> mvec_image;
+#endif
+  uint32_t mui32_dirty[ scui16_pageCnt / 32 ];
+  bool mb_dirty;
+  ecutime_t mi32_firstDirtyTime;
+
+  FILE* mpf_journal;
+  long ml_journalSize;
+  bool mb_writeError;
+};
+
+
+JournaledImage_c::JournaledImage_c()
+  : mb_opened( false )
+  , mb_openFailed( false )
+  , mpc_datFile( NULL )
+  , mstr_journalFile()
+  , mpui8_image( NULL )
+  , mb_dirty( false )
+  , mi32_firstDirtyTime( 0 )
+  , mpf_journal( NULL )
+  , ml_journalSize( 0 )
+  , mb_writeError( false )
+{
+  memset( mui32_dirty, 0, sizeof( mui32_dirty ) );
+}
+
+
+JournaledImage_c::~JournaledImage_c()
+{
+#ifdef USE_MUTUAL_EXCLUSION
+  if( mb_opened )
+    StopAndJoin();
+#endif
+  // final flush at program end
+  if( mb_opened )
+    (void)flush();
+
+  if( mpf_journal != NULL )
+    fclose( mpf_journal );
+#ifndef WIN32
+  if( mpui8_image != NULL )
+    munmap( mpui8_image, scui32_imageSize );
+#endif
+}
+
+
+bool
+JournaledImage_c::open()
+{
+  if( mb_opened )
+    return true;
+  if( mb_openFailed )
+    return false;
+
+  // same fallback as the simulating driver: the file in the calling directory
+  if( mapImage( EEPROM_DAT_FILE ) )
+    mpc_datFile = EEPROM_DAT_FILE;
+  else if( mapImage( "eeprom.dat" ) )
+    mpc_datFile = "eeprom.dat";
+  else
+  {
+    mb_openFailed = true;
+    return false;
+  }
+
+  mstr_journalFile = std::string( mpc_datFile ) + ".jnl";
+  replayJournal();
+
+  mpf_journal = fopen( mstr_journalFile.c_str(), "ab" );
+  if( mpf_journal == NULL )
+  {
+    mb_openFailed = true;
+    return false;
+  }
+
+  mb_opened = true;
+#ifdef USE_MUTUAL_EXCLUSION
+  Start();
+#endif
+  return true;
+}
+
+
+bool
+JournaledImage_c::mapImage( const char* fileName )
+{
+  // make sure the file exists and has full size, missing bytes read as 0xFF
+  FILE* file = fopen( fileName, "r+b" );
+  if( file == NULL )
+    file = fopen( fileName, "w+b" );
+  if( file == NULL )
+    return false;
+
+  fseek( file, 0, SEEK_END );
+  long size = ftell( file );
+  if( size < 0 )
+    size = 0;
+  for( ; size < long( scui32_imageSize ); ++size )
+    fputc( 0xFF, file );
+  const bool b_ok = syncFile( file );
+  fclose( file );
+  if( !b_ok )
+    return false;
+
+#ifdef WIN32
+  file = fopen( fileName, "rb" );
+  if( file == NULL )
+    return false;
+  mvec_image.resize( scui32_imageSize );
+  const bool b_read = ( fread( &mvec_image[ 0 ], 1, scui32_imageSize, file ) == scui32_imageSize );
+  fclose( file );
+  mpui8_image = &mvec_image[ 0 ];
+  return b_read;
+#else
+  const int fd = ::open( fileName, O_RDONLY );
+  if( fd < 0 )
+    return false;
+  // private: changes stay in memory until they're journaled
+  void* image = mmap( NULL, scui32_imageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+  ::close( fd );
+  if( image == MAP_FAILED )
+    return false;
+  mpui8_image = static_cast<uint8_t*>( image );
+  return true;
+#endif
+}
+
+
+void
+JournaledImage_c::replayJournal()
+{
+  FILE* file = fopen( mstr_journalFile.c_str(), "rb" );
+  if( file == NULL )
+    return; // no journal yet
+
+  std::vector<uint8_t> record;
+  long validSize = 0;
+  for( ;; )
+  {
+    uint8_t header[ scui16_recordHeaderSize ];
+    if( fread( header, 1, scui16_recordHeaderSize, file ) != scui16_recordHeaderSize )
+      break;
+    const uint16_t address = getUi16( header + 2 );
+    const uint16_t length = getUi16( header + 4 );
+    if( ( getUi16( header ) != scui16_recordMagic ) || ( uint32_t( address ) + length > scui32_imageSize ) )
+      break;
+
+    record.assign( header, header + scui16_recordHeaderSize );
+    record.resize( scui16_recordHeaderSize + length + 4 );
+    if( fread( &record[ scui16_recordHeaderSize ], 1, length + 4, file ) != size_t( length + 4 ) )
+      break;
+    if( crc32( 0, &record[ 0 ], scui16_recordHeaderSize + length ) != getUi32( &record[ scui16_recordHeaderSize + length ] ) )
+      break;
+
+    memcpy( mpui8_image + address, &record[ scui16_recordHeaderSize ], length );
+    validSize += scui16_recordHeaderSize + length + 4;
+  }
+
+  fseek( file, 0, SEEK_END );
+  const long fileSize = ftell( file );
+  fclose( file );
+
+  if( fileSize != validSize )
+  { // torn record of an interrupted flush - drop it
+#ifdef WIN32
+    const int fd = _open( mstr_journalFile.c_str(), _O_RDWR | _O_BINARY );
+    if( fd >= 0 ) { _chsize( fd, validSize ); _close( fd ); }
+#else
+    if( truncate( mstr_journalFile.c_str(), validSize ) != 0 )
+      mb_writeError = true;
+#endif
+  }
+  ml_journalSize = validSize;
+}
+
+
+int16_t
+JournaledImage_c::read( uint16_t address, uint16_t number, uint8_t* data )
+{
+  if( !open() )
+    return HAL_CONFIG_ERR;
+  if( uint32_t( address ) + number > scui32_imageSize )
+    return HAL_RANGE_ERR;
+
+  lock();
+  memcpy( data, mpui8_image + address, number );
+  unlock();
+  return HAL_NO_ERR;
+}
+
+
+int16_t
+JournaledImage_c::write( uint16_t address, uint16_t number, const uint8_t* data )
+{
+  if( !open() )
+    return HAL_CONFIG_ERR;
+  if( uint32_t( address ) + number > scui32_imageSize )
+    return HAL_RANGE_ERR;
+  if( number == 0 )
+    return HAL_NO_ERR;
+
+  lock();
+  if( memcmp( mpui8_image + address, data, number ) != 0 )
+  {
+    memcpy( mpui8_image + address, data, number );
+
+    const uint16_t lastPage = uint16_t( ( address + number - 1 ) / scui16_pageSize );
+    for( uint16_t page = address / scui16_pageSize; page <= lastPage; ++page )
+      mui32_dirty[ page / 32 ] |= ( uint32_t( 1 ) << ( page % 32 ) );
+
+    if( !mb_dirty )
+    {
+      mb_dirty = true;
+      mi32_firstDirtyTime = getTime();
+    }
+  }
+  const bool b_writeError = mb_writeError;
+  unlock();
+
+  return b_writeError ? HAL_OVERFLOW_ERR : HAL_NO_ERR;
+}
+
+
+void
+JournaledImage_c::flushIfDue()
+{
+#ifndef USE_MUTUAL_EXCLUSION
+  if( mb_dirty && ( ( getTime() - mi32_firstDirtyTime ) >= EEPROM_JOURNAL_FLUSH_DELAY ) )
+    (void)flush();
+#endif
+}
+
+
+bool
+JournaledImage_c::flush()
+{
+#ifdef USE_MUTUAL_EXCLUSION
+  m_protectFlush.waitAcquireAccess();
+#endif
+
+  // collect the dirty runs and - if due - the image to checkpoint
+  // in one go, so the checkpoint is exactly the journaled state
+  std::vector<uint8_t> records;
+  std::vector<uint8_t> image;
+
+  lock();
+  for( uint16_t page = 0; page < scui16_pageCnt; )
+  {
+    if( ( mui32_dirty[ page / 32 ] & ( uint32_t( 1 ) << ( page % 32 ) ) ) == 0 )
+    {
+      ++page;
+      continue;
+    }
+
+    const uint16_t firstPage = page;
+    while( ( page < scui16_pageCnt ) && ( mui32_dirty[ page / 32 ] & ( uint32_t( 1 ) << ( page % 32 ) ) ) )
+      ++page;
+
+    const uint16_t address = uint16_t( firstPage * scui16_pageSize );
+    const uint16_t length = uint16_t( ( page - firstPage ) * scui16_pageSize );
+    const size_t start = records.size();
+    putUi16( records, scui16_recordMagic );
+    putUi16( records, address );
+    putUi16( records, length );
+    records.insert( records.end(), mpui8_image + address, mpui8_image + address + length );
+    const uint32_t crc = crc32( 0, &records[ start ], scui16_recordHeaderSize + length );
+    putUi16( records, uint16_t( crc ) );
+    putUi16( records, uint16_t( crc >> 16 ) );
+  }
+  memset( mui32_dirty, 0, sizeof( mui32_dirty ) );
+  mb_dirty = false;
+
+  const bool b_checkpoint = ( ml_journalSize + long( records.size() ) ) > EEPROM_JOURNAL_CHECKPOINT_SIZE;
+  if( b_checkpoint )
+    image.assign( mpui8_image, mpui8_image + scui32_imageSize );
+  unlock();
+
+  if( mpf_journal == NULL ) // lost in a failed checkpoint
+    mpf_journal = fopen( mstr_journalFile.c_str(), "ab" );
+
+  bool b_ok = ( mpf_journal != NULL );
+  if( b_ok && !records.empty() )
+  {
+    b_ok = ( fwrite( &records[ 0 ], 1, records.size(), mpf_journal ) == records.size() ) && syncFile( mpf_journal );
+    ml_journalSize += long( records.size() );
+  }
+  if( b_ok && b_checkpoint )
+  { // no data lost if this fails, the journal just keeps growing
+    (void)checkpoint( image );
+  }
+
+  if( !b_ok )
+  {
+    lock();
+    mb_writeError = true;
+    unlock();
+  }
+
+#ifdef USE_MUTUAL_EXCLUSION
+  m_protectFlush.releaseAccess();
+#endif
+  return b_ok;
+}
+
+
+bool
+JournaledImage_c::checkpoint( const std::vector<uint8_t>& image )
+{
+  // a crash before the rename keeps the old image plus the full
+  // journal, after it replaying the journal is a no-op
+  const std::string tmpFile = std::string( mpc_datFile ) + ".tmp";
+  FILE* file = fopen( tmpFile.c_str(), "wb" );
+  if( file == NULL )
+    return false;
+  const bool b_written = ( fwrite( &image[ 0 ], 1, image.size(), file ) == image.size() ) && syncFile( file );
+  fclose( file );
+  if( !b_written )
+  {
+    remove( tmpFile.c_str() );
+    return false;
+  }
+
+#ifdef WIN32
+  remove( mpc_datFile ); // rename() doesn't replace on Windows
+#endif
+  if( rename( tmpFile.c_str(), mpc_datFile ) != 0 )
+    return false;
+
+  fclose( mpf_journal );
+  mpf_journal = fopen( mstr_journalFile.c_str(), "wb" );
+  ml_journalSize = 0;
+  return ( mpf_journal != NULL ) && syncFile( mpf_journal );
+}
+
+
+#ifdef USE_MUTUAL_EXCLUSION
+int
+JournaledImage_c::Exec()
+{
+  while( !GetRequestToStop() )
+  {
+    lock();
+    const bool b_due = mb_dirty && ( ( getTime() - mi32_firstDirtyTime ) >= EEPROM_JOURNAL_FLUSH_DELAY );
+    unlock();
+
+    if( b_due )
+      (void)flush();
+    else
+      sleep_max_ms( EEPROM_JOURNAL_FLUSH_DELAY / 2 + 1 );
+  }
+  return 0;
+}
+#endif
+
+
+JournaledImage_c& image()
+{
+  static JournaledImage_c s_image;
+  return s_image;
+}
+
+} // namespace
+
+
+/* ***************************************** */
+/* ****** EEPROM I/O BIOS functions  ******* */
+/* ***************************************** */
+
+/* get the size of the eeprom */
+uint32_t getEepromSize(void)
+{
+  return scui32_imageSize;
+}
+
+/* get the segment size of the eeprom for page write access */
+int16_t getEepromSegmentSize(void)
+{
+  return scui16_pageSize;
+}
+
+/* get the status of eeprom */
+int16_t eepromReady(void)
+{
+  image().flushIfDue();
+  return HAL_NO_ERR; // the image is always ready.
+}
+
+/* enable or disable write protection */
+int16_t eepromWp(boolean /* bitMode */ )
+{
+  return HAL_NO_ERR;
+}
+
+/* write one or more bytes into the eeprom*/
+int16_t eepromWrite(uint16_t wAddress,uint16_t wNumber,const uint8_t *pbData)
+{
+  image().flushIfDue();
+  return image().write( wAddress, wNumber, pbData );
+}
+
+/* write one uint8_t into the eeprom */
+int16_t eepromWriteByte(uint16_t wAddress,uint8_t bByte)
+{
+  return eepromWrite( wAddress, 1, &bByte );
+}
+
+/* read one or more uint8_t from the eeprom */
+int16_t eepromRead(uint16_t wAddress,uint16_t wNumber,uint8_t *pbByte)
+{
+  image().flushIfDue();
+  return image().read( wAddress, wNumber, pbByte );
+}
+
+} // End of namespace __HAL
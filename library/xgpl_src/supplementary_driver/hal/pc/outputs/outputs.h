@@ -66,6 +66,12 @@ namespace HAL
   inline void setDigout(uint8_t bOutputNo, uint16_t wPWMValue)
   { __HAL::setDigout(bOutputNo, wPWMValue); }
 
+  inline void setDigouts( const uint8_t* channels, const uint16_t* values, uint8_t count )
+  {
+    for( uint8_t i = 0; i < count; ++i )
+      __HAL::setDigout( channels[i], values[i] );
+  }
+
   inline uint16_t getDigout( uint8_t bOutputNo )
   { return __HAL::getDigout(bOutputNo); }
 
@@ -119,6 +119,14 @@ namespace HAL
   */
   inline int16_t getRs232Char(uint8_t *pbRead, uint8_t aui8_channel)
     {return __HAL::getRs232Char(pbRead, aui8_channel);};
+  /**
+    read up to wNumber bytes from receive buffer
+    @param pbRead pointer to target data
+    @param wNumber maximum number of bytes to read
+    @return number of bytes read, negative on error
+  */
+  inline int16_t getRs232NChar(uint8_t *pbRead, uint16_t wNumber, uint8_t aui8_channel)
+    {return __HAL::getRs232NChar(pbRead, wNumber, aui8_channel);};
   /**
     read bLastChar terminated string from receive buffer
     @param pbRead pointer to target data
@@ -95,6 +95,13 @@ int16_t getRs232Error(uint8_t *Errorcode, uint8_t aui8_channel = 0);
   @return HAL_NO_ERR -> o.k. else buffer underflow
 */
 int16_t getRs232Char(uint8_t *pbRead, uint8_t aui8_channel = 0);
+/**
+  read up to wNumber bytes from receive buffer
+  @param pbRead pointer to target data
+  @param wNumber maximum number of bytes to read
+  @return number of bytes read, negative on error
+*/
+int16_t getRs232NChar(uint8_t *pbRead, uint16_t wNumber, uint8_t aui8_channel = 0);
 /**
   read bLastChar terminated string from receive buffer
   @param pbRead pointer to target data
@@ -17,101 +17,408 @@
   Public License with exceptions for ISOAgLib. (See accompanying
   file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
 */
+
+/* Both directions are buffered in power-of-two ring buffers per channel
+ * (size as given to configRs232RxObj/configRs232TxObj, rounded up).
+ * The device is used non-blocking: every call moves whatever poll()
+ * reports ready between device and rings. Sending only blocks if the
+ * TX ring is full.
+ * With RS232_LINUX_IO_THREAD (needs USE_MUTUAL_EXCLUSION) a dedicated
+ * thread keeps the data flowing between the calls, too.
+ */
+
 #include "rs232_target_extensions.h"
 #include <IsoAgLib/hal/pc/errcodes.h>
 
-#include <fcntl.h>      /* for open()/read()/write() */
+#include <fcntl.h>      /* for open() */
+#include <poll.h>       /* for poll() */
 #include <termios.h>    /* for tcgetattr()/tcsetattr() */
-#include <unistd.h>     /* for close() */
-
-
+#include <unistd.h>     /* for close()/read()/write() */
 
 #include <cstdio>
 #include <cstdlib>
-#include <cctype>
-#include <ctime>
 #include <cstring>
-#include <deque>
+#include <vector>
+
+#ifdef RS232_LINUX_IO_THREAD
+#  ifndef USE_MUTUAL_EXCLUSION
+#    error "RS232_LINUX_IO_THREAD needs USE_MUTUAL_EXCLUSION"
+#  endif
+#  include <IsoAgLib/hal/generic_utils/system/mutex_pthread.h>
+#  include <IsoAgLib/hal/generic_utils/system/ThreadWrapper_pthread.h>
+#endif
 
 #ifndef RS232_SERIAL_DEV
 #define RS232_SERIAL_DEV "/dev/ttyS"
 #endif
 
+// ring size if configRs232RxObj/configRs232TxObj didn't set one
+#ifndef RS232_LINUX_BUFFER_SIZE
+#define RS232_LINUX_BUFFER_SIZE 4096
+#endif
+
 namespace __HAL {
 struct T_BAUD { uint32_t rate; uint32_t flag; } t_baud[] = {
   {    600L, B600    }, {   1200L, B1200   }, {   2400L, B2400   },
   {   4800L, B4800   }, {   9600L, B9600   }, {  19200L, B19200  },
-  {  38400L, B38400  }, {  57600L, B57600  }, { 115200L, B115200 } };
+  {  38400L, B38400  }, {  57600L, B57600  }, { 115200L, B115200 }
+#ifdef B230400
+  , { 230400L, B230400 }
+#endif
+#ifdef B460800
+  , { 460800L, B460800 }
+#endif
+#ifdef B921600
+  , { 921600L, B921600 }
+#endif
+  };
 
 
+namespace {
 
-struct termios t_com[RS232_CHANNEL_CNT];
-int32_t f_com[RS232_CHANNEL_CNT];
-STL_NAMESPACE::deque<int8_t> deq_readBuff[RS232_CHANNEL_CNT];
+/** largest ring, counts are reported as int16_t */
+const uint32_t scui32_maxRingSize = 0x4000;
+/** give up sending/draining if the device doesn't take data for this time [msec] */
+const int sci_sendTimeout = 1000;
 
-static bool arr_usedPort[RS232_CHANNEL_CNT] = {
-#if RS232_CHANNEL_CNT > 0
-false
-#endif
-#if RS232_CHANNEL_CNT > 1
-, false
-#endif
-#if RS232_CHANNEL_CNT > 2
-, false
-#endif
-#if RS232_CHANNEL_CNT > 3
-, false
-#endif
-#if RS232_CHANNEL_CNT > 4
-, false
-#endif
-#if RS232_CHANNEL_CNT > 5
-, false
-#endif
-#if RS232_CHANNEL_CNT > 6
-, false
-#endif
-#if RS232_CHANNEL_CNT > 7
-, false
+
+/** byte ring with power-of-two size;
+  the free running positions are masked on access.
+  Not synchronized, all access is done under the channel lock.
+*/
+class Ring_c
+{
+public:
+  Ring_c() : m_buf(), mui32_mask( 0 ), mui32_head( 0 ), mui32_tail( 0 ) {}
+
+  /** round up to a power of two (limited to scui32_maxRingSize), drops the content */
+  void resize( uint32_t size )
+  {
+    uint32_t ui32_size = 64;
+    while( ( ui32_size < size ) && ( ui32_size < scui32_maxRingSize ) )
+      ui32_size <<= 1;
+    m_buf.resize( ui32_size );
+    mui32_mask = ui32_size - 1;
+    clear();
+  }
+
+  void clear() { mui32_head = mui32_tail = 0; }
+
+  uint32_t capacity() const { return uint32_t( m_buf.size() ); }
+  uint32_t count() const { return mui32_head - mui32_tail; }
+  uint32_t space() const { return capacity() - count(); }
+
+  /** contiguous block to read from */
+  const uint8_t* readBlock( uint32_t& rui32_len ) const
+  {
+    const uint32_t ui32_offset = mui32_tail & mui32_mask;
+    rui32_len = count();
+    if( rui32_len > capacity() - ui32_offset )
+      rui32_len = capacity() - ui32_offset;
+    return &m_buf[ 0 ] + ui32_offset;
+  }
+  void consume( uint32_t n ) { mui32_tail += n; }
+
+  /** contiguous block to write to */
+  uint8_t* writeBlock( uint32_t& rui32_len )
+  {
+    const uint32_t ui32_offset = mui32_head & mui32_mask;
+    rui32_len = space();
+    if( rui32_len > capacity() - ui32_offset )
+      rui32_len = capacity() - ui32_offset;
+    return &m_buf[ 0 ] + ui32_offset;
+  }
+  void commit( uint32_t n ) { mui32_head += n; }
+
+  uint32_t get( uint8_t* dst, uint32_t n )
+  {
+    uint32_t ui32_done = 0;
+    while( ui32_done < n )
+    {
+      uint32_t ui32_len;
+      const uint8_t* src = readBlock( ui32_len );
+      if( ui32_len == 0 )
+        break;
+      if( ui32_len > n - ui32_done )
+        ui32_len = n - ui32_done;
+      memcpy( dst + ui32_done, src, ui32_len );
+      consume( ui32_len );
+      ui32_done += ui32_len;
+    }
+    return ui32_done;
+  }
+
+  uint32_t put( const uint8_t* src, uint32_t n )
+  {
+    uint32_t ui32_done = 0;
+    while( ui32_done < n )
+    {
+      uint32_t ui32_len;
+      uint8_t* dst = writeBlock( ui32_len );
+      if( ui32_len == 0 )
+        break;
+      if( ui32_len > n - ui32_done )
+        ui32_len = n - ui32_done;
+      memcpy( dst, src + ui32_done, ui32_len );
+      commit( ui32_len );
+      ui32_done += ui32_len;
+    }
+    return ui32_done;
+  }
+
+  /** @return distance of the first occurrence from the read position, -1 if not found */
+  int32_t find( uint8_t ui8_char ) const
+  {
+    uint32_t ui32_len;
+    const uint8_t* first = readBlock( ui32_len );
+    const void* found = memchr( first, ui8_char, ui32_len );
+    if( found != NULL )
+      return int32_t( static_cast<const uint8_t*>( found ) - first );
+
+    const uint32_t ui32_rest = count() - ui32_len;
+    found = ( ui32_rest > 0 ) ? memchr( &m_buf[ 0 ], ui8_char, ui32_rest ) : NULL;
+    if( found != NULL )
+      return int32_t( ui32_len + ( static_cast<const uint8_t*>( found ) - &m_buf[ 0 ] ) );
+    return -1;
+  }
+
+private:
+  STL_NAMESPACE::vector<uint8_t> m_buf;
+  uint32_t mui32_mask;
+  uint32_t mui32_head;
+  uint32_t mui32_tail;
+};
+
+
+struct Channel_s
+{
+  Channel_s() : fd( -1 ), used( false ), savedOptions(), rxSize( RS232_LINUX_BUFFER_SIZE ), txSize( RS232_LINUX_BUFFER_SIZE ), rx(), tx() {}
+
+  int fd;
+  bool used;
+  struct termios savedOptions;
+  uint16_t rxSize;
+  uint16_t txSize;
+  Ring_c rx;
+  Ring_c tx;
+};
+
+Channel_s s_channels[RS232_CHANNEL_CNT];
+
+
+#ifdef RS232_LINUX_IO_THREAD
+HAL::ExclusiveAccess_c s_protectChannels;
+
+class IoThread_c : public HAL::ThreadWrapper
+{
+public:
+  IoThread_c() : mb_running( false ) {}
+
+  void start() { if( !mb_running ) mb_running = Start(); }
+  void stop() { if( mb_running ) { (void)StopAndJoin(); mb_running = false; } }
+
+private:
+  virtual int Exec();
+  bool mb_running;
+};
+
+IoThread_c s_ioThread;
 #endif
-#if RS232_CHANNEL_CNT > 8
-, false
+
+
+/** all access to the channels is done with this lock held */
+class ChannelLock_c
+{
+public:
+#ifdef RS232_LINUX_IO_THREAD
+  ChannelLock_c() { s_protectChannels.waitAcquireAccess(); }
+  ~ChannelLock_c() { s_protectChannels.releaseAccess(); }
+#else
+  ChannelLock_c() {}
 #endif
 };
 
-#define false 0
-#define true 1
 
-int8_t c_read;
+/** events to wait for: only read if there's room, only write if there's data */
+short wantedEvents( const Channel_s& ch )
+{
+  short events = 0;
+  if( ch.rx.space() > 0 )
+    events |= POLLIN;
+  if( ch.tx.count() > 0 )
+    events |= POLLOUT;
+  return events;
+}
+
+
+/** move data between device and rings as reported by poll */
+void transfer( Channel_s& ch, short revents )
+{
+  if( revents & POLLIN )
+  {
+    for(;;)
+    {
+      uint32_t ui32_len;
+      uint8_t* dst = ch.rx.writeBlock( ui32_len );
+      if( ui32_len == 0 )
+        break;
+      const ssize_t n = read( ch.fd, dst, ui32_len );
+      if( n <= 0 )
+        break;
+      ch.rx.commit( uint32_t( n ) );
+      if( uint32_t( n ) < ui32_len )
+        break;
+    }
+  }
+  if( revents & POLLOUT )
+  {
+    for(;;)
+    {
+      uint32_t ui32_len;
+      const uint8_t* src = ch.tx.readBlock( ui32_len );
+      if( ui32_len == 0 )
+        break;
+      const ssize_t n = write( ch.fd, src, ui32_len );
+      if( n <= 0 )
+        break;
+      ch.tx.consume( uint32_t( n ) );
+      if( uint32_t( n ) < ui32_len )
+        break;
+    }
+  }
+}
+
+
+/** wait up to ai_timeout msec for readiness, then transfer */
+bool pump( Channel_s& ch, int ai_timeout = 0 )
+{
+  struct pollfd pfd;
+  pfd.fd = ch.fd;
+  pfd.events = wantedEvents( ch );
+  pfd.revents = 0;
+  if( ( pfd.events == 0 ) || ( poll( &pfd, 1, ai_timeout ) <= 0 ) )
+    return false;
+  transfer( ch, pfd.revents );
+  return true;
+}
+
+
+/** send the rest of the TX ring (limited time) and restore the port */
+void closePort( Channel_s& ch )
+{
+  int i_waited = 0;
+  while( ( ch.tx.count() > 0 ) && ( i_waited < sci_sendTimeout ) )
+  {
+    if( !pump( ch, 10 ) )
+      i_waited += 10;
+  }
+  tcsetattr( ch.fd, TCSANOW, &ch.savedOptions );
+  close( ch.fd );
+  ch.fd = -1;
+  ch.used = false;
+  ch.rx.clear();
+  ch.tx.clear();
+}
+
+
+bool anyPortUsed()
+{
+  for( int ind = 0; ind < RS232_CHANNEL_CNT; ind++ )
+    if( s_channels[ind].used )
+      return true;
+  return false;
+}
+
+
+#ifdef RS232_LINUX_IO_THREAD
+int IoThread_c::Exec()
+{
+  while( !GetRequestToStop() )
+  {
+    struct pollfd fds[RS232_CHANNEL_CNT];
+    uint8_t channels[RS232_CHANNEL_CNT];
+    nfds_t nfds = 0;
+    {
+      ChannelLock_c lock;
+      for( uint8_t ind = 0; ind < RS232_CHANNEL_CNT; ind++ )
+      {
+        if( !s_channels[ind].used )
+          continue;
+        fds[nfds].fd = s_channels[ind].fd;
+        fds[nfds].events = wantedEvents( s_channels[ind] );
+        fds[nfds].revents = 0;
+        channels[nfds] = ind;
+        if( fds[nfds].events != 0 )
+          ++nfds;
+      }
+    }
+
+    // with nothing to watch this is just the idle sleep
+    if( poll( fds, nfds, 10 ) <= 0 )
+      continue;
+
+    ChannelLock_c lock;
+    for( nfds_t ind = 0; ind < nfds; ind++ )
+    {
+      Channel_s& ch = s_channels[channels[ind]];
+      // the port may have been closed/reopened meanwhile
+      if( ( fds[ind].revents != 0 ) && ch.used && ( ch.fd == fds[ind].fd ) )
+        transfer( ch, fds[ind].revents );
+    }
+  }
+  return 0;
+}
+#endif
+
+} // anonymous namespace
+
 
 /** close the RS232 interface. */
 int16_t close_rs232(uint8_t comport)
 {
   if ( comport >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  if ( arr_usedPort[comport] )
+  bool b_anyUsed;
   {
-    tcsetattr(f_com[comport], TCSANOW, &(t_com[comport]));
-    close(f_com[comport]);
-    arr_usedPort[comport] = false;
-		return HAL_NO_ERR;
+    ChannelLock_c lock;
+    if ( !s_channels[comport].used )
+      return HAL_NOACT_ERR;
+    closePort( s_channels[comport] );
+    b_anyUsed = anyPortUsed();
   }
-	else
-	{
-		return HAL_NOACT_ERR;
-	}
+#ifdef RS232_LINUX_IO_THREAD
+  if ( !b_anyUsed )
+    s_ioThread.stop();
+#else
+  (void)b_anyUsed;
+#endif
+  return HAL_NO_ERR;
 }
 
 void close_rs232()
 {
-  for ( int ind = 0; ind < RS232_CHANNEL_CNT; ind++)
   {
-    if ( arr_usedPort[ind] )
+    ChannelLock_c lock;
+    for ( int ind = 0; ind < RS232_CHANNEL_CNT; ind++)
     {
-      tcsetattr(f_com[ind], TCSANOW, &(t_com[ind]));
-      close(f_com[ind]);
-      arr_usedPort[ind] = false;
+      if ( s_channels[ind].used )
+        closePort( s_channels[ind] );
     }
   }
+#ifdef RS232_LINUX_IO_THREAD
+  s_ioThread.stop();
+#endif
+}
+
+
+static uint32_t baudFlag( uint32_t baudrate )
+{
+  struct T_BAUD *b = t_baud;
+  uint32_t baudflag;
+  do {
+    baudflag = b->flag;
+    if (b->rate >= baudrate) break;
+  } while (++b < t_baud + sizeof t_baud/sizeof *t_baud);
+  return baudflag;
 }
 
 
@@ -129,34 +436,35 @@ int16_t init_rs232(uint32_t baudrate,uint8_t bMode,uint8_t bStoppbits,bool bitSo
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
 
-  char com[ strlen( RS232_SERIAL_DEV ) + 3 ];
+  char com[ strlen( RS232_SERIAL_DEV ) + 4 ];
 
   struct termios tty_options;
-  struct T_BAUD *b;
-  uint32_t  baudflag;
+  const uint32_t baudflag = baudFlag( baudrate );
 
   // first close if already configured
   close_rs232(aui8_channel);
 
-  b = t_baud;
-  do {
-    baudflag = b->flag;
-    if (b->rate >= baudrate) break;
-  } while (++b < t_baud + sizeof t_baud/sizeof *t_baud);
-
   sprintf( com, "%s%d", RS232_SERIAL_DEV, aui8_channel );
 
-  if ((f_com[aui8_channel] = open(com, O_RDWR|O_NOCTTY|O_NDELAY)) < 0) return HAL_CONFIG_ERR;
-  if (tcgetattr(f_com[aui8_channel], &(t_com[aui8_channel]))) return HAL_CONFIG_ERR;
+  const int fd = open(com, O_RDWR|O_NOCTTY|O_NONBLOCK);
+  if (fd < 0) return HAL_CONFIG_ERR;
 
-  arr_usedPort[aui8_channel] = true;
-  atexit(close_rs232);
+  Channel_s& ch = s_channels[aui8_channel];
+  if (tcgetattr(fd, &(ch.savedOptions)))
+  {
+    close(fd);
+    return HAL_CONFIG_ERR;
+  }
 
-  /* Configure port reading */
-  fcntl(f_com[aui8_channel], F_SETFL, FNDELAY);
+  static bool sb_atexitRegistered = false;
+  if ( !sb_atexitRegistered )
+  {
+    atexit(close_rs232);
+    sb_atexitRegistered = true;
+  }
 
   /* Get the current options for the port */
-  tcgetattr(f_com[aui8_channel], &tty_options);
+  tcgetattr(fd, &tty_options);
   cfsetispeed(&tty_options, baudflag);
   cfsetospeed(&tty_options, baudflag);
 
@@ -171,6 +479,8 @@ int16_t init_rs232(uint32_t baudrate,uint8_t bMode,uint8_t bStoppbits,bool bitSo
 
   // ignore BRK condition and parity error ( maybe also activate CR ignore - but that might be wanted )
   tty_options.c_iflag |= IGNBRK | IGNPAR /*| IGNCR*/;
+  // no CR/NL translation of the received bytes
+  tty_options.c_iflag &= ~(ICRNL | INLCR | IGNCR | ISTRIP);
 
   // no implementation defined output processing
   tty_options.c_oflag &= ~(OPOST);
@@ -223,23 +533,31 @@ int16_t init_rs232(uint32_t baudrate,uint8_t bMode,uint8_t bStoppbits,bool bitSo
   }
 
   /* Enable data to be processed as raw input */
-  tty_options.c_lflag &= ~(ICANON | ECHO | ISIG);
+  tty_options.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
 
-  // No wait time for reading, return 0 if no data available 
+  // No wait time for reading, return 0 if no data available
   tty_options.c_cc[VTIME] = 0;
   tty_options.c_cc[VMIN] = 0;
 
   // flush all i/o garbage data if present
-  tcflush(f_com[aui8_channel],TCIOFLUSH);
+  tcflush(fd,TCIOFLUSH);
 
   /* Set the new options for the port */
-  tcsetattr(f_com[aui8_channel], TCSANOW, &tty_options);
+  tcsetattr(fd, TCSANOW, &tty_options);
 
   // wait some time to avoid buffer error
   usleep( 500000 ); // sleep for 500msec
 
-  // reset read buffer
-  deq_readBuff[aui8_channel].clear();
+  {
+    ChannelLock_c lock;
+    ch.fd = fd;
+    ch.rx.resize( ch.rxSize );
+    ch.tx.resize( ch.txSize );
+    ch.used = true;
+  }
+#ifdef RS232_LINUX_IO_THREAD
+  s_ioThread.start();
+#endif
 
   return HAL_NO_ERR;
 }
@@ -252,38 +570,22 @@ int16_t init_rs232(uint32_t baudrate,uint8_t bMode,uint8_t bStoppbits,bool bitSo
 int16_t setRs232Baudrate(uint32_t baudrate, uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  struct termios tty_options;
-  struct T_BAUD *b;
-  uint32_t  baudflag;
-
-  // first close if already configured
-  close_rs232(aui8_channel);
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return HAL_CONFIG_ERR;
 
-  b = t_baud;
-  do {
-    baudflag = b->flag;
-    if (b->rate >= baudrate) break;
-  } while (++b < t_baud + sizeof t_baud/sizeof *t_baud);
+  struct termios tty_options;
+  const uint32_t baudflag = baudFlag( baudrate );
 
-  if (tcgetattr(f_com[aui8_channel], &tty_options)) return 0;
+  if (tcgetattr(ch.fd, &tty_options)) return HAL_CONFIG_ERR;
   cfsetispeed(&tty_options, baudflag);
   cfsetospeed(&tty_options, baudflag);
 
-  /* Set the new options for the port */
-  tcsetattr(f_com[aui8_channel], TCSANOW, &tty_options);
-
-  // wait some time to avoid buffer error
-  usleep( 500000 ); // sleep for 500msec
-  return 1;
+  /* Set the new options for the port, after everything is sent */
+  if (tcsetattr(ch.fd, TCSADRAIN, &tty_options)) return HAL_CONFIG_ERR;
+  return HAL_NO_ERR;
 }
 
-int16_t SioPutBuffer(uint32_t comport, const uint8_t *p, int16_t n)
-{
-  if ( comport >= RS232_CHANNEL_CNT ) return 0;
-  n = write(f_com[comport], p, n) == n;
-  tcdrain(f_com[comport]);
-  return n;
-}
 /**
   send single uint8_t on RS232
   @param bByte data uint8_t to send
@@ -291,14 +593,11 @@ int16_t SioPutBuffer(uint32_t comport, const uint8_t *p, int16_t n)
  */
 int16_t put_rs232Char(uint8_t bByte, uint8_t aui8_channel)
 {
-  if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  // printf("RS232:\n %c\n", bByte);
-  uint8_t b_data = bByte;
-  SioPutBuffer(aui8_channel, &b_data, 1);
-  return HAL_NO_ERR;
+  return put_rs232NChar(&bByte, 1, aui8_channel);
 }
 /**
-  send string of n uint8_t on RS232
+  send string of n uint8_t on RS232;
+  only blocks while the send buffer is full
   @param bpWrite pointer to source data string
   @param wNumber number of data uint8_t to send
   @return HAL_NO_ERR -> o.k. else send buffer overflow
@@ -306,8 +605,26 @@ int16_t put_rs232Char(uint8_t bByte, uint8_t aui8_channel)
 int16_t put_rs232NChar(const uint8_t *bpWrite,uint16_t wNumber, uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  SioPutBuffer(aui8_channel, bpWrite, wNumber);
-  return HAL_NO_ERR;
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return HAL_CONFIG_ERR;
+
+  uint32_t ui32_done = ch.tx.put( bpWrite, wNumber );
+  // start the transfer right away - the device is non-blocking,
+  // so it needs no poll() before
+  transfer( ch, POLLOUT );
+  int i_waited = 0;
+  for (;;)
+  {
+    if ( ui32_done == wNumber )
+      return HAL_NO_ERR;
+    const bool b_progress = pump( ch, 10 );
+    ui32_done += ch.tx.put( bpWrite + ui32_done, wNumber - ui32_done );
+    if ( b_progress )
+      i_waited = 0;
+    else if ( ( i_waited += 10 ) >= sci_sendTimeout )
+      return HAL_OVERFLOW_ERR;
+  }
 }
 /**
   send '\0' terminated string on RS232
@@ -316,10 +633,7 @@ int16_t put_rs232NChar(const uint8_t *bpWrite,uint16_t wNumber, uint8_t aui8_cha
  */
 int16_t put_rs232String(const uint8_t *pbString, uint8_t aui8_channel)
 {
-  if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  // printf("RS232:: %s", pbString);
-  SioPutBuffer(aui8_channel, pbString, strlen((const char*)pbString));
-  return HAL_NO_ERR;
+  return put_rs232NChar(pbString, uint16_t(strlen((const char*)pbString)), aui8_channel);
 }
 
 /**
@@ -329,12 +643,11 @@ int16_t put_rs232String(const uint8_t *pbString, uint8_t aui8_channel)
 int16_t getRs232RxBufCount(uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  int8_t c_temp[300];
-  int16_t tempLen = read(f_com[aui8_channel], c_temp, (299));
-
-  for ( uint16_t ind = 0; ind < tempLen; ind++ ) deq_readBuff[aui8_channel].push_back( c_temp[ind] );
-
-  return deq_readBuff[aui8_channel].size();
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return 0;
+  pump( ch );
+  return int16_t( ch.rx.count() );
 }
 
 /**
@@ -343,19 +656,37 @@ int16_t getRs232RxBufCount(uint8_t aui8_channel)
   @return HAL_NO_ERR -> o.k. else buffer underflow
  */
 int16_t getRs232Char(uint8_t *pbRead, uint8_t aui8_channel)
+{
+  const int16_t i16_read = getRs232NChar(pbRead, 1, aui8_channel);
+  if ( i16_read < 0 ) return i16_read;
+  return ( i16_read == 1 ) ? HAL_NO_ERR : HAL_NOACT_ERR;
+}
+
+/**
+  read up to wNumber bytes from receive buffer
+  @param pbRead pointer to target data
+  @param wNumber maximum number of bytes to read
+  @return number of bytes read, negative on error
+ */
+int16_t getRs232NChar(uint8_t *pbRead, uint16_t wNumber, uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  getRs232RxBufCount(aui8_channel);
-  if (! deq_readBuff[aui8_channel].empty())
-  {
-    pbRead[0] = deq_readBuff[aui8_channel].front();
-    deq_readBuff[aui8_channel].pop_front();
-    return HAL_NO_ERR;
-  }
-  else
-  {
-    return HAL_NOACT_ERR;
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return 0;
+  // the count has to fit into the int16_t result
+  if ( wNumber > 0x7FFF ) wNumber = 0x7FFF;
+
+  uint32_t ui32_done = 0;
+  if ( ch.rx.count() < wNumber )
+    pump( ch );
+  ui32_done = ch.rx.get( pbRead, wNumber );
+  if ( ui32_done < wNumber )
+  { // the ring may have been full
+    pump( ch );
+    ui32_done += ch.rx.get( pbRead + ui32_done, wNumber - ui32_done );
   }
+  return int16_t( ui32_done );
 }
 
 /**
@@ -367,41 +698,21 @@ int16_t getRs232Char(uint8_t *pbRead, uint8_t aui8_channel)
 int16_t getRs232String(uint8_t *pbRead,uint8_t bLastChar, uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  getRs232RxBufCount(aui8_channel);
-  if (! deq_readBuff[aui8_channel].empty())
-  {
-    for ( STL_NAMESPACE::deque<int8_t>::iterator iter = deq_readBuff[aui8_channel].begin(); iter != deq_readBuff[aui8_channel].end(); ++iter )
-    { // check if terminating char is found
-      if ( *iter == bLastChar )
-      { // found -> copy area from begin to iterator
-        uint16_t ind = 0;
-        for ( ; ( deq_readBuff[aui8_channel].front() != bLastChar); ind++ )
-        {
-          pbRead[ind] = deq_readBuff[aui8_channel].front();
-          deq_readBuff[aui8_channel].pop_front();
-        }
-        // lastly pop the termination char and terminate the result string
-        deq_readBuff[aui8_channel].pop_front();
-        pbRead[ind] = '\0';
-        return HAL_NO_ERR;
-      }
-    }
-  }
-  return HAL_NOACT_ERR;
-}
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return HAL_NOACT_ERR;
 
-#if 0
-int8_t *KeyGetString(char *buffer, int16_t len)
-{
-  struct termios t;
-  int8_t *p;
-  tcgetattr(0, &t);
-  tcsetattr(0, TCSAFLUSH, &t_0);
-  p = (int8_t*)fgets(buffer, len, stdin);
-  tcsetattr(0, TCSAFLUSH, &t);
-  return p;
+  pump( ch );
+  const int32_t i32_pos = ch.rx.find( bLastChar );
+  if ( i32_pos < 0 )
+    return HAL_NOACT_ERR;
+
+  // copy area before the termination char, drop it and terminate the result string
+  ch.rx.get( pbRead, uint32_t( i32_pos ) );
+  ch.rx.consume( 1 );
+  pbRead[i32_pos] = '\0';
+  return HAL_NO_ERR;
 }
-#endif
 
 
 /**
@@ -411,36 +722,60 @@ int8_t *KeyGetString(char *buffer, int16_t len)
 int16_t getRs232TxBufCount(uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  /** @todo ON REQUEST: decide if RS232 TX buffer from OS should be asked */
-  return 0;
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return 0;
+  if ( ch.tx.count() > 0 )
+    transfer( ch, POLLOUT );
+  return int16_t( ch.tx.count() );
 }
 /**
   configure a receive buffer and set optional irq function pointer for receive
-  @param wBuffersize wanted buffer size
+  @param wBuffersize wanted buffer size (rounded up to a power of two)
   @param pFunction pointer to irq function or NULL if not wanted
  */
 int16_t configRs232RxObj (uint16_t wBuffersize, void (*pFunction)(uint8_t *bByte), uint8_t aui8_channel)
 {
-  (void)wBuffersize;
   (void)pFunction;
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  /** @todo ON REQUEST: should this be implemented? */
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  ch.rxSize = ( wBuffersize > 0 ) ? wBuffersize : RS232_LINUX_BUFFER_SIZE;
+  if ( ch.used && ( ch.rx.capacity() < ch.rxSize ) && ( ch.rx.capacity() < scui32_maxRingSize ) )
+  { // keep the received data
+    STL_NAMESPACE::vector<uint8_t> received( ch.rx.count() );
+    if ( !received.empty() )
+      ch.rx.get( &received[0], uint32_t( received.size() ) );
+    ch.rx.resize( ch.rxSize );
+    if ( !received.empty() )
+      ch.rx.put( &received[0], uint32_t( received.size() ) );
+  }
   return HAL_NO_ERR;
 }
 /**
   configure a send buffer and set optional irq function pointer for send
-  @param wBuffersize wanted buffer size
+  @param wBuffersize wanted buffer size (rounded up to a power of two)
   @param funktionAfterTransmit pointer to irq function or NULL if not wanted
   @param funktionBeforTransmit pointer to irq function or NULL if not wanted
  */
 int16_t configRs232TxObj(uint16_t wBuffersize,void (*funktionAfterTransmit)(uint8_t *bByte),
                          void (*funktionBeforTransmit)(uint8_t *bByte), uint8_t aui8_channel)
 {
-  (void)wBuffersize;
   (void)funktionAfterTransmit;
   (void)funktionBeforTransmit;
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
-  /** @todo ON REQUEST: should this be implemented? */
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  ch.txSize = ( wBuffersize > 0 ) ? wBuffersize : RS232_LINUX_BUFFER_SIZE;
+  if ( ch.used && ( ch.tx.capacity() < ch.txSize ) && ( ch.tx.capacity() < scui32_maxRingSize ) )
+  { // keep the data still to send
+    STL_NAMESPACE::vector<uint8_t> pending( ch.tx.count() );
+    if ( !pending.empty() )
+      ch.tx.get( &pending[0], uint32_t( pending.size() ) );
+    ch.tx.resize( ch.txSize );
+    if ( !pending.empty() )
+      ch.tx.put( &pending[0], uint32_t( pending.size() ) );
+  }
   return HAL_NO_ERR;
 }
 /**
@@ -463,8 +798,12 @@ int16_t getRs232Error(uint8_t *Errorcode, uint8_t aui8_channel)
 void clearRs232RxBuffer(uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return;
-  /** @todo ON REQUEST: should this be implemented? */
-};
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return;
+  tcflush( ch.fd, TCIFLUSH );
+  ch.rx.clear();
+}
 
 /**
   clear send buffer
@@ -472,7 +811,11 @@ void clearRs232RxBuffer(uint8_t aui8_channel)
 void clearRs232TxBuffer(uint8_t aui8_channel)
 {
   if ( aui8_channel >= RS232_CHANNEL_CNT ) return;
-  /** @todo ON REQUEST: should this be implemented? */
+  ChannelLock_c lock;
+  Channel_s& ch = s_channels[aui8_channel];
+  if ( !ch.used ) return;
+  tcflush( ch.fd, TCOFLUSH );
+  ch.tx.clear();
 }
 
 } // end of namespace __HAL
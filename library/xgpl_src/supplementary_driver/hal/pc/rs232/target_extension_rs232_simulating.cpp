@@ -199,6 +199,22 @@ int16_t getRs232Char(uint8_t *pbRead, uint8_t aui8_channel)
   #endif
   return HAL_NO_ERR;
 }
+
+/**
+  read up to wNumber bytes from receive buffer
+  @param pbRead pointer to target data
+  @param wNumber maximum number of bytes to read
+  @return number of bytes read, negative on error
+ */
+int16_t getRs232NChar(uint8_t *pbRead, uint16_t wNumber, uint8_t aui8_channel)
+{
+  if ( aui8_channel >= RS232_CHANNEL_CNT ) return HAL_RANGE_ERR;
+  uint16_t ui16_read = 0;
+  while ( ( ui16_read < wNumber ) && ( getRs232Char( pbRead + ui16_read, aui8_channel ) == HAL_NO_ERR ) )
+    ++ui16_read;
+  return int16_t( ui16_read );
+}
+
 /**
   read bLastChar terminated string from receive buffer
   @param pbRead pointer to target data
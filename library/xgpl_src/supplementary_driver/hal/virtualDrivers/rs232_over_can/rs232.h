@@ -112,6 +112,22 @@ extern uint8_t RS232_over_can_initialized;
   */
   inline int16_t getRs232Char(uint8_t * /*pbRead*/, uint8_t /*aui8_channel*/)
     {return RS232_over_can_initialized ? HAL_NO_ERR : HAL_RANGE_ERR;};
+  /**
+    read up to wNumber bytes from receive buffer
+    @param pbRead pointer to target data
+    @param wNumber maximum number of bytes to read
+    @return number of bytes read, negative on error
+  */
+  inline int16_t getRs232NChar(uint8_t *pbRead, uint16_t wNumber, uint8_t aui8_channel)
+  {
+    const int16_t ci16_available = getRs232RxBufCount( aui8_channel );
+    if ( ci16_available < 0 ) return ci16_available;
+    if ( wNumber > uint16_t( ci16_available ) ) wNumber = uint16_t( ci16_available );
+    uint16_t ui16_read = 0;
+    while( ( ui16_read < wNumber ) && ( getRs232Char( pbRead + ui16_read, aui8_channel ) == HAL_NO_ERR ) )
+      ++ui16_read;
+    return int16_t( ui16_read );
+  }
   /**
     read bLastChar terminated string from receive buffer
     @param pbRead pointer to target data
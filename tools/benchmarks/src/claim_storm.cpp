@@ -0,0 +1,251 @@
+/*
+  claim_storm.cpp: Benchmark of the NAME bound IsoFilters during an
+    address claim storm - 30 remote nodes claim and change their
+    addresses while 4 IsoFilters are bound to each NAME.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#include <IsoAgLib/driver/system/isystem_c.h>
+#include <IsoAgLib/scheduler/ischeduler_c.h>
+#include <IsoAgLib/comm/iisobus_c.h>
+#include <IsoAgLib/driver/can/impl/canio_c.h>
+#include <IsoAgLib/comm/Part5_NetworkManagement/impl/isomonitor_c.h>
+#include <IsoAgLib/comm/Part5_NetworkManagement/impl/isofiltermanager_c.h>
+#include <IsoAgLib/hal/generic_utils/can/canfifo_c.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+using namespace __IsoAgLib;
+
+
+static const uint8_t scui8_nodes = 30;
+static const uint8_t scui8_pgns = 4;      // IsoFilters per NAME
+static const uint32_t scui32_rounds = 2000; // address changes of all nodes
+static const uint32_t scui32_firstPgn = 0xFF10;
+// the nodes alternate between these two address sets
+static const uint8_t scui8_saSet[ 2 ] = { 0x80, 0xA0 };
+
+
+class CountingCustomer_c : public CanCustomer_c
+{
+public:
+  CountingCustomer_c() : mui32_cnt( 0 ) {}
+  virtual void processMsg( const CanPkg_c& ) { ++mui32_cnt; }
+  uint32_t mui32_cnt;
+};
+
+
+static IsoName_c sc_names[ scui8_nodes ];
+static CountingCustomer_c sc_customers[ scui8_nodes ][ scui8_pgns ];
+static ecutime_t st_time = 0;
+
+
+static void put( uint32_t aui32_ident, const uint8_t* apui8_data )
+{
+  CanPkg_c c_pkg( aui32_ident, true, 8, ++st_time );
+  c_pkg.setDataFromString( apui8_data, 8 );
+  HAL::CanFifos_c::get( 0 ).push( c_pkg );
+}
+
+static void claim( uint8_t aui8_node, uint8_t aui8_sa )
+{
+  put( 0x18EEFF00UL | aui8_sa, sc_names[ aui8_node ].outputString() );
+}
+
+static void processAll()
+{
+  bool b_break = false;
+  getCanInstance( 0 ).processMsg( b_break );
+}
+
+static uint8_t sa( uint8_t aui8_node, uint32_t aui32_round )
+{
+  return uint8_t( scui8_saSet[ aui32_round & 1 ] + aui8_node );
+}
+
+
+/* The filter handling before the ResolvedSa_s table, replayed on
+   CanIo_c: each claim walked all IsoFilterBoxes, deleted the CAN
+   filters of the NAME and inserted them again with the new SA.
+   The simulating HAL filters are no-ops, so a target with HAL filter
+   reconfiguration pays more than this. */
+struct ChurnBox_s
+{
+  uint8_t node;
+  uint32_t pgn;
+  bool inserted;
+  uint8_t sa;
+};
+
+static ChurnBox_s ss_churn[ scui8_nodes * scui8_pgns ];
+static CountingCustomer_c sc_churnCustomer;
+static uint32_t sui32_churnFilterOps = 0;
+
+static IsoAgLib::iMaskFilterType_c churnFilter( const ChurnBox_s& acrs_box )
+{
+  return IsoAgLib::iMaskFilterType_c( 0x3FFFFFFUL, ( acrs_box.pgn << 8 ) | acrs_box.sa, IsoAgLib::iIdent_c::ExtendedIdent );
+}
+
+static void churnClaim( uint8_t aui8_node, uint8_t aui8_sa, bool ab_changed )
+{
+  const unsigned cu_boxes = unsigned( scui8_nodes ) * scui8_pgns;
+  if( ab_changed )
+  { // updateOnRemove() of all boxes
+    for( unsigned n = 0; n < cu_boxes; ++n )
+    {
+      if( ss_churn[ n ].inserted && ( sc_names[ ss_churn[ n ].node ] == sc_names[ aui8_node ] ) )
+      {
+        getCanInstance( 0 ).deleteFilter( sc_churnCustomer, churnFilter( ss_churn[ n ] ) );
+        ss_churn[ n ].inserted = false;
+        ++sui32_churnFilterOps;
+      }
+    }
+  }
+  // updateOnAdd() of all boxes
+  for( unsigned n = 0; n < cu_boxes; ++n )
+  {
+    if( ss_churn[ n ].inserted )
+      continue;
+    // the boxes looked up the current address in the monitor list
+    IsoItem_c* pc_item = getIsoMonitorInstance( 0 ).item( sc_names[ ss_churn[ n ].node ], true );
+    if( pc_item == NULL )
+      continue;
+    ss_churn[ n ].sa = ( ss_churn[ n ].node == aui8_node ) ? aui8_sa : pc_item->nr();
+    getCanInstance( 0 ).insertFilter( sc_churnCustomer, churnFilter( ss_churn[ n ] ), -1 );
+    ss_churn[ n ].inserted = true;
+    ++sui32_churnFilterOps;
+  }
+}
+
+
+/* the CAN filter box of each NAME bound PGN, looked up with an
+   unclaimed SA - so it can't be a SA specific one */
+static void snapshotFilterBoxes( FilterBox_c* apc_boxes[ scui8_pgns ] )
+{
+  for( uint8_t p = 0; p < scui8_pgns; ++p )
+  {
+    STL_NAMESPACE::list<FilterBox_c*>::iterator it_box; // CanIo_c::ArrFilterBox
+    apc_boxes[ p ] = getCanInstance( 0 ).canMsg2FilterBox( ( 0x18UL << 24 ) | ( ( scui32_firstPgn + p ) << 8 ) | 0xFE,
+                                                           Ident_c::ExtendedIdent, it_box )
+                     ? *it_box : NULL;
+  }
+}
+
+
+int main()
+{
+  IsoAgLib::getIsystemInstance().init();
+  IsoAgLib::getISchedulerInstance().init();
+  IsoAgLib::getIIsoBusInstance().init( 0 );
+
+  bool b_ok = true;
+
+  for( uint8_t n = 0; n < scui8_nodes; ++n )
+  { // self configurable, industry group 2, device class 4, different identity numbers
+    sc_names[ n ] = IsoName_c( true, 2, 4, 0, 0x80, 0x7FF, uint32_t( 1000 + n ), 0, 0 );
+    for( uint8_t p = 0; p < scui8_pgns; ++p )
+      getIsoFilterManagerInstance( 0 ).insertIsoFilter(
+        IsoFilter_s( sc_customers[ n ][ p ], IsoAgLib::iMaskFilter_c( 0x3FFFF00UL, ( scui32_firstPgn + p ) << 8 ), NULL, &sc_names[ n ] ) );
+  }
+
+  FilterBox_c* pc_boxesBefore[ scui8_pgns ];
+  snapshotFilterBoxes( pc_boxesBefore );
+
+  /// the storm: all nodes claim, then all change their address, again and again
+  const clock_t ct_start = clock();
+  for( uint32_t r = 0; r <= scui32_rounds; ++r )
+  {
+    for( uint8_t n = 0; n < scui8_nodes; ++n )
+      claim( n, sa( n, r ) );
+    processAll();
+  }
+  const double cd_storm = double( clock() - ct_start ) / CLOCKS_PER_SEC;
+  const uint32_t cui32_claims = ( scui32_rounds + 1 ) * scui8_nodes;
+
+  FilterBox_c* pc_boxesAfter[ scui8_pgns ];
+  snapshotFilterBoxes( pc_boxesAfter );
+  uint8_t ui8_rebuilt = 0;
+  for( uint8_t p = 0; p < scui8_pgns; ++p )
+  {
+    if( ( pc_boxesBefore[ p ] == NULL ) || ( pc_boxesAfter[ p ] != pc_boxesBefore[ p ] ) )
+      ++ui8_rebuilt;
+  }
+
+  printf( "%u nodes, %u IsoFilters bound to their NAMEs, %lu address claims\n",
+          unsigned( scui8_nodes ), unsigned( scui8_nodes ) * scui8_pgns, (unsigned long)cui32_claims );
+  printf( "ns per claim (CanIo, IsoMonitor, IsoFilterManager):       %8.1f\n", cd_storm * 1.0e9 / cui32_claims );
+  printf( "CAN filter boxes of the NAME bound PGNs rebuilt:           %8u of %u\n", unsigned( ui8_rebuilt ), unsigned( scui8_pgns ) );
+  if( ui8_rebuilt != 0 )
+    b_ok = false;
+
+  /// the former filter rebuilds for the same claim sequence
+  for( uint8_t n = 0; n < scui8_nodes; ++n )
+  {
+    for( uint8_t p = 0; p < scui8_pgns; ++p )
+    {
+      ChurnBox_s& rs_box = ss_churn[ n * scui8_pgns + p ];
+      rs_box.node = n;
+      rs_box.pgn = scui32_firstPgn + p;
+      rs_box.inserted = false;
+      rs_box.sa = 0xFE;
+    }
+  }
+  const clock_t ct_churnStart = clock();
+  for( uint32_t r = 0; r <= scui32_rounds; ++r )
+  {
+    for( uint8_t n = 0; n < scui8_nodes; ++n )
+      churnClaim( n, sa( n, r ), ( r > 0 ) );
+  }
+  const double cd_churn = double( clock() - ct_churnStart ) / CLOCKS_PER_SEC;
+  getCanInstance( 0 ).deleteAllFiltersForCustomer( sc_churnCustomer );
+
+  printf( "former path, filter rebuilds only:\n" );
+  printf( "  ns per claim:                                           %8.1f\n", cd_churn * 1.0e9 / cui32_claims );
+  printf( "  CAN filter inserts/deletes:                             %8lu\n", (unsigned long)sui32_churnFilterOps );
+
+  /// frames from the current address reach the customers, from the previous one not
+  const uint8_t cui8_data[ 8 ] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  for( uint8_t n = 0; n < scui8_nodes; ++n )
+  {
+    for( uint8_t p = 0; p < scui8_pgns; ++p )
+    {
+      put( ( 0x18UL << 24 ) | ( ( scui32_firstPgn + p ) << 8 ) | sa( n, scui32_rounds ), cui8_data );
+      put( ( 0x18UL << 24 ) | ( ( scui32_firstPgn + p ) << 8 ) | sa( n, scui32_rounds + 1 ), cui8_data );
+    }
+    processAll();
+  }
+  // a node with a lower NAME takes the address of node 0
+  const IsoName_c cc_intruder( true, 2, 4, 0, 0x00, 0x7FF, 1, 0, 0 );
+  put( 0x18EEFF00UL | sa( 0, scui32_rounds ), cc_intruder.outputString() );
+  put( ( 0x18UL << 24 ) | ( scui32_firstPgn << 8 ) | sa( 0, scui32_rounds ), cui8_data );
+  processAll();
+
+  uint32_t ui32_wrong = 0;
+  for( uint8_t n = 0; n < scui8_nodes; ++n )
+  {
+    for( uint8_t p = 0; p < scui8_pgns; ++p )
+    {
+      if( sc_customers[ n ][ p ].mui32_cnt != 1 )
+        ++ui32_wrong;
+    }
+  }
+  printf( "customers with a wrong frame count:                       %8lu\n", (unsigned long)ui32_wrong );
+  if( ui32_wrong != 0 )
+    b_ok = false;
+
+  IsoAgLib::getIIsoBusInstance().close();
+  IsoAgLib::getISchedulerInstance().close();
+  IsoAgLib::getIsystemInstance().close();
+
+  return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
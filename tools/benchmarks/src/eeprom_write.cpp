@@ -0,0 +1,139 @@
+/*
+  eeprom_write.cpp: Benchmark of bulk EepromIo_c operator<< sequences
+    on the PC EEPROM driver the project is built with - build it once
+    with "simulating" and once with "journaled" to compare them.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#include <IsoAgLib/driver/system/isystem_c.h>
+#include <supplementary_driver/driver/eeprom/ieepromio_c.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <unistd.h>
+
+using namespace IsoAgLib;
+
+
+/* a block of state as a gateway persists it: address claim
+   (SA, NAME) and some TC values per record */
+static const uint16_t scui16_records = 64;
+static const uint16_t scui16_recordSize = 1 + 8 + 4 + 4 + 2;
+static const uint16_t scui16_base = 0x400;
+static const uint32_t scui32_cycles = 100;
+
+
+static double wallTime_us()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec * 1.0e6 + ts.tv_nsec * 1.0e-3;
+}
+
+
+static uint32_t value( uint32_t aui32_cycle, uint16_t aui16_record )
+{
+  return aui32_cycle * 0x9E3779B9UL + aui16_record;
+}
+
+
+static void writeCycle( iEepromIo_c& arc_eeprom, uint32_t aui32_cycle )
+{
+  for( uint16_t r = 0; r < scui16_records; ++r )
+  {
+    const uint32_t cui32_val = value( aui32_cycle, r );
+    arc_eeprom.setp( uint16_t( scui16_base + r * scui16_recordSize ) );
+    arc_eeprom << uint8_t( 0x80 + ( r & 0x3F ) )
+               << uint64_t( 0xA000820000000000ULL | r )
+               << cui32_val
+               << int32_t( -int32_t( cui32_val >> 1 ) )
+               << uint16_t( cui32_val );
+  }
+}
+
+
+/* @return number of records not read back as written */
+static unsigned checkCycle( iEepromIo_c& arc_eeprom, uint32_t aui32_cycle )
+{
+  unsigned u_wrong = 0;
+  for( uint16_t r = 0; r < scui16_records; ++r )
+  {
+    const uint32_t cui32_val = value( aui32_cycle, r );
+    uint8_t ui8_sa;
+    uint64_t ui64_name;
+    uint32_t ui32_val;
+    int32_t i32_val;
+    uint16_t ui16_val;
+    arc_eeprom.setg( uint16_t( scui16_base + r * scui16_recordSize ) );
+    arc_eeprom >> ui8_sa >> ui64_name >> ui32_val >> i32_val >> ui16_val;
+    if( ( ui8_sa != uint8_t( 0x80 + ( r & 0x3F ) ) ) || ( ui64_name != ( 0xA000820000000000ULL | r ) )
+     || ( ui32_val != cui32_val ) || ( i32_val != -int32_t( cui32_val >> 1 ) ) || ( ui16_val != uint16_t( cui32_val ) ) )
+      ++u_wrong;
+  }
+  return u_wrong;
+}
+
+
+int main()
+{
+  // the drivers use eeprom.dat in the working directory if there is no ../../../simulated_io
+  remove( "eeprom.dat" );
+  remove( "eeprom.dat.jnl" );
+
+  getIsystemInstance().init();
+  iEepromIo_c& rc_eeprom = getIeepromInstance();
+  rc_eeprom.init();
+
+  const uint32_t cui32_ops = scui32_cycles * scui16_records * 5;
+  bool b_ok = true;
+
+  /// each operator<< on its own
+  double d_start = wallTime_us();
+  for( uint32_t c = 0; c < scui32_cycles; ++c )
+    writeCycle( rc_eeprom, c );
+  const double cd_single = wallTime_us() - d_start;
+  unsigned u_wrong = checkCycle( rc_eeprom, scui32_cycles - 1 );
+
+  /// the operator<< of a cycle in one transaction
+  d_start = wallTime_us();
+  for( uint32_t c = 0; c < scui32_cycles; ++c )
+  {
+    rc_eeprom.beginTransaction();
+    writeCycle( rc_eeprom, scui32_cycles + c );
+    if( !rc_eeprom.commitTransaction() )
+      b_ok = false;
+  }
+  const double cd_transaction = wallTime_us() - d_start;
+  u_wrong += checkCycle( rc_eeprom, 2 * scui32_cycles - 1 );
+  if( u_wrong != 0 )
+    b_ok = false;
+
+  /// a delayed flush (journaled) is done on the next access once due
+  usleep( 100 * 1000 );
+  d_start = wallTime_us();
+  uint8_t ui8_dummy;
+  rc_eeprom.setg( scui16_base );
+  rc_eeprom >> ui8_dummy;
+  const double cd_flush = wallTime_us() - d_start;
+
+  printf( "%lu operator<< (%u records of 5 values, %lu cycles)\n",
+          (unsigned long)cui32_ops, unsigned( scui16_records ), (unsigned long)scui32_cycles );
+  printf( "us per operator<<, each on its own:        %9.2f\n", cd_single / cui32_ops );
+  printf( "us per operator<<, one transaction/cycle:  %9.2f\n", cd_transaction / cui32_ops );
+  printf( "us for the next access after 100 ms:       %9.1f\n", cd_flush );
+  printf( "records read back wrong:                   %9u\n", u_wrong );
+
+  rc_eeprom.close();
+  getIsystemInstance().close();
+
+  return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,232 @@
+/*
+  frequency_estimator.cpp: Simulation harness for the CounterI_c
+    frequency estimation - replays generated wheel pulse traces with
+    TraceSimulator_c and reports the error of each filter.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#include <IsoAgLib/driver/system/isystem_c.h>
+#include <IsoAgLib/hal/pc/system/tracesimulator_c.h>
+#include <supplementary_driver/driver/inputs/icounteri_c.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+using namespace IsoAgLib;
+
+
+static const ecutime_t sct_cycle = 10;  // [ms] application cycle
+static const uint16_t scui16_timeout = 1000;
+
+/* one CounterI_c per filter, all on the same pulses */
+static const uint8_t scui8_filters = 3;
+static const char* const scpc_filterNames[ scui8_filters ] = { "raw", "window 8", "exponential 1/8" };
+
+
+/* xorshift, so the jitter is the same on every run */
+static uint32_t sui32_seed = 2463534242UL;
+static int32_t jitter_us( int32_t ai32_max )
+{
+  sui32_seed ^= sui32_seed << 13;
+  sui32_seed ^= sui32_seed >> 17;
+  sui32_seed ^= sui32_seed << 5;
+  return int32_t( sui32_seed % uint32_t( 2 * ai32_max + 1 ) ) - ai32_max;
+}
+
+
+struct Scenario_s
+{
+  const char* name;
+  uint32_t startFrequency_mHz;
+  uint32_t endFrequency_mHz;  // linear ramp over the duration
+  ecutime_t duration;         // [ms] of pulses, followed by a standstill
+  int32_t jitter_us;          // of each edge
+  bool filterGain;            // filters have to beat the raw HAL period
+};
+
+static const Scenario_s scs_scenarios[] = {
+  { "7.3 Hz, +-10 ms jitter",      7300,  7300, 10000, 10000, true },
+  { "40 Hz, +-1 ms jitter",       40000, 40000,  5000,  1000, true },
+  // the HAL period is exact, the window only has ms edge times
+  { "1.5 Hz, +-2 ms jitter",       1500,  1500, 20000,  2000, false },
+  // filters lag behind
+  { "20 -> 2 Hz ramp, then stop", 20000,  2000,  8000,  1000, false }
+};
+
+
+struct Result_s
+{
+  double sumSquares;
+  double maxError;
+  uint32_t samples;
+  ecutime_t stopDetected;  // [ms] after the last edge
+};
+
+
+/* put the pulses on all channels
+   @return time of the last edge [ms] */
+static ecutime_t generate( TraceSimulator_c& arc_sim, const Scenario_s& acrs_scenario )
+{
+  int64_t i64_time_us = 1000000; // the first second without pulses
+  int64_t i64_lastEdge_us = -1;
+  int32_t i32_count = 0;
+  const int64_t ci64_end_us = i64_time_us + int64_t( acrs_scenario.duration ) * 1000;
+  ecutime_t t_lastEdge = 0;
+  while( i64_time_us < ci64_end_us )
+  {
+    const double cd_progress = double( i64_time_us - 1000000 ) / double( ci64_end_us - 1000000 );
+    const double cd_frequency_mHz = acrs_scenario.startFrequency_mHz + cd_progress * ( double( acrs_scenario.endFrequency_mHz ) - acrs_scenario.startFrequency_mHz );
+    i64_time_us += int64_t( 1.0e9 / cd_frequency_mHz );
+
+    const int64_t ci64_edge_us = i64_time_us + jitter_us( acrs_scenario.jitter_us );
+    t_lastEdge = ecutime_t( ci64_edge_us / 1000 );
+    ++i32_count;
+    for( uint8_t ui8_ch = 0; ui8_ch < scui8_filters; ++ui8_ch )
+    {
+      arc_sim.addInput( t_lastEdge, TraceSimulator_c::KindCounter, ui8_ch, i32_count );
+      if( i64_lastEdge_us >= 0 )
+        arc_sim.addInput( t_lastEdge, TraceSimulator_c::KindPeriod, ui8_ch, int32_t( ci64_edge_us - i64_lastEdge_us ) );
+    }
+    i64_lastEdge_us = ci64_edge_us;
+  }
+  return t_lastEdge;
+}
+
+
+/* true frequency at the given time, 0 after the pulses */
+static double trueFrequency_mHz( const Scenario_s& acrs_scenario, ecutime_t at_now )
+{
+  const double cd_progress = double( at_now - 1000 ) / double( acrs_scenario.duration );
+  if( ( cd_progress < 0.0 ) || ( cd_progress > 1.0 ) )
+    return 0.0;
+  return acrs_scenario.startFrequency_mHz + cd_progress * ( double( acrs_scenario.endFrequency_mHz ) - acrs_scenario.startFrequency_mHz );
+}
+
+
+static void run( const Scenario_s& acrs_scenario, Result_s ars_results[ scui8_filters ] )
+{
+  TraceSimulator_c c_sim;
+  const ecutime_t ct_lastEdge = generate( c_sim, acrs_scenario );
+  __HAL::setHalSimulator( &c_sim );
+  c_sim.setClockMode( TraceSimulator_c::ClockVirtual );
+  c_sim.setTime( 0 );
+
+  iCounterI_c c_counter[ scui8_filters ];
+  for( uint8_t ui8_ch = 0; ui8_ch < scui8_filters; ++ui8_ch )
+    c_counter[ ui8_ch ].init( ui8_ch );
+  c_counter[ 0 ].setEstimator( iFrequencyEstimator_c::FilterRaw, 0, scui16_timeout );
+  c_counter[ 1 ].setEstimator( iFrequencyEstimator_c::FilterWindow, 8, scui16_timeout );
+  c_counter[ 2 ].setEstimator( iFrequencyEstimator_c::FilterExponential, 3, scui16_timeout );
+
+  for( uint8_t ui8_ch = 0; ui8_ch < scui8_filters; ++ui8_ch )
+  {
+    const Result_s cs_init = { 0.0, 0.0, 0, -1 };
+    ars_results[ ui8_ch ] = cs_init;
+  }
+
+  // judged from 2 s after the first pulse until the last generated period
+  const ecutime_t ct_from = 3000;
+  const ecutime_t ct_to = 1000 + acrs_scenario.duration - ecutime_t( 1000000 / acrs_scenario.endFrequency_mHz );
+  const ecutime_t ct_end = ct_lastEdge + scui16_timeout + 500;
+  for( ecutime_t t_now = 0; t_now < ct_end; t_now += sct_cycle )
+  {
+    c_sim.setTime( t_now );
+    const double cd_true = trueFrequency_mHz( acrs_scenario, t_now );
+    for( uint8_t ui8_ch = 0; ui8_ch < scui8_filters; ++ui8_ch )
+    {
+      c_counter[ ui8_ch ].updateEstimate();
+      const uint32_t cui32_estimate = c_counter[ ui8_ch ].estimatedFrequency_mHz();
+      Result_s& rs_result = ars_results[ ui8_ch ];
+      if( ( t_now >= ct_from ) && ( t_now <= ct_to ) )
+      {
+        const double cd_error = std::fabs( double( cui32_estimate ) - cd_true );
+        rs_result.sumSquares += cd_error * cd_error;
+        if( cd_error > rs_result.maxError )
+          rs_result.maxError = cd_error;
+        ++rs_result.samples;
+      }
+      if( ( t_now > ct_lastEdge ) && ( cui32_estimate == 0 ) && ( rs_result.stopDetected < 0 ) )
+        rs_result.stopDetected = t_now - ct_lastEdge;
+    }
+  }
+  __HAL::setHalSimulator( NULL );
+}
+
+
+/* time one estimate update and one frequency read */
+static void benchmark()
+{
+  TraceSimulator_c c_sim;
+  for( int32_t i = 1; i <= 100000; ++i )
+    c_sim.addInput( ecutime_t( i ) * 7, TraceSimulator_c::KindCounter, 0, i );
+  __HAL::setHalSimulator( &c_sim );
+  c_sim.setClockMode( TraceSimulator_c::ClockVirtual );
+  c_sim.setTime( 0 );
+
+  iCounterI_c c_counter( 0 );
+  c_counter.setEstimator( iFrequencyEstimator_c::FilterWindow, 8, scui16_timeout );
+
+  static const uint32_t scui32_updates = 700000;
+  clock_t t_start = clock();
+  for( uint32_t i = 0; i < scui32_updates; ++i )
+  {
+    c_sim.advanceTime( 1 );
+    c_counter.updateEstimate();
+  }
+  const double cd_update = double( clock() - t_start ) / CLOCKS_PER_SEC;
+
+  static const uint32_t scui32_reads = 100000000;
+  uint32_t ui32_sum = 0;
+  t_start = clock();
+  for( uint32_t i = 0; i < scui32_reads; ++i )
+    ui32_sum = ui32_sum * 31 + c_counter.estimatedFrequency_mHz();
+  const double cd_read = double( clock() - t_start ) / CLOCKS_PER_SEC;
+  __HAL::setHalSimulator( NULL );
+
+  printf( "\nns per updateEstimate() (incl. HAL simulation): %.1f\n", cd_update * 1.0e9 / scui32_updates );
+  printf( "ns per estimatedFrequency_mHz():                %.2f (checksum %lu)\n", cd_read * 1.0e9 / scui32_reads, (unsigned long)ui32_sum );
+}
+
+
+int main()
+{
+  getIsystemInstance().init();
+
+  bool b_ok = true;
+  for( size_t n = 0; n < sizeof( scs_scenarios ) / sizeof( scs_scenarios[ 0 ] ); ++n )
+  {
+    Result_s as_results[ scui8_filters ];
+    run( scs_scenarios[ n ], as_results );
+
+    printf( "%s\n", scs_scenarios[ n ].name );
+    for( uint8_t ui8_ch = 0; ui8_ch < scui8_filters; ++ui8_ch )
+    {
+      const Result_s& crs_result = as_results[ ui8_ch ];
+      printf( "  %-16s rms %8.1f mHz, max %8.1f mHz, stop detected after %lld ms\n", scpc_filterNames[ ui8_ch ],
+              ( crs_result.samples > 0 ) ? std::sqrt( crs_result.sumSquares / crs_result.samples ) : 0.0,
+              crs_result.maxError, (long long)crs_result.stopDetected );
+      // the stop has to be detected by the timeout
+      if( ( crs_result.stopDetected < 0 ) || ( crs_result.stopDetected > scui16_timeout + sct_cycle ) )
+        b_ok = false;
+    }
+    if( scs_scenarios[ n ].filterGain
+     && ( ( as_results[ 1 ].sumSquares >= as_results[ 0 ].sumSquares ) || ( as_results[ 2 ].sumSquares >= as_results[ 0 ].sumSquares ) ) )
+    {
+      printf( "  filtered estimate not better than the raw one\n" );
+      b_ok = false;
+    }
+  }
+
+  benchmark();
+  return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
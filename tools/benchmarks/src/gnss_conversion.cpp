@@ -0,0 +1,200 @@
+/*
+  gnss_conversion.cpp: Checks the integer GNSS conversions of
+    gnss_conversion.h against the former double-based conversions
+    and compares the decode time of both.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#include <IsoAgLib/comm/Part7_ApplicationLayer/impl/gnss_conversion.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+using namespace __IsoAgLib;
+
+
+/* the former conversions of Gnss_c/TimePosGps_c, verbatim except that
+   the double->uint16 casts go through int64_t: the direct cast is
+   undefined for results above 0xFFFF, the detour gives the wrap-around
+   seen on the PC */
+namespace former {
+
+int32_t degree10Minus7( int64_t ai64_raw ) { return int32_t( double( ai64_raw ) * 1.0e-9 ); }
+int32_t altitudeCm( int64_t ai64_raw ) { return int32_t( double( ai64_raw ) * 1.0e-4 ); }
+int32_t degree10Minus7High( int32_t ai32_raw ) { return int32_t( double( ai32_raw ) * 4294967296.0 * 1.0e-9 ); }
+int32_t altitudeCmHigh( int32_t ai32_raw ) { return int32_t( double( ai32_raw ) * 4294967296.0 * 1.0e-4 ); }
+#define MATH_PI 3.14159265
+uint16_t j1939Direction( uint16_t aui16_raw ) { return uint16_t( int64_t( double( aui16_raw ) * MATH_PI * 125.0 / 288.0 ) ); }
+uint16_t j1939Speed( uint16_t aui16_raw ) { return uint16_t( int64_t( double( aui16_raw * 125 ) / double( 128 * 9 ) ) ); }
+int32_t j1939Altitude( uint16_t aui16_raw ) { return int32_t( ( double( aui16_raw ) * 0.125 - 2500.0 ) * 100.0 ); }
+
+} // former
+
+
+/* xorshift, so the random inputs are the same on every run */
+static uint64_t sui64_seed = 0x9E3779B97F4A7C15ULL;
+static uint64_t random64()
+{
+  sui64_seed ^= sui64_seed << 13;
+  sui64_seed ^= sui64_seed >> 7;
+  sui64_seed ^= sui64_seed << 17;
+  return sui64_seed;
+}
+
+
+/* compares each result with the exactly truncated value (calculated in
+   64 bit integer) and counts where the former result differs from it */
+class Check_c
+{
+public:
+  Check_c( const char* apc_name ) : mpc_name( apc_name ), mui32_count( 0 ), mui32_wrong( 0 ), mui32_formerInexact( 0 ) {}
+
+  void compare( int64_t ai64_input, int32_t ai32_former, int32_t ai32_integer, int64_t ai64_exact )
+  {
+    ++mui32_count;
+    if( ai32_former != ai64_exact )
+      ++mui32_formerInexact;
+    if( ai32_integer == ai64_exact )
+      return;
+    if( mui32_wrong < 3 )
+      printf( "  %s: input %lld exact %lld integer %ld former %ld\n", mpc_name, (long long)ai64_input, (long long)ai64_exact, (long)ai32_integer, (long)ai32_former );
+    ++mui32_wrong;
+  }
+
+  /* @return true if all integer results were exact */
+  bool report() const
+  {
+    printf( "%-26s %9lu inputs, %7lu wrong, former double path off in %lu\n", mpc_name, (unsigned long)mui32_count, (unsigned long)mui32_wrong, (unsigned long)mui32_formerInexact );
+    return ( mui32_wrong == 0 );
+  }
+
+private:
+  const char* mpc_name;
+  uint32_t mui32_count;
+  uint32_t mui32_wrong;
+  uint32_t mui32_formerInexact;
+};
+
+
+static const uint32_t scui32_randomInputs = 10000000UL;
+
+
+static bool checkDegree()
+{
+  Check_c c_check( "latitude/longitude" );
+  Check_c c_checkHigh( "latitude/longitude (high)" );
+  // +-180 degree in 1.0e-16, exact multiples of the divisor and their neighbours first
+  for( int64_t i64_degree = -180; i64_degree <= 180; ++i64_degree )
+    for( int64_t i64_offset = -1; i64_offset <= 1; ++i64_offset )
+    {
+      const int64_t ci64_raw = i64_degree * 10000000000000000LL + i64_offset;
+      c_check.compare( ci64_raw, former::degree10Minus7( ci64_raw ), convertNmeaDegree10Minus16ToDegree10Minus7( ci64_raw ), ci64_raw / 1000000000LL );
+    }
+  for( uint32_t i = 0; i < scui32_randomInputs; ++i )
+  {
+    const int64_t ci64_raw = int64_t( random64() % 3600000000000000001ULL ) - 1800000000000000000LL;
+    c_check.compare( ci64_raw, former::degree10Minus7( ci64_raw ), convertNmeaDegree10Minus16ToDegree10Minus7( ci64_raw ), ci64_raw / 1000000000LL );
+    const int32_t ci32_high = int32_t( ci64_raw >> 32 );
+    c_checkHigh.compare( ci32_high, former::degree10Minus7High( ci32_high ), convertNmeaDegree10Minus16HighToDegree10Minus7( ci32_high ), int64_t( ci32_high ) * 4294967296LL / 1000000000LL );
+  }
+  const bool cb_equal = c_check.report();
+  return c_checkHigh.report() && cb_equal;
+}
+
+
+static bool checkAltitude()
+{
+  Check_c c_check( "altitude" );
+  Check_c c_checkHigh( "altitude (high)" );
+  // +-100 km in 1.0e-6 m, the high part over its whole useful range
+  for( uint32_t i = 0; i < scui32_randomInputs; ++i )
+  {
+    const int64_t ci64_raw = int64_t( random64() % 200000000001ULL ) - 100000000000LL;
+    c_check.compare( ci64_raw, former::altitudeCm( ci64_raw ), convertNmeaAltitude10Minus6ToCm( ci64_raw ), ci64_raw / 10000LL );
+  }
+  for( int32_t i32_high = -25; i32_high <= 25; ++i32_high )
+    c_checkHigh.compare( i32_high, former::altitudeCmHigh( i32_high ), convertNmeaAltitude10Minus6HighToCm( i32_high ), int64_t( i32_high ) * 4294967296LL / 10000LL );
+  const bool cb_equal = c_check.report();
+  return c_checkHigh.report() && cb_equal;
+}
+
+
+static bool checkJ1939()
+{
+  Check_c c_direction( "J1939 direction (valid)" );
+  Check_c c_speed( "J1939 speed" );
+  Check_c c_altitude( "J1939 altitude" );
+  uint32_t ui32_outOfRange = 0;
+  for( uint32_t ui32_raw = 0; ui32_raw <= 0xFFFF; ++ui32_raw )
+  {
+    const uint16_t cui16_raw = uint16_t( ui32_raw );
+    const uint32_t cui32_direction = convertJ1939DirectionToRad10Minus4( cui16_raw );
+    if( cui32_direction <= 62855 ) // the range Gnss_c/TimePosGps_c accept
+      c_direction.compare( cui16_raw, former::j1939Direction( cui16_raw ), int32_t( cui32_direction ), int64_t( ui32_raw ) * 314159265LL * 125 / ( 288LL * 100000000LL ) );
+    else if( former::j1939Direction( cui16_raw ) <= 62855 )
+      ++ui32_outOfRange; // wrapped into the valid range before, rejected now
+    c_speed.compare( cui16_raw, former::j1939Speed( cui16_raw ), int32_t( convertJ1939SpeedToCmSec( cui16_raw ) ), int64_t( ui32_raw ) * 125 / 1152 );
+    c_altitude.compare( cui16_raw, former::j1939Altitude( cui16_raw ), convertJ1939AltitudeToCm( cui16_raw ), ( int64_t( ui32_raw ) * 25 - 500000 ) / 2 );
+  }
+  bool b_equal = c_direction.report();
+  printf( "%-26s %9lu inputs were wrapped into the valid range before, are rejected now\n", "J1939 direction (invalid)", (unsigned long)ui32_outOfRange );
+  b_equal = c_speed.report() && b_equal;
+  return c_altitude.report() && b_equal;
+}
+
+
+/* decode the same input set both ways; the results are chained, so the
+   compiler can neither drop nor vectorize the decodes */
+static void benchmark()
+{
+  static const uint32_t scui32_inputs = 4096;
+  static const uint32_t scui32_rounds = 2000;
+  int64_t ai64_raw[ scui32_inputs ];
+  for( uint32_t i = 0; i < scui32_inputs; ++i )
+    ai64_raw[ i ] = int64_t( random64() % 3600000000000000001ULL ) - 1800000000000000000LL;
+
+  uint32_t ui32_sum = 0;
+  clock_t t_start = clock();
+  for( uint32_t r = 0; r < scui32_rounds; ++r )
+    for( uint32_t i = 0; i < scui32_inputs; ++i )
+      ui32_sum = ui32_sum * 31 + uint32_t( former::degree10Minus7( ai64_raw[ i ] ) + former::j1939Direction( uint16_t( ai64_raw[ i ] ) ) );
+  const double cd_former = double( clock() - t_start ) / CLOCKS_PER_SEC;
+
+  t_start = clock();
+  for( uint32_t r = 0; r < scui32_rounds; ++r )
+    for( uint32_t i = 0; i < scui32_inputs; ++i )
+      ui32_sum = ui32_sum * 31 + uint32_t( convertNmeaDegree10Minus16ToDegree10Minus7( ai64_raw[ i ] ) + int32_t( convertJ1939DirectionToRad10Minus4( uint16_t( ai64_raw[ i ] ) ) ) );
+  const double cd_integer = double( clock() - t_start ) / CLOCKS_PER_SEC;
+
+  t_start = clock();
+  for( uint32_t r = 0; r < scui32_rounds; ++r )
+    for( uint32_t i = 0; i < scui32_inputs; ++i )
+      ui32_sum = ui32_sum * 31 + uint32_t( convertNmeaDegree10Minus16HighToDegree10Minus7( int32_t( ai64_raw[ i ] >> 32 ) ) );
+  const double cd_integerHigh = double( clock() - t_start ) / CLOCKS_PER_SEC;
+
+  const double cd_decodes = double( scui32_rounds ) * scui32_inputs;
+  printf( "\nns per position+direction decode (this host, with FPU):\n" );
+  printf( "  former double       %6.2f\n", cd_former * 1.0e9 / cd_decodes );
+  printf( "  integer, 64 bit     %6.2f\n", cd_integer * 1.0e9 / cd_decodes );
+  printf( "  integer, 32 bit     %6.2f (position only, as on 16 bit targets)\n", cd_integerHigh * 1.0e9 / cd_decodes );
+  printf( "  (checksum %lu)\n", (unsigned long)ui32_sum );
+}
+
+
+int main()
+{
+  bool b_equal = checkDegree();
+  b_equal = checkAltitude() && b_equal;
+  b_equal = checkJ1939() && b_equal;
+  benchmark();
+  return b_equal ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,287 @@
+/*
+  nmea_scanner.cpp: Benchmark of the NmeaScanner_c on 20 Hz
+    GGA/RMC/VTG/GST receiver output, against framing by rescanning the
+    receive buffer for the terminator on every poll.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#include <supplementary_driver/driver/rs232/inmeascanner_c.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <string>
+
+using namespace IsoAgLib;
+
+
+static const uint32_t scui32_epochs = 20 * 60 * 30; // 30 min at 20 Hz
+static const uint32_t scui32_corruptEvery = 100;    // GST of every 100th epoch has a bad checksum
+
+/* bytes per poll: 2 ms at 9600, 115200 and 921600 baud, and a large read */
+static const uint16_t scui16_chunks[] = { 2, 23, 184, 1024 };
+static const uint8_t scui8_chunkCnt = sizeof( scui16_chunks ) / sizeof( scui16_chunks[ 0 ] );
+
+
+struct Expected_s
+{
+  uint8_t hour, minute, second;
+  uint16_t msec;
+  int32_t latMin10Minus5;   // [minutes * 10^5], positive north
+  int32_t lonMin10Minus5;   // [minutes * 10^5], positive east
+  int32_t altitudeCm;
+  uint32_t speedKmh10Minus3;
+  uint32_t course10Minus3;  // [degree * 10^3]
+};
+
+static Expected_s expected( uint32_t aui32_epoch )
+{
+  Expected_s s;
+  const uint32_t cui32_ms = aui32_epoch * 50;
+  s.hour = uint8_t( 12 + cui32_ms / 3600000 );
+  s.minute = uint8_t( ( cui32_ms / 60000 ) % 60 );
+  s.second = uint8_t( ( cui32_ms / 1000 ) % 60 );
+  s.msec = uint16_t( cui32_ms % 1000 );
+  s.latMin10Minus5 = 52 * 6000000 + 3012345 + int32_t( aui32_epoch * 7 );
+  s.lonMin10Minus5 = 13 * 6000000 + 2454321 - int32_t( aui32_epoch * 11 );
+  s.altitudeCm = 12345 + int32_t( aui32_epoch % 500 );
+  s.speedKmh10Minus3 = 12000 + ( aui32_epoch % 1000 );
+  s.course10Minus3 = ( aui32_epoch * 7 ) % 360000;
+  return s;
+}
+
+static int32_t degree10Minus7( int32_t ai32_min10Minus5 )
+{ // exactly: degrees and the minutes / 60, rounded
+  return ( ai32_min10Minus5 / 6000000 ) * 10000000
+       + int32_t( floor( ( ai32_min10Minus5 % 6000000 ) * 100.0 / 60.0 + 0.5 ) );
+}
+
+
+static void appendSentence( std::string& arstr_out, const char* apc_body, bool ab_corrupt )
+{
+  uint8_t ui8_sum = 0;
+  for( const char* pc = apc_body; *pc != '\0'; ++pc )
+    ui8_sum ^= uint8_t( *pc );
+  if( ab_corrupt )
+    ui8_sum ^= 0x5A;
+  char c_tail[ 8 ];
+  sprintf( c_tail, "*%02X\r\n", unsigned( ui8_sum ) );
+  arstr_out += '$';
+  arstr_out += apc_body;
+  arstr_out += c_tail;
+}
+
+static std::string generate()
+{
+  std::string str_out;
+  str_out.reserve( scui32_epochs * 300 );
+  char c_body[ 160 ];
+  for( uint32_t e = 0; e < scui32_epochs; ++e )
+  {
+    const Expected_s s = expected( e );
+    char c_time[ 16 ], c_lat[ 16 ], c_lon[ 16 ];
+    sprintf( c_time, "%02u%02u%02u.%02u", s.hour, s.minute, s.second, unsigned( s.msec / 10 ) );
+    sprintf( c_lat, "%02ld%02ld.%05ld", long( s.latMin10Minus5 / 6000000 ), long( ( s.latMin10Minus5 % 6000000 ) / 100000 ), long( s.latMin10Minus5 % 100000 ) );
+    sprintf( c_lon, "%03ld%02ld.%05ld", long( s.lonMin10Minus5 / 6000000 ), long( ( s.lonMin10Minus5 % 6000000 ) / 100000 ), long( s.lonMin10Minus5 % 100000 ) );
+    const unsigned cu_knots10Minus3 = unsigned( ( s.speedKmh10Minus3 * 1000UL + 926 ) / 1852 );
+    char c_course[ 16 ];
+    sprintf( c_course, "%lu.%03lu", (unsigned long)( s.course10Minus3 / 1000 ), (unsigned long)( s.course10Minus3 % 1000 ) );
+
+    sprintf( c_body, "GPGGA,%s,%s,N,%s,E,4,14,0.80,%ld.%02ld,M,47.12,M,1.0,0000",
+             c_time, c_lat, c_lon, long( s.altitudeCm / 100 ), long( s.altitudeCm % 100 ) );
+    appendSentence( str_out, c_body, false );
+    sprintf( c_body, "GPRMC,%s,A,%s,N,%s,E,%u.%03u,%s,191026,,,D",
+             c_time, c_lat, c_lon, cu_knots10Minus3 / 1000, cu_knots10Minus3 % 1000, c_course );
+    appendSentence( str_out, c_body, false );
+    sprintf( c_body, "GPVTG,%s,T,,M,%u.%03u,N,%lu.%03lu,K,D",
+             c_course, cu_knots10Minus3 / 1000, cu_knots10Minus3 % 1000,
+             (unsigned long)( s.speedKmh10Minus3 / 1000 ), (unsigned long)( s.speedKmh10Minus3 % 1000 ) );
+    appendSentence( str_out, c_body, false );
+    sprintf( c_body, "GPGST,%s,0.010,0.021,0.013,45.0,0.012,0.015,0.025", c_time );
+    appendSentence( str_out, c_body, ( e % scui32_corruptEvery ) == 0 );
+  }
+  return str_out;
+}
+
+
+/* decodes each sentence, checks each complete epoch (ends with GST);
+   or only counts the sentences, to time the framing alone */
+class Checker_c : public iNmeaScanner_c::SentenceHandler_c
+{
+public:
+  Checker_c( bool ab_decode ) : mb_decode( ab_decode ), mui32_sentences( 0 ), mui32_epochs( 0 ), mui32_wrongEpochs( 0 ) {}
+
+  virtual void handleSentence( const char* sentence, uint16_t len )
+  {
+    ++mui32_sentences;
+    if( mb_decode && ( iNmeaScanner_c::decode( sentence, len, m_data ) == iNmeaScanner_c::SentenceGst ) )
+      check();
+  }
+
+  const bool mb_decode;
+  uint32_t mui32_sentences;
+  uint32_t mui32_epochs;
+  uint32_t mui32_wrongEpochs;
+
+private:
+  void check()
+  {
+    ++mui32_epochs;
+    const uint32_t cui32_epoch = ( ( uint32_t( m_data.hour - 12 ) * 3600 + m_data.minute * 60 + m_data.second ) * 1000 + m_data.msec ) / 50;
+    const Expected_s s = expected( cui32_epoch );
+    const int32_t ci32_course = int32_t( floor( s.course10Minus3 * 3.14159265358979 / 18.0 + 0.5 ) );
+    if( !m_data.timeValid || !m_data.positionValid || !m_data.directionValid || !m_data.altitudeValid || !m_data.deviationValid
+     || ( m_data.latitudeDegree10Minus7 != degree10Minus7( s.latMin10Minus5 ) )
+     || ( m_data.longitudeDegree10Minus7 != degree10Minus7( s.lonMin10Minus5 ) )
+     || ( m_data.altitudeCm != s.altitudeCm )
+     || ( m_data.speedCmSec != uint16_t( floor( s.speedKmh10Minus3 / 36.0 + 0.5 ) ) )
+     || ( abs( int32_t( m_data.courseRad10Minus4 ) - ci32_course ) > 1 )
+     || ( m_data.satelliteCnt != 14 ) || ( m_data.hdop10Minus2 != 80 ) || ( m_data.gnssMethod != IsoRtkFixedInteger )
+     || ( m_data.latitudeDeviationCm != 1 ) || ( m_data.longitudeDeviationCm != 1 ) || ( m_data.altitudeDeviationCm != 2 ) )
+      ++mui32_wrongEpochs;
+  }
+
+  iNmeaData_s m_data;
+};
+
+
+/* the receive path before the scanner: the HAL queued the bytes in a
+   deque, getRs232String() searched it for the terminator from the
+   start on every call and copied the line out; the application
+   checked the checksum in another pass */
+class RescanFramer_c
+{
+public:
+  RescanFramer_c( Checker_c& arc_checker ) : mrc_checker( arc_checker ), mui32_checksumErrors( 0 ) {}
+
+  void feed( const uint8_t* apui8_data, uint16_t aui16_len )
+  {
+    for( uint16_t ui16_ind = 0; ui16_ind < aui16_len; ++ui16_ind )
+      mdeq_buff.push_back( int8_t( apui8_data[ ui16_ind ] ) );
+
+    char c_line[ 256 ];
+    while( getString( c_line, '\n' ) )
+      handleLine( c_line );
+  }
+
+  uint32_t mui32_checksumErrors;
+
+private:
+  bool getString( char* apc_read, char ac_lastChar )
+  {
+    for( std::deque<int8_t>::iterator iter = mdeq_buff.begin(); iter != mdeq_buff.end(); ++iter )
+    {
+      if( *iter == ac_lastChar )
+      {
+        uint16_t ind = 0;
+        for( ; ( mdeq_buff.front() != ac_lastChar ) && ( ind < 255 ); ind++ )
+        {
+          apc_read[ ind ] = char( mdeq_buff.front() );
+          mdeq_buff.pop_front();
+        }
+        mdeq_buff.pop_front();
+        apc_read[ ind ] = '\0';
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void handleLine( char* apc_line )
+  {
+    std::string::size_type len = strlen( apc_line );
+    if( ( len > 0 ) && ( apc_line[ len - 1 ] == '\r' ) )
+      apc_line[ --len ] = '\0';
+    const char* pc_star = strchr( apc_line, '*' );
+    if( ( apc_line[ 0 ] != '$' ) || ( pc_star == NULL ) )
+      return;
+
+    uint8_t ui8_sum = 0;
+    for( const char* pc = apc_line + 1; pc < pc_star; ++pc )
+      ui8_sum ^= uint8_t( *pc );
+    if( strtoul( pc_star + 1, NULL, 16 ) != ui8_sum )
+    {
+      ++mui32_checksumErrors;
+      return;
+    }
+    mrc_checker.handleSentence( apc_line, uint16_t( len ) );
+  }
+
+  Checker_c& mrc_checker;
+  std::deque<int8_t> mdeq_buff;
+};
+
+
+int main()
+{
+  const std::string cstr_stream = generate();
+  const uint8_t* const cpui8_stream = reinterpret_cast<const uint8_t*>( cstr_stream.data() );
+  const uint32_t cui32_size = uint32_t( cstr_stream.size() );
+  const uint32_t cui32_sentences = scui32_epochs * 4;
+  const uint32_t cui32_corrupt = ( scui32_epochs + scui32_corruptEvery - 1 ) / scui32_corruptEvery;
+
+  printf( "%lu epochs at 20 Hz (GGA, RMC, VTG, GST), %lu sentences, %lu bytes, %lu with a bad checksum\n",
+          (unsigned long)scui32_epochs, (unsigned long)cui32_sentences, (unsigned long)cui32_size, (unsigned long)cui32_corrupt );
+  printf( "             ns per sentence, framing only   ns per sentence, with decode\n" );
+  printf( "bytes/poll       scanner          rescan           scanner          rescan\n" );
+
+  bool b_ok = true;
+  for( uint8_t ui8_c = 0; ui8_c < scui8_chunkCnt; ++ui8_c )
+  {
+    const uint16_t cui16_chunk = scui16_chunks[ ui8_c ];
+    printf( "%10u", unsigned( cui16_chunk ) );
+
+    for( uint8_t ui8_decode = 0; ui8_decode < 2; ++ui8_decode )
+    {
+      Checker_c c_scanned( ui8_decode != 0 );
+      iNmeaScanner_c c_scanner;
+      c_scanner.setHandler( &c_scanned );
+      clock_t t_start = clock();
+      for( uint32_t ui32_pos = 0; ui32_pos < cui32_size; ui32_pos += cui16_chunk )
+        c_scanner.feed( cpui8_stream + ui32_pos, uint16_t( ( cui32_size - ui32_pos < cui16_chunk ) ? ( cui32_size - ui32_pos ) : cui16_chunk ) );
+      const double cd_scanner = double( clock() - t_start ) / CLOCKS_PER_SEC;
+
+      Checker_c c_rescanned( ui8_decode != 0 );
+      RescanFramer_c c_rescan( c_rescanned );
+      t_start = clock();
+      for( uint32_t ui32_pos = 0; ui32_pos < cui32_size; ui32_pos += cui16_chunk )
+        c_rescan.feed( cpui8_stream + ui32_pos, uint16_t( ( cui32_size - ui32_pos < cui16_chunk ) ? ( cui32_size - ui32_pos ) : cui16_chunk ) );
+      const double cd_rescan = double( clock() - t_start ) / CLOCKS_PER_SEC;
+
+      printf( "   %14.1f  %14.1f", cd_scanner * 1.0e9 / cui32_sentences, cd_rescan * 1.0e9 / cui32_sentences );
+
+      const uint32_t cui32_good = cui32_sentences - cui32_corrupt;
+      const uint32_t cui32_epochsChecked = ( ui8_decode != 0 ) ? ( scui32_epochs - cui32_corrupt ) : 0;
+      if( ( c_scanned.mui32_sentences != cui32_good ) || ( c_scanner.checksumErrorCnt() != cui32_corrupt )
+       || ( c_scanned.mui32_epochs != cui32_epochsChecked ) || ( c_scanned.mui32_wrongEpochs != 0 ) )
+      {
+        printf( "\n  scanner: %lu sentences, %lu checksum errors, %lu epochs, %lu decoded wrong\n",
+                (unsigned long)c_scanned.mui32_sentences, (unsigned long)c_scanner.checksumErrorCnt(),
+                (unsigned long)c_scanned.mui32_epochs, (unsigned long)c_scanned.mui32_wrongEpochs );
+        b_ok = false;
+      }
+      if( ( c_rescanned.mui32_sentences != cui32_good ) || ( c_rescan.mui32_checksumErrors != cui32_corrupt )
+       || ( c_rescanned.mui32_epochs != cui32_epochsChecked ) || ( c_rescanned.mui32_wrongEpochs != 0 ) )
+      {
+        printf( "\n  rescan: %lu sentences, %lu checksum errors, %lu epochs, %lu decoded wrong\n",
+                (unsigned long)c_rescanned.mui32_sentences, (unsigned long)c_rescan.mui32_checksumErrors,
+                (unsigned long)c_rescanned.mui32_epochs, (unsigned long)c_rescanned.mui32_wrongEpochs );
+        b_ok = false;
+      }
+    }
+    printf( "\n" );
+  }
+
+  return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,321 @@
+/*
+  rs232_pty.cpp: Throughput of the Linux RS232 HAL over a
+    pseudo-terminal pair, in block and in byte reads/writes, against
+    a replay of the former deque based HAL on the same pty.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#include <IsoAgLib/driver/system/isystem_c.h>
+#include <supplementary_driver/driver/rs232/irs232io_c.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <fcntl.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace IsoAgLib;
+
+
+/* the project defines RS232_SERIAL_DEV as "isoaglib_pty",
+   so channel 0 opens this link to the pty's slave side */
+static const char* const scpc_link = "isoaglib_pty0";
+
+
+static uint8_t pattern( uint32_t aui32_pos )
+{
+  return uint8_t( ( aui32_pos * 131 ) ^ ( aui32_pos >> 9 ) );
+}
+
+
+static double wallTime_s()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+
+/* the device on the other end, on the pty's master side */
+struct Peer_s
+{
+  int fd;
+  uint32_t size;
+  uint32_t wrong;
+  volatile bool done;
+};
+
+static void* peerWrite( void* apv_peer )
+{
+  Peer_s& rs_peer = *static_cast<Peer_s*>( apv_peer );
+  uint8_t pui8_buf[ 4096 ];
+  for( uint32_t ui32_pos = 0; ui32_pos < rs_peer.size; )
+  {
+    uint32_t ui32_len = rs_peer.size - ui32_pos;
+    if( ui32_len > sizeof( pui8_buf ) ) ui32_len = sizeof( pui8_buf );
+    for( uint32_t n = 0; n < ui32_len; ++n )
+      pui8_buf[ n ] = pattern( ui32_pos + n );
+    const ssize_t written = write( rs_peer.fd, pui8_buf, ui32_len );
+    if( written <= 0 )
+      break;
+    ui32_pos += uint32_t( written );
+  }
+  return NULL;
+}
+
+static void* peerRead( void* apv_peer )
+{
+  Peer_s& rs_peer = *static_cast<Peer_s*>( apv_peer );
+  uint8_t pui8_buf[ 4096 ];
+  for( uint32_t ui32_pos = 0; ui32_pos < rs_peer.size; )
+  {
+    const ssize_t got = read( rs_peer.fd, pui8_buf, sizeof( pui8_buf ) );
+    if( got <= 0 )
+      break;
+    for( ssize_t n = 0; n < got; ++n )
+    {
+      if( pui8_buf[ n ] != pattern( ui32_pos + uint32_t( n ) ) )
+        ++rs_peer.wrong;
+    }
+    ui32_pos += uint32_t( got );
+  }
+  rs_peer.done = true;
+  return NULL;
+}
+
+
+/* reads up to the given count, @return number of bytes read */
+class Reader_c
+{
+public:
+  virtual ~Reader_c() {}
+  virtual uint16_t read( uint8_t* apui8_buf, uint16_t aui16_len ) = 0;
+};
+
+class Writer_c
+{
+public:
+  virtual ~Writer_c() {}
+  virtual void write( const uint8_t* apui8_buf, uint16_t aui16_len ) = 0;
+  /* called until the peer has got everything */
+  virtual void idle() {}
+};
+
+
+class HalReader_c : public Reader_c
+{
+public:
+  virtual uint16_t read( uint8_t* apui8_buf, uint16_t aui16_len ) { return getIrs232Instance().receive( apui8_buf, aui16_len ); }
+};
+
+class HalWriter_c : public Writer_c
+{
+public:
+  virtual void write( const uint8_t* apui8_buf, uint16_t aui16_len ) { getIrs232Instance().send( apui8_buf, aui16_len ); }
+  // the tail of the TX ring is written on by any HAL call
+  virtual void idle() { (void)getIrs232Instance().rec_bufferCnt(); }
+};
+
+
+/* the former HAL: each getRs232Char() read up to 299 bytes into a deque
+   and took one byte out of it; sending wrote and waited with tcdrain().
+   It dropped the rest of a partial write, the replay writes it after
+   the drain so the peer can check the data. */
+class FormerReader_c : public Reader_c
+{
+public:
+  FormerReader_c( int ai_fd ) : mi_fd( ai_fd ) {}
+  virtual uint16_t read( uint8_t* apui8_buf, uint16_t aui16_len )
+  {
+    uint16_t ui16_done = 0;
+    for( ; ui16_done < aui16_len; ++ui16_done )
+    {
+      int8_t c_temp[ 300 ];
+      const ssize_t tempLen = ::read( mi_fd, c_temp, 299 );
+      for( ssize_t ind = 0; ind < tempLen; ind++ )
+        mdeq_buff.push_back( c_temp[ ind ] );
+      if( mdeq_buff.empty() )
+        break;
+      apui8_buf[ ui16_done ] = uint8_t( mdeq_buff.front() );
+      mdeq_buff.pop_front();
+    }
+    return ui16_done;
+  }
+private:
+  int mi_fd;
+  std::deque<int8_t> mdeq_buff;
+};
+
+class FormerWriter_c : public Writer_c
+{
+public:
+  FormerWriter_c( int ai_fd ) : mi_fd( ai_fd ) {}
+  virtual void write( const uint8_t* apui8_buf, uint16_t aui16_len )
+  {
+    while( aui16_len > 0 )
+    {
+      const ssize_t written = ::write( mi_fd, apui8_buf, aui16_len );
+      tcdrain( mi_fd );
+      if( written > 0 )
+      {
+        apui8_buf += written;
+        aui16_len = uint16_t( aui16_len - written );
+      }
+    }
+  }
+private:
+  int mi_fd;
+};
+
+
+/* @return MB/s, 0 if the data arrived wrong */
+static double measureRx( int ai_master, Reader_c& arc_reader, uint16_t aui16_block, uint32_t aui32_size )
+{
+  Peer_s s_peer = { ai_master, aui32_size, 0, false };
+  pthread_t t_peer;
+  const double cd_start = wallTime_s();
+  pthread_create( &t_peer, NULL, peerWrite, &s_peer );
+
+  uint8_t pui8_buf[ 4096 ];
+  uint32_t ui32_wrong = 0;
+  for( uint32_t ui32_pos = 0; ui32_pos < aui32_size; )
+  {
+    uint16_t ui16_len = ( aui32_size - ui32_pos < aui16_block ) ? uint16_t( aui32_size - ui32_pos ) : aui16_block;
+    ui16_len = arc_reader.read( pui8_buf, ui16_len );
+    for( uint16_t n = 0; n < ui16_len; ++n )
+    {
+      if( pui8_buf[ n ] != pattern( ui32_pos + n ) )
+        ++ui32_wrong;
+    }
+    ui32_pos += ui16_len;
+  }
+  const double cd_time = wallTime_s() - cd_start;
+  pthread_join( t_peer, NULL );
+  return ( ui32_wrong == 0 ) ? aui32_size / cd_time * 1.0e-6 : 0.0;
+}
+
+static double measureTx( int ai_master, Writer_c& arc_writer, uint16_t aui16_block, uint32_t aui32_size )
+{
+  Peer_s s_peer = { ai_master, aui32_size, 0, false };
+  pthread_t t_peer;
+  pthread_create( &t_peer, NULL, peerRead, &s_peer );
+  const double cd_start = wallTime_s();
+
+  uint8_t pui8_buf[ 4096 ];
+  for( uint32_t ui32_pos = 0; ui32_pos < aui32_size; )
+  {
+    const uint16_t cui16_len = ( aui32_size - ui32_pos < aui16_block ) ? uint16_t( aui32_size - ui32_pos ) : aui16_block;
+    for( uint16_t n = 0; n < cui16_len; ++n )
+      pui8_buf[ n ] = pattern( ui32_pos + n );
+    arc_writer.write( pui8_buf, cui16_len );
+    ui32_pos += cui16_len;
+  }
+  while( !s_peer.done )
+    arc_writer.idle();
+  pthread_join( t_peer, NULL );
+  const double cd_time = wallTime_s() - cd_start;
+  return ( s_peer.wrong == 0 ) ? aui32_size / cd_time * 1.0e-6 : 0.0;
+}
+
+
+struct Case_s
+{
+  const char* name;
+  uint16_t block;
+  uint32_t size;
+};
+
+static const Case_s scs_cases[] = {
+  { "4096 byte blocks", 4096, 32UL * 1024 * 1024 },
+  { "64 byte blocks",     64,  8UL * 1024 * 1024 },
+  { "single bytes",        1,       512UL * 1024 }
+};
+static const uint8_t scui8_cases = sizeof( scs_cases ) / sizeof( scs_cases[ 0 ] );
+
+
+static bool report( const char* apc_path, const Case_s& acrs_case, double ad_rx, double ad_tx )
+{
+  printf( "%-8s %-17s %10.2f %10.2f\n", apc_path, acrs_case.name, ad_rx, ad_tx );
+  return ( ad_rx > 0.0 ) && ( ad_tx > 0.0 );
+}
+
+
+int main()
+{
+  const int ci_master = posix_openpt( O_RDWR | O_NOCTTY );
+  if( ( ci_master < 0 ) || ( grantpt( ci_master ) != 0 ) || ( unlockpt( ci_master ) != 0 ) )
+  {
+    printf( "no pseudo-terminal available\n" );
+    return EXIT_FAILURE;
+  }
+  unlink( scpc_link );
+  if( symlink( ptsname( ci_master ), scpc_link ) != 0 )
+  {
+    printf( "can't create %s in the working directory\n", scpc_link );
+    return EXIT_FAILURE;
+  }
+
+  getIsystemInstance().init();
+
+  // 921600 baud are 0.09 MB/s
+  printf( "MB/s over %s\n", ptsname( ci_master ) );
+  printf( "path     transfer               read      write\n" );
+  bool b_ok = true;
+
+  { /// the former HAL, replayed on the slave side
+    const int ci_slave = open( scpc_link, O_RDWR | O_NOCTTY | O_NONBLOCK );
+    struct termios t_options;
+    tcgetattr( ci_slave, &t_options );
+    cfmakeraw( &t_options );
+    tcsetattr( ci_slave, TCSANOW, &t_options );
+
+    FormerReader_c c_reader( ci_slave );
+    FormerWriter_c c_writer( ci_slave );
+    // it only had single byte reads, but any block size for writing
+    for( uint8_t n = 0; n < scui8_cases; ++n )
+    {
+      Case_s s_case = scs_cases[ n ];
+      if( s_case.size > 4UL * 1024 * 1024 )
+        s_case.size = 4UL * 1024 * 1024;
+      b_ok &= report( "former", s_case, measureRx( ci_master, c_reader, 1, s_case.size ),
+                      measureTx( ci_master, c_writer, s_case.block, s_case.size ) );
+    }
+    close( ci_slave );
+  }
+
+  { /// the ring buffered HAL
+    if( !getIrs232Instance().init( 921600, iRS232IO_c::_8_N_1, false, 4096, 4096, 0 ) )
+    {
+      printf( "can't open %s with the RS232 HAL\n", scpc_link );
+      unlink( scpc_link );
+      return EXIT_FAILURE;
+    }
+    HalReader_c c_reader;
+    HalWriter_c c_writer;
+    for( uint8_t n = 0; n < scui8_cases; ++n )
+    {
+      b_ok &= report( "HAL", scs_cases[ n ], measureRx( ci_master, c_reader, scs_cases[ n ].block, scs_cases[ n ].size ),
+                      measureTx( ci_master, c_writer, scs_cases[ n ].block, scs_cases[ n ].size ) );
+    }
+    getIrs232Instance().close();
+  }
+
+  if( !b_ok )
+    printf( "data arrived wrong\n" );
+
+  close( ci_master );
+  unlink( scpc_link );
+  getIsystemInstance().close();
+  return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,178 @@
+/*
+  trace_replay.cpp: Regression driver for TraceSimulator_c - runs a
+    small control loop against an input trace on the virtual clock,
+    captures all outputs and compares them with an expected capture.
+
+  (C) Copyright 2009 - 2019 by OSB AG
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#include <IsoAgLib/driver/system/isystem_c.h>
+#include <IsoAgLib/hal/pc/system/tracesimulator_c.h>
+#include <supplementary_driver/driver/inputs/ianalogi_c.h>
+#include <supplementary_driver/driver/inputs/idigitali_c.h>
+#include <supplementary_driver/driver/inputs/icounteri_c.h>
+#include <supplementary_driver/driver/inputs/iinputs_c.h>
+#include <supplementary_driver/driver/outputs/idigitalo_c.h>
+#include <supplementary_driver/driver/outputs/ioutputs_c.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+using namespace IsoAgLib;
+
+
+static const ecutime_t sct_cycle = 10;     // [ms] application cycle
+static const ecutime_t sct_runOut = 1000;  // [ms] run on after the last input
+
+
+/* the built-in trace: a setpoint ramp on analog 0, an enable switch on
+   digital 1 and a wheel on counter 2 which speeds up and stops */
+static void builtInTrace( TraceSimulator_c& arc_sim )
+{
+  for( ecutime_t t = 0; t <= 4000; t += 100 )
+    arc_sim.addInput( t, TraceSimulator_c::KindAnalog, 0, int32_t( 500 + t / 2 ) );
+  arc_sim.addInput( 500, TraceSimulator_c::KindDigital, 1, 1 );
+  arc_sim.addInput( 3500, TraceSimulator_c::KindDigital, 1, 0 );
+
+  // 10 Hz for 1 s, 25 Hz for 1.5 s, then no more pulses
+  int32_t i32_count = 0;
+  ecutime_t t = 1000;
+  for( ; t < 2000; t += 100 )
+  {
+    arc_sim.addInput( t, TraceSimulator_c::KindCounter, 2, ++i32_count );
+    arc_sim.addInput( t, TraceSimulator_c::KindPeriod, 2, 100000 );
+  }
+  for( ; t < 3500; t += 40 )
+  {
+    arc_sim.addInput( t, TraceSimulator_c::KindCounter, 2, ++i32_count );
+    arc_sim.addInput( t, TraceSimulator_c::KindPeriod, 2, 40000 );
+  }
+}
+
+
+/* @return true if both files have the same content */
+static bool sameContent( const char* apc_file, const char* apc_expected )
+{
+  FILE* pc_file = fopen( apc_file, "r" );
+  FILE* pc_expected = fopen( apc_expected, "r" );
+  bool b_same = ( pc_file != NULL ) && ( pc_expected != NULL );
+  unsigned u_line = 0;
+  char line[ 128 ], expected[ 128 ];
+  while( b_same )
+  {
+    ++u_line;
+    const bool cb_line = ( fgets( line, sizeof( line ), pc_file ) != NULL );
+    const bool cb_expected = ( fgets( expected, sizeof( expected ), pc_expected ) != NULL );
+    if( !cb_line && !cb_expected )
+      break;
+    if( !cb_line || !cb_expected || ( strcmp( line, expected ) != 0 ) )
+    {
+      printf( "capture differs in line %u: %s  expected: %s\n", u_line, cb_line ? line : "<end>\n", cb_expected ? expected : "<end>\n" );
+      b_same = false;
+    }
+  }
+  if( pc_file != NULL ) fclose( pc_file );
+  if( pc_expected != NULL ) fclose( pc_expected );
+  return b_same;
+}
+
+
+int main( int argc, char *argv[] )
+{
+  const char* pc_trace = NULL;
+  const char* pc_capture = "trace_replay_capture.txt";
+  const char* pc_expected = NULL;
+  for( int i = 1; i < argc; ++i )
+  {
+    if( ( strcmp( argv[ i ], "-capture" ) == 0 ) && ( i + 1 < argc ) )
+      pc_capture = argv[ ++i ];
+    else if( ( strcmp( argv[ i ], "-expect" ) == 0 ) && ( i + 1 < argc ) )
+      pc_expected = argv[ ++i ];
+    else if( argv[ i ][ 0 ] != '-' )
+      pc_trace = argv[ i ];
+    else
+    {
+      printf( "Usage: %s [inputTrace] [-capture file] [-expect file]\n"
+              "  Without inputTrace a built-in trace is replayed.\n", argv[ 0 ] );
+      return EXIT_FAILURE;
+    }
+  }
+
+  TraceSimulator_c c_sim;
+  if( pc_trace == NULL )
+    builtInTrace( c_sim );
+  else if( !c_sim.loadTrace( pc_trace ) )
+  {
+    printf( "Can't read trace %s\n", pc_trace );
+    return EXIT_FAILURE;
+  }
+  __HAL::setHalSimulator( &c_sim );
+  c_sim.setClockMode( TraceSimulator_c::ClockVirtual );
+  c_sim.setTime( 0 );
+
+  getIsystemInstance().init();
+  getIinputsInstance().init();
+  getIoutputsInstance().init();
+
+  // the application: setpoint -> PWM, enable -> switch, wheel -> PWM frequency
+  iAnalogI_c c_setpoint( 0 );
+  iDigitalI_c c_enable( 1 );
+  iCounterI_c c_wheel( 2 );
+  iDigitalO_c c_valve( 0 ), c_switch( 1 ), c_pulse( 2 );
+  c_setpoint.setSampled( iInputs_c::AnalogMedian );
+  c_wheel.setEstimator( iFrequencyEstimator_c::FilterWindow, 4, 500 );
+
+  const clock_t ct_start = clock();
+  ecutime_t t_lastInput = -1;
+  uint32_t ui32_cycles = 0;
+  for( ;; )
+  {
+    if( !c_sim.replayFinished() )
+      t_lastInput = c_sim.nextInputTime();
+    else if( iSystem_c::getTime() > t_lastInput + sct_runOut )
+      break;
+
+    getIinputsInstance().sampleAnalog();
+    c_wheel.updateEstimate();
+
+    const bool cb_enabled = c_enable.active();
+    c_valve.stage( uint16_t( cb_enabled ? c_setpoint.val() : 0 ) );
+    c_switch.stage( cb_enabled );
+    c_pulse.stageFreq( c_wheel.estimatedFrequency_mHz() / 1000 );
+    c_pulse.stage( uint16_t( ( c_wheel.estimatedFrequency_mHz() > 0 ) ? 0x8000 : 0 ) );
+    getIoutputsInstance().commit();
+
+    c_sim.advanceTime( sct_cycle );
+    ++ui32_cycles;
+  }
+  const double cd_wall_ms = double( clock() - ct_start ) * 1000.0 / CLOCKS_PER_SEC;
+
+  getIoutputsInstance().close();
+  getIinputsInstance().close();
+
+  printf( "%lu cycles, %lld ms simulated in %.1f ms (%lu output events)\n",
+          (unsigned long)ui32_cycles, (long long)iSystem_c::getTime(), cd_wall_ms, (unsigned long)c_sim.capture().size() );
+  for( uint8_t ui8_ch = 0; ui8_ch < 3; ++ui8_ch )
+  {
+    const iOutputs_c::ChannelStatistics_s& crs_stats = getIoutputsInstance().statistics( ui8_ch );
+    printf( "output %u: %lu HAL writes, %lu suppressed\n", unsigned( ui8_ch ), (unsigned long)crs_stats.writes, (unsigned long)crs_stats.suppressed );
+  }
+
+  if( !c_sim.writeCapture( pc_capture ) )
+  {
+    printf( "Can't write capture %s\n", pc_capture );
+    return EXIT_FAILURE;
+  }
+  if( ( pc_expected != NULL ) && !sameContent( pc_capture, pc_expected ) )
+    return EXIT_FAILURE;
+  return EXIT_SUCCESS;
+}
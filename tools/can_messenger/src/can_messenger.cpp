@@ -20,11 +20,17 @@
 
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include <cstdlib>
+
+#include "../../libs/misc/cancapture.h"
 
 #ifdef WIN32
 #include <windows.h>
 #else
 #include <unistd.h>
+#include <time.h>
+#include <errno.h>
 #endif
 
 class cmdline_c
@@ -37,6 +43,10 @@ public:
   , i_channel (0)
   , i_period (0)
   , b_ext (false)
+  , d_speed (1.0)
+  , i_loops (1)
+  , i_pgnFilter (-1)
+  , i_saFilter (-1)
   {}
 
   int i_repeat;
@@ -45,6 +55,10 @@ public:
   int i_channel;
   int i_period;
   int b_ext;
+  double d_speed;
+  int i_loops;
+  int i_pgnFilter;
+  int i_saFilter;
   std::string str_replay_file;
   uint8_t pui8_databytes [8];
 
@@ -138,6 +152,10 @@ void cmdline_c::parse (int argc, char *argv[])
         case 'p': i_period = atoi (argv[i]); break;
         case 'x': b_ext = true; i--; break;
         case 'f': str_replay_file = std::string(argv[i]); break;
+        case 't': d_speed = atof (argv[i]); break;
+        case 'l': i_loops = atoi (argv[i]); break;
+        case 'g': i_pgnFilter = ahextoi (argv[i]) & 0x3FFFF; break;
+        case 'a': i_saFilter = ahextoi (argv[i]) & 0xFF; break;
         default: printf ("Unsupported parameter!\n"); usage_and_exit(1); break;
       }
       nextup[2-1] = ' '; // free to await next parameter-pair
@@ -150,6 +168,12 @@ void cmdline_c::parse (int argc, char *argv[])
     printf ("Incomplete parameter-type\n");
     usage_and_exit (1);
   }
+
+  if ((d_speed < 0.5) || (d_speed > 100.0))
+  {
+    printf ("Replay speed has to be in the range 0.5 .. 100!\n");
+    usage_and_exit (1);
+  }
 }
 
 
@@ -162,6 +186,11 @@ void cmdline_c::usage_and_exit (int ai_errorCode) const
   printf ("   -p <Period in ms>\n");
   printf ("   -x     (use eXtended Identifier)\n");
   printf ("   -f replay file (structure <timestamp (ms)> <ID> <up to 8 blank separated data bytes as HEX>\n");
+  printf ("      or a binary capture as written by \"logalizer --capture\"\n");
+  printf ("   -t <Replay speed factor 0.5 .. 100> (default 1)\n");
+  printf ("   -l <Replay loops> (0 = endless, default 1)\n");
+  printf ("   -g <Replay only this PGN as HEX>\n");
+  printf ("   -a <Replay only this source address as HEX>\n");
   printf ("\n Example: can_messenger -x -n 1 -c 0 -i 1ceafffe -d a1b2c3d4e5f6affe\n\n");
 
   exit (ai_errorCode);
@@ -171,6 +200,257 @@ void cmdline_c::usage_and_exit (int ai_errorCode) const
 using namespace IsoAgLib;
 using namespace __IsoAgLib;
 
+
+/** Preloads a CAN-log and sends it with the original timing.
+    Every frame has an absolute deadline relative to the replay start
+    (scaled by the speed factor), so sleeping/sending latencies don't
+    add up. All frames that are due are sent as one batch. */
+class ReplayEngine_c
+{
+public:
+  ReplayEngine_c()
+  : mui64_sent (0)
+  , mui64_late (0)
+  , mi64_errorSum_us (0)
+  , mi64_errorMax_us (0)
+  , mui64_batches (0)
+  {}
+
+  bool load (const std::string& file, int pgnFilter, int saFilter);
+  void run (CanPkg_c& pkg, double speed, int loops);
+  void report () const;
+
+  size_t size() const { return mvec_frames.size(); }
+
+private:
+  struct Frame_s
+  {
+    uint64_t time_us; // relative to the first frame
+    uint32_t identifier;
+    bool ext;
+    uint8_t len;
+    uint8_t data[8];
+  };
+
+  bool loadCapture (const std::string& file);
+  bool loadText (const std::string& file);
+  void filter (int pgnFilter, int saFilter);
+
+  static uint64_t now_us();
+  static void sleepUntil_us (uint64_t deadline);
+
+  std::vector<Frame_s> mvec_frames;
+
+  uint64_t mui64_sent;
+  uint64_t mui64_late; // more than 1ms behind the deadline
+  int64_t mi64_errorSum_us;
+  int64_t mi64_errorMax_us;
+  uint64_t mui64_batches;
+};
+
+
+uint64_t ReplayEngine_c::now_us()
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency (&freq);
+  QueryPerformanceCounter (&count);
+  return uint64_t (count.QuadPart / freq.QuadPart) * 1000000
+       + uint64_t (count.QuadPart % freq.QuadPart) * 1000000 / uint64_t (freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return uint64_t (ts.tv_sec) * 1000000 + uint64_t (ts.tv_nsec) / 1000;
+#endif
+}
+
+
+void ReplayEngine_c::sleepUntil_us (uint64_t deadline)
+{
+#ifdef WIN32
+  // Sleep() is too coarse, sleep most of the time and spin the rest
+  for (;;)
+  {
+    const uint64_t now = now_us();
+    if (now >= deadline)
+      return;
+    if (deadline - now > 2000)
+      Sleep (DWORD ((deadline - now) / 1000 - 1));
+  }
+#else
+  struct timespec ts;
+  ts.tv_sec = time_t (deadline / 1000000);
+  ts.tv_nsec = long (deadline % 1000000) * 1000;
+  while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    ;
+#endif
+}
+
+
+bool ReplayEngine_c::load (const std::string& file, int pgnFilter, int saFilter)
+{
+  mvec_frames.clear();
+  const bool ok = CanCapture::Reader_c::isCapture (file) ? loadCapture (file) : loadText (file);
+  if (!ok)
+    return false;
+
+  filter (pgnFilter, saFilter);
+
+  // make the timestamps relative, the log may start at any time
+  if (!mvec_frames.empty())
+  {
+    const uint64_t first = mvec_frames[0].time_us;
+    for (size_t i = 0; i < mvec_frames.size(); ++i)
+      mvec_frames[i].time_us = (mvec_frames[i].time_us > first) ? (mvec_frames[i].time_us - first) : 0;
+  }
+  return true;
+}
+
+
+bool ReplayEngine_c::loadCapture (const std::string& file)
+{
+  CanCapture::Reader_c capture;
+  if (!capture.open (file))
+    return false;
+
+  mvec_frames.reserve (size_t (capture.size()));
+  CanCapture::Record_s record;
+  while (capture.next (record))
+  {
+    Frame_s frame;
+    frame.time_us = record.mui64_time_us;
+    frame.identifier = record.mui32_identifier;
+    frame.ext = record.mb_ext;
+    frame.len = (record.mui8_dlc > 8) ? 8 : record.mui8_dlc;
+    memcpy (frame.data, record.marr_data, 8);
+    mvec_frames.push_back (frame);
+  }
+  return true;
+}
+
+
+/* <timestamp (ms)> <ID> <up to 8 blank separated data bytes as HEX> */
+bool ReplayEngine_c::loadText (const std::string& file)
+{
+  std::ifstream input (file.c_str());
+  if (!input)
+    return false;
+
+  std::string line;
+  while (std::getline (input, line))
+  {
+    const char* cursor = line.c_str();
+    char* end;
+    const double timestamp = strtod (cursor, &end);
+    if (end == cursor)
+      continue; // empty or no log line
+    cursor = end;
+    const unsigned long identifier = strtoul (cursor, &end, 16);
+    if (end == cursor)
+      continue;
+    cursor = end;
+
+    Frame_s frame;
+    frame.time_us = (timestamp > 0.0) ? uint64_t (timestamp * 1000.0) : 0;
+    frame.identifier = uint32_t (identifier);
+    frame.ext = (identifier >= (1 << 11));
+    frame.len = 0;
+    while (frame.len < 8)
+    {
+      const unsigned long value = strtoul (cursor, &end, 16);
+      if (end == cursor)
+        break;
+      frame.data[frame.len++] = uint8_t (value);
+      cursor = end;
+    }
+    mvec_frames.push_back (frame);
+  }
+  return true;
+}
+
+
+void ReplayEngine_c::filter (int pgnFilter, int saFilter)
+{
+  if ((pgnFilter < 0) && (saFilter < 0))
+    return;
+
+  size_t kept = 0;
+  for (size_t i = 0; i < mvec_frames.size(); ++i)
+  {
+    const Frame_s& frame = mvec_frames[i];
+    if (!frame.ext)
+      continue; // no PGN/SA
+
+    CanCapture::Record_s record;
+    record.mui32_identifier = frame.identifier;
+    if ((pgnFilter >= 0) && (record.pgn() != uint32_t (pgnFilter)))
+      continue;
+    if ((saFilter >= 0) && (record.sourceAddress() != saFilter))
+      continue;
+    mvec_frames[kept++] = frame;
+  }
+  mvec_frames.resize (kept);
+}
+
+
+void ReplayEngine_c::run (CanPkg_c& pkg, double speed, int loops)
+{
+  if (mvec_frames.empty())
+    return;
+
+  // a loop lasts as long as the log plus the average frame distance
+  const uint64_t loopDuration_us = mvec_frames.back().time_us
+    + ((mvec_frames.size() > 1) ? mvec_frames.back().time_us / (mvec_frames.size() - 1) : 0);
+
+  const uint64_t start = now_us();
+  for (int loop = 0; (loops == 0) || (loop < loops); ++loop)
+  {
+    size_t i = 0;
+    while (i < mvec_frames.size())
+    {
+      const uint64_t loopOffset_us = uint64_t (loop) * loopDuration_us;
+      const uint64_t deadline = start + uint64_t (double (mvec_frames[i].time_us + loopOffset_us) / speed);
+      sleepUntil_us (deadline);
+
+      // send everything that's due now as one batch
+      const uint64_t now = now_us();
+      ++mui64_batches;
+      do
+      {
+        const Frame_s& frame = mvec_frames[i];
+        const uint64_t frameDeadline = start + uint64_t (double (frame.time_us + loopOffset_us) / speed);
+        if (frameDeadline > now)
+          break;
+
+        pkg.setIdent (frame.identifier, frame.ext ? iIdent_c::ExtendedIdent : iIdent_c::StandardIdent);
+        pkg.setDataFromString (0, frame.data, frame.len);
+        pkg.setLen (frame.len);
+        getCanInstance() << pkg;
+
+        const int64_t error = int64_t (now_us() - frameDeadline);
+        mi64_errorSum_us += error;
+        if (error > mi64_errorMax_us) mi64_errorMax_us = error;
+        if (error > 1000) ++mui64_late;
+        ++mui64_sent;
+        ++i;
+      } while (i < mvec_frames.size());
+    }
+  }
+}
+
+
+void ReplayEngine_c::report () const
+{
+  if (mui64_sent == 0)
+  {
+    printf ("Nothing replayed.\n");
+    return;
+  }
+  printf ("Replayed %lu frames in %lu batches. Timing error (sent - intended): mean %ld us, max %ld us, %lu frames > 1 ms late.\n",
+          (unsigned long)mui64_sent, (unsigned long)mui64_batches,
+          long (mi64_errorSum_us / int64_t (mui64_sent)), long (mi64_errorMax_us), (unsigned long)mui64_late);
+}
+
 int main( int argc, char *argv[] )
 {
   cmdline_c params;
@@ -193,69 +473,17 @@ int main( int argc, char *argv[] )
   
   if(!params.str_replay_file.empty())
   {
-    std::ifstream input(params.str_replay_file.c_str());
-    if (!input)
+    ReplayEngine_c replay;
+    if (!replay.load(params.str_replay_file, params.i_pgnFilter, params.i_saFilter))
     {
       params.usage_and_exit(1);
     }
 
-    printf ("Replaying CAN-log...\n" );
-
-    float timestamp = 0.0;
-    float last_time = 0.0;
-
-    const uint32_t buf_size = 256;
-    char buf[buf_size];
-    
-    uint32_t identifier = 0;
-    uint32_t data_byte = 0;
-    uint8_t len = 0;
-        
-    while (!input.eof())
-    {
-      input.getline(buf, buf_size);
-      std::istringstream lineStream(buf);
-
-      if (lineStream.eof())
-        break;
-      lineStream >> timestamp;
-      
-      if (lineStream.eof())
-        break;
-      lineStream >> std::hex >> identifier;
-
-      len = 0;
-      while (!lineStream.eof()) {
-        lineStream >> data_byte;
-        if(!lineStream.eof())
-        {
-          pkg.setUint8Data(len, data_byte & 0xFF);
-          len++;
-        }
-        if(len >= 8)
-        {
-          break;
-        }
-      }
-
-      if (last_time != 0.0)
-      {
-#ifdef WIN32
-          Sleep(uint32_t(timestamp - last_time)); // won't be too accurate though due to bad Windows Sleep-capability.
-#else
-          usleep(uint32_t(timestamp - last_time) * 1000);
-#endif
-      }
-      
-      pkg.setIdent(identifier, (identifier >= (1 << 11)) ? iIdent_c::ExtendedIdent : iIdent_c::StandardIdent);
-      pkg.setLen(len);
-
-      getCanInstance() << pkg;
-      
-      std::cout << std::hex << timestamp << " " << identifier << std::endl;
+    printf ("Replaying CAN-log (%lu frames, speed x%g, %d loop(s))...\n",
+            (unsigned long)replay.size(), params.d_speed, params.i_loops );
 
-      last_time = timestamp;
-    } // while( !eof )
+    replay.run(pkg, params.d_speed, params.i_loops);
+    replay.report();
   }
   else
   {
@@ -0,0 +1,389 @@
+/*
+  cancapture.h: compact binary CAN capture format with side indexes,
+    shared by the tools (logalizer, can_messenger)
+
+  (C) Copyright 2009 - 2019 by OSB AG and developing partners
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef CANCAPTURE_H
+#define CANCAPTURE_H
+
+/* File layout (all values little endian):
+
+   header (32 bytes)
+     char[8]  magic "ISOCAPT1"
+     uint32   record size (24)
+     uint32   time block size (records per time index entry)
+     uint64   number of records
+     uint64   offset of the index section
+
+   records (24 bytes each, in capture order)
+     uint64   timestamp [us]
+     uint32   identifier, bit 31 set for extended (29 bit) identifiers
+     uint8    dlc
+     uint8    channel
+     uint8[2] reserved
+     uint8[8] data
+
+   index section
+     uint32   number of time blocks (B), uint32 number of PGNs (P)
+     uint64   first timestamp of each time block              [B]
+     uint32   PGN, first reference, number of references      [P] (sorted by PGN)
+     uint32   first reference, number of references per SA    [256]
+     uint32   record numbers grouped by PGN                   [extended frames]
+     uint32   record numbers grouped by SA                    [extended frames]
+
+   Record numbers inside each group are ascending, so a filtered query
+   still reads the capture in time order. */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#ifdef WIN32
+#if ( _MSC_VER > 1500 )
+#include <cstdint>
+#endif
+#else
+#include <stdint.h>
+#endif
+
+
+namespace CanCapture {
+
+static const char scpc_magic[8] = { 'I', 'S', 'O', 'C', 'A', 'P', 'T', '1' };
+enum { HeaderSize = 32, RecordSize = 24, TimeBlockSize = 4096, ExtendedFlag = 0x80000000UL };
+
+
+struct Record_s {
+  uint64_t mui64_time_us;
+  uint32_t mui32_identifier; // without ExtendedFlag
+  bool mb_ext;
+  uint8_t mui8_dlc;
+  uint8_t mui8_channel;
+  uint8_t marr_data[8];
+
+  uint8_t sourceAddress() const { return uint8_t(mui32_identifier); }
+  uint32_t pgn() const {
+    const uint32_t pf = (mui32_identifier >> 16) & 0xFF;
+    return ((mui32_identifier >> 8) & 0x30000UL) | (pf << 8) | ((pf >= 0xF0) ? ((mui32_identifier >> 8) & 0xFF) : 0);
+  }
+};
+
+
+inline void putLe(uint8_t *p, uint64_t v, unsigned bytes) {
+  for (unsigned i = 0; i < bytes; ++i) p[i] = uint8_t(v >> (8*i));
+}
+
+inline uint64_t getLe(const uint8_t *p, unsigned bytes) {
+  uint64_t v = 0;
+  for (unsigned i = bytes; i > 0; --i) v = (v << 8) | p[i-1];
+  return v;
+}
+
+inline int seek(std::FILE *f, uint64_t pos) {
+#ifdef WIN32
+  return _fseeki64(f, int64_t(pos), SEEK_SET);
+#else
+  return fseeko(f, off_t(pos), SEEK_SET);
+#endif
+}
+
+
+/* Writes the records sequentially, the indexes are built on close(). */
+class Writer_c {
+public:
+  Writer_c() : mp_file(NULL) {}
+  ~Writer_c() { close(); }
+
+  bool open(const std::string &acr_filename)
+  {
+    mp_file = std::fopen(acr_filename.c_str(), "wb");
+    if (!mp_file)
+      return false;
+    uint8_t header[HeaderSize] = { 0 };
+    return std::fwrite(header, 1, HeaderSize, mp_file) == HeaderSize; // written on close()
+  }
+
+  /* @return false on write error or if the record numbers would overflow */
+  bool append(const Record_s &ars_record)
+  {
+    if (!mp_file || (mvec_keys.size() >= 0xFFFFFFFFUL))
+      return false;
+
+    if ((mvec_keys.size() % TimeBlockSize) == 0)
+      mvec_blockTimes.push_back(ars_record.mui64_time_us);
+
+    uint8_t buf[RecordSize];
+    putLe(buf, ars_record.mui64_time_us, 8);
+    putLe(buf+8, ars_record.mui32_identifier | (ars_record.mb_ext ? uint32_t(ExtendedFlag) : 0), 4);
+    buf[12] = ars_record.mui8_dlc;
+    buf[13] = ars_record.mui8_channel;
+    buf[14] = buf[15] = 0;
+    std::memcpy(buf+16, ars_record.marr_data, 8);
+
+    // standard frames have no PGN/SA, they're not indexed
+    mvec_keys.push_back(ars_record.mb_ext ? ((ars_record.pgn() << 8) | ars_record.sourceAddress()) : 0xFFFFFFFFUL);
+    return std::fwrite(buf, 1, RecordSize, mp_file) == RecordSize;
+  }
+
+  bool close()
+  {
+    if (!mp_file)
+      return true;
+
+    const uint64_t cui64_indexOffset = uint64_t(HeaderSize) + uint64_t(mvec_keys.size()) * RecordSize;
+
+    // counting the references per PGN / SA
+    std::vector< uint32_t > vec_pgnOrder;
+    uint32_t arr_saCount[256] = { 0 };
+    for (uint32_t i = 0; i < mvec_keys.size(); ++i) {
+      if (mvec_keys[i] == 0xFFFFFFFFUL) continue;
+      vec_pgnOrder.push_back(i);
+      ++arr_saCount[mvec_keys[i] & 0xFF];
+    }
+    std::stable_sort(vec_pgnOrder.begin(), vec_pgnOrder.end(), KeyLess_s(mvec_keys));
+
+    std::vector< uint8_t > idx;
+    putU32(idx, uint32_t(mvec_blockTimes.size()));
+    std::vector< uint32_t > vec_pgnTable; // pgn, first, count
+    for (uint32_t i = 0; i < vec_pgnOrder.size(); ++i) {
+      const uint32_t pgn = mvec_keys[vec_pgnOrder[i]] >> 8;
+      if (vec_pgnTable.empty() || vec_pgnTable[vec_pgnTable.size()-3] != pgn) {
+        vec_pgnTable.push_back(pgn);
+        vec_pgnTable.push_back(i);
+        vec_pgnTable.push_back(0);
+      }
+      ++vec_pgnTable.back();
+    }
+    putU32(idx, uint32_t(vec_pgnTable.size() / 3));
+    for (size_t i = 0; i < mvec_blockTimes.size(); ++i) {
+      idx.resize(idx.size() + 8);
+      putLe(&idx[idx.size()-8], mvec_blockTimes[i], 8);
+    }
+    for (size_t i = 0; i < vec_pgnTable.size(); ++i)
+      putU32(idx, vec_pgnTable[i]);
+    uint32_t ui32_first = 0;
+    for (unsigned sa = 0; sa < 256; ++sa) {
+      putU32(idx, ui32_first);
+      putU32(idx, arr_saCount[sa]);
+      ui32_first += arr_saCount[sa];
+    }
+    for (size_t i = 0; i < vec_pgnOrder.size(); ++i)
+      putU32(idx, vec_pgnOrder[i]);
+
+    std::vector< uint32_t > vec_saRefs(vec_pgnOrder.size());
+    uint32_t arr_saPos[256];
+    arr_saPos[0] = 0;
+    for (unsigned sa = 1; sa < 256; ++sa)
+      arr_saPos[sa] = arr_saPos[sa-1] + arr_saCount[sa-1];
+    for (uint32_t i = 0; i < mvec_keys.size(); ++i)
+      if (mvec_keys[i] != 0xFFFFFFFFUL)
+        vec_saRefs[arr_saPos[mvec_keys[i] & 0xFF]++] = i;
+    for (size_t i = 0; i < vec_saRefs.size(); ++i)
+      putU32(idx, vec_saRefs[i]);
+
+    bool b_ok = idx.empty() || (std::fwrite(&idx[0], 1, idx.size(), mp_file) == idx.size());
+
+    uint8_t header[HeaderSize];
+    std::memcpy(header, scpc_magic, 8);
+    putLe(header+8, RecordSize, 4);
+    putLe(header+12, TimeBlockSize, 4);
+    putLe(header+16, mvec_keys.size(), 8);
+    putLe(header+24, cui64_indexOffset, 8);
+    b_ok = b_ok && (seek(mp_file, 0) == 0) && (std::fwrite(header, 1, HeaderSize, mp_file) == HeaderSize);
+
+    b_ok = (std::fclose(mp_file) == 0) && b_ok;
+    mp_file = NULL;
+    mvec_keys.clear();
+    mvec_blockTimes.clear();
+    return b_ok;
+  }
+
+private:
+  struct KeyLess_s {
+    KeyLess_s(const std::vector< uint32_t > &keys) : mcr_keys(keys) {}
+    bool operator()(uint32_t a, uint32_t b) const { return (mcr_keys[a] >> 8) < (mcr_keys[b] >> 8); }
+    const std::vector< uint32_t > &mcr_keys;
+  };
+
+  static void putU32(std::vector< uint8_t > &v, uint32_t value) {
+    v.resize(v.size() + 4);
+    putLe(&v[v.size()-4], value, 4);
+  }
+
+  // not copyable
+  Writer_c(const Writer_c &);
+  Writer_c &operator=(const Writer_c &);
+
+  std::FILE *mp_file;
+  std::vector< uint32_t > mvec_keys; // (pgn << 8) | sa per record
+  std::vector< uint64_t > mvec_blockTimes;
+};
+
+
+class Reader_c {
+public:
+  Reader_c() : mp_file(NULL), mui64_count(0), mui64_position(0) {}
+  ~Reader_c() { if (mp_file) std::fclose(mp_file); }
+
+  static bool isCapture(const std::string &acr_filename)
+  {
+    std::FILE *f = std::fopen(acr_filename.c_str(), "rb");
+    if (!f)
+      return false;
+    char magic[8];
+    const bool cb_match = (std::fread(magic, 1, 8, f) == 8) && (std::memcmp(magic, scpc_magic, 8) == 0);
+    std::fclose(f);
+    return cb_match;
+  }
+
+  bool open(const std::string &acr_filename)
+  {
+    mp_file = std::fopen(acr_filename.c_str(), "rb");
+    if (!mp_file)
+      return false;
+
+    uint8_t header[HeaderSize];
+    if ((std::fread(header, 1, HeaderSize, mp_file) != HeaderSize)
+     || (std::memcmp(header, scpc_magic, 8) != 0)
+     || (getLe(header+8, 4) != RecordSize))
+      return false;
+    mui32_blockSize = uint32_t(getLe(header+12, 4));
+    mui64_count = getLe(header+16, 8);
+    const uint64_t cui64_indexOffset = getLe(header+24, 8);
+
+    // the index is small compared to the records, keep it in memory
+    uint8_t counts[8];
+    if ((seek(mp_file, cui64_indexOffset) != 0) || (std::fread(counts, 1, 8, mp_file) != 8))
+      return false;
+    mvec_blockTimes.resize(size_t(getLe(counts, 4)));
+    mvec_pgnTable.resize(size_t(getLe(counts+4, 4)) * 3);
+    for (size_t i = 0; i < mvec_blockTimes.size(); ++i)
+      mvec_blockTimes[i] = readLe(8);
+    for (size_t i = 0; i < mvec_pgnTable.size(); ++i)
+      mvec_pgnTable[i] = uint32_t(readLe(4));
+    for (unsigned i = 0; i < 512; ++i)
+      marr_saTable[i] = uint32_t(readLe(4));
+    mui64_refsOffset = uint64_t(cui64_indexOffset) + 8 + mvec_blockTimes.size()*8 + mvec_pgnTable.size()*4 + 512*4;
+
+    return !std::ferror(mp_file) && (seek(mp_file, HeaderSize) == 0);
+  }
+
+  uint64_t size() const { return mui64_count; }
+
+  /* sequential read, @return false at the end */
+  bool next(Record_s &ars_record)
+  {
+    if (mui64_position >= mui64_count)
+      return false;
+    uint8_t buf[RecordSize];
+    if (std::fread(buf, 1, RecordSize, mp_file) != RecordSize)
+      return false;
+    ++mui64_position;
+    const uint32_t cui32_id = uint32_t(getLe(buf+8, 4));
+    ars_record.mui64_time_us = getLe(buf, 8);
+    ars_record.mb_ext = (cui32_id & ExtendedFlag) != 0;
+    ars_record.mui32_identifier = cui32_id & ~uint32_t(ExtendedFlag);
+    ars_record.mui8_dlc = buf[12];
+    ars_record.mui8_channel = buf[13];
+    std::memcpy(ars_record.marr_data, buf+16, 8);
+    return true;
+  }
+
+  bool seekRecord(uint64_t aui64_record)
+  {
+    mui64_position = std::min(aui64_record, mui64_count);
+    return seek(mp_file, uint64_t(HeaderSize) + mui64_position * RecordSize) == 0;
+  }
+
+  /* @return number of the first record with a timestamp >= aui64_time_us */
+  uint64_t findTime(uint64_t aui64_time_us)
+  {
+    if (mvec_blockTimes.empty())
+      return 0;
+    // last block starting before the time, then linear inside the block
+    std::vector< uint64_t >::const_iterator it = std::upper_bound(mvec_blockTimes.begin(), mvec_blockTimes.end(), aui64_time_us);
+    const uint64_t cui64_block = (it == mvec_blockTimes.begin()) ? 0 : uint64_t(it - mvec_blockTimes.begin()) - 1;
+    Record_s s_record = Record_s();
+    seekRecord(cui64_block * mui32_blockSize);
+    uint64_t ui64_record = mui64_position;
+    for (;;)
+    {
+      if (!next(s_record))
+      { // end of capture (or read error): no record at or after the time
+        ui64_record = mui64_count;
+        break;
+      }
+      if (s_record.mui64_time_us >= aui64_time_us)
+        break;
+      ui64_record = mui64_position;
+    }
+    seekRecord(ui64_record);
+    return ui64_record;
+  }
+
+  /* record numbers (ascending) of all extended frames with the given PGN */
+  bool recordsOfPgn(uint32_t aui32_pgn, std::vector< uint32_t > &ar_records)
+  {
+    ar_records.clear();
+    for (size_t i = 0; i < mvec_pgnTable.size(); i += 3)
+      if (mvec_pgnTable[i] == aui32_pgn)
+        return readRefs(mui64_refsOffset, mvec_pgnTable[i+1], mvec_pgnTable[i+2], ar_records);
+    return true;
+  }
+
+  /* record numbers (ascending) of all extended frames from the given source address */
+  bool recordsOfSa(uint8_t aui8_sa, std::vector< uint32_t > &ar_records)
+  {
+    uint64_t ui64_pgnRefs = 0;
+    for (size_t i = 2; i < mvec_pgnTable.size(); i += 3)
+      ui64_pgnRefs += mvec_pgnTable[i];
+    return readRefs(mui64_refsOffset + ui64_pgnRefs*4, marr_saTable[2*aui8_sa], marr_saTable[2*aui8_sa+1], ar_records);
+  }
+
+private:
+  uint64_t readLe(unsigned bytes)
+  {
+    uint8_t buf[8] = { 0 };
+    (void)std::fread(buf, 1, bytes, mp_file);
+    return getLe(buf, bytes);
+  }
+
+  bool readRefs(uint64_t aui64_offset, uint32_t aui32_first, uint32_t aui32_count, std::vector< uint32_t > &ar_records)
+  {
+    ar_records.resize(aui32_count);
+    if (aui32_count == 0)
+      return true;
+    std::vector< uint8_t > buf(size_t(aui32_count) * 4);
+    if ((seek(mp_file, aui64_offset + uint64_t(aui32_first)*4) != 0) || (std::fread(&buf[0], 1, buf.size(), mp_file) != buf.size()))
+      return false;
+    for (uint32_t i = 0; i < aui32_count; ++i)
+      ar_records[i] = uint32_t(getLe(&buf[4*i], 4));
+    return seekRecord(mui64_position);
+  }
+
+  // not copyable
+  Reader_c(const Reader_c &);
+  Reader_c &operator=(const Reader_c &);
+
+  std::FILE *mp_file;
+  uint64_t mui64_count;
+  uint64_t mui64_position;
+  uint32_t mui32_blockSize;
+  uint64_t mui64_refsOffset;
+  std::vector< uint64_t > mvec_blockTimes;
+  std::vector< uint32_t > mvec_pgnTable; // pgn, first, count
+  uint32_t marr_saTable[512]; // first, count
+};
+
+} // CanCapture
+
+#endif
@@ -0,0 +1,379 @@
+/*
+  busstatistics.cpp
+
+  (C) Copyright 2009 - 2019 by OSB AG and developing partners
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#include <logenvirons.h>
+#include <busstatistics.h>
+#include <cstring>
+#include <cmath>
+#include <iomanip>
+
+
+namespace {
+const uint32_t scui32_tpConnManagePgn  = 0x00EC00;
+const uint32_t scui32_tpDataPgn        = 0x00EB00;
+const uint32_t scui32_etpConnManagePgn = 0x00C800;
+
+char const *const scpc_variantNames[] = { "TP", "ETP", "BAM" };
+
+uint32_t pgnOf(uint32_t aui32_identifier)
+{
+  uint32_t const cui32_pf = (aui32_identifier >> 16) & 0xFF;
+  return ((aui32_identifier >> 8) & 0x30000UL) | (cui32_pf << 8) | ((cui32_pf >= 0xF0) ? ((aui32_identifier >> 8) & 0xFF) : 0);
+}
+
+double ms(uint64_t aui64_us)
+{
+  return double(aui64_us) / 1000.0;
+}
+}
+
+
+BusStatistics_c::BusStatistics_c() :
+  mui64_frames(0),
+  mui64_standardFrames(0),
+  mui64_first_us(0),
+  mui64_last_us(0),
+  mui64_droppedPgnSa(0)
+{
+  memset(marrs_sa, 0, sizeof(marrs_sa));
+  memset(marrs_pgnSa, 0, sizeof(marrs_pgnSa));
+  for (unsigned i = 0; i < pgnSaSlots; ++i)
+    marrs_pgnSa[i].mui32_key = keyEmpty;
+  memset(marrs_transfers, 0, sizeof(marrs_transfers));
+  memset(marrs_transferStats, 0, sizeof(marrs_transferStats));
+}
+
+
+unsigned
+BusStatistics_c::histogramBin(uint64_t aui64_time_us)
+{
+  uint64_t ui64_ms = aui64_time_us / 1000;
+  unsigned bin = 0;
+  while ((ui64_ms > 0) && (bin < histogramBins - 1)) {
+    ui64_ms >>= 1;
+    ++bin;
+  }
+  return bin;
+}
+
+
+void
+BusStatistics_c::Interval_s::add(uint64_t aui64_time_us, uint8_t aui8_dlc)
+{
+  if (mui64_count == 0) {
+    mui64_first_us = aui64_time_us;
+    mui64_intervalMin_us = uint64_t(-1);
+  } else {
+    uint64_t const cui64_interval = (aui64_time_us > mui64_last_us) ? (aui64_time_us - mui64_last_us) : 0;
+    if (cui64_interval < mui64_intervalMin_us) mui64_intervalMin_us = cui64_interval;
+    if (cui64_interval > mui64_intervalMax_us) mui64_intervalMax_us = cui64_interval;
+    // n-th interval for the (n+1)-th frame
+    double const cd_delta = double(cui64_interval) - md_intervalMean_us;
+    md_intervalMean_us += cd_delta / double(mui64_count);
+    md_intervalM2 += cd_delta * (double(cui64_interval) - md_intervalMean_us);
+    ++marrui32_histogram[histogramBin(cui64_interval)];
+  }
+  mui64_last_us = aui64_time_us;
+  mui64_bytes += aui8_dlc;
+  ++mui64_count;
+}
+
+
+BusStatistics_c::PgnSaEntry_s *
+BusStatistics_c::findPgnSa(uint32_t aui32_key)
+{
+  // open addressing, linear probing
+  unsigned slot = (aui32_key * 2654435761UL) % pgnSaSlots;
+  for (unsigned probe = 0; probe < pgnSaSlots; ++probe) {
+    PgnSaEntry_s &entry = marrs_pgnSa[(slot + probe) % pgnSaSlots];
+    if (entry.mui32_key == aui32_key)
+      return &entry;
+    if (entry.mui32_key == keyEmpty) {
+      entry.mui32_key = aui32_key;
+      return &entry;
+    }
+  }
+  return 0;
+}
+
+
+void
+BusStatistics_c::transferEnd(Variant_e ae_variant, Transfer_s &ar_transfer, uint64_t aui64_time_us, bool ab_aborted)
+{
+  TransferStats_s &stats = marrs_transferStats[ae_variant];
+  ar_transfer.mui8_state = 0;
+  if (ab_aborted) {
+    ++stats.mui64_aborted;
+    return;
+  }
+
+  uint64_t const cui64_duration = (aui64_time_us > ar_transfer.mui64_start_us) ? (aui64_time_us - ar_transfer.mui64_start_us) : 0;
+  if ((stats.mui64_completed == 0) || (cui64_duration < stats.mui64_durationMin_us)) stats.mui64_durationMin_us = cui64_duration;
+  if (cui64_duration > stats.mui64_durationMax_us) stats.mui64_durationMax_us = cui64_duration;
+  stats.mui64_durationSum_us += cui64_duration;
+  stats.mui64_bytes += ar_transfer.mui32_size;
+  ++stats.marrui32_histogram[histogramBin(cui64_duration)];
+  ++stats.mui64_completed;
+}
+
+
+void
+BusStatistics_c::addTransport(uint64_t aui64_time_us, Variant_e ae_variant, uint8_t aui8_sa, uint8_t aui8_da, uint8_t const *apui8_data)
+{
+  switch (apui8_data[0]) {
+  case 0x10: // TP RTS
+  case 0x14: // ETP RTS
+  {
+    Transfer_s &transfer = marrs_transfers[ae_variant][aui8_sa][aui8_da];
+    if (transfer.mui8_state)
+      ++marrs_transferStats[ae_variant].mui64_aborted; // restarted without finishing
+    transfer.mui64_start_us = aui64_time_us;
+    transfer.mui32_size = (ae_variant == variantTp)
+      ? (uint32_t(apui8_data[1]) | (uint32_t(apui8_data[2]) << 8))
+      : (uint32_t(apui8_data[1]) | (uint32_t(apui8_data[2]) << 8) | (uint32_t(apui8_data[3]) << 16) | (uint32_t(apui8_data[4]) << 24));
+    transfer.mui8_state = 1;
+    break;
+  }
+  case 0x20: // BAM
+  {
+    Transfer_s &transfer = marrs_transfers[variantBam][aui8_sa][0xFF];
+    if (transfer.mui8_state)
+      ++marrs_transferStats[variantBam].mui64_aborted;
+    transfer.mui64_start_us = aui64_time_us;
+    transfer.mui32_size = uint32_t(apui8_data[1]) | (uint32_t(apui8_data[2]) << 8);
+    transfer.mui8_state = 1;
+    break;
+  }
+  case 0x13: // TP EoMA (from the receiver)
+  case 0x17: // ETP EoMA (from the receiver)
+  {
+    Transfer_s &transfer = marrs_transfers[ae_variant][aui8_da][aui8_sa];
+    if (transfer.mui8_state)
+      transferEnd(ae_variant, transfer, aui64_time_us, false);
+    break;
+  }
+  case 0xFF: // Abort, from either side
+  {
+    Transfer_s &transferTx = marrs_transfers[ae_variant][aui8_sa][aui8_da];
+    Transfer_s &transferRx = marrs_transfers[ae_variant][aui8_da][aui8_sa];
+    if (transferTx.mui8_state)
+      transferEnd(ae_variant, transferTx, aui64_time_us, true);
+    else if (transferRx.mui8_state)
+      transferEnd(ae_variant, transferRx, aui64_time_us, true);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+
+void
+BusStatistics_c::add(
+    uint64_t aui64_time_us,
+    uint32_t aui32_identifier,
+    bool ab_ext,
+    uint8_t aui8_dlc,
+    uint8_t const *apui8_data)
+{
+  if (mui64_frames == 0)
+    mui64_first_us = aui64_time_us;
+  mui64_last_us = aui64_time_us;
+  ++mui64_frames;
+
+  if (!ab_ext) {
+    ++mui64_standardFrames;
+    return;
+  }
+
+  uint8_t const cui8_sa = uint8_t(aui32_identifier);
+  uint32_t const cui32_pgn = pgnOf(aui32_identifier);
+  marrs_sa[cui8_sa].add(aui64_time_us, aui8_dlc);
+
+  PgnSaEntry_s *ps_entry = findPgnSa((cui32_pgn << 8) | cui8_sa);
+  if (ps_entry)
+    ps_entry->ms_stats.add(aui64_time_us, aui8_dlc);
+  else
+    ++mui64_droppedPgnSa;
+
+  if (aui8_dlc < 8)
+    return;
+
+  uint8_t const cui8_da = uint8_t(aui32_identifier >> 8);
+  if (cui32_pgn == scui32_tpConnManagePgn)
+    addTransport(aui64_time_us, variantTp, cui8_sa, cui8_da, apui8_data);
+  else if (cui32_pgn == scui32_etpConnManagePgn)
+    addTransport(aui64_time_us, variantEtp, cui8_sa, cui8_da, apui8_data);
+  else if ((cui32_pgn == scui32_tpDataPgn) && (cui8_da == 0xFF)) {
+    Transfer_s &transfer = marrs_transfers[variantBam][cui8_sa][0xFF];
+    if (transfer.mui8_state && (uint32_t(apui8_data[0]) * 7 >= transfer.mui32_size))
+      transferEnd(variantBam, transfer, aui64_time_us, false); // last packet
+  }
+}
+
+
+void
+BusStatistics_c::report(std::ostream &ar_out, Format_e ae_format) const
+{
+  if (ae_format == formatJson)
+    reportJson(ar_out);
+  else
+    reportCsv(ar_out);
+}
+
+
+namespace {
+void
+writeIntervalCsv(std::ostream &ar_out, uint64_t aui64_count, uint64_t aui64_bytes, uint64_t aui64_first_us, uint64_t aui64_last_us,
+                 uint64_t aui64_min_us, double ad_mean_us, double ad_m2, uint64_t aui64_max_us, uint32_t const *apui32_histogram, unsigned au_bins)
+{
+  double const cd_span_s = double(aui64_last_us - aui64_first_us) / 1000000.0;
+  ar_out << aui64_count << "," << aui64_bytes << ","
+         << ms(aui64_first_us) << "," << ms(aui64_last_us) << ","
+         << ((cd_span_s > 0.0) ? double(aui64_count - 1) / cd_span_s : 0.0) << ",";
+  if (aui64_count > 1)
+    ar_out << ms(aui64_min_us) << "," << ad_mean_us / 1000.0 << ","
+           << ((aui64_count > 2) ? std::sqrt(ad_m2 / double(aui64_count - 2)) / 1000.0 : 0.0) << "," << ms(aui64_max_us);
+  else
+    ar_out << ",,,";
+  for (unsigned i = 0; i < au_bins; ++i)
+    ar_out << "," << apui32_histogram[i];
+  ar_out << "\n";
+}
+
+void
+writeIntervalJson(std::ostream &ar_out, uint64_t aui64_count, uint64_t aui64_bytes, uint64_t aui64_first_us, uint64_t aui64_last_us,
+                  uint64_t aui64_min_us, double ad_mean_us, double ad_m2, uint64_t aui64_max_us, uint32_t const *apui32_histogram, unsigned au_bins)
+{
+  double const cd_span_s = double(aui64_last_us - aui64_first_us) / 1000000.0;
+  ar_out << "\"count\": " << aui64_count << ", \"bytes\": " << aui64_bytes
+         << ", \"first_ms\": " << ms(aui64_first_us) << ", \"last_ms\": " << ms(aui64_last_us)
+         << ", \"rate_hz\": " << ((cd_span_s > 0.0) ? double(aui64_count - 1) / cd_span_s : 0.0);
+  if (aui64_count > 1)
+    ar_out << ", \"interval_ms\": { \"min\": " << ms(aui64_min_us) << ", \"mean\": " << ad_mean_us / 1000.0
+           << ", \"stddev\": " << ((aui64_count > 2) ? std::sqrt(ad_m2 / double(aui64_count - 2)) / 1000.0 : 0.0)
+           << ", \"max\": " << ms(aui64_max_us) << " }";
+  ar_out << ", \"histogram\": [";
+  for (unsigned i = 0; i < au_bins; ++i)
+    ar_out << (i ? ", " : "") << apui32_histogram[i];
+  ar_out << "]";
+}
+}
+
+
+void
+BusStatistics_c::reportCsv(std::ostream &ar_out) const
+{
+  ar_out << std::dec << std::setprecision(6);
+  ar_out << "table,pgn,sa,count,bytes,first_ms,last_ms,rate_hz,interval_min_ms,interval_mean_ms,interval_stddev_ms,interval_max_ms";
+  for (unsigned i = 0; i < histogramBins; ++i)
+    ar_out << ",h" << ((i == 0) ? 0 : (1u << (i - 1))) << "ms";
+  ar_out << "\n";
+
+  ar_out << "bus,,," << mui64_frames << ",," << ms(mui64_first_us) << "," << ms(mui64_last_us) << ",,,,,";
+  for (unsigned i = 0; i < histogramBins; ++i)
+    ar_out << ",";
+  ar_out << "\n";
+
+  for (unsigned sa = 0; sa < 256; ++sa) {
+    Interval_s const &s = marrs_sa[sa];
+    if (s.mui64_count == 0) continue;
+    ar_out << "sa,," << sa << ",";
+    writeIntervalCsv(ar_out, s.mui64_count, s.mui64_bytes, s.mui64_first_us, s.mui64_last_us,
+                     s.mui64_intervalMin_us, s.md_intervalMean_us, s.md_intervalM2, s.mui64_intervalMax_us, s.marrui32_histogram, histogramBins);
+  }
+
+  for (unsigned i = 0; i < pgnSaSlots; ++i) {
+    PgnSaEntry_s const &e = marrs_pgnSa[i];
+    if (e.mui32_key == keyEmpty) continue;
+    Interval_s const &s = e.ms_stats;
+    ar_out << "pgn_sa," << (e.mui32_key >> 8) << "," << (e.mui32_key & 0xFF) << ",";
+    writeIntervalCsv(ar_out, s.mui64_count, s.mui64_bytes, s.mui64_first_us, s.mui64_last_us,
+                     s.mui64_intervalMin_us, s.md_intervalMean_us, s.md_intervalM2, s.mui64_intervalMax_us, s.marrui32_histogram, histogramBins);
+  }
+
+  // transfers: count=completed, bytes=payload, interval columns are the durations
+  ar_out << "\ntable,variant,completed,aborted,bytes,duration_min_ms,duration_mean_ms,duration_max_ms";
+  for (unsigned i = 0; i < histogramBins; ++i)
+    ar_out << ",h" << ((i == 0) ? 0 : (1u << (i - 1))) << "ms";
+  ar_out << "\n";
+  for (unsigned v = 0; v < variantCount; ++v) {
+    TransferStats_s const &t = marrs_transferStats[v];
+    ar_out << "transfer," << scpc_variantNames[v] << "," << t.mui64_completed << "," << t.mui64_aborted << "," << t.mui64_bytes << ",";
+    if (t.mui64_completed)
+      ar_out << ms(t.mui64_durationMin_us) << "," << ms(t.mui64_durationSum_us) / double(t.mui64_completed) << "," << ms(t.mui64_durationMax_us);
+    else
+      ar_out << ",,";
+    for (unsigned i = 0; i < histogramBins; ++i)
+      ar_out << "," << t.marrui32_histogram[i];
+    ar_out << "\n";
+  }
+
+  ar_out << "\ntable,frames,standard_frames,dropped_pgn_sa\n";
+  ar_out << "totals," << mui64_frames << "," << mui64_standardFrames << "," << mui64_droppedPgnSa << "\n";
+}
+
+
+void
+BusStatistics_c::reportJson(std::ostream &ar_out) const
+{
+  ar_out << std::dec << std::setprecision(6);
+  ar_out << "{\n  \"frames\": " << mui64_frames
+         << ",\n  \"standard_frames\": " << mui64_standardFrames
+         << ",\n  \"first_ms\": " << ms(mui64_first_us)
+         << ",\n  \"last_ms\": " << ms(mui64_last_us)
+         << ",\n  \"dropped_pgn_sa\": " << mui64_droppedPgnSa
+         << ",\n  \"histogram_bins_ms\": [0";
+  for (unsigned i = 1; i < histogramBins; ++i)
+    ar_out << ", " << (1u << (i - 1));
+  ar_out << "],\n  \"sa\": [";
+
+  bool b_first = true;
+  for (unsigned sa = 0; sa < 256; ++sa) {
+    Interval_s const &s = marrs_sa[sa];
+    if (s.mui64_count == 0) continue;
+    ar_out << (b_first ? "\n" : ",\n") << "    { \"sa\": " << sa << ", ";
+    writeIntervalJson(ar_out, s.mui64_count, s.mui64_bytes, s.mui64_first_us, s.mui64_last_us,
+                      s.mui64_intervalMin_us, s.md_intervalMean_us, s.md_intervalM2, s.mui64_intervalMax_us, s.marrui32_histogram, histogramBins);
+    ar_out << " }";
+    b_first = false;
+  }
+  ar_out << "\n  ],\n  \"pgn_sa\": [";
+
+  b_first = true;
+  for (unsigned i = 0; i < pgnSaSlots; ++i) {
+    PgnSaEntry_s const &e = marrs_pgnSa[i];
+    if (e.mui32_key == keyEmpty) continue;
+    Interval_s const &s = e.ms_stats;
+    ar_out << (b_first ? "\n" : ",\n") << "    { \"pgn\": " << (e.mui32_key >> 8) << ", \"sa\": " << (e.mui32_key & 0xFF) << ", ";
+    writeIntervalJson(ar_out, s.mui64_count, s.mui64_bytes, s.mui64_first_us, s.mui64_last_us,
+                      s.mui64_intervalMin_us, s.md_intervalMean_us, s.md_intervalM2, s.mui64_intervalMax_us, s.marrui32_histogram, histogramBins);
+    ar_out << " }";
+    b_first = false;
+  }
+  ar_out << "\n  ],\n  \"transfers\": [";
+
+  for (unsigned v = 0; v < variantCount; ++v) {
+    TransferStats_s const &t = marrs_transferStats[v];
+    ar_out << (v ? ",\n" : "\n") << "    { \"variant\": \"" << scpc_variantNames[v] << "\", \"completed\": " << t.mui64_completed
+           << ", \"aborted\": " << t.mui64_aborted << ", \"bytes\": " << t.mui64_bytes;
+    if (t.mui64_completed)
+      ar_out << ", \"duration_ms\": { \"min\": " << ms(t.mui64_durationMin_us)
+             << ", \"mean\": " << ms(t.mui64_durationSum_us) / double(t.mui64_completed)
+             << ", \"max\": " << ms(t.mui64_durationMax_us) << " }";
+    ar_out << ", \"histogram\": [";
+    for (unsigned i = 0; i < histogramBins; ++i)
+      ar_out << (i ? ", " : "") << t.marrui32_histogram[i];
+    ar_out << "] }";
+  }
+  ar_out << "\n  ]\n}\n";
+}
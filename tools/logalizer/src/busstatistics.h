@@ -0,0 +1,102 @@
+/*
+  busstatistics.h
+
+  (C) Copyright 2009 - 2019 by OSB AG and developing partners
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef BUSSTATISTICS_H
+#define BUSSTATISTICS_H
+
+#include <logenvirons.h>
+#include <iostream>
+
+
+/* Streaming bus statistics for the stats-only mode.
+   All tables have a fixed size, nothing is formatted before report(). */
+class BusStatistics_c {
+public:
+  enum Format_e {
+    formatCsv,
+    formatJson
+  };
+
+  // inter-arrival histogram: [0,1) [1,2) [2,4) ... [1024,2048) [2048,inf) ms
+  enum { histogramBins = 13 };
+
+  BusStatistics_c();
+
+  void add(
+      uint64_t aui64_time_us,
+      uint32_t aui32_identifier,
+      bool ab_ext,
+      uint8_t aui8_dlc,
+      uint8_t const *apui8_data);
+
+  void report(std::ostream &ar_out, Format_e ae_format) const;
+
+private:
+  struct Interval_s {
+    uint64_t mui64_count;
+    uint64_t mui64_bytes;
+    uint64_t mui64_first_us;
+    uint64_t mui64_last_us;
+    uint64_t mui64_intervalMin_us;
+    uint64_t mui64_intervalMax_us;
+    double md_intervalMean_us; // Welford
+    double md_intervalM2;
+    uint32_t marrui32_histogram[histogramBins];
+
+    void add(uint64_t aui64_time_us, uint8_t aui8_dlc);
+  };
+
+  struct PgnSaEntry_s {
+    uint32_t mui32_key; // (pgn << 8) | sa, keyEmpty if unused
+    Interval_s ms_stats;
+  };
+
+  struct Transfer_s {
+    uint64_t mui64_start_us;
+    uint32_t mui32_size;
+    uint8_t mui8_state; // 0: idle, 1: running
+  };
+
+  struct TransferStats_s {
+    uint64_t mui64_completed;
+    uint64_t mui64_aborted;
+    uint64_t mui64_bytes;
+    uint64_t mui64_durationMin_us;
+    uint64_t mui64_durationMax_us;
+    uint64_t mui64_durationSum_us;
+    uint32_t marrui32_histogram[histogramBins];
+  };
+
+  enum { pgnSaSlots = 4096, keyEmpty = 0xFFFFFFFFUL };
+  enum Variant_e { variantTp, variantEtp, variantBam, variantCount };
+
+  PgnSaEntry_s *findPgnSa(uint32_t aui32_key);
+  void addTransport(uint64_t aui64_time_us, Variant_e ae_variant, uint8_t aui8_sa, uint8_t aui8_da, uint8_t const *apui8_data);
+  void transferEnd(Variant_e ae_variant, Transfer_s &ar_transfer, uint64_t aui64_time_us, bool ab_aborted);
+  static unsigned histogramBin(uint64_t aui64_time_us);
+
+  void reportCsv(std::ostream &ar_out) const;
+  void reportJson(std::ostream &ar_out) const;
+
+  uint64_t mui64_frames;
+  uint64_t mui64_standardFrames;
+  uint64_t mui64_first_us;
+  uint64_t mui64_last_us;
+  uint64_t mui64_droppedPgnSa; // table full
+  Interval_s marrs_sa[256];
+  PgnSaEntry_s marrs_pgnSa[pgnSaSlots];
+  Transfer_s marrs_transfers[variantCount][256][256]; // [variant][sa][da], BAM uses da 0xFF
+  TransferStats_s marrs_transferStats[variantCount];
+};
+
+
+#endif
@@ -0,0 +1,247 @@
+/*
+  frameingest.cpp
+
+  (C) Copyright 2009 - 2019 by OSB AG and developing partners
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#include <frameingest.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+// per thread and batch; large enough to keep the threads busy,
+// small enough to not hold the whole log in frame form.
+const uint64_t scui64_chunkSize = 4 * 1024 * 1024;
+}
+
+
+PtrDataFrame_t
+CompactFrame_s::toDataFrame() const
+{
+  return PtrDataFrame_t( new DataFrame_c(
+      mui64_time_ms,
+      mui32_identifier,
+      std::vector< uint8_t >( marr_data, marr_data + mui8_dataSize ),
+      mb_canExt ) );
+}
+
+
+#ifdef WIN32
+MappedFile_c::MappedFile_c(std::string const &acr_filename) :
+  mpc_data(0),
+  mui64_size(0),
+  mh_file(INVALID_HANDLE_VALUE),
+  mh_mapping(NULL)
+{
+  mh_file = CreateFileA(acr_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (mh_file == INVALID_HANDLE_VALUE)
+  {
+    mui64_size = 1; // not open
+    return;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(mh_file, &size))
+  {
+    mui64_size = 1; // not open
+    return;
+  }
+  mui64_size = uint64_t(size.QuadPart);
+  if (mui64_size == 0)
+    return;
+
+  mh_mapping = CreateFileMappingA(mh_file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mh_mapping != NULL)
+    mpc_data = static_cast< char const * >(MapViewOfFile(mh_mapping, FILE_MAP_READ, 0, 0, 0));
+}
+
+
+MappedFile_c::~MappedFile_c()
+{
+  if (mpc_data)
+    UnmapViewOfFile(mpc_data);
+  if (mh_mapping != NULL)
+    CloseHandle(mh_mapping);
+  if (mh_file != INVALID_HANDLE_VALUE)
+    CloseHandle(mh_file);
+}
+#else
+MappedFile_c::MappedFile_c(std::string const &acr_filename) :
+  mpc_data(0),
+  mui64_size(1), // not open until mapped
+  mi_fd(open(acr_filename.c_str(), O_RDONLY))
+{
+  struct stat st;
+  if ((mi_fd < 0) || (fstat(mi_fd, &st) != 0) || !S_ISREG(st.st_mode))
+    return;
+
+  mui64_size = uint64_t(st.st_size);
+  if (mui64_size == 0)
+    return;
+
+  void *p = mmap(0, size_t(mui64_size), PROT_READ, MAP_PRIVATE, mi_fd, 0);
+  if (p == MAP_FAILED)
+  {
+    mui64_size = 1; // not open
+    return;
+  }
+  (void)madvise(p, size_t(mui64_size), MADV_SEQUENTIAL);
+  mpc_data = static_cast< char const * >(p);
+}
+
+
+MappedFile_c::~MappedFile_c()
+{
+  if (mpc_data)
+    munmap(const_cast< char * >(mpc_data), size_t(mui64_size));
+  if (mi_fd >= 0)
+    close(mi_fd);
+}
+#endif
+
+
+FrameIngestion_c::FrameIngestion_c(Parse_t *apt_parse, unsigned ai_threads) :
+  mpt_parse(apt_parse),
+  mi_threads(ai_threads)
+{
+  if (mi_threads == 0)
+    mi_threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+void
+FrameIngestion_c::compact(std::pair< int, PtrDataFrame_t > const &acr_result, CompactFrame_s &ars_frame)
+{
+  ars_frame.mi_parseResult = acr_result.first;
+  if (acr_result.first == 0)
+  {
+    DataFrame_c const &frame = *acr_result.second;
+    ars_frame.mui64_time_ms = frame.time();
+    ars_frame.mui32_identifier = uint32_t(frame.identifier());
+    ars_frame.mb_canExt = frame.isExtendedFrameFormat();
+    ars_frame.mui8_dataSize = uint8_t(std::min(frame.dataSize(), size_t(8)));
+    std::copy(frame.data().begin(), frame.data().begin() + ars_frame.mui8_dataSize, ars_frame.marr_data);
+  }
+  else
+  {
+    ars_frame.mui64_time_ms = 0;
+    ars_frame.mui32_identifier = 0;
+    ars_frame.mb_canExt = false;
+    ars_frame.mui8_dataSize = 0;
+  }
+}
+
+
+void
+FrameIngestion_c::parseChunk(Parse_t *apt_parse, char const *apc_base, Chunk_s &ar_chunk)
+{
+  ar_chunk.mvec_frames.clear();
+  // rough guess for CAN logs, avoids most of the reallocations
+  ar_chunk.mvec_frames.reserve(size_t(ar_chunk.mpc_end - ar_chunk.mpc_begin) / 48 + 1);
+
+  std::string str_line;
+  char const *pc_line = ar_chunk.mpc_begin;
+  while (pc_line < ar_chunk.mpc_end)
+  {
+    char const *pc_eol = static_cast< char const * >(memchr(pc_line, '\n', size_t(ar_chunk.mpc_end - pc_line)));
+    if (pc_eol == 0)
+      pc_eol = ar_chunk.mpc_end;
+
+    str_line.assign(pc_line, pc_eol);
+    std::pair< int, PtrDataFrame_t > result = apt_parse(str_line);
+
+    CompactFrame_s s_frame;
+    compact(result, s_frame);
+    s_frame.mui64_lineOffset = uint64_t(pc_line - apc_base);
+    s_frame.mui32_lineLength = uint32_t(pc_eol - pc_line);
+    ar_chunk.mvec_frames.push_back(s_frame);
+
+    pc_line = pc_eol + 1;
+  }
+}
+
+
+uint64_t
+FrameIngestion_c::splitBatch(char const *apc_base, uint64_t aui64_size, uint64_t aui64_pos, std::vector< Chunk_s > &ar_batch) const
+{
+  ar_batch.clear();
+  while ((aui64_pos < aui64_size) && (ar_batch.size() < mi_threads))
+  {
+    uint64_t ui64_end = std::min(aui64_size, aui64_pos + scui64_chunkSize);
+    if (ui64_end < aui64_size)
+    { // extend to the end of the line
+      char const *pc_eol = static_cast< char const * >(memchr(apc_base + ui64_end, '\n', size_t(aui64_size - ui64_end)));
+      ui64_end = pc_eol ? uint64_t(pc_eol - apc_base) + 1 : aui64_size;
+    }
+
+    Chunk_s s_chunk;
+    s_chunk.mpc_begin = apc_base + aui64_pos;
+    s_chunk.mpc_end = apc_base + ui64_end;
+    ar_batch.push_back(s_chunk);
+    aui64_pos = ui64_end;
+  }
+  return aui64_pos;
+}
+
+
+bool
+FrameIngestion_c::run(std::string const &acr_filename, Consumer_c &ar_consumer)
+{
+  MappedFile_c c_file(acr_filename);
+  if (!c_file.isOpen())
+    return false;
+
+  char const *pc_base = c_file.data();
+  uint64_t const cui64_size = c_file.size();
+
+  std::vector< Chunk_s > arrvec_batch[2];
+  std::vector< std::thread > vec_workers;
+  unsigned ui_current = 0;
+
+  uint64_t ui64_pos = splitBatch(pc_base, cui64_size, 0, arrvec_batch[ui_current]);
+  for (size_t i = 0; i < arrvec_batch[ui_current].size(); ++i)
+    vec_workers.push_back(std::thread(parseChunk, mpt_parse, pc_base, std::ref(arrvec_batch[ui_current][i])));
+
+  while (!arrvec_batch[ui_current].empty())
+  {
+    for (size_t i = 0; i < vec_workers.size(); ++i)
+      vec_workers[i].join();
+    vec_workers.clear();
+
+    // parse the next batch while the current one is being consumed
+    unsigned const cui_next = 1 - ui_current;
+    ui64_pos = splitBatch(pc_base, cui64_size, ui64_pos, arrvec_batch[cui_next]);
+    for (size_t i = 0; i < arrvec_batch[cui_next].size(); ++i)
+      vec_workers.push_back(std::thread(parseChunk, mpt_parse, pc_base, std::ref(arrvec_batch[cui_next][i])));
+
+    std::vector< Chunk_s > &batch = arrvec_batch[ui_current];
+    for (size_t c = 0; c < batch.size(); ++c)
+    {
+      std::vector< CompactFrame_s > const &frames = batch[c].mvec_frames;
+      for (size_t f = 0; f < frames.size(); ++f)
+        ar_consumer.consume(frames[f], pc_base + frames[f].mui64_lineOffset);
+    }
+    batch.clear();
+
+    ui_current = cui_next;
+  }
+
+  return true;
+}
@@ -0,0 +1,103 @@
+/*
+  frameingest.h
+
+  (C) Copyright 2009 - 2019 by OSB AG and developing partners
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+#ifndef FRAMEINGEST_H
+#define FRAMEINGEST_H
+
+#include <logenvirons.h>
+#include <dataframe.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+
+/* parse result of one log line, kept in-place (no heap per frame) */
+struct CompactFrame_s {
+  uint64_t mui64_time_ms;
+  uint64_t mui64_lineOffset; // into the mapped file
+  uint32_t mui32_lineLength;
+  uint32_t mui32_identifier;
+  int mi_parseResult;
+  uint8_t mui8_dataSize;
+  bool mb_canExt;
+  uint8_t marr_data[8];
+
+  PtrDataFrame_t toDataFrame() const;
+};
+
+
+class MappedFile_c {
+// RAII Programming Idiom for the mapping being the resource
+public:
+  MappedFile_c(std::string const &acr_filename);
+  ~MappedFile_c();
+  bool isOpen() const { return mpc_data != 0 || mui64_size == 0; }
+  char const *data() const { return mpc_data; }
+  uint64_t size() const { return mui64_size; }
+
+private:
+  // don't let the public copy it:
+  MappedFile_c(MappedFile_c const &);
+  MappedFile_c &operator=(MappedFile_c const &);
+  char const *mpc_data;
+  uint64_t mui64_size;
+#ifdef WIN32
+  void *mh_file;
+  void *mh_mapping;
+#else
+  int mi_fd;
+#endif
+};
+
+
+/* Parses a mapped log file in line aligned chunks on several threads.
+   The parsed chunks are handed to the consumer strictly in file order,
+   so all stateful interpretation can stay single-threaded. Parsing of
+   the next batch overlaps with the consumption of the current one. */
+class FrameIngestion_c {
+public:
+  typedef std::pair< int, PtrDataFrame_t > Parse_t(std::string const &acr_line);
+
+  class Consumer_c {
+  public:
+    virtual ~Consumer_c() {}
+    // apc_line points to the raw line (mui32_lineLength chars, no newline)
+    virtual void consume(CompactFrame_s const &acrs_frame, char const *apc_line) = 0;
+  };
+
+  /* ai_threads: number of parser threads, 0 for one per hardware thread.
+     Parsers with internal state (e.g. relative timestamps) need 1. */
+  FrameIngestion_c(Parse_t *apt_parse, unsigned ai_threads);
+
+  /* @return false if the file couldn't be mapped */
+  bool run(std::string const &acr_filename, Consumer_c &ar_consumer);
+
+  /* fills everything except the line position */
+  static void compact(std::pair< int, PtrDataFrame_t > const &acr_result, CompactFrame_s &ars_frame);
+
+private:
+  struct Chunk_s {
+    char const *mpc_begin;
+    char const *mpc_end;
+    std::vector< CompactFrame_s > mvec_frames;
+  };
+
+  static void parseChunk(Parse_t *apt_parse, char const *apc_base, Chunk_s &ar_chunk);
+
+  uint64_t splitBatch(char const *apc_base, uint64_t aui64_size, uint64_t aui64_pos, std::vector< Chunk_s > &ar_batch) const;
+
+  Parse_t *mpt_parse;
+  unsigned mi_threads;
+};
+
+
+#endif
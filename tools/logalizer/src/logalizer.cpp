@@ -15,6 +15,9 @@
 #include <alivecollection.h>
 #include <dataframe.h>
 #include <inputstream.h>
+#include <frameingest.h>
+#include <cancapture.h>
+#include <busstatistics.h>
 #include <addresstracker.h>
 #include <string>
 #include <vector>
@@ -180,6 +183,14 @@ typedef std::string Interprete_t(PtrDataFrame_t);
 struct Main_s {
   Main_s();
   size_t mt_sizeMultipacketWrap; // default will be set when parsing parameters
+  unsigned mui_parseThreads; // 0: one per hardware thread
+  std::string mstr_captureFile; // convert to binary capture instead of analyzing
+  uint64_t mui64_fromMs; // filters for binary capture input
+  uint64_t mui64_toMs;
+  int32_t mi32_pgnFilter; // -1: no filter
+  int mi_saFilter; // -1: no filter
+  BusStatistics_c *mp_stats; // only in stats-only mode
+  BusStatistics_c::Format_e me_statsFormat;
   bool mb_storeIop;
   bool mb_storeDdop;
   TransferCollection_c mc_trans;
@@ -193,6 +204,14 @@ struct Main_s {
 
 inline Main_s::Main_s() :
   mt_sizeMultipacketWrap(0),
+  mui_parseThreads(0),
+  mstr_captureFile(),
+  mui64_fromMs(0),
+  mui64_toMs(uint64_t(-1)),
+  mi32_pgnFilter(-1),
+  mi_saFilter(-1),
+  mp_stats(NULL),
+  me_statsFormat(BusStatistics_c::formatCsv),
   mb_storeIop(false),
   mb_storeDdop(false),
   mc_trans(),
@@ -208,7 +227,7 @@ struct Main_s gs_main;
 } //namespace
 
 
-enum { OPT_GPX, OPT_TYPE, OPT_WRAP, OPT_TC_SA, OPT_STORE_IOP, OPT_STORE_DDOP, OPT_HELP};
+enum { OPT_GPX, OPT_TYPE, OPT_WRAP, OPT_TC_SA, OPT_STORE_IOP, OPT_STORE_DDOP, OPT_THREADS, OPT_CAPTURE, OPT_FROM, OPT_TO, OPT_PGN, OPT_SA, OPT_STATS, OPT_HELP};
 
 CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_GPX, "-gpx", SO_REQ_SEP },
@@ -217,6 +236,13 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_TC_SA, "-tc", SO_REQ_SEP},
     { OPT_STORE_IOP, "--iop", SO_NONE },
     { OPT_STORE_DDOP, "--ddop", SO_NONE },
+    { OPT_THREADS, "-j", SO_REQ_SEP },
+    { OPT_CAPTURE, "--capture", SO_REQ_SEP },
+    { OPT_FROM, "-from", SO_REQ_SEP },
+    { OPT_TO, "-to", SO_REQ_SEP },
+    { OPT_PGN, "-pgn", SO_REQ_SEP },
+    { OPT_SA, "-sa", SO_REQ_SEP },
+    { OPT_STATS, "--stats", SO_REQ_SEP },
     { OPT_HELP, "--help", SO_NONE },
     SO_END_OF_OPTIONS
 };
@@ -239,7 +265,7 @@ void
 exit_with_usage(const char* progname)
 {
   std::cerr << "ISOBUS-Logalizer (c) 2007 - 2019 OSB AG." << std::endl << std::endl;
-  std::cerr << "Usage: " << progname << " [-t logType] [-gpx gpxFile] [-w num] [-tc num] [--iop] [--ddop] logFile" << std::endl << std::endl;
+  std::cerr << "Usage: " << progname << " [-t logType] [-gpx gpxFile] [-w num] [-tc num] [-j num] [--iop] [--ddop] [--capture binFile] [-from ms] [-to ms] [-pgn hex] [-sa num] [--stats csv|json] logFile" << std::endl << std::endl;
   std::cerr << "-t:      0 -> can_server [DEFAULT]"<<std::endl;
   std::cerr << "         1 -> rte"<<std::endl;
   std::cerr << "         2 -> CANMon"<<std::endl;
@@ -269,6 +295,13 @@ exit_with_usage(const char* progname)
   std::cerr << "-tc:     Override TC SA manually. SA must be given as decimal integer." << std::endl;
   std::cerr << "--iop:   Store VT object pool transfers in iop format. Default: do not store" << std::endl;
   std::cerr << "--ddop:  Store TC object pool transfers in ddop format. Default: do not store" << std::endl;
+  std::cerr << "-j:      Number of threads parsing the log file. Defaults to 0 (one per CPU)." << std::endl;
+  std::cerr << "--capture: Convert the log file to the indexed binary capture format instead of analyzing it." << std::endl;
+  std::cerr << "         Binary captures are detected automatically when given as logFile (-t is ignored then)." << std::endl;
+  std::cerr << "-from/-to: Only analyze frames in this time range [ms] (binary capture input only)." << std::endl;
+  std::cerr << "-pgn/-sa:  Only analyze frames of this PGN (hex) / source address (binary capture input only)." << std::endl;
+  std::cerr << "--stats: Don't interpret the frames, only report bus statistics (per SA / PGN+SA rates, inter-arrival" << std::endl;
+  std::cerr << "         histograms, TP/ETP/BAM durations) as csv or json." << std::endl;
   std::cerr << "logFile: filepath or - (dash, means standard input rather than a real file)" << std::endl;
   std::cerr << std::endl;
 
@@ -836,116 +869,99 @@ interpretePgnsTPETP(PtrDataFrame_t at_ptrFrame)
 }
 
 
+// PGN -> data interpreter, sorted by PGN for binary search
+class PgnInterpreterRegistry_c {
+public:
+  void add( uint32_t aui32_pgn, Interprete_t *apt_interprete )
+  {
+    Entry_s const cs_entry = { aui32_pgn, apt_interprete };
+    std::vector< Entry_s >::iterator iter = std::lower_bound( mvec_entries.begin(), mvec_entries.end(), cs_entry );
+    if( ( iter != mvec_entries.end() ) && ( iter->mui32_pgn == aui32_pgn ) )
+      iter->pt_interprete = apt_interprete;
+    else
+      mvec_entries.insert( iter, cs_entry );
+  }
+
+  void addRange( uint32_t aui32_firstPgn, uint32_t aui32_lastPgn, Interprete_t *apt_interprete )
+  {
+    for( uint32_t pgn = aui32_firstPgn; pgn <= aui32_lastPgn; ++pgn )
+      add( pgn, apt_interprete );
+  }
+
+  Interprete_t *find( uint32_t aui32_pgn ) const
+  {
+    Entry_s const cs_entry = { aui32_pgn, 0 };
+    std::vector< Entry_s >::const_iterator iter = std::lower_bound( mvec_entries.begin(), mvec_entries.end(), cs_entry );
+    return ( ( iter != mvec_entries.end() ) && ( iter->mui32_pgn == aui32_pgn ) ) ? iter->pt_interprete : 0;
+  }
+
+private:
+  struct Entry_s {
+    uint32_t mui32_pgn;
+    Interprete_t *pt_interprete;
+    bool operator<( Entry_s const &acrs_rhs ) const { return mui32_pgn < acrs_rhs.mui32_pgn; }
+  };
+  std::vector< Entry_s > mvec_entries;
+};
+
+
+PgnInterpreterRegistry_c const &
+pgnInterpreters()
+{
+  static PgnInterpreterRegistry_c s_registry;
+  static bool sb_initialized = false;
+  if( sb_initialized )
+    return s_registry;
+  sb_initialized = true;
+
+  // PGNs without data interpretation (yet) are simply not registered
+  s_registry.add( TIM_SERVER_TO_CLIENT_PGN,               interpretePgnsTimServerToClient );
+  s_registry.add( TIM_CLIENT_TO_SERVER_PGN,               interpretePgnsTimClientToServer );
+  s_registry.add( AUTH_SERVER_TO_CLIENT_PGN,              interpreteTimAuthenticationServerToClient );
+  s_registry.add( AUTH_CLIENT_TO_SERVER_PGN,              interpreteTimAuthenticationClientToServer );
+  s_registry.add( VT_TO_ECU_PGN,                          interpretePgnsVtToEcu );
+  s_registry.add( ECU_TO_VT_PGN,                          interpretePgnsVtFromEcu );
+  s_registry.add( ACKNOWLEDGEMENT_PGN,                    interpretePgnAcknowledge );
+  s_registry.add( CLIENT_TO_FS_PGN,                       interpretePgnsCl2Fs );
+  s_registry.add( FS_TO_CLIENT_PGN,                       interpretePgnsFs2Cl );
+  s_registry.add( ETP_DATA_TRANSFER_PGN,                  interpretePgnsTPETP );
+  s_registry.add( ETP_CONN_MANAGE_PGN,                    interpretePgnsTPETP );
+  s_registry.add( TP_DATA_TRANSFER_PGN,                   interpretePgnsTPETP );
+  s_registry.add( TP_CONN_MANAGE_PGN,                     interpretePgnsTPETP );
+  s_registry.add( LANGUAGE_PGN,                           interpretePgnLanguage );
+  s_registry.add( LIGHTING_COMMAND_PGN,                   interpreteLightingCommand );
+  s_registry.add( REAR_PTO_STATE_PGN,                     interpreteRearPTOstate );
+  s_registry.add( REAR_HITCH_STATE_PGN,                   interpreteRearHitch );
+  s_registry.add( WHEEL_BASED_SPEED_DIST_PGN,             interpreteWheelBasedSpeedDist );
+  s_registry.add( GROUND_BASED_SPEED_DIST_PGN,            interpreteGroundBasedSpeedDist );
+  s_registry.add( ELECTRONIC_ENGINE_CONTROLLER_1_MESSAGE, interpreteEngineSpeedMsg );
+  s_registry.add( VEHICLE_DIRECTION_SPEED,                interpreteVehicleSpeed );
+  s_registry.add( VEHICLE_POSITION,                       interpreteVehiclePosition );
+  s_registry.addRange( AUX_VALVE_0_ESTIMATED_FLOW, AUX_VALVE_15_ESTIMATED_FLOW, interpreteValveEstimatedFlow );
+  s_registry.addRange( AUX_VALVE_0_MEASURED_FLOW,  AUX_VALVE_15_MEASURED_FLOW,  interpreteValveMeasuredFlow );
+  s_registry.addRange( AUX_VALVE_0_COMMAND,        AUX_VALVE_15_COMMAND,        interpreteValveCommand );
+  s_registry.add( REQUEST_PGN_MSG_PGN,                    interpreteRequestPgnMsg );
+  s_registry.add( ADDRESS_CLAIM_PGN,                      interpreteAddressClaimed );
+  s_registry.add( PROCESS_DATA_PGN,                       interpreteProcessData );
+  s_registry.add( MAINTAIN_POWER_REQUEST_PGN,             interpreteMaintainPower );
+  s_registry.add( NMEA_GPS_CROSS_TRACK_ERROR_PGN,         interpreteCrossTrackError );
+  s_registry.add( GUIDANCE_MACHINE_STATUS,                interpreteGuidanceMachineStatus );
+  s_registry.add( TIME_DATE_PGN,                          interpreteTimeDate );
+  s_registry.add( NMEA_GPS_POSITION_RAPID_UPDATE_PGN,     interpretePositionDataRapidUpdate );
+  s_registry.add( NMEA_GPS_COG_SOG_RAPID_UPDATE_PGN,      interpreteCogSogRapidUpdate );
+  s_registry.add( NMEA_GPS_POSITION_DATA_PGN,             interpreteGpsPositionData );
+
+  return s_registry;
+}
+
+
 Interprete_t *
 getPgnDataInterpreter( PtrDataFrame_t at_ptrFrame )
 {
-    uint32_t pgn = at_ptrFrame->pgn();
-    if ((pgn & PROPRIETARY_B_PGN) == PROPRIETARY_B_PGN)
-        pgn = PROPRIETARY_B_PGN;
-  switch (pgn)
-  {
-  case TIM_SERVER_TO_CLIENT_PGN:                return interpretePgnsTimServerToClient;
-  case TIM_CLIENT_TO_SERVER_PGN:                return interpretePgnsTimClientToServer;
-  case AUTH_SERVER_TO_CLIENT_PGN:               return interpreteTimAuthenticationServerToClient;
-  case AUTH_CLIENT_TO_SERVER_PGN:               return interpreteTimAuthenticationClientToServer;
-  case VT_TO_ECU_PGN:                           return interpretePgnsVtToEcu;
-  case ECU_TO_VT_PGN:                           return interpretePgnsVtFromEcu;
-  case ACKNOWLEDGEMENT_PGN:                     return interpretePgnAcknowledge;
-  case CLIENT_TO_FS_PGN:                        return interpretePgnsCl2Fs;
-  case FS_TO_CLIENT_PGN:                        return interpretePgnsFs2Cl;
-  case ETP_DATA_TRANSFER_PGN:                   return interpretePgnsTPETP;
-  case ETP_CONN_MANAGE_PGN:                     return interpretePgnsTPETP;
-  case TP_DATA_TRANSFER_PGN:                    return interpretePgnsTPETP;
-  case TP_CONN_MANAGE_PGN:                      return interpretePgnsTPETP;
-  case LANGUAGE_PGN:                            return interpretePgnLanguage;
-  case LIGHTING_COMMAND_PGN:                    return interpreteLightingCommand;
-  case REAR_PTO_STATE_PGN:                      return interpreteRearPTOstate;
-  case REAR_HITCH_STATE_PGN:                    return interpreteRearHitch;
-  case WHEEL_BASED_SPEED_DIST_PGN:              return interpreteWheelBasedSpeedDist;
-  case GROUND_BASED_SPEED_DIST_PGN:             return interpreteGroundBasedSpeedDist;
-  case ELECTRONIC_ENGINE_CONTROLLER_1_MESSAGE:  return interpreteEngineSpeedMsg;
-  case VEHICLE_DIRECTION_SPEED:                 return interpreteVehicleSpeed;
-  case VEHICLE_POSITION:                        return interpreteVehiclePosition;
-  case AUX_VALVE_0_ESTIMATED_FLOW:
-  case AUX_VALVE_1_ESTIMATED_FLOW:
-  case AUX_VALVE_2_ESTIMATED_FLOW:
-  case AUX_VALVE_3_ESTIMATED_FLOW:
-  case AUX_VALVE_4_ESTIMATED_FLOW:
-  case AUX_VALVE_5_ESTIMATED_FLOW:
-  case AUX_VALVE_6_ESTIMATED_FLOW:
-  case AUX_VALVE_7_ESTIMATED_FLOW:
-  case AUX_VALVE_8_ESTIMATED_FLOW:
-  case AUX_VALVE_9_ESTIMATED_FLOW:
-  case AUX_VALVE_10_ESTIMATED_FLOW:
-  case AUX_VALVE_11_ESTIMATED_FLOW:
-  case AUX_VALVE_12_ESTIMATED_FLOW:
-  case AUX_VALVE_13_ESTIMATED_FLOW:
-  case AUX_VALVE_14_ESTIMATED_FLOW:
-  case AUX_VALVE_15_ESTIMATED_FLOW:             return interpreteValveEstimatedFlow;
-  case AUX_VALVE_0_MEASURED_FLOW:
-  case AUX_VALVE_1_MEASURED_FLOW:
-  case AUX_VALVE_2_MEASURED_FLOW:
-  case AUX_VALVE_3_MEASURED_FLOW:
-  case AUX_VALVE_4_MEASURED_FLOW:
-  case AUX_VALVE_5_MEASURED_FLOW:
-  case AUX_VALVE_6_MEASURED_FLOW:
-  case AUX_VALVE_7_MEASURED_FLOW:
-  case AUX_VALVE_8_MEASURED_FLOW:
-  case AUX_VALVE_9_MEASURED_FLOW:
-  case AUX_VALVE_10_MEASURED_FLOW:
-  case AUX_VALVE_11_MEASURED_FLOW:
-  case AUX_VALVE_12_MEASURED_FLOW:
-  case AUX_VALVE_13_MEASURED_FLOW:
-  case AUX_VALVE_14_MEASURED_FLOW:
-  case AUX_VALVE_15_MEASURED_FLOW:              return interpreteValveMeasuredFlow;
-  case AUX_VALVE_0_COMMAND:
-  case AUX_VALVE_1_COMMAND:
-  case AUX_VALVE_2_COMMAND:
-  case AUX_VALVE_3_COMMAND:
-  case AUX_VALVE_4_COMMAND:
-  case AUX_VALVE_5_COMMAND:
-  case AUX_VALVE_6_COMMAND:
-  case AUX_VALVE_7_COMMAND:
-  case AUX_VALVE_8_COMMAND:
-  case AUX_VALVE_9_COMMAND:
-  case AUX_VALVE_10_COMMAND:
-  case AUX_VALVE_11_COMMAND:
-  case AUX_VALVE_12_COMMAND:
-  case AUX_VALVE_13_COMMAND:
-  case AUX_VALVE_14_COMMAND:
-  case AUX_VALVE_15_COMMAND:                    return interpreteValveCommand;
-  case REQUEST_PGN_MSG_PGN:                     return interpreteRequestPgnMsg;
-  case ADDRESS_CLAIM_PGN:                       return interpreteAddressClaimed;
-  case PROCESS_DATA_PGN:                        return interpreteProcessData;
-  case MAINTAIN_POWER_REQUEST_PGN:              return interpreteMaintainPower;
-  case NMEA_GPS_CROSS_TRACK_ERROR_PGN:          return interpreteCrossTrackError;
-  case GUIDANCE_MACHINE_STATUS:                 return interpreteGuidanceMachineStatus;
-  case GUIDANCE_SYSTEM_CMD:
-  case ISOBUS_CERTIFICATION_PGN:
-  case PROPRIETARY_A_PGN:
-  case PROPRIETARY_A2_PGN:
-  case WORKING_SET_MEMBER_PGN:
-  case WORKING_SET_MASTER_PGN:
-  case LIGHTING_DATA_PGN:
-  case HITCH_PTO_COMMANDS:
-  case FRONT_PTO_STATE_PGN:
-  case FRONT_HITCH_STATE_PGN:
-  case SELECTED_SPEED_CMD:
-  case SELECTED_SPEED_MESSAGE:
-  case SOFTWARE_IDENTIFICATION_PGN:
-      break;
-  case TIME_DATE_PGN:                           return interpreteTimeDate;
-  case PROPRIETARY_B_PGN:
-      break;
-  case NMEA_GPS_POSITION_RAPID_UPDATE_PGN:      return interpretePositionDataRapidUpdate;
-  case NMEA_GPS_COG_SOG_RAPID_UPDATE_PGN:       return interpreteCogSogRapidUpdate;
-  case NMEA_GPS_POSITION_DATA_PGN:              return interpreteGpsPositionData;
-  case NMEA_GPS_DIRECTION_DATA_PGN:
-  case NMEA_GNSS_PSEUDORANGE_NOISE_STATISTICS:
-  default:
-    break;
-  }
-  return 0;
+  uint32_t pgn = at_ptrFrame->pgn();
+  if ((pgn & PROPRIETARY_B_PGN) == PROPRIETARY_B_PGN)
+    return 0; // no interpretation for PROPRIETARY_B
+  return pgnInterpreters().find( pgn );
 }
 
 
@@ -1027,13 +1043,20 @@ getLogLineParser( size_t at_choice )
 }
 
 
-std::pair< int, PtrDataFrame_t >
-parseLogLine( std::ostream& out, std::string const &acr_line )
+bool
+isLogLineParserReentrant( ParseLogLine_t *apt_parseLogLine )
+{
+  // these keep state between the lines (detected mode / relative timestamps)
+  return (apt_parseLogLine != parseLogLineRte) && (apt_parseLogLine != parseLogLineRte2);
+}
+
+
+void
+printLogLine( std::ostream& out, std::pair< int, PtrDataFrame_t > const &result, std::string const &acr_line )
 {
 #if DEBUG
   out << "Reading " << acr_line << std::endl;
 #endif
-  std::pair< int, PtrDataFrame_t > result = gs_main.pt_parseLogLine(acr_line);
   if (result.first == 0) // no error
   { /// Printout interpreted line
     PtrDataFrame_t t_ptrFrame = result.second;
@@ -1097,7 +1120,6 @@ parseLogLine( std::ostream& out, std::string const &acr_line )
     // report original line:
     out << "(" << acr_line << ")" <<std::endl;
   }
-  return result;
 }
 
 
@@ -1105,6 +1127,135 @@ parseLogLine( std::ostream& out, std::string const &acr_line )
 #include "gpx_writer.inc"
 
 
+void
+checkFrame( PtrDataFrame_t at_ptrFrame )
+{
+  checkAlives(at_ptrFrame);
+  checkSingles(at_ptrFrame);
+  checkHandshakingsVtCommands(at_ptrFrame);
+  checkHandshakingTP(at_ptrFrame);
+  checkHandshakingsProcData(at_ptrFrame);
+}
+
+
+// writes the parsed frames to a binary capture
+class CaptureConsumer_c : public FrameIngestion_c::Consumer_c {
+public:
+  CaptureConsumer_c(CanCapture::Writer_c &ar_writer) : mr_writer(ar_writer), mui64_frames(0), mui64_skipped(0), mb_ok(true) {}
+
+  virtual void consume(CompactFrame_s const &acrs_frame, char const *)
+  {
+    if (0 != acrs_frame.mi_parseResult) {
+      ++mui64_skipped;
+      return;
+    }
+    CanCapture::Record_s s_record;
+    s_record.mui64_time_us = acrs_frame.mui64_time_ms * 1000; // text logs are parsed in ms resolution
+    s_record.mui32_identifier = acrs_frame.mui32_identifier;
+    s_record.mb_ext = acrs_frame.mb_canExt;
+    s_record.mui8_dlc = acrs_frame.mui8_dataSize;
+    s_record.mui8_channel = 0;
+    std::fill(s_record.marr_data, s_record.marr_data + 8, uint8_t(0));
+    std::copy(acrs_frame.marr_data, acrs_frame.marr_data + acrs_frame.mui8_dataSize, s_record.marr_data);
+    mb_ok = mr_writer.append(s_record) && mb_ok;
+    ++mui64_frames;
+  }
+
+  CanCapture::Writer_c &mr_writer;
+  uint64_t mui64_frames;
+  uint64_t mui64_skipped;
+  bool mb_ok;
+};
+
+
+// stats-only: no interpretation, no DataFrame_c
+class StatsConsumer_c : public FrameIngestion_c::Consumer_c {
+public:
+  virtual void consume(CompactFrame_s const &acrs_frame, char const *)
+  {
+    if (0 == acrs_frame.mi_parseResult)
+      gs_main.mp_stats->add(acrs_frame.mui64_time_ms * 1000, acrs_frame.mui32_identifier, acrs_frame.mb_canExt, acrs_frame.mui8_dataSize, acrs_frame.marr_data);
+  }
+};
+
+
+// consumes the (in parallel) parsed frames in log order
+class LogLineConsumer_c : public FrameIngestion_c::Consumer_c {
+public:
+  virtual void consume(CompactFrame_s const &acrs_frame, char const *apc_line)
+  {
+    std::pair< int, PtrDataFrame_t > result(acrs_frame.mi_parseResult, PtrDataFrame_t(0));
+    if (0 == result.first)
+      result.second = acrs_frame.toDataFrame();
+
+#if DEBUG
+    bool const cb_needLine = true;
+#else
+    bool const cb_needLine = (0 != result.first);
+#endif
+    printLogLine(std::cout, result, cb_needLine ? std::string(apc_line, acrs_frame.mui32_lineLength) : std::string());
+
+    if (0 == result.first)
+      checkFrame(result.second);
+  }
+};
+
+
+void
+analyzeFrame( CanCapture::Record_s const &acrs_record )
+{
+  if( gs_main.mp_stats ) {
+    gs_main.mp_stats->add( acrs_record.mui64_time_us, acrs_record.mui32_identifier, acrs_record.mb_ext, std::min( acrs_record.mui8_dlc, uint8_t(8) ), acrs_record.marr_data );
+    return;
+  }
+
+  std::pair< int, PtrDataFrame_t > result( 0, PtrDataFrame_t( new DataFrame_c(
+      acrs_record.mui64_time_us / 1000,
+      acrs_record.mui32_identifier,
+      std::vector< uint8_t >( acrs_record.marr_data, acrs_record.marr_data + std::min( acrs_record.mui8_dlc, uint8_t(8) ) ),
+      acrs_record.mb_ext ) ) );
+  printLogLine( std::cout, result, std::string() );
+  checkFrame( result.second );
+}
+
+
+// the capture's timestamps are expected to be ascending (as recorded)
+void
+analyzeCapture( std::string const &acr_filename )
+{
+  CanCapture::Reader_c c_reader;
+  if( !c_reader.open( acr_filename ) )
+    exit_with_error( ( std::string( "Couldn't read binary capture: " ) + acr_filename ).c_str() );
+
+  uint64_t const cui64_from_us = gs_main.mui64_fromMs * 1000;
+  uint64_t const cui64_to_us = ( gs_main.mui64_toMs < uint64_t(-1) / 1000 ) ? gs_main.mui64_toMs * 1000 : uint64_t(-1);
+  uint64_t const cui64_first = c_reader.findTime( cui64_from_us );
+
+  CanCapture::Record_s s_record;
+  if( ( gs_main.mi32_pgnFilter < 0 ) && ( gs_main.mi_saFilter < 0 ) ) {
+    while( c_reader.next( s_record ) && ( s_record.mui64_time_us <= cui64_to_us ) )
+      analyzeFrame( s_record );
+    return;
+  }
+
+  // use the smaller side index, check the other filter per frame
+  std::vector< uint32_t > vec_records;
+  if( gs_main.mi32_pgnFilter >= 0 )
+    c_reader.recordsOfPgn( uint32_t( gs_main.mi32_pgnFilter ), vec_records );
+  else
+    c_reader.recordsOfSa( uint8_t( gs_main.mi_saFilter ), vec_records );
+
+  std::vector< uint32_t >::const_iterator iter = std::lower_bound( vec_records.begin(), vec_records.end(), cui64_first );
+  for( ; iter != vec_records.end(); ++iter ) {
+    if( !c_reader.seekRecord( *iter ) || !c_reader.next( s_record ) || ( s_record.mui64_time_us > cui64_to_us ) )
+      break;
+    if( ( gs_main.mi_saFilter >= 0 ) && ( s_record.sourceAddress() != gs_main.mi_saFilter ) )
+      continue;
+    analyzeFrame( s_record );
+  }
+}
+
+
 int main (int argc, char** argv)
 {
   gs_main.pt_parseLogLine = parseLogLineCanServer;
@@ -1133,6 +1284,34 @@ int main (int argc, char** argv)
           case OPT_STORE_DDOP:
             gs_main.mb_storeDdop = true;
             break;
+          case OPT_THREADS:
+            gs_main.mui_parseThreads = atoi( args.OptionArg() );
+            break;
+          case OPT_CAPTURE:
+            gs_main.mstr_captureFile = args.OptionArg();
+            break;
+          case OPT_FROM:
+            gs_main.mui64_fromMs = strtoull( args.OptionArg(), NULL, 10 );
+            break;
+          case OPT_TO:
+            gs_main.mui64_toMs = strtoull( args.OptionArg(), NULL, 10 );
+            break;
+          case OPT_PGN:
+            gs_main.mi32_pgnFilter = int32_t( strtoul( args.OptionArg(), NULL, 16 ) & 0x3FFFF );
+            break;
+          case OPT_SA:
+            gs_main.mi_saFilter = atoi( args.OptionArg() ) & 0xFF;
+            break;
+          case OPT_STATS:
+            if( std::string( args.OptionArg() ) == "json" )
+              gs_main.me_statsFormat = BusStatistics_c::formatJson;
+            else if( std::string( args.OptionArg() ) == "csv" )
+              gs_main.me_statsFormat = BusStatistics_c::formatCsv;
+            else
+              exit_with_usage( argv[0] );
+            if( !gs_main.mp_stats )
+              gs_main.mp_stats = new BusStatistics_c();
+            break;
           case OPT_HELP:
             exit_with_usage( argv[0] );
             return 0;
@@ -1147,32 +1326,75 @@ int main (int argc, char** argv)
     exit_with_usage( argv[0] );
   }
 
-  PtrInputStream_t t_ptrIn = PtrInputStream_t( new InputStream_c( args.Files()[0] ) );
+  std::string const cstr_input( args.Files()[0] );
+  bool const cb_binaryInput = ( cstr_input != "-" ) && CanCapture::Reader_c::isCapture( cstr_input );
 
-  if (!t_ptrIn->isOpen())
-    exit_with_error( ( std::string( "Couldn't open file: " ) + std::string( args.Files()[0] ) ).c_str() );
+  CanCapture::Writer_c c_writer;
+  if( !gs_main.mstr_captureFile.empty() ) {
+    if( cb_binaryInput )
+      exit_with_error( "Input is already a binary capture." );
+    if( !c_writer.open( gs_main.mstr_captureFile ) )
+      exit_with_error( ( std::string( "Couldn't create file: " ) + gs_main.mstr_captureFile ).c_str() );
+  }
+  CaptureConsumer_c c_captureConsumer( c_writer );
+  StatsConsumer_c c_statsConsumer;
+  LogLineConsumer_c c_logLineConsumer;
+  FrameIngestion_c::Consumer_c &r_consumer = !gs_main.mstr_captureFile.empty()
+    ? static_cast< FrameIngestion_c::Consumer_c & >( c_captureConsumer )
+    : ( gs_main.mp_stats
+      ? static_cast< FrameIngestion_c::Consumer_c & >( c_statsConsumer )
+      : static_cast< FrameIngestion_c::Consumer_c & >( c_logLineConsumer ) );
+
+  // regular files are mapped and parsed in parallel, stdin/pipes line by line
+  bool b_ingested = false;
+  if( cb_binaryInput ) {
+    analyzeCapture( cstr_input );
+    b_ingested = true;
+  }
+  else if( cstr_input != "-" ) {
+    FrameIngestion_c c_ingestion(
+        gs_main.pt_parseLogLine,
+        isLogLineParserReentrant( gs_main.pt_parseLogLine ) ? gs_main.mui_parseThreads : 1 );
+    b_ingested = c_ingestion.run( cstr_input, r_consumer );
+  }
 
-  std::string str_line;
-  for (;;) {
-    getline(t_ptrIn->raw(), str_line);
-    if( t_ptrIn->raw().fail() ) {
-      break;
-    }
-    std::pair< int, PtrDataFrame_t > parse_result = parseLogLine(std::cout, str_line);
-    if (0 == parse_result.first)
-    {
-      checkAlives(parse_result.second);
-      checkSingles(parse_result.second);
-      checkHandshakingsVtCommands(parse_result.second);
-      checkHandshakingTP(parse_result.second);
-      checkHandshakingsProcData(parse_result.second);
-    }
-    if (t_ptrIn->raw().eof()) {
-      break;
+  if( !b_ingested ) {
+    PtrInputStream_t t_ptrIn = PtrInputStream_t( new InputStream_c( cstr_input ) );
+
+    if (!t_ptrIn->isOpen())
+      exit_with_error( ( std::string( "Couldn't open file: " ) + cstr_input ).c_str() );
+
+    std::string str_line;
+    for (;;) {
+      getline(t_ptrIn->raw(), str_line);
+      if( t_ptrIn->raw().fail() ) {
+        break;
+      }
+      CompactFrame_s s_frame;
+      FrameIngestion_c::compact( gs_main.pt_parseLogLine(str_line), s_frame );
+      s_frame.mui64_lineOffset = 0;
+      s_frame.mui32_lineLength = uint32_t( str_line.size() );
+      r_consumer.consume( s_frame, str_line.c_str() );
+      if (t_ptrIn->raw().eof()) {
+        break;
+      }
     }
   }
 
-  t_ptrIn = PtrInputStream_t(0);
+  if( !gs_main.mstr_captureFile.empty() ) {
+    if( !c_writer.close() || !c_captureConsumer.mb_ok )
+      exit_with_error( ( std::string( "Couldn't write file: " ) + gs_main.mstr_captureFile ).c_str() );
+    std::cerr << c_captureConsumer.mui64_frames << " frames written to " << gs_main.mstr_captureFile
+              << ", " << c_captureConsumer.mui64_skipped << " lines not parsed." << std::endl;
+    return 0;
+  }
+
+  if( gs_main.mp_stats ) {
+    gs_main.mp_stats->report( std::cout, gs_main.me_statsFormat );
+    delete gs_main.mp_stats;
+    gs_main.mp_stats = NULL;
+    return 0;
+  }
 
   gs_main.m_alive.report( std::cout );
   printFullListOfSupportedFunctions(std::cout);
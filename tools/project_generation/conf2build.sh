@@ -555,7 +555,7 @@ driver_and_hal_features()
         printf '%s' " -o -name '*analogi*'" >&3
     fi
     if [ "$PRJ_INPUTS_COUNTER" -gt 0 ]; then
-        printf '%s' " -o -name '*counteri*'" >&3
+        printf '%s' " -o -name '*counteri*' -o -name '*frequencyestimator*'" >&3
     fi
     if [ "$PRJ_INPUTS_DIGITAL" -gt 0 -o "$PRJ_INPUTS_ANALOG" -gt 0 -o "$PRJ_INPUTS_COUNTER" -gt 0 ]; then
         printf '%s' " -o -name '*inputbase_c.*' -o -name '*iinput_c.*' -o -name '*inputs_c.*' -o -path '*/hal/hal_inputs.h'" >&3
@@ -627,11 +627,14 @@ driver_and_hal_features()
             (hal_simulator)
                 printf '%s' " -o -path '*${HAL_PATH_SUPPLEMENTARY_EEPROM}/target_extension_eeprom_hal_simulator*'" >&4
                 ;;
+            (journaled)
+                printf '%s' " -o -path '*${HAL_PATH_SUPPLEMENTARY_EEPROM}/target_extension_eeprom_journaled*'" >&4
+                ;;
             (sys)
                 printf '%s' " -o -path '*${HAL_PATH_SUPPLEMENTARY_EEPROM}/target_extension_eeprom_sys*'" >&4
                 ;;
             (*)
-                echo_ 'ERROR! Please set the config variable "USE_EEPROM_DRIVER" to one of "sys"|"simulating"|"hal_simulator"'
+                echo_ 'ERROR! Please set the config variable "USE_EEPROM_DRIVER" to one of "sys"|"simulating"|"journaled"|"hal_simulator"'
                 echo_ 'Current Setting is $USE_EEPROM_DRIVER'
                 exit 3
         esac
@@ -853,6 +856,9 @@ END_OF_PATH
     
         if [ "$PRJ_EEPROM" -gt 0 ] ; then
             echo_e "#define USE_EEPROM_IO" >&3
+            if [ "$USE_EEPROM_DRIVER" = "journaled" ] ; then
+                echo_e "#define HAL_USE_BUFFERED_EEPROM" >&3
+            fi
         fi
     
         if [ "$PRJ_DATASTREAMS" -gt 0 -o $PRJ_ISO_VIRTUALTERMINAL_CLIENT -gt 0 ]; then
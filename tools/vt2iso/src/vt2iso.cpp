@@ -254,6 +254,9 @@ static void usage()
     " -k     Pedantic mode during resolving values from translation files for inputstring, stringvariable and outputstring.\n"
     " -b=cl  Derive the object pool from the given base class. Defaults to IsoAgLib::iVtClientObjectPool_c.\n"
     " -bh=h  Specify the header file to include for the base class which was specified with the -b option. Defaults to none.\n"
+    " -j=n   Convert the bitmaps on n threads. Defaults to one per hardware thread.\n"
+    " -cache=dir Keep the converted bitmaps in the given directory and reuse them while the bitmap file is unchanged.\n"
+    " -incremental Keep object IDs stable between runs (stored in <prefix>.vt2iso-state) and only rewrite generated files whose content changed.\n"
     "[XML-Parser:]\n"
     " -v=xxx Validation scheme [always | never | auto]. Defaults to auto\n"
     " -n     Enable namespace processing. Defaults to off.\n"
@@ -481,7 +484,38 @@ FILE& vt2iso_c::save_fopen (const std::string& arcstr_fileName, const char* apcc
 }
 
 
+FILE& vt2iso_c::save_fopenOutput (const std::string& arcstr_fileName)
+{
+  if (sb_incremental)
+    sl_outputFiles.push_back (arcstr_fileName);
+  return save_fopen (outputFileName (arcstr_fileName), "wt");
+}
+
+
+std::string vt2iso_c::outputFileName (const std::string& arcstr_fileName)
+{
+  return sb_incremental ? (arcstr_fileName + ".tmp") : arcstr_fileName;
+}
+
+
+unsigned int vt2iso_c::commitOutputFiles()
+{
+  unsigned int ui_written = 0;
+  for (std::list<std::string>::const_iterator iter = sl_outputFiles.begin(); iter != sl_outputFiles.end(); ++iter)
+  {
+    if (!existsFile (outputFileName (*iter)))
+      continue; // already removed again, e.g. an empty ListByObject_c
+    if (diffFileSave (*iter, outputFileName (*iter)))
+      ++ui_written;
+  }
+  sl_outputFiles.clear();
+  return ui_written;
+}
+
+
 bool vt2iso_c::sb_WSFound = false;
+bool vt2iso_c::sb_incremental = false;
+std::list<std::string> vt2iso_c::sl_outputFiles;
 
 void vt2iso_c::clean_exit (const char* error_message)
 {
@@ -659,7 +693,7 @@ void vt2iso_c::clean_exit (const char* error_message)
   // Write Derived Includes (-cpp)
   FILE* partFile_derived = NULL;
   partFileName = mstr_destinDirAndProjectPrefix + "_derived-cpp.h";
-  partFile_derived = &save_fopen (partFileName.c_str(),"wt");
+  partFile_derived = &save_fopenOutput (partFileName);
 
   fprintf (partFile_derived, "#include \"%s-variables%s.inc\"\n", mstr_outFileName.c_str(), extension.c_str());
   fprintf (partFile_derived, "\n#if defined( USE_SECTION_VT_OBJECT_POOL )\n");
@@ -706,7 +740,7 @@ void vt2iso_c::clean_exit (const char* error_message)
 
 
   partFileName = mstr_destinDirAndProjectPrefix + "-attributes.inc";
-  partFileTmp = &save_fopen(partFileName.c_str(), "wt");
+  partFileTmp = &save_fopenOutput (partFileName);
 
   for( unsigned int objType=0; objType< maxObjectTypes; ++objType )
   {
@@ -720,7 +754,7 @@ void vt2iso_c::clean_exit (const char* error_message)
 
 
   partFileName = mstr_destinDirAndProjectPrefix + "-variables.inc";
-  partFileTmp = &save_fopen(partFileName.c_str(), "wt");
+  partFileTmp = &save_fopenOutput (partFileName);
 
   for( unsigned int objType=0; objType< maxObjectTypes; ++objType )
   {
@@ -735,7 +769,7 @@ void vt2iso_c::clean_exit (const char* error_message)
 
   // Write Derived Includes (-h)
   partFileName = mstr_destinDirAndProjectPrefix + "_derived-h.h";
-  partFileTmp = &save_fopen (partFileName.c_str(),"wt");
+  partFileTmp = &save_fopenOutput (partFileName);
 
   fprintf (partFileTmp, "#include <IsoAgLib/comm/Part6_VirtualTerminal_Client/ivtincludes.h>\n");
   fprintf (partFileTmp, "#include \"%s-handler-derived.inc\"\n", mstr_outFileName.c_str());
@@ -746,13 +780,13 @@ void vt2iso_c::clean_exit (const char* error_message)
   if (b_externalize)
   {
     partFileName = mstr_destinDirAndProjectPrefix + "-variables.cpp";
-    partFileTmp = &save_fopen (partFileName.c_str(), "wt");
+    partFileTmp = &save_fopenOutput (partFileName);
     fprintf (partFileTmp, "#include <IsoAgLib/comm/Part6_VirtualTerminal_Client/ivtincludes.h>\n");
     fprintf (partFileTmp, "#include \"%s-variables.inc\"\n", mstr_outFileName.c_str());
     fclose (partFileTmp);
 
     partFileName = mstr_destinDirAndProjectPrefix + "-attributes.cpp";
-    partFileTmp = &save_fopen (partFileName.c_str(), "wt");
+    partFileTmp = &save_fopenOutput (partFileName);
     fprintf (partFileTmp, "#include <IsoAgLib/comm/Part6_VirtualTerminal_Client/ivtincludes.h>\n");
     fprintf (partFileTmp, "#include \"%s-variables-extern.inc\"\n", mstr_outFileName.c_str());
     fprintf (partFileTmp, "#include \"%s-attributes-extern.inc\"\n", mstr_outFileName.c_str());
@@ -768,7 +802,7 @@ void vt2iso_c::clean_exit (const char* error_message)
     fclose (partFileTmp);
 
     partFileName = mstr_destinDirAndProjectPrefix + "-list.cpp";
-    partFileTmp = &save_fopen (partFileName.c_str(), "wt");
+    partFileTmp = &save_fopenOutput (partFileName);
     fprintf (partFileTmp, "#include <IsoAgLib/comm/Part6_VirtualTerminal_Client/ivtincludes.h>\n");
     fprintf (partFileTmp, "#include \"%s-attributes-extern.inc\"\n", mstr_outFileName.c_str());
     fprintf (partFileTmp, "#include \"%s-variables-extern.inc\"\n", mstr_outFileName.c_str());
@@ -788,7 +822,7 @@ void vt2iso_c::clean_exit (const char* error_message)
     fclose (partFileTmp);
 
     partFileName = mstr_destinDirAndProjectPrefix + "-list_attributes.cpp";
-    partFileTmp = &save_fopen (partFileName.c_str(), "wt");
+    partFileTmp = &save_fopenOutput (partFileName);
     fprintf (partFileTmp, "#include <IsoAgLib/comm/Part6_VirtualTerminal_Client/ivtincludes.h>\n");
     fprintf (partFileTmp, "#include \"%s-attributes-extern.inc\"\n", mstr_outFileName.c_str());
     fprintf (partFileTmp, "\n#if defined( USE_SECTION_VT_OBJECT_POOL )\n");
@@ -829,7 +863,7 @@ void vt2iso_c::clean_exit (const char* error_message)
   // if any "-attributes.inc" was written, wrap all long lines creating a temporary file "-attributes.inc.tmp"
   for( unsigned int objType=0; objType< maxObjectTypes; ++objType )
   {
-    const std::string partFileName_attributes = AttributesListByObject_List[objType]->getPathAndFileName();
+    const std::string partFileName_attributes = outputFileName (AttributesListByObject_List[objType]->getPathAndFileName());
     partFileName = partFileName_attributes + ".tmp";
     lineWrapTextFile( partFileName_attributes, partFileName, 1022 );
   }
@@ -846,8 +880,8 @@ void vt2iso_c::clean_exit (const char* error_message)
     fprintf ( partFile_attributes_prop, "%s", mstr_namespaceDeclarationEnd.c_str());
     fclose (partFile_attributes_prop);
     // if "-attributes-prop.inc" was written, wrap all long lines creating a temporary file "-attributes-prop.inc.tmp"
-    partFileName = partFileName_attributes_prop + ".tmp";
-    lineWrapTextFile( partFileName_attributes_prop, partFileName, 1022 );
+    partFileName = outputFileName (partFileName_attributes_prop) + ".tmp";
+    lineWrapTextFile( outputFileName (partFileName_attributes_prop), partFileName, 1022 );
   }
 #endif
 
@@ -857,6 +891,13 @@ void vt2iso_c::clean_exit (const char* error_message)
     partFileName = partFileName_obj_selection + ".tmp";
     diffFileSave( partFileName_obj_selection, partFileName );
   }
+
+  if (sb_incremental)
+  {
+    const unsigned int ui_written = commitOutputFiles();
+    if (!mb_silentMode)
+      std::cout << "vt2iso: " << ui_written << " generated file(s) changed." << std::endl;
+  }
   if (error_message != NULL)
     std::cout << error_message;
 
@@ -1026,7 +1067,15 @@ signed long int vt2iso_c::getID (const char* objName, bool b_isMacro, bool b_wis
     }
     else if ( checkForAllowedExecution() )
     { /// only auto-decrement if the current object has a basic or proprietary object type
-      if (b_isMacro)
+      std::map<std::string, uint16_t>::const_iterator iter_previous = mmap_previousObjNameIdTable.find (str_objName);
+      if ( (iter_previous != mmap_previousObjNameIdTable.end())
+        && !mbitset_objIdUsed.test (iter_previous->second)
+        && (!b_isMacro || (iter_previous->second <= 255)) )
+      { // incremental mode: keep the ID of the last run, so the object's output stays the same
+        foundID = iter_previous->second;
+        mbitset_objIdUsed.set (foundID, 1);
+      }
+      else if (b_isMacro)
       {
         foundID = getFreeId (objNextMacroAutoID);
       }
@@ -1051,7 +1100,7 @@ signed long int vt2iso_c::getID (const char* objName, bool b_isMacro, bool b_wis
 
 unsigned int vt2iso_c::getFreeId (unsigned int& aui_objNextId)
 {
-  while (mbitset_objIdUsed.test (aui_objNextId))
+  while (mbitset_objIdUsed.test (aui_objNextId) || mbitset_objIdReserved.test (aui_objNextId))
     --aui_objNextId;
   return (aui_objNextId--);
 }
@@ -1227,33 +1276,33 @@ vt2iso_c::init(
 
 #ifdef USE_SPECIAL_PARSING_PROP
   partFileName = mstr_destinDirAndProjectPrefix + "-variables-prop.inc";
-  partFile_variables_prop = &save_fopen (partFileName.c_str(),"wt");
+  partFile_variables_prop = &save_fopenOutput (partFileName);
   fprintf (partFile_variables_prop, "%s", mstr_namespaceDeclarationBegin.c_str());
 #endif
 
   partFileName = mstr_destinDirAndProjectPrefix + "-variables-extern.inc";
-  partFile_variables_extern = &save_fopen (partFileName.c_str(),"wt");
+  partFile_variables_extern = &save_fopenOutput (partFileName);
   fprintf (partFile_variables_extern, "%s", mstr_namespaceDeclarationBegin.c_str());
 
 #ifdef USE_SPECIAL_PARSING_PROP
   partFileName_attributes_prop = mstr_destinDirAndProjectPrefix + "-attributes-prop.inc"; // store original file-name for later wrap-copying over
   partFileName = partFileName_attributes_prop;
-  partFile_attributes_prop = &save_fopen (partFileName.c_str(),"wt");
+  partFile_attributes_prop = &save_fopenOutput (partFileName);
   fprintf (partFile_attributes_prop, "%s", mstr_namespaceDeclarationBegin.c_str());
 #endif
 
   partFileName = mstr_destinDirAndProjectPrefix + "-attributes-extern.inc";
-  partFile_attributes_extern = &save_fopen (partFileName.c_str(),"wt");
+  partFile_attributes_extern = &save_fopenOutput (partFileName);
   fprintf (partFile_attributes_extern, "%s", mstr_namespaceDeclarationBegin.c_str());
 
   partFileName = mstr_destinDirAndProjectPrefix + "-functions.inc";
-  partFile_functions = &save_fopen (partFileName.c_str(),"wt");
+  partFile_functions = &save_fopenOutput (partFileName);
 
   partFileName = mstr_destinDirAndProjectPrefix + "-functions-origin.inc";
-  partFile_functions_origin = &save_fopen (partFileName.c_str(),"wt");
+  partFile_functions_origin = &save_fopenOutput (partFileName);
 
   partFileName = mstr_destinDirAndProjectPrefix + "-defines.inc";
-  partFile_defines = &save_fopen (partFileName.c_str(),"wt");
+  partFile_defines = &save_fopenOutput (partFileName);
   fprintf (partFile_defines, "%s", mstr_namespaceDeclarationBegin.c_str());
 
   partFileName_obj_selection = mstr_destinDirAndProjectPrefix + "-objectselection.inc";
@@ -1261,18 +1310,18 @@ vt2iso_c::init(
   partFile_obj_selection = &save_fopen (partFileName.c_str(),"wt");
 
   partFileName = mstr_destinDirAndProjectPrefix + "-list.inc";
-  partFile_list = &save_fopen (partFileName.c_str(),"wt");
+  partFile_list = &save_fopenOutput (partFileName);
   fprintf (partFile_list, "%s", mstr_namespaceDeclarationBegin.c_str());
   fprintf (partFile_list, "IsoAgLib::iVtObject_c* const HUGE_MEM all_iVtObjects [] = {");
 
   partFileName = mstr_destinDirAndProjectPrefix + "-list_attributes.inc";
-  partFile_listAttributes = &save_fopen (partFileName.c_str(),"wt");
+  partFile_listAttributes = &save_fopenOutput (partFileName);
   fprintf (partFile_listAttributes, "%s", mstr_namespaceDeclarationBegin.c_str());
   // const implies local linking, but the "extern" forces external linking (lists should be in .rodata section instead of .data)
   fprintf (partFile_listAttributes, "extern IsoAgLib::iVtObject_c::iVtObject_s* const HUGE_MEM all_sROMs [] = {");
 
   partFileName = mstr_destinDirAndProjectPrefix + "-handler-derived.inc";
-  partFile_handler_derived = &save_fopen (partFileName.c_str(),"wt");
+  partFile_handler_derived = &save_fopenOutput (partFileName);
 
 #ifdef USE_SPECIAL_PARSING_PROP
   pc_specialParsingPropTag = new SpecialParsingUsePropTag_c (arcstr_cmdlineName,
@@ -1770,8 +1819,14 @@ bool vt2iso_c::openDecodePrintOut (const std::list<Path_s>& rcl_stdBitmapPath, u
       return false;
     }
 
+    const Vt2IsoImageCache_c::Entry_s* ps_converted = mc_imageCache.find (filename);
+    if (ps_converted != NULL)
+    { // converted in advance
+      if (mb_verbose) std::cout << "Loaded successfully (converted in advance)! ";
+      c_Bitmap.adoptDimensions( ps_converted->ui_width, ps_converted->ui_height );
+    }
     // Open Bitmap
-    if ( c_Bitmap.openBitmap( filename.c_str() ) )
+    else if ( c_Bitmap.openBitmap( filename.c_str() ) )
     {
       if (mb_verbose) std::cout << "Loaded successfully! ";
     }
@@ -1786,19 +1841,30 @@ bool vt2iso_c::openDecodePrintOut (const std::list<Path_s>& rcl_stdBitmapPath, u
       ui_picBufferSize = c_Bitmap.getWidth() * c_Bitmap.getHeight();
       picBuffer = new unsigned char[ui_picBufferSize];
     }
-    // Decode bitmap to buffer!
-    switch (actDepth)
+    if (ps_converted != NULL)
     {
-      case 0: // 1 bit colour (monochrome) = 2 colours (black/white)
-        c_Bitmap.write1BitBitmap( picBuffer, ui_picBufferSize );
-        break;
+      const std::vector<unsigned char>& rvec_bitmap = ps_converted->vec_bitmap [actDepth];
+      std::copy (rvec_bitmap.begin(), rvec_bitmap.end(), picBuffer);
+      c_Bitmap.objRawBitmapBytes [actDepth] = rvec_bitmap.size();
+      if ((actDepth == 2) && ps_converted->b_invalidPalette)
+        std::cout << "*** WRONG PALETTE in " << filename << ". Please use the ISO11783-Part 6 (VT)-Palette for bitmaps you have saved palettized and use in 8bit-mode. Use 'vt2iso -p' to generate an .act file and resample your bitmap to use this palette! ***" << std::endl;
+    }
+    else
+    {
+      // Decode bitmap to buffer!
+      switch (actDepth)
+      {
+        case 0: // 1 bit colour (monochrome) = 2 colours (black/white)
+          c_Bitmap.write1BitBitmap( picBuffer, ui_picBufferSize );
+          break;
         case 1: // 4 bit colour = 16 colours
           c_Bitmap.write4BitBitmap( picBuffer, ui_picBufferSize );
           break;
-          case 2: // 8 bit colour = 256 colours
-            c_Bitmap.write8BitBitmap( picBuffer, ui_picBufferSize );
-            break;
-    } // switch
+        case 2: // 8 bit colour = 256 colours
+          c_Bitmap.write8BitBitmap( picBuffer, ui_picBufferSize );
+          break;
+      } // switch
+    }
 
     if (c_Bitmap.objRawBitmapBytes [actDepth] == 0)
     {
@@ -2486,7 +2552,7 @@ vt2iso_c::processElement (DOMNode *n, uint64_t ombType /*, const char* rpcc_inKe
             /// Also add this language to the intern language-table!
             std::string langFileName;
             langFileName = str(format("%s-list%02d.inc") % mstr_destinDirAndProjectPrefix % ui_languages);
-            arrs_language [ui_languages].partFile = &save_fopen (langFileName.c_str(), "wt");
+            arrs_language [ui_languages].partFile = &save_fopenOutput (langFileName);
             langFileName = str(format("%sIsoAgLib::iVtObject_c* const HUGE_MEM all_iVtObjects%d [] = {") % mstr_namespaceDeclarationBegin % ui_languages);
             fputs (langFileName.c_str(), arrs_language [ui_languages].partFile);
             arrs_language [ui_languages].code[0] = languageCode[0];
@@ -4615,6 +4681,7 @@ vt2iso_c::vt2iso_c()
   , partFile_split_function( NULL )
   , ui_languages(0)
   , mbitset_objIdUsed()
+  , mbitset_objIdReserved()
   , map_objNameIdTable()
   , objNextAutoID(65534)
   , objNextMacroAutoID(255)
@@ -5284,6 +5351,9 @@ int main(int argC, char* argV[])
   std::string str_langPrefix;
   std::string str_baseClass = "IsoAgLib::iVtClientObjectPool_c"; // default value if -b commandline parameter is not specified
   std::string str_baseClassHdr; // empty so no '#include "..."' directive is written on default. Use -bh to set it and generate that directive
+  unsigned int ui_bitmapThreads = 0; // one per hardware thread
+  std::string str_bitmapCacheDir;
+  bool b_incremental = false;
 
   int filenameInd = -1; // defaults to: no filename specified.
   for (int argInd = 1; argInd < argC; argInd++)
@@ -5363,6 +5433,10 @@ int main(int argC, char* argV[])
       if (!b_silentMode)
         verbose = true;
     }
+    else if (!strcmp(argV[argInd], "-incremental"))
+    {
+      b_incremental = true;
+    }
     else if (!strncmp(argV[argInd], "-i", 2))
     {
       usage();
@@ -5373,6 +5447,14 @@ int main(int argC, char* argV[])
     {
       str_outDir.assign (&argV[argInd][3]);
     }
+    else if (!strncmp(argV[argInd], "-j=", 3))
+    {
+      ui_bitmapThreads = atoi (&argV[argInd][3]);
+    }
+    else if (!strncmp(argV[argInd], "-cache=", 7))
+    {
+      str_bitmapCacheDir.assign (&argV[argInd][7]);
+    }
     else if (!strncmp(argV[argInd], "-c=", 3))
     {
       str_vtPresetFile.assign (&argV[argInd][3]);
@@ -5514,10 +5596,14 @@ int main(int argC, char* argV[])
   // And create our error handler and install it
   parser->setErrorHandler(pc_vt2iso);
 
+  // before init(), which already opens the generated files
+  pc_vt2iso->setIncremental (b_incremental);
+
   const bool cb_initSuccess = pc_vt2iso->init (str_cmdlineName, &dictionary, externalize, createAll, b_disableContainmentRules, parser, verbose, str_outDir, str_namespace, b_accept_unknown_attributes, b_silentMode, b_pedanticMode, str_outFileName, str_searchPath, str_langPrefix, str_definesPrefix, str_baseClass, str_baseClassHdr );
 
   if (cb_initSuccess)
   {
+    pc_vt2iso->setBitmapConversion (ui_bitmapThreads, str_bitmapCacheDir);
 
     if (!str_vtPresetFile.empty())
     {
@@ -5566,8 +5652,20 @@ void vt2iso_c::parse()
 
   if(!mb_silentMode) std::cout << "** Pass 1 **"<<std::endl;
 
+  if (sb_incremental)
+    loadIncrementalState();
+
   if (!doAllFiles (actionMarkIds)) return;
 
+  if (sb_incremental)
+  {
+    reservePreviousIds();
+    if (!mb_silentMode)
+      reportIncrementalChanges();
+  }
+
+  mc_imageCache.convertRequested (mb_verbose);
+
   if(!mb_silentMode) std::cout << "** Pass 2 **"<<std::endl;
 
   setParseModeWorkingSet (true); // only parse for the workingset-object!
@@ -5583,6 +5681,9 @@ void vt2iso_c::parse()
 
   generateIncludeDefines();
 
+  if (sb_incremental && !m_errorOccurred)
+    saveIncrementalState();
+
   clean_exit ((m_errorOccurred) ? "vt2iso: XML-Parsing error occurred. Terminating.\n"
                                 : mb_silentMode ? 0 : "vt2iso: All conversion done successfully.\n");
 }
@@ -5702,11 +5803,22 @@ void vt2iso_c::markIds (DOMNode *n)
     int nSize = pAttributes->getLength();
     int id=-1;
     std::string name;
+    const StrX nodeName (n->getNodeName());
+    const bool b_isBitmap = (0 == strcmp (nodeName.localForm(), otCompTable [otPicturegraphic])) || (0 == strcmp (nodeName.localForm(), otCompTable [otFixedBitmap]));
     for (int i=0;i<nSize;++i)
     {
       DOMAttr *pAttributeNode = (DOMAttr*) pAttributes->item(i);
       utf16convert (pAttributeNode->getName(), local_attrName);
       utf16convert (pAttributeNode->getValue(), local_attrValue);
+      if (b_isBitmap && !local_attrValue.empty()
+          && ( (local_attrName.compare(attrNameTable [attrFile]) == 0)
+            || (local_attrName.compare(attrNameTable [attrFile0]) == 0)
+            || (local_attrName.compare(attrNameTable [attrFile1]) == 0)
+            || (local_attrName.compare(attrNameTable [attrFile2]) == 0) ))
+      { // convert all bitmaps in advance (in parallel) after this pass
+        requestBitmap (local_attrValue);
+        continue;
+      }
       if (local_attrName.compare("id") == 0)
       {
         id = atoi (local_attrValue.c_str());
@@ -5727,6 +5839,25 @@ void vt2iso_c::markIds (DOMNode *n)
         continue;
       }
     }
+    if (sb_incremental && !name.empty())
+    { // FNV-1a over the object's own tag and attributes (children are objects on their own)
+      uint64_t ui64_hash = 14695981039346656037ULL;
+      std::string str_input = nodeName.localForm();
+      for (int i=0;i<nSize;++i)
+      {
+        DOMAttr *pAttributeNode = (DOMAttr*) pAttributes->item(i);
+        utf16convert (pAttributeNode->getName(), local_attrName);
+        utf16convert (pAttributeNode->getValue(), local_attrValue);
+        str_input += std::string(" ") + local_attrName + "=" + local_attrValue;
+      }
+      for (std::string::const_iterator iter = str_input.begin(); iter != str_input.end(); ++iter)
+      {
+        ui64_hash ^= (unsigned char)*iter;
+        ui64_hash *= 1099511628211ULL;
+      }
+      mmap_objInputHash [name] = ui64_hash;
+    }
+
     // now check if a pair with name/id was found
     bool const is_found = !name.empty() && 0 <= id && id != 65535;
     if (is_found)
@@ -5754,6 +5885,102 @@ void vt2iso_c::markIds (DOMNode *n)
 }
 
 
+// one line per object: <name> <id> <input hash>
+void vt2iso_c::loadIncrementalState()
+{
+  std::ifstream stateFile ((mstr_destinDirAndProjectPrefix + ".vt2iso-state").c_str());
+  std::string str_name;
+  unsigned int ui_id;
+  std::string str_hash;
+  while (stateFile >> str_name >> ui_id >> str_hash)
+  {
+    if (ui_id < 65535)
+      mmap_previousObjNameIdTable [str_name] = uint16_t (ui_id);
+    mmap_previousObjInputHash [str_name] = strtoull (str_hash.c_str(), NULL, 16);
+  }
+}
+
+
+void vt2iso_c::saveIncrementalState() const
+{
+  std::ofstream stateFile ((mstr_destinDirAndProjectPrefix + ".vt2iso-state").c_str());
+  for (std::map<std::string, uint16_t>::const_iterator iter = map_objNameIdTable.begin(); iter != map_objNameIdTable.end(); ++iter)
+  {
+    std::map<std::string, uint64_t>::const_iterator iter_hash = mmap_objInputHash.find (iter->first);
+    stateFile << iter->first << " " << iter->second << " " << std::hex
+              << ((iter_hash != mmap_objInputHash.end()) ? iter_hash->second : 0) << std::dec << "\n";
+  }
+}
+
+
+// after pass 1: IDs given in the XML files are known now
+void vt2iso_c::reservePreviousIds()
+{
+  for (std::map<std::string, uint16_t>::const_iterator iter = mmap_previousObjNameIdTable.begin(); iter != mmap_previousObjNameIdTable.end(); ++iter)
+  {
+    if (map_objNameIdTable.find (iter->first) != map_objNameIdTable.end())
+      continue; // has an ID given in the XML now
+    // don't let auto-IDs take the ID of an object of the last run
+    mbitset_objIdReserved.set (iter->second, 1);
+  }
+}
+
+
+void vt2iso_c::reportIncrementalChanges() const
+{
+  unsigned int ui_changed = 0, ui_new = 0, ui_removed = 0;
+  for (std::map<std::string, uint64_t>::const_iterator iter = mmap_objInputHash.begin(); iter != mmap_objInputHash.end(); ++iter)
+  {
+    std::map<std::string, uint64_t>::const_iterator iter_previous = mmap_previousObjInputHash.find (iter->first);
+    if (iter_previous == mmap_previousObjInputHash.end())
+    {
+      ++ui_new;
+      if (mb_verbose) std::cout << "  new object: " << iter->first << std::endl;
+    }
+    else if (iter_previous->second != iter->second)
+    {
+      ++ui_changed;
+      if (mb_verbose) std::cout << "  changed object: " << iter->first << std::endl;
+    }
+  }
+  for (std::map<std::string, uint64_t>::const_iterator iter = mmap_previousObjInputHash.begin(); iter != mmap_previousObjInputHash.end(); ++iter)
+  {
+    if ((iter->second != 0) && (mmap_objInputHash.find (iter->first) == mmap_objInputHash.end()))
+      ++ui_removed;
+  }
+  std::cout << "vt2iso: " << ui_changed << " object(s) changed, " << ui_new << " new, " << ui_removed << " removed since the last run." << std::endl;
+}
+
+
+void vt2iso_c::requestBitmap (const std::string& astr_file)
+{
+  struct stat s_stat;
+
+  // absolute path in picture graphic object
+  if (stat(astr_file.c_str(), &s_stat) == 0)
+    mc_imageCache.request (astr_file);
+
+  std::string str_concat = " "; str_concat[0] = scc_dirSeparatorCorrect;
+  const std::list<Path_s>* arrpl_paths [2] = { &l_stdBitmapPath, &l_fixedBitmapPath };
+  for (int list = 0; list < 2; ++list)
+  {
+    for (std::list<Path_s>::const_iterator iter = arrpl_paths[list]->begin(); iter != arrpl_paths[list]->end(); ++iter)
+    {
+      std::string str_tmpWorkDir = mstr_sourceDir;
+      if (!iter->b_relativePath)
+        str_tmpWorkDir.clear();
+
+      const std::string str_filename = str_tmpWorkDir + iter->str_pathName + str_concat + astr_file;
+      if (stat(str_filename.c_str(), &s_stat) == 0)
+      { // first match is taken by openDecodePrintOut, too
+        mc_imageCache.request (str_filename);
+        break;
+      }
+    }
+  }
+}
+
+
 void
 vt2iso_c::clearAndSetElements (DOMNode *child, const std::vector <int> &avec)
 {
@@ -6279,7 +6506,7 @@ void vt2iso_c::lineWrapTextFile( const std::string &srcFileName, const std::stri
 }
 
 
-void vt2iso_c::diffFileSave( const std::string &destFileName, const std::string &tempFileName )
+bool vt2iso_c::diffFileSave( const std::string &destFileName, const std::string &tempFileName )
 {
   if ( existsFile( destFileName ) )
   {
@@ -6352,6 +6579,9 @@ void vt2iso_c::diffFileSave( const std::string &destFileName, const std::string
             break;
           }
         }
+        /* one file may only be a prefix of the other */
+        if ( (destI < destLen) || (srcI < srcLen) )
+          filesMatch = false;
       }
 
       if ( destBuf )  delete [] destBuf;
@@ -6364,6 +6594,7 @@ void vt2iso_c::diffFileSave( const std::string &destFileName, const std::string
     if ( filesMatch )
     {
       remove( tempFileName.c_str() );
+      return false;
     }
     else
     {
@@ -6375,6 +6606,7 @@ void vt2iso_c::diffFileSave( const std::string &destFileName, const std::string
   { /* destination does not exist, just rename the temp */
     rename( tempFileName.c_str(), destFileName.c_str() );
   }
+  return true;
 }
 
 
@@ -6583,7 +6815,7 @@ void vt2iso_c::ListByObject_c::open()
 
     const char* className = otClassnameTable[objType];
 
-    partFile = &save_fopen( getPathAndFileName().c_str(),"wt" );
+    partFile = &save_fopenOutput( getPathAndFileName() );
     fprintf (partFile, "%s", mstr_namespaceDeclarationBegin.c_str());
   }
 }
@@ -26,6 +26,7 @@
 
 #include "vt2iso-defines.hpp"
 #include "vt2iso-globals.hpp"
+#include "vt2isoimagecache_c.h"
 
 // Would like to use wchar_t but C standard does not guarantee that wchar_t has at least
 //  16 bits, so lets be most portable definition with unsigned short for the incoming UCS-2
@@ -248,6 +249,11 @@ public:
 
   void parse();
 
+  /** convert bitmaps on aui_threads threads ( 0: one per hardware thread ),
+      astr_cacheDir: keep converted bitmaps there ( empty: no cache ) */
+  void setBitmapConversion( unsigned int aui_threads, const std::string& astr_cacheDir )
+  { mc_imageCache.setThreads( aui_threads ); mc_imageCache.setCacheDir( astr_cacheDir ); }
+
   bool prepareFileNameAndDirectory (const std::string& astr_fileName);
 
   void convertIdReferenceToNameReference (int ai_attrType);
@@ -285,6 +291,9 @@ private:
 
   bool openDecodePrintOut (const std::list<Path_s>& rcl_bitmapPath, unsigned int &options, int& ref_maxDepth, int fixNr=-1);
 
+  /** find the bitmap file like openDecodePrintOut does and request its conversion in advance */
+  void requestBitmap (const std::string& astr_file);
+
   // return -1 on error, otherwise 2/16/256
   int processColourMapCsv( const std::string& filename, std::vector<std::string>& aref_vecStrValues );
 
@@ -309,7 +318,18 @@ private:
   //! copies tmpFileName (the text-file without linewrapping) over to destFileName respecting the given mayLineLen
   void lineWrapTextFile( const std::string &destFileName, const std::string &tmpFileName, unsigned int maxLineLen );
 
-  void diffFileSave( const std::string &destFileName, const std::string &tempFileName );
+  //! @return true if destFileName was (re)written
+  bool diffFileSave( const std::string &destFileName, const std::string &tempFileName );
+
+  //! incremental mode: replace the generated files whose content changed
+  //! @return number of rewritten files
+  unsigned int commitOutputFiles();
+
+  //! incremental mode: object IDs and input hashes of the last run
+  void loadIncrementalState();
+  void saveIncrementalState() const;
+  void reservePreviousIds();
+  void reportIncrementalChanges() const;
 
   std::list<std::string> scanLanguageFilesOS( language_s& a_lang );
 
@@ -318,6 +338,14 @@ public:
 
   static FILE& save_fopen (const std::string& arcstr_fileName, const char* apcc_mode);
 
+  //! open a generated file for writing. In incremental mode it is written
+  //! to outputFileName() and only replaces the file in commitOutputFiles()
+  static FILE& save_fopenOutput (const std::string& arcstr_fileName);
+  //! name the generated file is actually written to until commitOutputFiles()
+  static std::string outputFileName (const std::string& arcstr_fileName);
+
+  void setIncremental( bool ab_incremental ) { sb_incremental = ab_incremental; }
+
 private:
   class ListByObject_c
   {
@@ -431,6 +459,13 @@ private:
   static const char* mscp_langDetectionDoneAttributeName;
   
   std::bitset<65536> mbitset_objIdUsed;
+  // incremental mode: IDs of the last run, kept free for their objects
+  std::bitset<65536> mbitset_objIdReserved;
+  std::map<std::string, uint16_t> mmap_previousObjNameIdTable;
+  std::map<std::string, uint64_t> mmap_objInputHash;
+  std::map<std::string, uint64_t> mmap_previousObjInputHash;
+  static bool sb_incremental;
+  static std::list<std::string> sl_outputFiles;
 
   std::map<std::string, uint16_t> map_objNameIdTable;
 
@@ -517,6 +552,8 @@ private:
   std::list<Path_s> l_stdBitmapPath;
   std::list<Path_s> l_fixedBitmapPath;
 
+  Vt2IsoImageCache_c mc_imageCache;
+
   std::list<Path_s> l_dictionaryPath;
 
   std::list<std::string> scanLanguageFiles( language_s& a_lang );
@@ -283,8 +283,23 @@ Vt2IsoImageBase_c::Vt2IsoImageBase_c( void )
   , i_currentThreshold( -1 )
   , ui_width( 0 )
   , ui_height( 0 )
+  , mb_rgbDecoded( false )
+  , mb_paletteIndexDecoded( false )
   , mp_ostream( NULL )
 {
+  // rgbtopalette16 only depends on the 0x00/0x99/0xCC/0xFF step of each component
+  static const unsigned int scui_steps [4] = { 0x00, 0x99, 0xCC, 0xFF };
+  for ( unsigned int comp = 0; comp < 256; comp++ )
+  {
+    const unsigned int step = componentto09CF( comp );
+    marr_component4Step [comp] = ( step == 0x00 ) ? 0 : ( step == 0x99 ) ? 1 : ( step == 0xCC ) ? 2 : 3;
+  }
+  for ( unsigned int i = 0; i < 64; i++ )
+    marr_palette16 [i] = rgbtopalette16( scui_steps [i >> 4], scui_steps [( i >> 2 ) & 0x3], scui_steps [i & 0x3] );
+
+  // insert() keeps the first ( lowest ) index for duplicate colours
+  for ( unsigned int idx = 0; idx < 256; idx++ )
+    mmap_exactColour.insert( std::make_pair( ( (unsigned int)vtColourTable[idx].bgrRed << 16 ) | ( (unsigned int)vtColourTable[idx].bgrGreen << 8 ) | vtColourTable[idx].bgrBlue, (unsigned char)idx ) );
 }
 
 void Vt2IsoImageBase_c::close( void )
@@ -296,6 +311,10 @@ void Vt2IsoImageBase_c::reset( void )
   i_currentThreshold = -1;
   ui_width = 0;
   ui_height = 0;
+  mvec_rgb.clear();
+  mvec_paletteIndex.clear();
+  mb_rgbDecoded = false;
+  mb_paletteIndexDecoded = false;
 }
 
 
@@ -307,74 +326,118 @@ void Vt2IsoImageBase_c::resetLengths( void )
 }
 
 
+void Vt2IsoImageBase_c::adoptDimensions( unsigned int aui_width, unsigned int aui_height )
+{
+  reset();
+  ui_width = aui_width;
+  ui_height = aui_height;
+  // nothing to decode
+  mb_rgbDecoded = true;
+  mb_paletteIndexDecoded = true;
+}
+
+
+void Vt2IsoImageBase_c::decodeRgb( void )
+{
+  mvec_rgb.resize( 3 * getWidth() * getHeight() );
+  unsigned char* pui_pixel = mvec_rgb.empty() ? NULL : &mvec_rgb[0];
+  for ( unsigned int ui_y = 0; ui_y < getHeight(); ui_y++ )
+  {
+    for ( unsigned int ui_x = 0; ui_x < getWidth(); ui_x++ )
+    {
+      *pui_pixel++ = getR( ui_x, ui_y );
+      *pui_pixel++ = getG( ui_x, ui_y );
+      *pui_pixel++ = getB( ui_x, ui_y );
+    }
+  }
+}
+
+
+void Vt2IsoImageBase_c::decodePaletteIndex( void )
+{
+  mb_paletteIndexDecoded = true;
+  mvec_paletteIndex.clear();
+  if ( ( getWidth() == 0 ) || ( getHeight() == 0 ) )
+    return;
+
+  // first pixel decides ( and reports a wrong palette only once )
+  if ( getPaletteIndex( 0, 0 ) < 0 )
+    return;
+
+  mvec_paletteIndex.resize( getWidth() * getHeight() );
+  unsigned char* pui_index = &mvec_paletteIndex[0];
+  for ( unsigned int ui_y = 0; ui_y < getHeight(); ui_y++ )
+    for ( unsigned int ui_x = 0; ui_x < getWidth(); ui_x++ )
+      *pui_index++ = (unsigned char)getPaletteIndex( ui_x, ui_y );
+}
+
+
 /** deliver the b/w thresholded value at given bitmap position
   ( calculate the optimal bitmap threshold if not yet defined )
   */
 unsigned int Vt2IsoImageBase_c::get1BitPixel( unsigned int aui_x, unsigned int aui_y )
 {
   if ( i_currentThreshold < 0 )  getOptimalBwThreshold();
-  return ( int( ( getR( aui_x, aui_y ) + getG( aui_x, aui_y ) + getB( aui_x, aui_y ) ) / 3 ) >= i_currentThreshold )?1U:0U;
+  if ( ( aui_x >= getWidth() ) || ( aui_y >= getHeight() ) ) return ( 0 >= i_currentThreshold )?1U:0U;
+  const unsigned char* pui_pixel = rgbData() + 3 * ( aui_y * getWidth() + aui_x );
+  return ( int( ( pui_pixel[0] + pui_pixel[1] + pui_pixel[2] ) / 3 ) >= i_currentThreshold )?1U:0U;
 }
 
 /** get the ISO virtual table indexed bitmap value for 4Bit ( 16colour ) target bitmap */
 unsigned int Vt2IsoImageBase_c::get4BitPixel( unsigned int aui_x, unsigned int aui_y )
 {
-  return rgbtopalette16 ( getR( aui_x, aui_y ), getG( aui_x, aui_y ), getB( aui_x, aui_y ) );
+  if ( ( aui_x >= getWidth() ) || ( aui_y >= getHeight() ) ) return marr_palette16 [0];
+  const unsigned char* pui_pixel = rgbData() + 3 * ( aui_y * getWidth() + aui_x );
+  return marr_palette16 [( marr_component4Step [pui_pixel[0]] << 4 ) | ( marr_component4Step [pui_pixel[1]] << 2 ) | marr_component4Step [pui_pixel[2]]];
 }
 
 /** get the ISO virtual table indexed bitmap value for 8Bit ( 256colour ) target bitmap */
 unsigned int Vt2IsoImageBase_c::get8BitPixel( unsigned int aui_x, unsigned int aui_y )
 {
-  int idx = getPaletteIndex (aui_x, aui_y);
-  if (idx >= 0)
+  if ( !mb_paletteIndexDecoded ) decodePaletteIndex();
+  if ( ( aui_x >= getWidth() ) || ( aui_y >= getHeight() ) ) return 0;
+
+  if ( !mvec_paletteIndex.empty() )
   { // we're palettized!
     // 0..255 possible - directly taken out of the bitmap!
-    return idx;
+    return mvec_paletteIndex [aui_y * getWidth() + aui_x];
   }
-  else 
-  { // we're NOT palettized, calculate a palette index!
-    const uint8_t ui8_red = getR( aui_x, aui_y );
-    const uint8_t ui8_green = getG( aui_x, aui_y );
-    const uint8_t ui8_blue = getB( aui_x, aui_y );
-
-    static unsigned int directMatchIdx = 0;
-    // try previous value (prevent iteration for speed up)
-    if ((vtColourTable[directMatchIdx].bgrRed == ui8_red) && (vtColourTable[directMatchIdx].bgrGreen == ui8_green) && (vtColourTable[directMatchIdx].bgrBlue == ui8_blue)) 
-      return directMatchIdx;
-
-    for ( directMatchIdx = 0; directMatchIdx < 256; directMatchIdx++)
-    {
-      if ((vtColourTable[directMatchIdx].bgrRed == ui8_red) && (vtColourTable[directMatchIdx].bgrGreen == ui8_green) && (vtColourTable[directMatchIdx].bgrBlue == ui8_blue)) 
-        return directMatchIdx;
-    }
+  const unsigned char* pui_pixel = rgbData() + 3 * ( aui_y * getWidth() + aui_x );
+  return rgbtopalette256( pui_pixel[0], pui_pixel[1], pui_pixel[2] );
+}
 
-    idx = 16 + ( componenttoindex6 ( getR( aui_x, aui_y ) )*36 )
-             + ( componenttoindex6 ( getG( aui_x, aui_y ) )*6  )
-             + ( componenttoindex6 ( getB( aui_x, aui_y ) )    );
-    // 16..231 possible - mapped to this area!
-    switch (idx)
-    { // now try to map down those colours that exactly match to the range 0..15!
-      // because those colours will be used in the 16-colour version, too. This makes it easier for the transparency colour then!
-      case  16: idx = 0; break;
-      case 231: idx = 1; break;
-      case  34: idx = 2; break;
-      case  37: idx = 3; break;
-      case 124: idx = 4; break;
-      case 127: idx = 5; break;
-      case 142: idx = 6; break;
-      case 188: idx = 7; break;
-      case 145: idx = 8; break;
-      case  21: idx = 9; break;
-      case  46: idx =10; break;
-      case  51: idx =11; break;
-      case 196: idx =12; break;
-      case 201: idx =13; break;
-      case 226: idx =14; break;
-      case  19: idx =15; break;
-    }
-    return idx;
+/** deliver 8Bit VT palette index for given R/G/B values ( non palettized case ) */
+unsigned int Vt2IsoImageBase_c::rgbtopalette256 (unsigned int red, unsigned int green, unsigned int blue)
+{
+  std::map<unsigned int, unsigned char>::const_iterator iter = mmap_exactColour.find( ( red << 16 ) | ( green << 8 ) | blue );
+  if ( iter != mmap_exactColour.end() )
+    return iter->second;
+
+  unsigned int idx = 16 + ( componenttoindex6 ( red )*36 )
+                        + ( componenttoindex6 ( green )*6  )
+                        + ( componenttoindex6 ( blue )    );
+  // 16..231 possible - mapped to this area!
+  switch (idx)
+  { // now try to map down those colours that exactly match to the range 0..15!
+    // because those colours will be used in the 16-colour version, too. This makes it easier for the transparency colour then!
+    case  16: idx = 0; break;
+    case 231: idx = 1; break;
+    case  34: idx = 2; break;
+    case  37: idx = 3; break;
+    case 124: idx = 4; break;
+    case 127: idx = 5; break;
+    case 142: idx = 6; break;
+    case 188: idx = 7; break;
+    case 145: idx = 8; break;
+    case  21: idx = 9; break;
+    case  46: idx =10; break;
+    case  51: idx =11; break;
+    case 196: idx =12; break;
+    case 201: idx =13; break;
+    case 226: idx =14; break;
+    case  19: idx =15; break;
   }
-  return 0; // Only for compiler satisfaction.
+  return idx;
 }
 
 /** write the Bitmap to the given buffer and return amount of written Bytes */
@@ -383,25 +446,24 @@ unsigned int Vt2IsoImageBase_c::write1BitBitmap( unsigned char* pui_bitmap, unsi
   objRawBitmapBytes [0] = 0;
   if ( ( i_currentThreshold < 0 ) || ( i_currentThreshold == 128 ) ) getOptimalBwThreshold();
 
-  unsigned int roundedWidth = ( ( getWidth() + 7U ) & ( 0xFFFFFFFFU - 7U ) );
+  const unsigned int bytesPerLine = ( getWidth() + 7U ) / 8U;
+  // avoid overflow
+  if ( bytesPerLine * getHeight() > aui_maxSize ) return 0;
 
+  const unsigned char* pui_pixel = rgbData();
   for (unsigned int ui_y=0; ui_y< getHeight(); ui_y++) {
-    for (unsigned int ui_x=0; ui_x < roundedWidth; ui_x+=8) {
-      unsigned int pixel1PaletteIndex = get1BitPixel( ui_x, ui_y );
-      unsigned int pixel2PaletteIndex = get1BitPixel( ui_x+1, ui_y );
-      unsigned int pixel3PaletteIndex = get1BitPixel( ui_x+2, ui_y );
-      unsigned int pixel4PaletteIndex = get1BitPixel( ui_x+3, ui_y );
-      unsigned int pixel5PaletteIndex = get1BitPixel( ui_x+4, ui_y );;
-      unsigned int pixel6PaletteIndex = get1BitPixel( ui_x+5, ui_y );
-      unsigned int pixel7PaletteIndex = get1BitPixel( ui_x+6, ui_y );
-      unsigned int pixel8PaletteIndex = get1BitPixel( ui_x+7, ui_y );
-      unsigned int byte = (pixel1PaletteIndex << 7) + (pixel2PaletteIndex << 6) + (pixel3PaletteIndex << 5) + (pixel4PaletteIndex << 4)
-                + (pixel5PaletteIndex << 3) + (pixel6PaletteIndex << 2) + (pixel7PaletteIndex << 1) + pixel8PaletteIndex;
-      // avoid overflow
-      if ( objRawBitmapBytes [0] > aui_maxSize ) return 0;
-
-      pui_bitmap [objRawBitmapBytes [0]] = byte;
-      objRawBitmapBytes [0]++;
+    for (unsigned int ui_byte=0; ui_byte < bytesPerLine; ui_byte++) {
+      unsigned int byte = 0;
+      const unsigned int ui_x = 8 * ui_byte;
+      for (unsigned int ui_bit = 0; ui_bit < 8; ui_bit++) {
+        int grey = 0; // pixels right of the bitmap are black
+        if ( ui_x + ui_bit < getWidth() ) {
+          grey = ( pui_pixel[0] + pui_pixel[1] + pui_pixel[2] ) / 3;
+          pui_pixel += 3;
+        }
+        byte = ( byte << 1 ) | ( ( grey >= i_currentThreshold )?1U:0U );
+      }
+      pui_bitmap [objRawBitmapBytes [0]++] = byte;
     }
   } // iterate loop
   return objRawBitmapBytes [0];
@@ -412,18 +474,22 @@ unsigned int Vt2IsoImageBase_c::write1BitBitmap( unsigned char* pui_bitmap, unsi
 unsigned int Vt2IsoImageBase_c::write4BitBitmap( unsigned char* pui_bitmap, unsigned int aui_maxSize )
 {
   objRawBitmapBytes [1] = 0;
-  unsigned int roundedWidth = ( ( getWidth() + 1U ) & ( 0xFFFFFFFFU - 1U ) );
+  const unsigned int bytesPerLine = ( getWidth() + 1U ) / 2U;
+  // avoid overflow
+  if ( bytesPerLine * getHeight() > aui_maxSize ) return 0;
 
+  const unsigned char* pui_pixel = rgbData();
   for ( unsigned int ui_y=0; ui_y< getHeight(); ui_y++) {
-    for (unsigned int ui_x=0; ui_x<roundedWidth; ui_x+=2) {
-      unsigned int pixel1PaletteIndex = get4BitPixel( ui_x, ui_y );
-      unsigned int pixel2PaletteIndex = get4BitPixel( ui_x+1, ui_y );
-      unsigned int byte = (pixel1PaletteIndex << 4) + pixel2PaletteIndex;
-      // avoid overflow
-      if ( objRawBitmapBytes [1] > aui_maxSize ) return 0;
-
-      pui_bitmap [objRawBitmapBytes [1]] = byte;
-      objRawBitmapBytes [1]++;
+    for (unsigned int ui_x=0; ui_x<getWidth(); ui_x+=2) {
+      unsigned int byte = marr_palette16 [( marr_component4Step [pui_pixel[0]] << 4 ) | ( marr_component4Step [pui_pixel[1]] << 2 ) | marr_component4Step [pui_pixel[2]]] << 4;
+      pui_pixel += 3;
+      if ( ui_x + 1 < getWidth() ) {
+        byte |= marr_palette16 [( marr_component4Step [pui_pixel[0]] << 4 ) | ( marr_component4Step [pui_pixel[1]] << 2 ) | marr_component4Step [pui_pixel[2]]];
+        pui_pixel += 3;
+      }
+      else
+        byte |= marr_palette16 [0]; // pixel right of the bitmap is black
+      pui_bitmap [objRawBitmapBytes [1]++] = byte;
     }
   } // iterate loop
   return objRawBitmapBytes [1];
@@ -434,16 +500,35 @@ int Vt2IsoImageBase_c::write8BitBitmap( unsigned char* pui_bitmap, unsigned int
 {
   b_isInvalidPalette = false;
   objRawBitmapBytes [2] = 0;
-  for ( unsigned int ui_y=0; ui_y< getHeight(); ui_y++) {
-    for ( unsigned int ui_x=0; ui_x < getWidth(); ui_x++) {
-      unsigned int pixelPaletteIndex = get8BitPixel( ui_x, ui_y );
-      // avoid overflow
-      if ( objRawBitmapBytes [2] > aui_maxSize ) return 0;
-
-      pui_bitmap [objRawBitmapBytes [2]] = pixelPaletteIndex;
-      objRawBitmapBytes [2]++;
+  const unsigned int pixels = getWidth() * getHeight();
+  // avoid overflow
+  if ( pixels > aui_maxSize ) return 0;
+
+  decodePaletteIndex();
+  if ( !mvec_paletteIndex.empty() )
+  { // palettized - indices are taken directly out of the bitmap
+    for ( unsigned int ui_i = 0; ui_i < pixels; ui_i++ )
+      pui_bitmap [ui_i] = mvec_paletteIndex [ui_i];
+  }
+  else
+  {
+    const unsigned char* pui_pixel = rgbData();
+    // neighbouring pixels mostly have the same colour
+    unsigned int ui_lastRgb = 0xFFFFFFFFU;
+    unsigned int ui_lastIndex = 0;
+    for ( unsigned int ui_i = 0; ui_i < pixels; ui_i++, pui_pixel += 3 )
+    {
+      const unsigned int ui_rgb = ( (unsigned int)pui_pixel[0] << 16 ) | ( (unsigned int)pui_pixel[1] << 8 ) | pui_pixel[2];
+      if ( ui_rgb != ui_lastRgb )
+      {
+        ui_lastRgb = ui_rgb;
+        ui_lastIndex = rgbtopalette256( pui_pixel[0], pui_pixel[1], pui_pixel[2] );
+      }
+      pui_bitmap [ui_i] = ui_lastIndex;
     }
-  } // iterate loop
+  }
+  objRawBitmapBytes [2] = pixels;
+
   if( b_isInvalidPalette )
 	return -1;
 
@@ -492,27 +577,36 @@ void Vt2IsoImageBase_c::getOptimalBwThreshold( void )
   thresholdLoopAllWhite = 0,
   thresholdLoopAllBlack = 0,
   optimalThreshold = 0;
-  unsigned int roundedWidth = ( ( getWidth() + 7U ) & ( 0xFFFFFFFFU - 7U ) );
 
-  for (unsigned int threshold = 32; threshold <= 224; threshold += 16 ) {
-  thresholdLoopAllWhite = 0;
-  thresholdLoopAllBlack = 0;
+  // A byte of 8 pixels is all 0 if its brightest pixel is below the threshold
+  // and all 1 if its darkest pixel reaches it. So one pass collecting the
+  // per-byte min/max is enough for all thresholds.
+  unsigned int arr_maxCount [256] = { 0 };
+  unsigned int arr_minCount [256] = { 0 };
+  const unsigned int bytesPerLine = ( getWidth() + 7U ) / 8U;
+  const unsigned char* pui_pixel = rgbData();
   for (unsigned int ui_y=0; ui_y<getHeight(); ui_y++) {
-    for (unsigned int ui_x=0; ui_x<roundedWidth; ui_x+=8) {
-      unsigned int pixel1PaletteIndex = ( ( ( getR( ui_x, ui_y ) + getG( ui_x, ui_y ) + getB( ui_x, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int pixel2PaletteIndex = ( ( ( getR( ui_x+1, ui_y ) + getG( ui_x+1, ui_y ) + getB( ui_x+1, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int pixel3PaletteIndex = ( ( ( getR( ui_x+2, ui_y ) + getG( ui_x+2, ui_y ) + getB( ui_x+2, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int pixel4PaletteIndex = ( ( ( getR( ui_x+3, ui_y ) + getG( ui_x+3, ui_y ) + getB( ui_x+3, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int pixel5PaletteIndex = ( ( ( getR( ui_x+4, ui_y ) + getG( ui_x+4, ui_y ) + getB( ui_x+4, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int pixel6PaletteIndex = ( ( ( getR( ui_x+5, ui_y ) + getG( ui_x+5, ui_y ) + getB( ui_x+5, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int pixel7PaletteIndex = ( ( ( getR( ui_x+6, ui_y ) + getG( ui_x+6, ui_y ) + getB( ui_x+6, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int pixel8PaletteIndex = ( ( ( getR( ui_x+7, ui_y ) + getG( ui_x+7, ui_y ) + getB( ui_x+7, ui_y ) ) / 3 ) >= threshold )?1:0;
-      unsigned int byte = (pixel1PaletteIndex << 7) + (pixel2PaletteIndex << 6) + (pixel3PaletteIndex << 5) + (pixel4PaletteIndex << 4)
-                + (pixel5PaletteIndex << 3) + (pixel6PaletteIndex << 2) + (pixel7PaletteIndex << 1) + pixel8PaletteIndex;
-      if ( byte == 0 ) thresholdLoopAllWhite++;
-      else if ( byte == 0xFF ) thresholdLoopAllBlack++;
+    for (unsigned int ui_byte=0; ui_byte<bytesPerLine; ui_byte++) {
+      unsigned int ui_min = 255, ui_max = 0;
+      for (unsigned int ui_x = 8 * ui_byte; ui_x < 8 * ui_byte + 8; ui_x++) {
+        unsigned int grey = 0; // pixels right of the bitmap are black
+        if ( ui_x < getWidth() ) {
+          grey = ( pui_pixel[0] + pui_pixel[1] + pui_pixel[2] ) / 3;
+          pui_pixel += 3;
+        }
+        if ( grey < ui_min ) ui_min = grey;
+        if ( grey > ui_max ) ui_max = grey;
+      }
+      arr_minCount [ui_min]++;
+      arr_maxCount [ui_max]++;
     } // loop one columns of one line
   } // iterate loop for all lines
+
+  for (unsigned int threshold = 32; threshold <= 224; threshold += 16 ) {
+  thresholdLoopAllWhite = 0;
+  thresholdLoopAllBlack = 0;
+  for (unsigned int grey = 0; grey < threshold; grey++ ) thresholdLoopAllWhite += arr_maxCount [grey];
+  for (unsigned int grey = threshold; grey < 256; grey++ ) thresholdLoopAllBlack += arr_minCount [grey];
   if ( ( thresholdLoopAllWhite + thresholdLoopAllBlack ) < ( thresholdOptimalAllWhite + thresholdOptimalAllBlack ) ) {
     // new optimum found
     thresholdOptimalAllWhite = thresholdLoopAllWhite;
@@ -15,6 +15,8 @@
 #define VT2ISOIMAGEBASE_C_H
 
 #include <ostream>
+#include <vector>
+#include <map>
 
 
 static const unsigned int colour16table [16] [3] = {
@@ -86,6 +88,12 @@ class Vt2IsoImageBase_c
 	unsigned int objRawBitmapBytes [3];
 	bool b_isInvalidPalette;
 
+	/** take over the dimensions of a bitmap that was converted elsewhere
+	    ( e.g. delivered by the image cache ) - no pixel access possible then */
+	void adoptDimensions( unsigned int aui_width, unsigned int aui_height );
+	/** deliver the b/w threshold used for the last write1BitBitmap() */
+	int getThreshold( void ) const { return i_currentThreshold; }
+
 
  protected:
 	/** deliver R-value of bitmap at given position */
@@ -100,6 +108,17 @@ class Vt2IsoImageBase_c
    @return 0..255 for PALETTE INDEX */
   virtual int getPaletteIndex (unsigned int aui_x, unsigned int aui_y) = 0;
 
+	/** decode all pixels once into mvec_rgb ( R,G,B per pixel, top row first ).
+	    Default uses getR/getG/getB, derived classes can do it line-wise. */
+	virtual void decodeRgb( void );
+	/** decode all palette indices once into mvec_paletteIndex,
+	    stays empty if the bitmap is not palettized ( or has a wrong palette ) */
+	void decodePaletteIndex( void );
+	/** make sure the packed RGB buffer is available */
+	const unsigned char* rgbData( void ) { if ( !mb_rgbDecoded ) { decodeRgb(); mb_rgbDecoded = true; } return mvec_rgb.empty() ? NULL : &mvec_rgb[0]; }
+	/** deliver 8Bit VT palette index for given R/G/B values ( non palettized case ) */
+	unsigned int rgbtopalette256 (unsigned int red, unsigned int green, unsigned int blue);
+
 	/** calculate the optimal threshold for conversion to b/w */
 	void getOptimalBwThreshold( void );
 	/** deliver 4Bit palette value */
@@ -123,12 +142,25 @@ class Vt2IsoImageBase_c
 	/** height of bitmap */
 	unsigned int ui_height;
 
+	/** packed pixels, decoded only once per bitmap */
+	std::vector<unsigned char> mvec_rgb;
+	std::vector<unsigned char> mvec_paletteIndex;
+	bool mb_rgbDecoded;
+	bool mb_paletteIndexDecoded;
+
   bool isOstream() { return (mp_ostream != NULL); }
   // only use getOstream() if checked with isOstream().
   std::ostream& getOstream() { return *mp_ostream; }
 
 private:
   std::ostream* mp_ostream;
+
+  /** component ( 0..255 ) to 0x00/0x99/0xCC/0xFF step ( 0..3 ) */
+  unsigned char marr_component4Step [256];
+  /** 16 colour palette index for all 4*4*4 steps */
+  unsigned char marr_palette16 [64];
+  /** first exact match in the VT palette per 0xRRGGBB */
+  std::map<unsigned int, unsigned char> mmap_exactColour;
 };
 
 #endif
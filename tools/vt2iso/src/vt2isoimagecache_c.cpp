@@ -0,0 +1,276 @@
+/*
+  vt2isoimagecache_c.cpp: parallel and cached bitmap conversion for vt2iso
+
+  (C) Copyright 2009 - 2019 by OSB AG and developing partners
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#if defined( WIN32 ) && defined( __GNUC__ )
+ // MinGW as gcc compiler on Win32 platform
+ // include header to get DWORD and corresponding types
+ #include <windef.h>
+ #include <wingdi.h>
+#endif
+
+#include "vt2isoimagecache_c.h"
+#include "vt2isoimagefreeimage_c.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+
+namespace {
+
+// bump whenever the conversion itself changes, so old cache files get ignored
+const unsigned int scui_converterVersion = 1;
+const char scc_magic [4] = { 'V', '2', 'I', 'C' };
+
+// FNV-1a
+unsigned long long hashFile( const std::string& astr_filename, bool& rb_ok )
+{
+  unsigned long long hash = 14695981039346656037ULL;
+  std::ifstream file( astr_filename.c_str(), std::ios::binary );
+  rb_ok = file.good();
+  char buffer [16384];
+  while ( file )
+  {
+    file.read( buffer, sizeof( buffer ) );
+    const std::streamsize count = file.gcount();
+    for ( std::streamsize i = 0; i < count; ++i )
+    {
+      hash ^= (unsigned char)buffer [i];
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+void writeU32( std::ostream& out, unsigned int value )
+{
+  const unsigned char bytes [4] = { (unsigned char)value, (unsigned char)( value >> 8 ), (unsigned char)( value >> 16 ), (unsigned char)( value >> 24 ) };
+  out.write( (const char*)bytes, 4 );
+}
+
+bool readU32( std::istream& in, unsigned int& value )
+{
+  unsigned char bytes [4];
+  if ( !in.read( (char*)bytes, 4 ) ) return false;
+  value = bytes[0] | ( bytes[1] << 8 ) | ( bytes[2] << 16 ) | ( (unsigned int)bytes[3] << 24 );
+  return true;
+}
+
+} // namespace
+
+
+Vt2IsoImageCache_c::Vt2IsoImageCache_c()
+  : mui_threads( 0 )
+  , mstr_cacheDir()
+  , mvec_requested()
+  , mmap_entries()
+{
+}
+
+
+void Vt2IsoImageCache_c::request( const std::string& astr_filename )
+{
+  if ( mmap_entries.find( astr_filename ) != mmap_entries.end() )
+    return;
+  if ( std::find( mvec_requested.begin(), mvec_requested.end(), astr_filename ) != mvec_requested.end() )
+    return;
+  mvec_requested.push_back( astr_filename );
+}
+
+
+unsigned int Vt2IsoImageCache_c::convertRequested( bool ab_verbose )
+{
+  if ( mvec_requested.empty() )
+    return 0;
+
+  std::vector<Job_s> vec_jobs( mvec_requested.size() );
+  for ( unsigned int i = 0; i < vec_jobs.size(); ++i )
+  {
+    vec_jobs[i].str_filename = mvec_requested[i];
+    vec_jobs[i].ps_entry = new Entry_s;
+  }
+  mvec_requested.clear();
+
+  unsigned int ui_threads = mui_threads;
+  if ( ui_threads == 0 )
+    ui_threads = std::thread::hardware_concurrency();
+  if ( ui_threads == 0 )
+    ui_threads = 1;
+  if ( ui_threads > vec_jobs.size() )
+    ui_threads = vec_jobs.size();
+
+  // static interleaved split: bitmaps of one pool are of similar size
+  std::vector<std::thread> vec_workers;
+  for ( unsigned int t = 1; t < ui_threads; ++t )
+    vec_workers.push_back( std::thread( &Vt2IsoImageCache_c::convertJobs, this, std::ref( vec_jobs ), t, ui_threads ) );
+  convertJobs( vec_jobs, 0, ui_threads );
+  for ( unsigned int t = 0; t < vec_workers.size(); ++t )
+    vec_workers[t].join();
+
+  unsigned int ui_converted = 0, ui_fromDisk = 0;
+  for ( unsigned int i = 0; i < vec_jobs.size(); ++i )
+  {
+    if ( vec_jobs[i].ps_entry == NULL )
+      continue; // will be reported when the DOM walk tries to load it
+
+    ++ui_converted;
+    if ( vec_jobs[i].ps_entry->b_fromDisk )
+      ++ui_fromDisk;
+    mmap_entries[vec_jobs[i].str_filename] = *vec_jobs[i].ps_entry;
+    delete vec_jobs[i].ps_entry;
+  }
+
+  if ( ab_verbose )
+    std::cout << "Converted " << ui_converted << " bitmap(s) on " << ui_threads << " thread(s), "
+              << ui_fromDisk << " taken from the bitmap cache." << std::endl;
+  return ui_converted;
+}
+
+
+const Vt2IsoImageCache_c::Entry_s* Vt2IsoImageCache_c::find( const std::string& astr_filename ) const
+{
+  std::map<std::string, Entry_s>::const_iterator iter = mmap_entries.find( astr_filename );
+  return ( iter != mmap_entries.end() ) ? &iter->second : NULL;
+}
+
+
+void Vt2IsoImageCache_c::convertJobs( std::vector<Job_s>& arvec_jobs, unsigned int aui_first, unsigned int aui_step ) const
+{
+  for ( unsigned int i = aui_first; i < arvec_jobs.size(); i += aui_step )
+  {
+    if ( !convert( arvec_jobs[i].str_filename, *arvec_jobs[i].ps_entry ) )
+    {
+      delete arvec_jobs[i].ps_entry;
+      arvec_jobs[i].ps_entry = NULL;
+    }
+  }
+}
+
+
+bool Vt2IsoImageCache_c::convert( const std::string& astr_filename, Entry_s& ars_entry ) const
+{
+  const std::string str_cacheFile = cacheFileName( astr_filename );
+  if ( !str_cacheFile.empty() && loadFromDisk( str_cacheFile, ars_entry ) )
+  {
+    ars_entry.b_fromDisk = true;
+    return true;
+  }
+
+  // own instance per job, no output from the worker threads
+  Vt2IsoImageFreeImage_c c_image;
+  c_image.resetOstream();
+  if ( !c_image.openBitmap( astr_filename.c_str() ) )
+    return false;
+
+  ars_entry.ui_width = c_image.getWidth();
+  ars_entry.ui_height = c_image.getHeight();
+  ars_entry.b_fromDisk = false;
+
+  const unsigned int ui_maxSize = ars_entry.ui_width * ars_entry.ui_height;
+  c_image.resetLengths();
+  ars_entry.vec_bitmap[0].resize( ui_maxSize );
+  ars_entry.vec_bitmap[0].resize( c_image.write1BitBitmap( ars_entry.vec_bitmap[0].empty() ? NULL : &ars_entry.vec_bitmap[0][0], ui_maxSize ) );
+  ars_entry.i_threshold = c_image.getThreshold();
+  ars_entry.vec_bitmap[1].resize( ui_maxSize );
+  ars_entry.vec_bitmap[1].resize( c_image.write4BitBitmap( ars_entry.vec_bitmap[1].empty() ? NULL : &ars_entry.vec_bitmap[1][0], ui_maxSize ) );
+  ars_entry.vec_bitmap[2].resize( ui_maxSize );
+  c_image.write8BitBitmap( ars_entry.vec_bitmap[2].empty() ? NULL : &ars_entry.vec_bitmap[2][0], ui_maxSize );
+  ars_entry.vec_bitmap[2].resize( c_image.objRawBitmapBytes [2] );
+  ars_entry.b_invalidPalette = c_image.b_isInvalidPalette;
+  c_image.close();
+
+  if ( !str_cacheFile.empty() )
+    storeToDisk( str_cacheFile, ars_entry );
+  return true;
+}
+
+
+std::string Vt2IsoImageCache_c::cacheFileName( const std::string& astr_filename ) const
+{
+  if ( mstr_cacheDir.empty() )
+    return std::string();
+
+  bool b_ok;
+  const unsigned long long hash = hashFile( astr_filename, b_ok );
+  if ( !b_ok )
+    return std::string();
+
+  char pc_name [32];
+  sprintf( pc_name, "%08lx%08lx.v2ic", (unsigned long)( hash >> 32 ), (unsigned long)( hash & 0xFFFFFFFFUL ) );
+  const char c_last = mstr_cacheDir [mstr_cacheDir.size() - 1];
+  return mstr_cacheDir + ( ( c_last == '/' || c_last == '\\' ) ? "" : "/" ) + pc_name;
+}
+
+
+bool Vt2IsoImageCache_c::loadFromDisk( const std::string& astr_cacheFile, Entry_s& ars_entry ) const
+{
+  std::ifstream file( astr_cacheFile.c_str(), std::ios::binary );
+  char pc_magic [4];
+  unsigned int ui_version, ui_threshold, ui_flags;
+  unsigned int arr_sizes [3];
+  if ( !file.read( pc_magic, 4 ) || memcmp( pc_magic, scc_magic, 4 ) != 0
+    || !readU32( file, ui_version ) || ( ui_version != scui_converterVersion )
+    || !readU32( file, ars_entry.ui_width ) || !readU32( file, ars_entry.ui_height )
+    || !readU32( file, ui_threshold ) || !readU32( file, ui_flags )
+    || !readU32( file, arr_sizes[0] ) || !readU32( file, arr_sizes[1] ) || !readU32( file, arr_sizes[2] ) )
+    return false;
+
+  ars_entry.i_threshold = int( ui_threshold );
+  ars_entry.b_invalidPalette = ( ui_flags & 0x1 ) != 0;
+  for ( int depth = 0; depth < 3; ++depth )
+  {
+    if ( arr_sizes[depth] > ars_entry.ui_width * ars_entry.ui_height )
+      return false;
+    ars_entry.vec_bitmap[depth].resize( arr_sizes[depth] );
+    if ( arr_sizes[depth] && !file.read( (char*)&ars_entry.vec_bitmap[depth][0], arr_sizes[depth] ) )
+      return false;
+  }
+  return true;
+}
+
+
+void Vt2IsoImageCache_c::storeToDisk( const std::string& astr_cacheFile, const Entry_s& ars_entry ) const
+{
+  // write to a temporary file first, concurrent vt2iso runs may share the cache
+  char pc_suffix [32];
+  sprintf( pc_suffix, ".%p.tmp", (const void*)&ars_entry );
+  const std::string str_tmpFile = astr_cacheFile + pc_suffix;
+  {
+    std::ofstream file( str_tmpFile.c_str(), std::ios::binary );
+    if ( !file )
+      return;
+    file.write( scc_magic, 4 );
+    writeU32( file, scui_converterVersion );
+    writeU32( file, ars_entry.ui_width );
+    writeU32( file, ars_entry.ui_height );
+    writeU32( file, (unsigned int)ars_entry.i_threshold );
+    writeU32( file, ars_entry.b_invalidPalette ? 0x1 : 0x0 );
+    for ( int depth = 0; depth < 3; ++depth )
+      writeU32( file, ars_entry.vec_bitmap[depth].size() );
+    for ( int depth = 0; depth < 3; ++depth )
+      if ( !ars_entry.vec_bitmap[depth].empty() )
+        file.write( (const char*)&ars_entry.vec_bitmap[depth][0], ars_entry.vec_bitmap[depth].size() );
+    if ( !file )
+    {
+      file.close();
+      remove( str_tmpFile.c_str() );
+      return;
+    }
+  }
+  remove( astr_cacheFile.c_str() ); // rename() doesn't replace on Windows
+  if ( rename( str_tmpFile.c_str(), astr_cacheFile.c_str() ) != 0 )
+    remove( str_tmpFile.c_str() );
+}
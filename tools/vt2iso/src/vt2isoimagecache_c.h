@@ -0,0 +1,79 @@
+/*
+  vt2isoimagecache_c.h: parallel and cached bitmap conversion for vt2iso
+
+  (C) Copyright 2009 - 2019 by OSB AG and developing partners
+
+  See the repository-log for details on the authors and file-history.
+  (Repository information can be found at <http://isoaglib.com/download>)
+
+  Use, modification and distribution are subject to the GNU General
+  Public License with exceptions for ISOAgLib. (See accompanying
+  file LICENSE.txt or copy at <http://isoaglib.com/download/license>)
+*/
+
+#ifndef VT2ISOIMAGECACHE_C_H
+#define VT2ISOIMAGECACHE_C_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+
+// ---------------------------------------------------------------------------
+//  Converts all requested bitmap files to all three colour depths up front.
+//  Independent files are converted on a pool of threads, the results are
+//  kept in memory for the DOM walk and optionally in a directory keyed by
+//  the hash of the file content, so unchanged bitmaps aren't converted
+//  again on the next run.
+// ---------------------------------------------------------------------------
+class Vt2IsoImageCache_c
+{
+ public:
+  struct Entry_s
+  {
+    unsigned int ui_width;
+    unsigned int ui_height;
+    int i_threshold;
+    bool b_invalidPalette;
+    bool b_fromDisk;
+    std::vector<unsigned char> vec_bitmap [3]; // 1, 4 and 8 bit raw bitmap
+  };
+
+  Vt2IsoImageCache_c();
+
+  /** ai_threads == 0: one per hardware thread */
+  void setThreads( unsigned int aui_threads ) { mui_threads = aui_threads; }
+  /** empty: no persistent cache */
+  void setCacheDir( const std::string& astr_dir ) { mstr_cacheDir = astr_dir; }
+
+  /** remember the file for the next convertRequested() */
+  void request( const std::string& astr_filename );
+
+  /** convert all requested files ( on several threads )
+      @return number of converted files ( including cache hits ) */
+  unsigned int convertRequested( bool ab_verbose );
+
+  /** @return NULL if the file wasn't converted ( e.g. couldn't be loaded ) */
+  const Entry_s* find( const std::string& astr_filename ) const;
+
+ private:
+  struct Job_s
+  {
+    std::string str_filename;
+    Entry_s* ps_entry; // NULL if failed
+  };
+
+  void convertJobs( std::vector<Job_s>& arvec_jobs, unsigned int aui_first, unsigned int aui_step ) const;
+  bool convert( const std::string& astr_filename, Entry_s& ars_entry ) const;
+
+  std::string cacheFileName( const std::string& astr_filename ) const;
+  bool loadFromDisk( const std::string& astr_cacheFile, Entry_s& ars_entry ) const;
+  void storeToDisk( const std::string& astr_cacheFile, const Entry_s& ars_entry ) const;
+
+  unsigned int mui_threads;
+  std::string mstr_cacheDir;
+  std::vector<std::string> mvec_requested;
+  std::map<std::string, Entry_s> mmap_entries;
+};
+
+#endif
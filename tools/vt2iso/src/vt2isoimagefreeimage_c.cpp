@@ -183,6 +183,37 @@ void Vt2IsoImageFreeImage_c::close( void )
 }
 
 
+void Vt2IsoImageFreeImage_c::decodeRgb( void )
+{
+ mvec_rgb.resize( 3 * ui_width * ui_height );
+ unsigned char* pui_pixel = mvec_rgb.empty() ? NULL : &mvec_rgb[0];
+ for ( unsigned int ui_y = 0; ui_y < ui_height; ui_y++ )
+ {
+  if (mb_palettized)
+  { // RGB has to be taken via the palette-index's colour
+   for ( unsigned int ui_x = 0; ui_x < ui_width; ui_x++ )
+   {
+    fiuint8_t idx;
+    FreeImage_GetPixelIndex (bitmap, ui_x, (ui_height - 1) - ui_y, &idx);
+    *pui_pixel++ = vtColourTable[idx].bgrRed;
+    *pui_pixel++ = vtColourTable[idx].bgrGreen;
+    *pui_pixel++ = vtColourTable[idx].bgrBlue;
+   }
+  }
+  else
+  { // first scanline in memory is bottommost
+   const BYTE* pui_line = FreeImage_GetScanLine(bitmap, ( (ui_height - 1) - ui_y ) );
+   for ( unsigned int ui_x = 0; ui_x < ui_width; ui_x++, pui_line += bytespp )
+   {
+    *pui_pixel++ = pui_line[FI_RGBA_RED];
+    *pui_pixel++ = pui_line[FI_RGBA_GREEN];
+    *pui_pixel++ = pui_line[FI_RGBA_BLUE];
+   }
+  }
+ }
+}
+
+
 /** check and adapt scanline */
 void Vt2IsoImageFreeImage_c::checkUpdateScanline( unsigned int aui_y )
 {
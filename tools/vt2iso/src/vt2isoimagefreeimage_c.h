@@ -50,6 +50,9 @@ class Vt2IsoImageFreeImage_c : public Vt2IsoImageBase_c
 
   int getPaletteIndex (unsigned int aui_x, unsigned int aui_y);
 
+	/** decode the whole bitmap scanline-wise */
+	virtual void decodeRgb( void );
+
  private:
 	/** check and adapt scanline */
 	void checkUpdateScanline( unsigned int aui_y );